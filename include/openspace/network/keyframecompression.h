@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___KEYFRAMECOMPRESSION___H__
+#define __OPENSPACE_CORE___KEYFRAMECOMPRESSION___H__
+
+#include <openspace/network/messagestructures.h>
+#include <ghoul/glm.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openspace::datamessagestructures {
+
+/**
+ * Quantizes the \p rotation using the "smallest three" encoding. The largest component
+ * of the normalized quaternion is omitted and its index is stored in \p index, while the
+ * remaining three components are stored as 16 bit integers in \p components.
+ */
+void quantizeRotation(const glm::dquat& rotation, uint8_t& index,
+    std::array<int16_t, 3>& components);
+
+/**
+ * Reconstructs a normalized quaternion from the result of the quantizeRotation function.
+ */
+glm::dquat dequantizeRotation(uint8_t index, const std::array<int16_t, 3>& components);
+
+/**
+ * The CameraKeyframeEncoder is fed with the camera pose on the sending side every frame
+ * and decides which of these poses have to be sent as CompactCameraKeyframes. A pose is
+ * only sent if the linear interpolation between the last sent keyframe and the current
+ * pose, which is what the KeyframeNavigator on the receiving side will perform,
+ * deviates from any of the poses in between by more than the tolerance. In addition, a
+ * keyframe is sent if the camera moved and the maximum interval has passed, so that the
+ * receiving side always has a future keyframe available.
+ *
+ * The encoder keeps track of the state on the receiving side, so that the positions are
+ * expressed as differences to the position that the receiver has reconstructed, which
+ * prevents the accumulation of errors.
+ */
+class CameraKeyframeEncoder {
+public:
+    /**
+     * Adds the camera pose \p keyframe, which has to have a larger timestamp than the
+     * previously added pose, and returns the keyframes that have to be sent as a result.
+     * The returned list is usually empty, but might contain up to two keyframes if the
+     * focus node changed.
+     */
+    std::vector<CompactCameraKeyframe> encode(const CameraKeyframe& keyframe);
+
+    /**
+     * Resets the encoder, which causes the next keyframe to be a sync point that also
+     * contains the names of the focus nodes. This has to be called whenever a new peer
+     * might have joined the connection.
+     */
+    void reset();
+
+    /**
+     * Sets the maximum relative position error and the maximum rotation error (in
+     * radians) that the interpolation on the receiving side is allowed to have.
+     */
+    void setTolerance(double tolerance);
+
+    /**
+     * Sets the maximum number of seconds between two keyframes while the camera is
+     * moving.
+     */
+    void setMaximumInterval(double interval);
+
+private:
+    CompactCameraKeyframe compress(const CameraKeyframe& keyframe);
+    bool isInterpolatable(const CameraKeyframe& begin, const CameraKeyframe& end,
+        const CameraKeyframe& sample) const;
+
+    double _tolerance = 5e-4;
+    double _maximumInterval = 0.1;
+
+    // The last keyframe as it was reconstructed on the receiving side
+    std::optional<CameraKeyframe> _lastSent;
+    // All poses that were added since the last keyframe was sent
+    std::vector<CameraKeyframe> _pending;
+
+    std::map<std::string, uint16_t> _focusNodeIndices;
+    double _lastSyncTimestamp = 0.0;
+};
+
+/**
+ * The CameraKeyframeDecoder reconstructs CameraKeyframes from the CompactCameraKeyframes
+ * created by the CameraKeyframeEncoder on the sending side. The keyframes have to be
+ * decoded in the order in which they were encoded.
+ */
+class CameraKeyframeDecoder {
+public:
+    /**
+     * Decodes the \p keyframe. If the keyframe references information that has not been
+     * received yet, which can happen if this peer joined after the last sync point,
+     * `std::nullopt` is returned.
+     */
+    std::optional<CameraKeyframe> decode(const CompactCameraKeyframe& keyframe);
+
+    /**
+     * Resets the decoder, which causes all keyframes to be ignored until the next sync
+     * point is received.
+     */
+    void reset();
+
+private:
+    std::map<uint16_t, std::string> _focusNodes;
+    std::optional<glm::dvec3> _position;
+};
+
+} // namespace openspace::datamessagestructures
+
+#endif // __OPENSPACE_CORE___KEYFRAMECOMPRESSION___H__
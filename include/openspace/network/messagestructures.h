@@ -29,9 +29,11 @@
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -41,7 +43,9 @@ namespace openspace::datamessagestructures {
 enum class Type : uint32_t {
     CameraData = 0,
     TimelineData,
-    ScriptData
+    ScriptData,
+    CompactCameraData,
+    CompactTimelineData
 };
 
 struct CameraKeyframe {
@@ -381,6 +385,259 @@ struct TimeTimeline {
     }
 };
 
+/**
+ * A compact representation of a CameraKeyframe that is used for sending keyframes over
+ * the parallel connection. The focus node is interned as an index that is only sent
+ * together with its name when it was not sent before, the position is sent as a single
+ * precision difference to the previously sent position, and the rotation is quantized
+ * into 16 bit integers using the three smallest components of the quaternion. Keyframes
+ * that have the AbsolutePosition flag set are sync points that can be decoded without
+ * knowledge of the previous keyframes. The CompactCameraKeyframes are created and
+ * decoded by the CameraKeyframeEncoder and CameraKeyframeDecoder respectively.
+ */
+struct CompactCameraKeyframe {
+    enum Flag : uint8_t {
+        FollowNodeRotation = 1 << 0,
+        HasFocusNodeName = 1 << 1,
+        AbsolutePosition = 1 << 2
+    };
+
+    CompactCameraKeyframe() = default;
+    CompactCameraKeyframe(const std::vector<char>& buffer) {
+        deserialize(buffer);
+    }
+
+    uint8_t _flags = 0;
+    uint16_t _focusNodeIndex = 0;
+    // Only valid if the HasFocusNodeName flag is set
+    std::string _focusNodeName;
+    // Only valid if the AbsolutePosition flag is set
+    glm::dvec3 _position = glm::dvec3(0.0);
+    // Only valid if the AbsolutePosition flag is not set
+    glm::vec3 _positionDelta = glm::vec3(0.f);
+    // The index of the omitted largest component of the rotation quaternion
+    uint8_t _rotationIndex = 3;
+    // The remaining three components of the rotation quaternion in order
+    std::array<int16_t, 3> _rotation = { 0, 0, 0 };
+    float _scale = 0.f;
+
+    double _timestamp = 0.0;
+
+    void serialize(std::vector<char>& buffer) const {
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_flags),
+            reinterpret_cast<const char*>(&_flags) + sizeof(_flags)
+        );
+
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_focusNodeIndex),
+            reinterpret_cast<const char*>(&_focusNodeIndex) + sizeof(_focusNodeIndex)
+        );
+        if (_flags & HasFocusNodeName) {
+            const uint8_t nameLength = static_cast<uint8_t>(
+                std::min<size_t>(_focusNodeName.size(), 255)
+            );
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&nameLength),
+                reinterpret_cast<const char*>(&nameLength) + sizeof(nameLength)
+            );
+            buffer.insert(
+                buffer.end(),
+                _focusNodeName.data(),
+                _focusNodeName.data() + nameLength
+            );
+        }
+
+        if (_flags & AbsolutePosition) {
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&_position),
+                reinterpret_cast<const char*>(&_position) + sizeof(_position)
+            );
+        }
+        else {
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&_positionDelta),
+                reinterpret_cast<const char*>(&_positionDelta) + sizeof(_positionDelta)
+            );
+        }
+
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_rotationIndex),
+            reinterpret_cast<const char*>(&_rotationIndex) + sizeof(_rotationIndex)
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(_rotation.data()),
+            reinterpret_cast<const char*>(_rotation.data()) + sizeof(_rotation)
+        );
+
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_scale),
+            reinterpret_cast<const char*>(&_scale) + sizeof(_scale)
+        );
+
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_timestamp),
+            reinterpret_cast<const char*>(&_timestamp) + sizeof(_timestamp)
+        );
+    }
+
+    size_t deserialize(const std::vector<char>& buffer, size_t offset = 0) {
+        size_t size = 0;
+
+        size = sizeof(_flags);
+        std::memcpy(&_flags, buffer.data() + offset, size);
+        offset += size;
+
+        size = sizeof(_focusNodeIndex);
+        std::memcpy(&_focusNodeIndex, buffer.data() + offset, size);
+        offset += size;
+        if (_flags & HasFocusNodeName) {
+            uint8_t nameLength = 0;
+            size = sizeof(nameLength);
+            std::memcpy(&nameLength, buffer.data() + offset, size);
+            offset += size;
+
+            size = nameLength;
+            _focusNodeName = std::string(
+                buffer.data() + offset,
+                buffer.data() + offset + size
+            );
+            offset += size;
+        }
+
+        if (_flags & AbsolutePosition) {
+            size = sizeof(_position);
+            std::memcpy(glm::value_ptr(_position), buffer.data() + offset, size);
+            offset += size;
+        }
+        else {
+            size = sizeof(_positionDelta);
+            std::memcpy(glm::value_ptr(_positionDelta), buffer.data() + offset, size);
+            offset += size;
+        }
+
+        size = sizeof(_rotationIndex);
+        std::memcpy(&_rotationIndex, buffer.data() + offset, size);
+        offset += size;
+        size = sizeof(_rotation);
+        std::memcpy(_rotation.data(), buffer.data() + offset, size);
+        offset += size;
+
+        size = sizeof(_scale);
+        std::memcpy(&_scale, buffer.data() + offset, size);
+        offset += size;
+
+        size = sizeof(_timestamp);
+        std::memcpy(&_timestamp, buffer.data() + offset, size);
+        offset += size;
+
+        return offset;
+    }
+};
+
+/**
+ * A compact representation of a TimeTimeline. In contrast to the TimeTimeline, which
+ * copies the padded TimeKeyframe structs, only the used bytes are sent and the boolean
+ * values are packed into a single byte per keyframe.
+ */
+struct CompactTimeTimeline {
+    enum Flag : uint8_t {
+        Paused = 1 << 0,
+        RequiresTimeJump = 1 << 1
+    };
+
+    CompactTimeTimeline() = default;
+    CompactTimeTimeline(const std::vector<char>& buffer) {
+        deserialize(buffer);
+    }
+
+    bool _clear = true;
+    std::vector<TimeKeyframe> _keyframes;
+
+    void serialize(std::vector<char>& buffer) const {
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_clear),
+            reinterpret_cast<const char*>(&_clear) + sizeof(bool)
+        );
+
+        const uint16_t nKeyframes = static_cast<uint16_t>(
+            std::min<size_t>(_keyframes.size(), std::numeric_limits<uint16_t>::max())
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&nKeyframes),
+            reinterpret_cast<const char*>(&nKeyframes) + sizeof(uint16_t)
+        );
+        for (uint16_t i = 0; i < nKeyframes; i++) {
+            const TimeKeyframe& k = _keyframes[i];
+            const uint8_t flags =
+                (k._paused ? Paused : 0) | (k._requiresTimeJump ? RequiresTimeJump : 0);
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&flags),
+                reinterpret_cast<const char*>(&flags) + sizeof(uint8_t)
+            );
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&k._time),
+                reinterpret_cast<const char*>(&k._time) + sizeof(double)
+            );
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&k._dt),
+                reinterpret_cast<const char*>(&k._dt) + sizeof(double)
+            );
+            buffer.insert(
+                buffer.end(),
+                reinterpret_cast<const char*>(&k._timestamp),
+                reinterpret_cast<const char*>(&k._timestamp) + sizeof(double)
+            );
+        }
+    }
+
+    size_t deserialize(const std::vector<char>& buffer, size_t offset = 0) {
+        size_t size = 0;
+
+        size = sizeof(_clear);
+        std::memcpy(&_clear, buffer.data() + offset, size);
+        offset += size;
+
+        uint16_t nKeyframes = 0;
+        size = sizeof(nKeyframes);
+        std::memcpy(&nKeyframes, buffer.data() + offset, size);
+        offset += size;
+
+        _keyframes.resize(nKeyframes);
+        for (TimeKeyframe& k : _keyframes) {
+            uint8_t flags = 0;
+            size = sizeof(flags);
+            std::memcpy(&flags, buffer.data() + offset, size);
+            offset += size;
+            k._paused = flags & Paused;
+            k._requiresTimeJump = flags & RequiresTimeJump;
+
+            size = sizeof(double);
+            std::memcpy(&k._time, buffer.data() + offset, size);
+            offset += size;
+            std::memcpy(&k._dt, buffer.data() + offset, size);
+            offset += size;
+            std::memcpy(&k._timestamp, buffer.data() + offset, size);
+            offset += size;
+        }
+        return offset;
+    }
+};
+
 struct ScriptMessage {
     ScriptMessage() = default;
     ScriptMessage(const std::vector<char>& buffer) {
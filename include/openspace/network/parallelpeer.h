@@ -27,6 +27,7 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/network/keyframecompression.h>
 #include <openspace/network/messagestructures.h>
 #include <openspace/network/parallelconnection.h>
 #include <openspace/properties/scalar/floatproperty.h>
@@ -84,6 +85,9 @@ private:
     void dataMessageReceived(const std::vector<char>& message);
     void connectionStatusMessageReceived(const std::vector<char>& message);
     void nConnectionsMessageReceived(const std::vector<char>& message);
+    void addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf);
+    void addTimeKeyframes(const std::vector<datamessagestructures::TimeKeyframe>& kfs,
+        bool clear, double timestamp);
 
     void sendCameraKeyframe();
     void sendTimeTimeline();
@@ -106,9 +110,13 @@ private:
     properties::FloatProperty _bufferTime;
     properties::FloatProperty _timeKeyframeInterval;
     properties::FloatProperty _cameraKeyframeInterval;
+    properties::FloatProperty _cameraKeyframeTolerance;
 
     double _lastTimeKeyframeTimestamp = 0.0;
-    double _lastCameraKeyframeTimestamp = 0.0;
+
+    datamessagestructures::CameraKeyframeEncoder _cameraKeyframeEncoder;
+    datamessagestructures::CameraKeyframeDecoder _cameraKeyframeDecoder;
+    std::atomic_bool _shouldResetKeyframeEncoder = true;
 
     std::atomic_bool _shouldDisconnect = false;
 
@@ -26,8 +26,14 @@
 #define __OPENSPACE_CORE___PROPERTYOWNER___H__
 
 #include <openspace/json.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::properties {
@@ -139,13 +145,34 @@ public:
      */
     std::vector<Property*> propertiesRecursive() const;
 
+    /**
+     * Returns a list of all Propertys directly or indirectly owned by this PropertyOwner
+     * together with their URIs relative to this PropertyOwner. The URIs are built
+     * during a single traversal of the subtree, which is considerably cheaper than
+     * calling Property::fullyQualifiedIdentifier for each Property. The order of the
+     * list is the same as for propertiesRecursive.
+     *
+     * \return A list of all Propertys in the subtree of this PropertyOwner and their URIs
+     */
+    std::vector<std::pair<std::string, Property*>> propertiesWithUri() const;
+
+    /**
+     * Enables the URI index for this PropertyOwner. The index maps the URIs of all
+     * Propertys in the subtree of this PropertyOwner to the Propertys, which turns the
+     * PropertyOwner::property lookup into a single hash lookup. The index is kept up to
+     * date whenever a Property or sub-owner is added or removed anywhere in the subtree,
+     * or when a sub-owner changes its identifier.
+     */
+    void enableUriIndex();
+
     /**
      * Retrieves a Property identified by \p uri from this PropertyOwner. If \p uri does
      * not contain a `.` the identifier must refer to a Property directly owned
      * by this PropertyOwner. If the identifier contains one or more `.`, the
      * first part of the name will be recursively extracted and used as a name for a
      * sub-owner and only the last part of the identifier is referring to a Property owned
-     * by PropertyOwner named by the second-but-last name.
+     * by PropertyOwner named by the second-but-last name. If the URI index is enabled,
+     * the Property is instead looked up in the index.
      *
      * \param uri The identifier of the Property that should be extracted
      * \return If the Property cannot be found, `nullptr` is returned, otherwise the
@@ -297,6 +324,26 @@ public:
     // Generate JSON for documentation
     nlohmann::json generateJson() const;
 
+    /**
+     * Returns the version of the last structural change of this PropertyOwner. A
+     * structural change is the addition or removal of a Property or sub-owner, or a
+     * change to the identifier, GUI name, description, or tags. Versions are drawn from
+     * a single, monotonically increasing counter that is shared between all
+     * PropertyOwners, so they can be compared across owners.
+     *
+     * \return The version of the last structural change of this PropertyOwner
+     */
+    uint64_t structureVersion() const;
+
+    /**
+     * Returns the version of the last structural change to this PropertyOwner or any of
+     * its direct or indirect sub-owners. If this value is unchanged, the entire subtree
+     * rooted in this PropertyOwner is unchanged as well.
+     *
+     * \return The version of the last structural change of this PropertyOwner's subtree
+     */
+    uint64_t subtreeVersion() const;
+
 protected:
     /// The unique identifier of this PropertyOwner
     std::string _identifier;
@@ -317,6 +364,35 @@ protected:
     std::map<std::string, std::string> _groupNames;
     /// Collection of string tag(s) assigned to this property
     std::vector<std::string> _tags;
+
+private:
+    struct UriIndex {
+        std::unordered_map<std::string, Property*> properties;
+        std::mutex mutex;
+    };
+
+    /// Marks this PropertyOwner and all of its owners as structurally changed
+    void notifyStructureChange();
+
+    /// Returns whether this PropertyOwner or any of its owners has an URI index
+    bool isUriIndexed() const;
+
+    /**
+     * Calls \p update for the URI index of this PropertyOwner and all of its owners
+     * together with the prefix that has to be prepended to URIs relative to this
+     * PropertyOwner to make them relative to the owner of the index.
+     */
+    void updateUriIndices(
+        const std::function<void(UriIndex&, const std::string&)>& update);
+
+    /// The index of all Propertys in this subtree, if enabled
+    std::shared_ptr<UriIndex> _uriIndex;
+
+    /// The version of the last structural change of this PropertyOwner. Atomic as owners
+    /// are attached concurrently while a scene is initialized
+    std::atomic<uint64_t> _structureVersion = 0;
+    /// The version of the last structural change in this PropertyOwner's subtree
+    std::atomic<uint64_t> _subtreeVersion = 0;
 };
 
 }  // namespace openspace::properties
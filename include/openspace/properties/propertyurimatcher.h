@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PROPERTYURIMATCHER___H__
+#define __OPENSPACE_CORE___PROPERTYURIMATCHER___H__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace openspace::properties {
+
+class Property;
+class PropertyOwner;
+
+/**
+ * This class compiles the URI expressions that are used to address multiple Propertys at
+ * the same time, for example in the `openspace.setPropertyValue` function. An expression
+ * is either a literal URI, or contains a single `*` wildcard which splits the expression
+ * into a node name part and a property name part. Additionally, a group name can be
+ * provided, in which case only Propertys whose owners (direct or indirect) carry the
+ * group name as a tag are matched.
+ *
+ * The expression is parsed once on construction, after which the matcher can be applied
+ * to an arbitrary number of URIs. The #matchingProperties function additionally caches
+ * the result of a search until the structure of the searched PropertyOwner changes.
+ */
+class PropertyUriMatcher {
+public:
+    /**
+     * Compiles the provided \p expression and optional \p groupName. If the expression is
+     * malformed, the matcher will not match any URI and #isValid returns `false`.
+     *
+     * \param expression The URI expression, which may contain a single `*` wildcard
+     * \param groupName If not empty, only Propertys with an owner tagged with this name
+     *        are matched
+     */
+    explicit PropertyUriMatcher(std::string expression, std::string groupName = "");
+
+    /**
+     * Returns whether the expression passed to the constructor was well-formed.
+     *
+     * \return `true` if the expression was well-formed, `false` otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * Returns a description of the problem with the expression if #isValid returns
+     * `false`, or an empty string otherwise.
+     *
+     * \return The description of the problem with the expression
+     */
+    const std::string& error() const;
+
+    /**
+     * Returns whether this matcher is a literal URI, which means that at most one
+     * Property can ever be matched.
+     *
+     * \return `true` if the expression is a literal URI
+     */
+    bool isLiteral() const;
+
+    /**
+     * Tests whether the \p prop with the fully qualified \p uri is matched by this
+     * matcher.
+     *
+     * \param uri The fully qualified URI of the \p prop
+     * \param prop The Property that is tested. It is only accessed if a group name was
+     *        provided
+     * \return `true` if the Property is matched by this matcher
+     */
+    bool matches(const std::string& uri, const Property& prop) const;
+
+    /**
+     * Returns all Propertys in the subtree of \p root that are matched by this matcher
+     * together with their URIs relative to \p root. The result is in the same order as
+     * PropertyOwner::propertiesRecursive.
+     *
+     * \param root The PropertyOwner whose subtree is searched
+     * \return All matching Propertys together with their URIs
+     */
+    std::vector<std::pair<std::string, Property*>> findMatches(
+        const PropertyOwner& root) const;
+
+    /**
+     * Returns the expression that was passed to the constructor.
+     *
+     * \return The expression of this matcher
+     */
+    const std::string& expression() const;
+
+    /**
+     * Returns a key that uniquely identifies the expression and group name of this
+     * matcher.
+     *
+     * \return The key for this matcher
+     */
+    const std::string& key() const;
+
+private:
+    std::string _expression;
+    std::string _key;
+    std::string _error;
+    std::string _nodeName;
+    std::string _propertyName;
+    std::string _groupName;
+    bool _isLiteral = false;
+};
+
+/**
+ * Returns all Propertys in the subtree of \p root that are matched by the \p matcher,
+ * together with their URIs relative to \p root. The result of the search is cached and
+ * reused for subsequent calls with the same expression until the structure of \p root's
+ * subtree changes, as reported by PropertyOwner::subtreeVersion. Literal URIs are
+ * resolved through PropertyOwner::property directly without a search.
+ *
+ * \param root The PropertyOwner whose subtree is searched
+ * \param matcher The compiled expression that is used to find the Propertys
+ * \return All matching Propertys together with their URIs
+ */
+std::vector<std::pair<std::string, Property*>> matchingProperties(
+    const PropertyOwner& root, const PropertyUriMatcher& matcher);
+
+} // namespace openspace::properties
+
+#endif // __OPENSPACE_CORE___PROPERTYURIMATCHER___H__
@@ -79,6 +79,16 @@ public:
     virtual ~Renderable() override = default;
 
     virtual void initialize();
+
+    /**
+     * Loads and prepares the data of this renderable. This function is called after
+     * #initialize and before #initializeGL. If the scene is initialized with multiple
+     * threads, this function is called on one of the worker threads, so it must not call
+     * any OpenGL functions. All expensive CPU work, such as reading and parsing files,
+     * should be done here so that #initializeGL only has to upload the prepared data.
+     */
+    virtual void initializeData();
+
     virtual void initializeGL();
     virtual void deinitialize();
     virtual void deinitializeGL();
@@ -166,6 +166,13 @@ public:
      */
     bool isInitializing() const;
 
+    /**
+     * Logs the time that the scene graph nodes spent in each of their initialization
+     * phases. The \p nEntries nodes that took the longest are logged as info messages,
+     * the remaining nodes as debug messages.
+     */
+    void logLoadTimes(int nEntries = 10) const;
+
     /**
      * Adds an interpolation request for the passed \p prop that will run for
      * \p durationSeconds seconds. Every time the #updateInterpolations method is called
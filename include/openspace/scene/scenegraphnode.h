@@ -74,6 +74,16 @@ public:
 
     BooleanType(UpdateScene);
 
+    /// The time that was spent in each of the initialization phases of a node
+    struct LoadTimes {
+        std::chrono::duration<double, std::milli> initialize =
+            std::chrono::duration<double, std::milli>(0.0);
+        std::chrono::duration<double, std::milli> data =
+            std::chrono::duration<double, std::milli>(0.0);
+        std::chrono::duration<double, std::milli> gl =
+            std::chrono::duration<double, std::milli>(0.0);
+    };
+
     static constexpr const char* RootNodeIdentifier = "Root";
     static constexpr std::string_view KeyIdentifier = "Identifier";
     static constexpr std::string_view KeyParentName = "Parent";
@@ -87,6 +97,7 @@ public:
         const ghoul::Dictionary& dictionary);
 
     void initialize();
+    void initializeData();
     void initializeGL();
     void deinitialize();
     void deinitializeGL();
@@ -149,6 +160,8 @@ public:
     std::string guiPath() const;
     bool hasGuiHintHidden() const;
 
+    const LoadTimes& loadTimes() const;
+
     static documentation::Documentation Documentation();
 
 private:
@@ -159,6 +172,7 @@ private:
     void renderDebugSphere(const Camera& camera, double size, glm::vec4 color);
 
     std::atomic<State> _state = State::Loaded;
+    LoadTimes _loadTimes;
     std::vector<ghoul::mm_unique_ptr<SceneGraphNode>> _children;
     SceneGraphNode* _parent = nullptr;
     std::vector<SceneGraphNode*> _dependencies;
@@ -53,6 +53,16 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Returns whether the #position(const UpdateData&) function can be called from
+     * multiple threads at the same time, provided that none of the properties of this
+     * Translation change while doing so. Callers have to evaluate one position on the
+     * calling thread first, which initializes any state that is computed lazily.
+     *
+     * \return `true` if the position can be evaluated concurrently
+     */
+    virtual bool supportsConcurrentEvaluation() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
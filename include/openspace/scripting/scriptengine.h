@@ -30,11 +30,14 @@
 #include <openspace/json.h>
 #include <ghoul/lua/luastate.h>
 #include <ghoul/misc/boolean.h>
+#include <chrono>
 #include <filesystem>
+#include <list>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <functional>
+#include <unordered_map>
 
 namespace openspace { class SyncBuffer; }
 
@@ -61,8 +64,27 @@ public:
         ScriptCallback callback;
     };
 
+    /// Statistics about the cache of compiled Lua chunks used by #runScript
+    struct ChunkCacheStatistics {
+        /// The number of scripts that were served from the cache
+        uint64_t hits = 0;
+        /// The number of scripts that had to be compiled
+        uint64_t misses = 0;
+        /// The number of compiled chunks that were removed to make room for new ones
+        uint64_t evictions = 0;
+        /// The number of compiled chunks currently in the cache
+        size_t size = 0;
+        /// The total time spent compiling scripts
+        std::chrono::microseconds compileTime = std::chrono::microseconds(0);
+        /// The compilation time that was avoided by reusing cached chunks
+        std::chrono::microseconds compileTimeSaved = std::chrono::microseconds(0);
+    };
+
     static constexpr std::string_view OpenSpaceLibraryName = "openspace";
 
+    /// The default number of compiled chunks that are kept in the cache
+    static constexpr size_t DefaultChunkCacheSize = 512;
+
     ScriptEngine();
 
     /**
@@ -83,9 +105,35 @@ public:
     void addLibrary(LuaLibrary library);
     bool hasLibrary(const std::string& name);
 
+    /**
+     * Executes the provided \p script in the internal Lua state. Scripts are compiled
+     * into Lua chunks that are kept in a least-recently-used cache, so that a script that
+     * is executed repeatedly is only compiled once. If a \p callback is provided, it is
+     * called with all values returned by the script.
+     *
+     * \param script The Lua script that should be executed
+     * \param callback The function that is called with the return values of the script
+     * \return `true` if the script was executed successfully, `false` otherwise
+     */
     bool runScript(const std::string& script, ScriptCallback callback = ScriptCallback());
     bool runScriptFile(const std::filesystem::path& filename);
 
+    /**
+     * Sets the maximum number of compiled chunks that are kept in the cache. If the cache
+     * currently contains more chunks, the least recently used ones are removed. A size of
+     * 0 disables the cache.
+     *
+     * \param size The maximum number of compiled chunks
+     */
+    void setChunkCacheSize(size_t size);
+
+    /**
+     * Returns the statistics about the compiled chunk cache that is used by #runScript.
+     *
+     * \return The statistics about the compiled chunk cache
+     */
+    ChunkCacheStatistics chunkCacheStatistics() const;
+
     virtual void preSync(bool isMaster) override;
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
@@ -110,7 +158,30 @@ private:
 
     void addBaseLibrary();
 
+    /**
+     * Pushes the compiled chunk for the \p script onto the stack of the internal Lua
+     * state, either from the cache or by compiling the script. If the script fails to
+     * compile, the error message is pushed instead and `false` is returned.
+     */
+    bool pushCompiledChunk(const std::string& script);
+
+    /// Removes least recently used chunks until the cache fits into its maximum size
+    void shrinkChunkCache(size_t size);
+
     ghoul::lua::LuaState _state;
+
+    struct CompiledChunk {
+        std::string script;
+        // Reference to the compiled function in the registry of the Lua state
+        int reference;
+        std::chrono::microseconds compileTime;
+    };
+    // The most recently used chunk is at the front of the list
+    std::list<CompiledChunk> _chunkCache;
+    std::unordered_map<size_t, std::list<CompiledChunk>::iterator> _chunkCacheIndex;
+    size_t _chunkCacheSize = DefaultChunkCacheSize;
+    ChunkCacheStatistics _chunkCacheStatistics;
+
     std::vector<LuaLibrary> _registeredLibraries;
 
     std::queue<QueueItem> _incomingScripts;
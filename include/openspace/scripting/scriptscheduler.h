@@ -32,9 +32,12 @@
 #include <openspace/scripting/lualibrary.h>
 
 #include <functional>
+#include <map>
 #include <optional>
 #include <queue>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace ghoul { class Dictionary; }
@@ -46,7 +49,12 @@ struct LuaLibrary;
 
 /**
  * Maintains an ordered list of `ScheduledScript`s and provides a simple
- * interface for retrieveing scheduled scripts
+ * interface for retrieveing scheduled scripts. The scripts are stored in a timeline that
+ * is ordered by time and load order, which allows batches of scripts to be inserted and
+ * removed without touching the rest of the schedule. The scripts of each group are
+ * tracked separately so that a group can be cleared without searching the schedule. The
+ * script bodies are interned, so identical scripts are only stored once and can be
+ * handed out as views without being copied.
  */
 class ScriptScheduler : public properties::PropertyOwner {
 public:
@@ -98,8 +106,10 @@ public:
     * the script scheduler should progress to.
     *
     * \returns vector with the scheduled scripts that should be run from begining to end.
+    *          The views refer to the interned script bodies and remain valid until the
+    *          next call to #loadScripts or #clearSchedule
     */
-    std::vector<std::string> progressTo(double newTime);
+    std::vector<std::string_view> progressTo(double newTime);
 
     /**
      * Returns the the j2000 time value that the script scheduler is currently at
@@ -139,11 +149,52 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /// Orders the entries of the timeline by time and then by the order they were loaded
+    struct EntryKey {
+        double time;
+        uint64_t order;
+
+        bool operator<(const EntryKey& rhs) const;
+    };
+
+    struct Entry {
+        ScheduledScript script;
+        /// The interned script that is executed when passing the entry going forward
+        std::string_view forwardScript;
+        /// The interned script that is executed when passing the entry going backward
+        std::string_view backwardScript;
+    };
+
+    using Timeline = std::map<EntryKey, Entry>;
+
+    /**
+     * Returns a view of the interned copy of \p script, which is valid until the same
+     * number of calls to #releaseScript have been made.
+     */
+    std::string_view internScript(std::string script);
+    void releaseScript(std::string_view script);
+
+    /// Removes the entry pointed to by \p it from the timeline
+    void eraseEntry(Timeline::iterator it);
+
+    /**
+     * Updates the position in the timeline after it has been modified, which is
+     * equivalent to rewinding and progressing to the current time again.
+     */
+    void updatePosition();
+
     properties::BoolProperty _enabled;
     properties::BoolProperty _shouldRunAllTimeJump;
-    std::vector<ScheduledScript> _scripts;
 
-    int _currentIndex = 0;
+    Timeline _timeline;
+    /// The entries of the timeline that belong to each group
+    std::map<int, std::vector<Timeline::iterator>> _groups;
+    /// The interned script bodies together with the number of entries referencing them
+    std::unordered_map<std::string, int> _scriptBodies;
+    /// The first entry in the timeline that has not been passed yet
+    Timeline::iterator _position = _timeline.end();
+    uint64_t _nextOrder = 0;
+
     double _currentTime = 0;
 
     openspace::interaction::KeyframeTimeRef _timeframeMode
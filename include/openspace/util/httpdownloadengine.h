@@ -0,0 +1,181 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___HTTPDOWNLOADENGINE___H__
+#define __OPENSPACE_CORE___HTTPDOWNLOADENGINE___H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * This class downloads files concurrently using a single thread that drives all of the
+ * transfers through the curl multi interface. At most a fixed number of transfers are
+ * active at the same time and the connections to a server are kept alive and reused for
+ * the following transfers to the same server.
+ *
+ * Every file is first downloaded into a temporary file next to its destination, which is
+ * renamed once the transfer has completed. If this temporary file already exists, for
+ * example because a previous download was interrupted, the transfer is resumed from the
+ * end of the existing file. The ETag or modification date of the partially downloaded
+ * file is stored next to it and sent with the range request, so that the server sends
+ * the entire file instead if it has changed since. Partial files without such a
+ * validator are downloaded again from the beginning. All protocols supported by curl
+ * can be used, which includes `file://` URLs to copy files from a local directory.
+ *
+ * Files are submitted to the engine as a Batch. The progress of a batch is aggregated
+ * while the transfers are reporting their progress, so querying it is independent of the
+ * number of files in the batch.
+ */
+class HttpDownloadEngine {
+public:
+    /// A single file that should be downloaded from the #url to the #destination
+    struct File {
+        std::string url;
+        std::filesystem::path destination;
+    };
+
+    /// A group of files that were submitted together by a call to #download
+    class Batch {
+    public:
+        /**
+         * Blocks until all files of this batch have either been downloaded or have
+         * failed and returns whether all of the files were downloaded successfully.
+         */
+        bool wait();
+
+        /**
+         * Blocks until all files of this batch have been handled or until the \p timeout
+         * has passed. Returns `true` if the batch is finished.
+         */
+        bool waitFor(std::chrono::milliseconds timeout);
+
+        /// Returns whether all files of this batch have been handled
+        bool isFinished() const;
+
+        /**
+         * Cancels all transfers of this batch. Transfers that have already started are
+         * aborted the next time they report any progress and all cancelled transfers
+         * are counted as failures.
+         */
+        void cancel();
+
+        /// The number of bytes downloaded by all transfers of this batch
+        int64_t nDownloadedBytes() const;
+
+        /// The number of bytes in all files of this batch whose size is known
+        int64_t nTotalBytes() const;
+
+        /// Returns `true` if the size of every file in this batch is known
+        bool isTotalBytesKnown() const;
+
+        /// Returns the URLs of all files that failed to download
+        std::vector<std::string> failedUrls() const;
+
+    private:
+        friend class HttpDownloadEngine;
+
+        std::atomic<int64_t> _nDownloadedBytes = 0;
+        std::atomic<int64_t> _nTotalBytes = 0;
+        std::atomic_int _nUnknownTotals = 0;
+        std::atomic_bool _shouldCancel = false;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _finishedCondition;
+        int _nRemaining = 0;
+        std::vector<std::string> _failedUrls;
+    };
+
+    /**
+     * Creates a new download engine that will transfer at most \p maxConcurrentTransfers
+     * files at the same time. The thread driving the transfers is started with the
+     * first call to #download.
+     *
+     * \pre \p maxConcurrentTransfers must be positive
+     */
+    explicit HttpDownloadEngine(int maxConcurrentTransfers = 8);
+
+    /// Cancels all outstanding transfers and waits for the transfer thread to finish
+    ~HttpDownloadEngine();
+
+    /**
+     * Enqueues all \p files for download and returns the Batch that can be used to query
+     * the progress of these files. Existing files at the destinations are overwritten
+     * once the respective transfer has finished successfully.
+     */
+    std::shared_ptr<Batch> download(std::vector<File> files);
+
+private:
+    struct Transfer;
+
+    /// The main loop of the transfer thread
+    void run();
+
+    /// Moves queued transfers into the set of active transfers. Called with _mutex held
+    void startQueuedTransfers();
+    bool startTransfer(Transfer& transfer);
+    void finishTransfer(std::unique_ptr<Transfer> transfer, bool success);
+
+    /// Updates the progress of the \p transfer's batch with the absolute \p nBytes and
+    /// \p nTotalBytes of the transfer, the latter being 0 if it is unknown
+    static void reportProgress(Transfer& transfer, int64_t nBytes, int64_t nTotalBytes);
+
+    /// Removes everything that the \p transfer has reported from its batch's progress
+    static void resetProgress(Transfer& transfer);
+
+    const int _maxConcurrentTransfers;
+
+    /// The handle to the curl multi interface. Only accessed by the transfer thread
+    void* _multiHandle = nullptr;
+
+    /// Easy handles of finished transfers that are reused so that their connections and
+    /// DNS caches can be used by later transfers
+    std::vector<void*> _idleHandles;
+
+    /// Transfers that are currently being downloaded. Only accessed by the transfer
+    /// thread
+    std::vector<std::unique_ptr<Transfer>> _activeTransfers;
+
+    std::mutex _mutex;
+    /// Signalled when transfers are enqueued or the engine is destroyed, which wakes up
+    /// the transfer thread while it has no active transfers
+    std::condition_variable _wakeUpCondition;
+    std::deque<std::unique_ptr<Transfer>> _queuedTransfers;
+    std::atomic_bool _shouldStop = false;
+    std::thread _thread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___HTTPDOWNLOADENGINE___H__
@@ -38,21 +38,30 @@
 #include <openspace/scene/scene.h>
 #include <openspace/scene/lightsource.h>
 #include <ghoul/io/model/modelgeometry.h>
+#include <ghoul/io/model/modelreader.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
 #include <ghoul/misc/invariants.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/framebufferobject.h>
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <optional>
 
 namespace {
     constexpr std::string_view _loggerCat = "RenderableModel";
     constexpr std::string_view ProgramName = "ModelProgram";
 
+    // Increase this number whenever the contents of the cached model files change so
+    // that existing caches are no longer used
+    constexpr int CurrentCacheVersion = 1;
+
     constexpr int DefaultBlending = 0;
     constexpr int AdditiveBlending = 1;
     constexpr int PointsAndLinesBlending = 2;
@@ -191,6 +200,103 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    std::filesystem::path cachedModelFile(const std::filesystem::path& file,
+                                          bool forceRenderInvisible)
+    {
+        // The cache is keyed by the content of the source file and the options that
+        // change the resulting geometry, so that a modified model is imported again
+        const unsigned int hash = ghoul::hashCRC32File(file);
+        const std::string information = fmt::format(
+            "{}|{}|{}", CurrentCacheVersion, hash, forceRenderInvisible
+        );
+
+        // The binary model reader is picked based on the extension of the cached file
+        std::filesystem::path name = file.filename();
+        name.replace_extension("osmodel");
+        return FileSys.cacheManager()->cachedFilename(name, information);
+    }
+
+    std::filesystem::path importTimeFile(std::filesystem::path cachedFile) {
+        return cachedFile.replace_extension("importtime");
+    }
+
+    std::unique_ptr<ghoul::modelgeometry::ModelGeometry> loadModel(
+                                                       const std::filesystem::path& file,
+                                                                bool forceRenderInvisible,
+                                                              bool notifyInvisibleDropped)
+    {
+        using namespace std::chrono;
+        using ModelReader = ghoul::io::ModelReader;
+
+        auto load = [&](const std::filesystem::path& path) {
+            return ModelReader::ref().loadModel(
+                path,
+                ModelReader::ForceRenderInvisible(forceRenderInvisible),
+                ModelReader::NotifyInvisibleDropped(notifyInvisibleDropped)
+            );
+        };
+
+        // Models that are already stored in the binary format don't need to be cached
+        if (file.extension() == ".osmodel") {
+            return load(file);
+        }
+
+        const std::filesystem::path cachedFile =
+            cachedModelFile(file, forceRenderInvisible);
+        const std::filesystem::path timeFile = importTimeFile(cachedFile);
+
+        if (std::filesystem::is_regular_file(cachedFile)) {
+            const steady_clock::time_point start = steady_clock::now();
+            try {
+                std::unique_ptr<ghoul::modelgeometry::ModelGeometry> geometry =
+                    load(cachedFile);
+                const duration<double, std::milli> loadTime = steady_clock::now() - start;
+
+                double importTime = 0.0;
+                std::ifstream(timeFile) >> importTime;
+                if (importTime > 0.0) {
+                    LINFO(fmt::format(
+                        "Loaded model {} from cache in {:.1f} ms, {:.1f} times faster "
+                        "than importing it ({:.1f} ms)",
+                        file, loadTime.count(), importTime / loadTime.count(),
+                        importTime
+                    ));
+                }
+                else {
+                    LINFO(fmt::format(
+                        "Loaded model {} from cache in {:.1f} ms", file, loadTime.count()
+                    ));
+                }
+                return geometry;
+            }
+            catch (const ghoul::RuntimeError& e) {
+                // If the cached file can't be read, it is overwritten below
+                LWARNING(fmt::format(
+                    "Failed to load cached model {}: {}", cachedFile, e.message
+                ));
+            }
+        }
+
+        const steady_clock::time_point start = steady_clock::now();
+        std::unique_ptr<ghoul::modelgeometry::ModelGeometry> geometry = load(file);
+        const duration<double, std::milli> importTime = steady_clock::now() - start;
+
+        if (geometry->saveToCacheFile(cachedFile)) {
+            std::ofstream(timeFile) << importTime.count();
+            LINFO(fmt::format(
+                "Imported model {} in {:.1f} ms and saved cache {}",
+                file, importTime.count(), cachedFile
+            ));
+        }
+        else {
+            LWARNING(fmt::format(
+                "Failed to save cache {} for model {}", cachedFile, file
+            ));
+        }
+
+        return geometry;
+    }
+
     struct [[codegen::Dictionary(RenderableModel)]] Parameters {
         // The file or files that should be loaded in this RenderableModel. The file can
         // contain filesystem tokens. This specifies the model that is rendered by
@@ -550,11 +656,7 @@ void RenderableModel::initializeGL() {
     ZoneScoped;
 
     // Load model
-    _geometry = ghoul::io::ModelReader::ref().loadModel(
-        _file,
-        ghoul::io::ModelReader::ForceRenderInvisible(_forceRenderInvisible),
-        ghoul::io::ModelReader::NotifyInvisibleDropped(_notifyInvisibleDropped)
-    );
+    _geometry = loadModel(_file, _forceRenderInvisible, _notifyInvisibleDropped);
     _modelHasAnimation = _geometry->hasAnimation();
 
     // @TODO (abock, 2023-06-03) Leaving this here to address issue #2731. The
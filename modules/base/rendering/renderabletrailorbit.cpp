@@ -85,8 +85,19 @@
 //
 // NB: This method was implemented without a ring buffer before by manually shifting the
 // items in memory as was shown to be much slower than the current system.   ---abock
+//
+// The fixed points are located at multiples of the time between two points and are taken
+// from a TrailSampleCache. A full sweep, for example after a jump in time, only resets
+// the array and the points are then filled in over the following frames, starting with
+// the newest one. While the sweep is in progress, only the filled part of the array is
+// rendered. Since the points lie on a fixed grid, jumping back to a previous time reuses
+// the points that were evaluated before.
 
 namespace {
+    // The maximum number of points that are evaluated in a single frame (and per thread
+    // for translations that can be evaluated concurrently)
+    constexpr int SamplesPerFrame = 1024;
+
     constexpr openspace::properties::Property::PropertyInfo PeriodInfo = {
         "Period",
         "Period (in days)",
@@ -153,7 +164,10 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
-    _translation->onParameterChange([this]() { _needsFullSweep = true; });
+    _translation->onParameterChange([this]() {
+        _needsFullSweep = true;
+        _samples.clear();
+    });
 
     // Period is in days
     _period = p.period;
@@ -341,63 +355,61 @@ void RenderableTrailOrbit::update(const UpdateData& data) {
 RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
                                                                    const UpdateData& data)
 {
+    const double now = data.time.j2000Seconds();
     if (_needsFullSweep) {
-        fullSweep(data.time.j2000Seconds());
-        return { false, true, UpdateReport::All } ;
+        fullSweep(now);
+        return { false, true, UpdateReport::All };
     }
 
+    if (_nSwept < _resolution - 1) {
+        // A sweep is still in progress. If the newest point has changed in the meantime,
+        // the sweep starts over, which reuses all of the points evaluated so far
+        if (_samples.sampleIndex(now) != _newestSample) {
+            fullSweep(now);
+        }
+        else {
+            continueSweep();
+        }
+        return { false, true, UpdateReport::All };
+    }
 
     constexpr double Epsilon = 1e-7;
     // When time stands still (at the iron hill), we don't need to perform any work
-    if (std::abs(data.time.j2000Seconds() - _previousTime) < Epsilon) {
+    if (std::abs(now - _previousTime) < Epsilon) {
         return { false, false, 0 };
     }
 
-    using namespace std::chrono;
-    double periodSeconds = _period * duration_cast<seconds>(hours(24)).count();
-    const double secondsPerPoint = periodSeconds / (_resolution - 1);
-    // How much time has passed since the last permanent point
-    const double delta = data.time.j2000Seconds() - _lastPointTime;
-
-    // We'd like to test for equality with 0 here, but due to rounding issues, we won't
-    // get there. If this check is not here, we will trigger the positive or negative
-    // branch below even though we don't have to
-    //
-    // This might become a bigger issue if we are starting to look at very short time
-    // intervals
-
-    if (std::abs(delta) < Epsilon) {
-        return { false, false, 0 };
+    // The number of fixed points that the trail needs to move. If the value is positive,
+    // the time has progressed forwards
+    const int64_t delta = _samples.sampleIndex(now) - _newestSample;
+    if (delta == 0) {
+        // No new permanent point is needed as less than a point's worth of time has
+        // passed since the newest permanent point
+        return { true, false, 0 };
     }
 
-    if (delta > 0.0) {
-        // Check whether we need to drop a new permanent point. This is only the case if
-        // enough (> secondsPerPoint) time has passed since the last permanent point
-        if (std::abs(delta) < secondsPerPoint) {
-            return { true, false, 0 };
-        }
-
-        // See how many points we need to drop
-        const int nNewPoints = static_cast<int>(floor(delta / secondsPerPoint));
-
-        // If we would need to generate more new points than there are total points in the
-        // array, it is faster to regenerate the entire array
-        if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
-        }
+    // If we would need to generate more new points than there are total points in the
+    // array, or more than we can evaluate in a single frame, we sweep the entire array
+    const int64_t nNewPoints = std::abs(delta);
+    if (nNewPoints >= _resolution || nNewPoints > SamplesPerFrame) {
+        fullSweep(now);
+        return { false, true, UpdateReport::All };
+    }
 
-        for (int i = 0; i < nNewPoints; ++i) {
-            _lastPointTime += secondsPerPoint;
+    if (delta > 0) {
+        _samples.fill(
+            *_translation,
+            _newestSample + 1,
+            _newestSample + delta,
+            static_cast<size_t>(nNewPoints)
+        );
 
+        for (int64_t i = 1; i <= nNewPoints; ++i) {
             // Get the new permanent point and write it into the (previously) floating
             // location
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_lastPointTime),
-                Time(0.0)
-            });
-            _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
+            const glm::vec3* p = _samples.find(_newestSample + i);
+            ghoul_assert(p, "Trail point was not evaluated");
+            _vertexArray[_primaryRenderInformation.first] = { p->x, p->y, p->z };
 
             // Move the current pointer back one step to be used as the new floating
             // location
@@ -407,36 +419,22 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
                 _primaryRenderInformation.first += _primaryRenderInformation.count;
             }
         }
-
-        // The previously oldest permanent point has been moved nNewPoints steps into the
-        // future
-        _firstPointTime += nNewPoints * secondsPerPoint;
-
-        return { false, true, nNewPoints };
     }
     else {
-        // See how many new points needs to be generated. Delta is negative, so we need
-        // to invert the ratio
-        const int nNewPoints = -(static_cast<int>(floor(delta / secondsPerPoint)));
-
-        // If we would need to generate more new points than there are total points in the
-        // array, it is faster to regenerate the entire array
-        if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
-        }
-
-        for (int i = 0; i < nNewPoints; ++i) {
-            _firstPointTime -= secondsPerPoint;
-
+        const int64_t oldestSample = _newestSample - (_resolution - 2);
+        _samples.fill(
+            *_translation,
+            oldestSample - nNewPoints,
+            oldestSample - 1,
+            static_cast<size_t>(nNewPoints)
+        );
+
+        for (int64_t i = 1; i <= nNewPoints; ++i) {
             // Get the new permanent point and write it into the (previously) floating
             // location
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_firstPointTime),
-                Time(0.0)
-            });
-            _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
+            const glm::vec3* p = _samples.find(oldestSample - i);
+            ghoul_assert(p, "Trail point was not evaluated");
+            _vertexArray[_primaryRenderInformation.first] = { p->x, p->y, p->z };
 
             // if we are on the upper bounds of the array, we start at 0
             if (_primaryRenderInformation.first == _primaryRenderInformation.count - 1) {
@@ -449,12 +447,14 @@ RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
                 ++_primaryRenderInformation.first;
             }
         }
+    }
 
-        // The previously youngest point has become nNewPoints steps older
-        _lastPointTime -= nNewPoints * secondsPerPoint;
+    // Both the oldest and the newest permanent point have moved by delta points
+    _newestSample += delta;
+    _lastPointTime = _samples.sampleTime(_newestSample);
+    _firstPointTime = _samples.sampleTime(_newestSample - (_resolution - 2));
 
-        return { false, true, -nNewPoints };
-    }
+    return { false, true, static_cast<int>(delta) };
 }
 
 void RenderableTrailOrbit::fullSweep(double time) {
@@ -471,23 +471,52 @@ void RenderableTrailOrbit::fullSweep(double time) {
         std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
     }
 
-    _lastPointTime = time;
-
     using namespace std::chrono;
     const double periodSeconds = _period * duration_cast<seconds>(hours(24)).count();
     const double secondsPerPoint = periodSeconds / (_resolution - 1);
-    // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; ++i) {
-        const glm::vec3 p = _translation->position({ {}, Time(time), Time(0.0) });
-        _vertexArray[i] = { p.x, p.y, p.z };
+    _samples.setSampleInterval(secondsPerPoint);
+    // Keep enough points around to cover jumps of about one period in either direction
+    _samples.setCapacity(4 * static_cast<size_t>(_resolution));
 
-        time -= secondsPerPoint;
-    }
+    // The newest permanent point is the last one before the current time
+    _newestSample = _samples.sampleIndex(time);
+    _lastPointTime = _samples.sampleTime(_newestSample);
+    _firstPointTime = _samples.sampleTime(_newestSample - (_resolution - 2));
+    _nSwept = 0;
 
+    // Until the sweep progresses, only the floating position is rendered
     _primaryRenderInformation.first = 0;
-    _primaryRenderInformation.count = _resolution;
+    _primaryRenderInformation.count = 1;
+
+    _needsFullSweep = false;
+
+    continueSweep();
+}
 
-    _firstPointTime = time + secondsPerPoint;
+void RenderableTrailOrbit::continueSweep() {
+    // starting at 1 because the first position is a floating current one
+    const int nPoints = _resolution - 1;
+    _samples.fill(
+        *_translation,
+        _newestSample - (nPoints - 1),
+        _newestSample - _nSwept,
+        SamplesPerFrame
+    );
+
+    // Copy all points that are available, starting at the newest one that is missing
+    while (_nSwept < nPoints) {
+        const glm::vec3* p = _samples.find(_newestSample - _nSwept);
+        if (!p) {
+            break;
+        }
+        _vertexArray[1 + _nSwept] = { p->x, p->y, p->z };
+        _nSwept++;
+    }
+
+    _primaryRenderInformation.count = 1 + _nSwept;
+    if (_nSwept < nPoints) {
+        return;
+    }
 
     // Updating bounding sphere
     glm::vec3 maxVertex(-std::numeric_limits<float>::max());
@@ -503,11 +532,9 @@ void RenderableTrailOrbit::fullSweep(double time) {
         minVertex.z = std::min(minVertex.z, vertexData.z);
     };
 
-    std::for_each(_vertexArray.begin(), _vertexArray.end(), setMax);
+    std::for_each(_vertexArray.begin() + 1, _vertexArray.end(), setMax);
 
     setBoundingSphere(glm::distance(maxVertex, minVertex) / 2.f);
-
-    _needsFullSweep = false;
 }
 
 } // namespace openspace
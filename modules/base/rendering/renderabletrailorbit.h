@@ -27,6 +27,7 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 
+#include <modules/base/rendering/trailsamplecache.h>
 #include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 
@@ -43,6 +44,10 @@ namespace documentation { struct Documentation; }
  * are rendered. Each of these fixed points are fixed time steps apart, where as the most
  * current point is floating and updated every frame. The _period determines the length of
  * the trail (the distance between the newest and oldest point being _period days).
+ *
+ * The fixed points lie on a regular time grid and are taken from a TrailSampleCache. If
+ * the time jumps, the trail is rebuilt over a number of frames, starting at the object,
+ * and reuses all samples that were evaluated before.
  */
 class RenderableTrailOrbit : public RenderableTrail {
 public:
@@ -57,11 +62,19 @@ public:
 
 private:
     /**
-     * Performs a full sweep of the orbit and fills the entire vertex buffer object.
+     * Starts a full sweep of the orbit which resets the entire vertex buffer object. The
+     * points are filled in by this call and the following calls to #continueSweep.
      * \param time The current time up to which the full sweep should be performed
      */
     void fullSweep(double time);
 
+    /**
+     * Fills in the next batch of points of a sweep that was started by #fullSweep. The
+     * number of points that are evaluated is limited so that the update of a single
+     * frame does not stall.
+     */
+    void continueSweep();
+
     /// This structure is returned from the #updateTrails method and gives information
     /// about which parts of the vertex array to update
     struct UpdateReport {
@@ -105,6 +118,13 @@ private:
     double _lastPointTime = 0.0;
     /// The time stamp of when the last valid trail was generated.
     double _previousTime = 0.0;
+
+    /// The positions of the translation sampled at the times of the fixed points
+    TrailSampleCache _samples;
+    /// The sample index of the newest fixed point in the array
+    int64_t _newestSample = 0;
+    /// The number of fixed points that have been filled in by the current sweep
+    int _nSwept = 0;
 };
 
 } // namespace openspace
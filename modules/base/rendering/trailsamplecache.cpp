@@ -0,0 +1,196 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/rendering/trailsamplecache.h>
+
+#include <openspace/scene/translation.h>
+#include <openspace/util/threadpool.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Below this number of missing samples it is not worth involving the worker threads
+    constexpr size_t MinSamplesPerThread = 64;
+
+    // The threads that help the calling thread with evaluating the samples. They are
+    // shared by all trails and kept alive, as the trails are filled every frame
+    openspace::ThreadPool& workerPool() {
+        static openspace::ThreadPool pool(
+            std::max(std::thread::hardware_concurrency(), 2u) - 1
+        );
+        return pool;
+    }
+
+    glm::vec3 evaluate(const openspace::Translation& translation, double time) {
+        using namespace openspace;
+        return glm::vec3(translation.position({ {}, Time(time), Time(0.0) }));
+    }
+} // namespace
+
+namespace openspace {
+
+TrailSampleCache::TrailSampleCache(size_t capacity)
+    : _capacity(capacity)
+{}
+
+void TrailSampleCache::setSampleInterval(double seconds) {
+    ghoul_precondition(seconds > 0.0, "Sample interval must be positive");
+
+    if (seconds != _sampleInterval) {
+        _sampleInterval = seconds;
+        _samples.clear();
+    }
+}
+
+double TrailSampleCache::sampleInterval() const {
+    return _sampleInterval;
+}
+
+void TrailSampleCache::setCapacity(size_t capacity) {
+    _capacity = capacity;
+}
+
+void TrailSampleCache::clear() {
+    _samples.clear();
+}
+
+size_t TrailSampleCache::size() const {
+    return _samples.size();
+}
+
+int64_t TrailSampleCache::sampleIndex(double time) const {
+    return static_cast<int64_t>(std::floor(time / _sampleInterval));
+}
+
+double TrailSampleCache::sampleTime(int64_t index) const {
+    return static_cast<double>(index) * _sampleInterval;
+}
+
+const glm::vec3* TrailSampleCache::find(int64_t index) const {
+    auto it = _samples.find(index);
+    return it != _samples.end() ? &it->second : nullptr;
+}
+
+bool TrailSampleCache::fill(const Translation& translation, int64_t first,
+                            int64_t last, size_t budget)
+{
+    ZoneScoped;
+
+    const bool concurrent = translation.supportsConcurrentEvaluation();
+    const size_t nThreads =
+        concurrent ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : 1;
+    const size_t totalBudget = budget * nThreads;
+
+    // Collect the missing samples, newest first, until the budget is exhausted
+    std::vector<int64_t> missing;
+    bool isComplete = true;
+    for (int64_t i = last; i >= first; i--) {
+        if (_samples.find(i) == _samples.end()) {
+            if (missing.size() == totalBudget) {
+                isComplete = false;
+                break;
+            }
+            missing.push_back(i);
+        }
+    }
+
+    if (missing.empty()) {
+        return isComplete;
+    }
+
+    std::vector<glm::vec3> positions(missing.size());
+    // The first sample is always evaluated on the calling thread so that lazily
+    // computed state in the translation is initialized before any worker starts
+    positions[0] = evaluate(translation, sampleTime(missing[0]));
+
+    const size_t nWorkers = std::min(nThreads, missing.size() / MinSamplesPerThread);
+    if (nWorkers > 1) {
+        auto work = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                positions[i] = evaluate(translation, sampleTime(missing[i]));
+            }
+        };
+
+        const size_t n = missing.size() - 1;
+        std::vector<std::future<void>> futures;
+        futures.reserve(nWorkers - 1);
+        for (size_t w = 1; w < nWorkers; w++) {
+            auto done = std::make_shared<std::promise<void>>();
+            futures.push_back(done->get_future());
+            const size_t begin = 1 + n * w / nWorkers;
+            const size_t end = 1 + n * (w + 1) / nWorkers;
+            workerPool().enqueue([&work, begin, end, done]() {
+                work(begin, end);
+                done->set_value();
+            });
+        }
+        work(1, 1 + n / nWorkers);
+        for (std::future<void>& f : futures) {
+            f.get();
+        }
+    }
+    else {
+        for (size_t i = 1; i < missing.size(); i++) {
+            positions[i] = evaluate(translation, sampleTime(missing[i]));
+        }
+    }
+
+    for (size_t i = 0; i < missing.size(); i++) {
+        _samples[missing[i]] = positions[i];
+    }
+
+    evict(first, last);
+    return isComplete;
+}
+
+void TrailSampleCache::evict(int64_t first, int64_t last) {
+    if (_capacity == 0 || _samples.size() <= _capacity) {
+        return;
+    }
+
+    // Keep the samples that are closest to the requested range
+    const int64_t range = last - first + 1;
+    const int64_t margin =
+        std::max<int64_t>((static_cast<int64_t>(_capacity) - range) / 2, 0);
+    const int64_t lower = first - margin;
+    const int64_t upper = last + margin;
+    for (auto it = _samples.begin(); it != _samples.end();) {
+        if (it->first < lower || it->first > upper) {
+            it = _samples.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_BASE___TRAILSAMPLECACHE___H__
+#define __OPENSPACE_MODULE_BASE___TRAILSAMPLECACHE___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <unordered_map>
+
+namespace openspace {
+
+class Translation;
+
+/**
+ * A cache of the positions of a Translation that are sampled on a regular time grid. The
+ * sample with index `i` is located at the time `i * sampleInterval()` seconds past
+ * J2000, so trails that jump back and forth in time find the samples that they have
+ * evaluated before, even if the jump did not move the trail by a whole number of
+ * samples. The cache only keeps the samples closest to the most recently requested
+ * range once it has grown beyond its capacity.
+ */
+class TrailSampleCache {
+public:
+    /**
+     * Creates an empty cache that holds up to \p capacity samples.
+     */
+    explicit TrailSampleCache(size_t capacity = 0);
+
+    /**
+     * Sets the time between two samples in seconds. If the interval changes, all cached
+     * samples are discarded.
+     *
+     * \pre \p seconds must be positive
+     */
+    void setSampleInterval(double seconds);
+    double sampleInterval() const;
+
+    /**
+     * Sets the number of samples above which samples that are far from the most recently
+     * requested range are discarded.
+     */
+    void setCapacity(size_t capacity);
+
+    /// Discards all samples, for example when the Translation has changed
+    void clear();
+
+    /// Returns the number of samples that are currently cached
+    size_t size() const;
+
+    /// Returns the index of the last sample at or before the provided \p time
+    int64_t sampleIndex(double time) const;
+
+    /// Returns the time in seconds past J2000 of the sample with the provided \p index
+    double sampleTime(int64_t index) const;
+
+    /**
+     * Returns the cached sample with the provided \p index or `nullptr` if the sample has
+     * not been evaluated yet. The returned pointer is valid until the next call to
+     * #fill, #clear, or #setSampleInterval.
+     */
+    const glm::vec3* find(int64_t index) const;
+
+    /**
+     * Evaluates the missing samples with indices in [\p first, \p last] using the
+     * \p translation, starting with the highest index, i.e. the newest sample, until
+     * \p budget samples have been evaluated. If the \p translation supports concurrent
+     * evaluation, the samples are distributed among worker threads and the \p budget
+     * applies to each of the threads. All threads have finished when this function
+     * returns.
+     *
+     * \param translation The Translation that provides the positions
+     * \param first The index of the oldest sample that is requested
+     * \param last The index of the newest sample that is requested
+     * \param budget The maximum number of samples that are evaluated per thread
+     * \return `true` if all samples in the requested range are available
+     */
+    bool fill(const Translation& translation, int64_t first, int64_t last,
+        size_t budget);
+
+private:
+    void evict(int64_t first, int64_t last);
+
+    double _sampleInterval = 1.0;
+    size_t _capacity = 0;
+    std::unordered_map<int64_t, glm::vec3> _samples;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___TRAILSAMPLECACHE___H__
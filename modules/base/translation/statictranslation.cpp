@@ -77,4 +77,8 @@ glm::dvec3 StaticTranslation::position(const UpdateData&) const {
     return _position;
 }
 
+bool StaticTranslation::supportsConcurrentEvaluation() const {
+    return true;
+}
+
 } // namespace openspace
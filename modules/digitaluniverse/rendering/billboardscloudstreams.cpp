@@ -0,0 +1,262 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/digitaluniverse/rendering/billboardscloudstreams.h>
+
+#include <modules/space/speckloader.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <glm/gtx/component_wise.hpp>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <thread>
+
+namespace {
+    // Below this number of points per thread, starting the threads costs more than the
+    // transformation itself
+    constexpr size_t MinPointsPerThread = 16384;
+
+    // Calls func(begin, end) for contiguous ranges of [0, n) on up to nThreads threads
+    // and returns the results in the order of the ranges
+    template <typename Func>
+    auto parallelRanges(size_t n, unsigned int nThreads, const Func& func) {
+        using Result = decltype(func(size_t(0), size_t(0)));
+
+        if (nThreads == 0) {
+            nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        const size_t nRanges = std::clamp<size_t>(n / MinPointsPerThread, 1, nThreads);
+        const size_t rangeSize = (n + nRanges - 1) / nRanges;
+
+        std::vector<std::future<Result>> workers;
+        for (size_t i = 1; i < nRanges; i++) {
+            const size_t begin = std::min(i * rangeSize, n);
+            const size_t end = std::min(begin + rangeSize, n);
+            workers.push_back(std::async(std::launch::async, func, begin, end));
+        }
+
+        std::vector<Result> results;
+        results.push_back(func(0, std::min(rangeSize, n)));
+        for (std::future<Result>& worker : workers) {
+            results.push_back(worker.get());
+        }
+        return results;
+    }
+
+    float unitValue(openspace::DistanceUnit unit) {
+        using namespace openspace;
+
+        // (abock, 2022-01-02)  This is vestigial from a previous rewrite. I just want to
+        // make it work for now and we can rewrite it properly later
+        switch (unit) {
+            case DistanceUnit::Meter:         return 0.f;
+            case DistanceUnit::Kilometer:     return 1.f;
+            case DistanceUnit::Parsec:        return 2.f;
+            case DistanceUnit::Kiloparsec:    return 3.f;
+            case DistanceUnit::Megaparsec:    return 4.f;
+            case DistanceUnit::Gigaparsec:    return 5.f;
+            case DistanceUnit::Gigalightyear: return 6.f;
+            default:                          throw ghoul::MissingCaseException();
+        }
+    }
+} // namespace
+
+namespace openspace::billboardscloud {
+
+PositionStream createPositionStream(const speck::Dataset& dataset,
+                                    const glm::dmat4& transform, DistanceUnit unit,
+                                    unsigned int nThreads)
+{
+    ZoneScoped;
+
+    const float value = unitValue(unit);
+    const double unitMeter = toMeter(unit);
+
+    PositionStream result;
+    result.positions.resize(dataset.entries.size());
+
+    struct Extent {
+        double maxRadius = 0.0;
+        float biggestCoordinate = -1.f;
+    };
+    std::vector<Extent> extents = parallelRanges(
+        dataset.entries.size(),
+        nThreads,
+        [&](size_t begin, size_t end) {
+            Extent extent;
+            for (size_t i = begin; i < end; i++) {
+                const speck::Dataset::Entry& e = dataset.entries[i];
+                glm::vec3 transformedPos = glm::vec3(transform * glm::vec4(
+                    e.position, 1.0
+                ));
+                glm::vec4 position(transformedPos, value);
+                result.positions[i] = position;
+
+                glm::dvec3 p = glm::dvec3(position) * unitMeter;
+                const double r = glm::length(p);
+                extent.maxRadius = std::max(extent.maxRadius, r);
+                extent.biggestCoordinate = std::max(
+                    extent.biggestCoordinate,
+                    glm::compMax(position)
+                );
+            }
+            return extent;
+        }
+    );
+
+    for (const Extent& extent : extents) {
+        result.maxRadius = std::max(result.maxRadius, extent.maxRadius);
+        result.biggestCoordinate = std::max(
+            result.biggestCoordinate,
+            extent.biggestCoordinate
+        );
+    }
+    return result;
+}
+
+std::vector<glm::vec4> createColorStream(const speck::Dataset& dataset,
+                                         const speck::ColorMap& colorMap,
+                                         const ColorMapping& mapping,
+                                         unsigned int nThreads)
+{
+    ZoneScoped;
+
+    ghoul_precondition(!colorMap.entries.empty(), "Color map must not be empty");
+
+    const int index = mapping.dataIndex;
+    float cmin = 0.f;
+    float cmax = 0.f;
+    if (mapping.range.has_value()) {
+        cmin = mapping.range->x;
+        cmax = mapping.range->y;
+    }
+    else {
+        // An entry without any data resets the range, so only the entries after the last
+        // such entry contribute to it
+        auto lastEmpty = std::find_if(
+            dataset.entries.rbegin(),
+            dataset.entries.rend(),
+            [](const speck::Dataset::Entry& e) { return e.data.empty(); }
+        );
+        const size_t first = std::distance(lastEmpty, dataset.entries.rend());
+        const bool hasEmpty = lastEmpty != dataset.entries.rend();
+
+        std::vector<glm::vec2> ranges = parallelRanges(
+            dataset.entries.size() - first,
+            nThreads,
+            [&](size_t begin, size_t end) {
+                glm::vec2 range = glm::vec2(
+                    std::numeric_limits<float>::max(),
+                    -std::numeric_limits<float>::max()
+                );
+                for (size_t i = first + begin; i < first + end; i++) {
+                    const float color = dataset.entries[i].data[index];
+                    range.x = std::min(color, range.x);
+                    range.y = std::max(color, range.y);
+                }
+                return range;
+            }
+        );
+
+        cmin = hasEmpty ? 0.f : std::numeric_limits<float>::max();
+        cmax = hasEmpty ? 0.f : -std::numeric_limits<float>::max();
+        for (const glm::vec2& range : ranges) {
+            cmin = std::min(range.x, cmin);
+            cmax = std::max(range.y, cmax);
+        }
+    }
+
+    const std::vector<glm::vec4>& entries = colorMap.entries;
+    const float ncmap = static_cast<float>(entries.size());
+    const float normalization = ((cmax != cmin) && (ncmap > 2.f)) ?
+        (ncmap - 2.f) / (cmax - cmin) : 0;
+
+    std::vector<glm::vec4> result(dataset.entries.size());
+    parallelRanges(
+        dataset.entries.size(),
+        nThreads,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                // Note: if exact colormap option is not selected, the first color and
+                // the last color in the colormap file are the outliers colors.
+                const float variableColor = dataset.entries[i].data[index];
+
+                if (mapping.isExact) {
+                    const int colorIndex = static_cast<int>(variableColor + cmin);
+                    result[i] = entries[colorIndex];
+                }
+                else if (mapping.useLinearFiltering) {
+                    float valueT = (variableColor - cmin) / (cmax - cmin); // in [0, 1)
+                    valueT = std::clamp(valueT, 0.f, 1.f);
+
+                    const float idx = valueT * (entries.size() - 1);
+                    const int floorIdx = static_cast<int>(std::floor(idx));
+                    const int ceilIdx = static_cast<int>(std::ceil(idx));
+
+                    const glm::vec4 floorColor = entries[floorIdx];
+                    const glm::vec4 ceilColor = entries[ceilIdx];
+
+                    result[i] = floorColor != ceilColor ?
+                        floorColor + idx * (ceilColor - floorColor) :
+                        floorColor;
+                }
+                else {
+                    int colorIndex = static_cast<int>(
+                        (variableColor - cmin) * normalization + 1.f
+                    );
+                    colorIndex = colorIndex < 0 ? 0 : colorIndex;
+                    colorIndex = colorIndex >= ncmap ?
+                        static_cast<int>(ncmap - 1.f) : colorIndex;
+                    result[i] = entries[colorIndex];
+                }
+            }
+            return true;
+        }
+    );
+    return result;
+}
+
+std::vector<float> createSizeStream(const speck::Dataset& dataset, int dataIndex,
+                                    unsigned int nThreads)
+{
+    ZoneScoped;
+
+    std::vector<float> result(dataset.entries.size());
+    parallelRanges(
+        dataset.entries.size(),
+        nThreads,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                result[i] = dataset.entries[i].data[dataIndex];
+            }
+            return true;
+        }
+    );
+    return result;
+}
+
+} // namespace openspace::billboardscloud
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSCLOUDSTREAMS___H__
+#define __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSCLOUDSTREAMS___H__
+
+#include <openspace/util/distanceconversion.h>
+#include <ghoul/glm.h>
+#include <optional>
+#include <vector>
+
+namespace openspace::speck {
+    struct ColorMap;
+    struct Dataset;
+} // namespace openspace::speck
+
+namespace openspace::billboardscloud {
+
+/**
+ * The per-point positions of a billboard cloud. The w component of each position
+ * encodes the distance unit of the dataset for the shader.
+ */
+struct PositionStream {
+    std::vector<glm::vec4> positions;
+
+    /// The largest distance from the origin of any point in meters
+    double maxRadius = 0.0;
+
+    /// The largest component of any of the positions
+    float biggestCoordinate = -1.f;
+};
+
+/// The parameters that determine how the data values are mapped onto colors
+struct ColorMapping {
+    /// The index of the data column that is used for the color
+    int dataIndex = 0;
+
+    /// The range of values that is mapped onto the color map. If it is not set, the
+    /// range of the values in the dataset is used instead
+    std::optional<glm::vec2> range;
+
+    /// If `true`, the values are used directly as indices into the color map
+    bool isExact = false;
+
+    /// If `true`, colors are interpolated between the color map entries
+    bool useLinearFiltering = false;
+};
+
+/**
+ * Transforms the positions of all entries in the \p dataset by the \p transform and
+ * stores them with the encoded \p unit. The work is split across \p nThreads threads,
+ * where 0 uses all available hardware threads.
+ */
+PositionStream createPositionStream(const speck::Dataset& dataset,
+    const glm::dmat4& transform, DistanceUnit unit, unsigned int nThreads = 0);
+
+/**
+ * Maps the values of the data column in the \p mapping onto colors of the
+ * \p colorMap for all entries in the \p dataset. The work is split across \p nThreads
+ * threads, where 0 uses all available hardware threads.
+ *
+ * \pre \p colorMap must not be empty
+ */
+std::vector<glm::vec4> createColorStream(const speck::Dataset& dataset,
+    const speck::ColorMap& colorMap, const ColorMapping& mapping,
+    unsigned int nThreads = 0);
+
+/**
+ * Extracts the values of the data column \p dataIndex that are used to scale the
+ * points for all entries in the \p dataset. The work is split across \p nThreads
+ * threads, where 0 uses all available hardware threads.
+ */
+std::vector<float> createSizeStream(const speck::Dataset& dataset, int dataIndex,
+    unsigned int nThreads = 0);
+
+} // namespace openspace::billboardscloud
+
+#endif // __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSCLOUDSTREAMS___H__
@@ -25,6 +25,7 @@
 #include <modules/digitaluniverse/rendering/renderablebillboardscloud.h>
 
 #include <modules/digitaluniverse/digitaluniversemodule.h>
+#include <modules/digitaluniverse/rendering/billboardscloudstreams.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
@@ -403,7 +404,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
             }
         }
         _colorOption.onChange([this]() {
-            _dataIsDirty = true;
+            _colorDataIsDirty = true;
             const glm::vec2 colorRange = _colorRangeData[_colorOption.value()];
             _optionColorRangeData = colorRange;
             _colorOptionString = _optionConversionMap[_colorOption.value()];
@@ -417,7 +418,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
         _optionColorRangeData.onChange([this]() {
             const glm::vec2 colorRange = _optionColorRangeData;
             _colorRangeData[_colorOption.value()] = colorRange;
-            _dataIsDirty = true;
+            _colorDataIsDirty = true;
         });
         addProperty(_optionColorRangeData);
 
@@ -442,7 +443,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
         }
 
         _datavarSizeOption.onChange([this]() {
-            _dataIsDirty = true;
+            _sizeDataIsDirty = true;
             _datavarSizeOptionString = _optionConversionSizeMap[_datavarSizeOption];
         });
         addProperty(_datavarSizeOption);
@@ -504,11 +505,11 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
     });
     addProperty(_setRangeFromData);
 
-    _useColorMap.onChange([this]() { _dataIsDirty = true; });
+    _useColorMap.onChange([this]() { _colorDataIsDirty = true; });
     addProperty(_useColorMap);
 
     _useLinearFiltering = p.useLinearFiltering.value_or(_useLinearFiltering);
-    _useLinearFiltering.onChange([this]() { _dataIsDirty = true; });
+    _useLinearFiltering.onChange([this]() { _colorDataIsDirty = true; });
     addProperty(_useLinearFiltering);
 }
 
@@ -579,11 +580,21 @@ void RenderableBillboardsCloud::initializeGL() {
     if (_hasPolygon) {
         createPolygonTexture();
     }
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableBillboardsCloud::deinitializeGL() {
-    glDeleteBuffers(1, &_vbo);
-    _vbo = 0;
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
+    for (VertexStream* stream : { &_positionStream, &_colorStream, &_sizeStream }) {
+        glDeleteBuffers(1, &stream->vbo);
+        *stream = VertexStream();
+    }
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
@@ -738,121 +749,82 @@ void RenderableBillboardsCloud::render(const RenderData& data, RendererTasks&) {
 void RenderableBillboardsCloud::update(const UpdateData&) {
     ZoneScoped;
 
-    if (_dataIsDirty && _hasSpeckFile) {
+    const bool isDirty = _dataIsDirty || _colorDataIsDirty || _sizeDataIsDirty;
+    if (isDirty && _hasSpeckFile && !_dataset.entries.empty()) {
         ZoneScopedN("Data dirty");
         TracyGpuZone("Data dirty");
-        LDEBUG("Regenerating data");
-
-        std::vector<float> slice = createDataSlice();
-
-        int size = static_cast<int>(slice.size());
 
         if (_vao == 0) {
             glGenVertexArrays(1, &_vao);
             LDEBUG(fmt::format("Generating Vertex Array id '{}'", _vao));
         }
-        if (_vbo == 0) {
-            glGenBuffers(1, &_vbo);
-            LDEBUG(fmt::format("Generating Vertex Buffer Object id '{}'", _vbo));
-        }
-
         glBindVertexArray(_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, size * sizeof(float), slice.data(), GL_STATIC_DRAW);
-        GLint positionAttrib = _program->attributeLocation("in_position");
-
-        if (_hasColorMapFile && _hasDatavarSize) {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                9 * sizeof(float),
-                nullptr
-            );
-
-            GLint colorMapAttrib = _program->attributeLocation("in_colormap");
-            glEnableVertexAttribArray(colorMapAttrib);
-            glVertexAttribPointer(
-                colorMapAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                9 * sizeof(float),
-                reinterpret_cast<void*>(4 * sizeof(float))
-            );
 
-            GLint dvarScalingAttrib = _program->attributeLocation("in_dvarScaling");
-            glEnableVertexAttribArray(dvarScalingAttrib);
-            glVertexAttribPointer(
-                dvarScalingAttrib,
-                1,
-                GL_FLOAT,
-                GL_FALSE,
-                9 * sizeof(float),
-                reinterpret_cast<void*>(8 * sizeof(float))
+        // Each attribute lives in its own buffer, so changing one of the options only
+        // rebuilds and uploads the attribute that depends on it
+        if (_dataIsDirty) {
+            LDEBUG("Regenerating positions");
+            billboardscloud::PositionStream positions =
+                billboardscloud::createPositionStream(
+                    _dataset,
+                    _transformationMatrix,
+                    _unit
+                );
+            uploadStream(
+                _positionStream,
+                positions.positions.data(),
+                positions.positions.size() * sizeof(glm::vec4),
+                "in_position",
+                4
             );
+            setBoundingSphere(positions.maxRadius);
+            _fadeInDistances.setMaxValue(glm::vec2(10.f * positions.biggestCoordinate));
+            _dataIsDirty = false;
         }
-        else if (_hasColorMapFile) {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                8 * sizeof(float),
-                nullptr
-            );
 
-            GLint colorMapAttrib = _program->attributeLocation("in_colormap");
-            glEnableVertexAttribArray(colorMapAttrib);
-            glVertexAttribPointer(
-                colorMapAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                8 * sizeof(float),
-                reinterpret_cast<void*>(4 * sizeof(float))
-            );
+        if (_colorDataIsDirty) {
+            if (_hasColorMapFile && _useColorMap && !_colorMap.entries.empty()) {
+                LDEBUG("Regenerating colors");
+                billboardscloud::ColorMapping mapping;
+                mapping.dataIndex = _dataset.index(_colorOptionString);
+                if (!_colorRangeData.empty()) {
+                    mapping.range = _colorRangeData[_colorOption.value()];
+                }
+                mapping.isExact = _isColorMapExact;
+                mapping.useLinearFiltering = _useLinearFiltering;
+
+                std::vector<glm::vec4> colors =
+                    billboardscloud::createColorStream(_dataset, _colorMap, mapping);
+                uploadStream(
+                    _colorStream,
+                    colors.data(),
+                    colors.size() * sizeof(glm::vec4),
+                    "in_colormap",
+                    4
+                );
+            }
+            _colorDataIsDirty = false;
         }
-        else if (_hasDatavarSize) {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                8 * sizeof(float),
-                nullptr
-            );
 
-            GLint dvarScalingAttrib = _program->attributeLocation("in_dvarScaling");
-            glEnableVertexAttribArray(dvarScalingAttrib);
-            glVertexAttribPointer(
-                dvarScalingAttrib,
-                1,
-                GL_FLOAT,
-                GL_FALSE,
-                5 * sizeof(float),
-                reinterpret_cast<void*>(4 * sizeof(float))
-            );
-        }
-        else {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                0,
-                nullptr
-            );
+        if (_sizeDataIsDirty) {
+            if (_hasDatavarSize) {
+                LDEBUG("Regenerating sizes");
+                std::vector<float> sizes = billboardscloud::createSizeStream(
+                    _dataset,
+                    _dataset.index(_datavarSizeOptionString)
+                );
+                uploadStream(
+                    _sizeStream,
+                    sizes.data(),
+                    sizes.size() * sizeof(float),
+                    "in_dvarScaling",
+                    1
+                );
+            }
+            _sizeDataIsDirty = false;
         }
 
         glBindVertexArray(0);
-
-        _dataIsDirty = false;
     }
 
     if (_hasSpriteTexture && _spriteTextureIsDirty && !_spriteTexturePath.value().empty())
@@ -883,174 +855,30 @@ void RenderableBillboardsCloud::update(const UpdateData&) {
     }
 }
 
-std::vector<float> RenderableBillboardsCloud::createDataSlice() {
-    ZoneScoped;
-
-    if (_dataset.entries.empty()) {
-        return std::vector<float>();
+void RenderableBillboardsCloud::uploadStream(VertexStream& stream, const void* data,
+                                             GLsizeiptr size, const char* attribute,
+                                             GLint nComponents)
+{
+    if (stream.vbo == 0) {
+        glGenBuffers(1, &stream.vbo);
+        LDEBUG(fmt::format("Generating Vertex Buffer Object id '{}'", stream.vbo));
     }
 
-    std::vector<float> result;
-    if (_hasColorMapFile) {
-        result.reserve(8 * _dataset.entries.size());
+    glBindBuffer(GL_ARRAY_BUFFER, stream.vbo);
+    if (size == stream.size) {
+        // The number of points never changes, so the storage can be reused
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
     }
     else {
-        result.reserve(4 * _dataset.entries.size());
-    }
-
-    // what datavar in use for the index color
-    int colorMapInUse =
-        _hasColorMapFile ? _dataset.index(_colorOptionString) : 0;
-
-    // what datavar in use for the size scaling (if present)
-    int sizeScalingInUse =
-        _hasDatavarSize ? _dataset.index(_datavarSizeOptionString) : -1;
-
-    float minColorIdx = std::numeric_limits<float>::max();
-    float maxColorIdx = -std::numeric_limits<float>::max();
-    for (const speck::Dataset::Entry& e : _dataset.entries) {
-        if (e.data.size() > 0) {
-            float color = e.data[colorMapInUse];
-            minColorIdx = std::min(color, minColorIdx);
-            maxColorIdx = std::max(color, maxColorIdx);
-        } else {
-            minColorIdx = 0;
-            maxColorIdx = 0;
-        }
+        glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+        stream.size = size;
     }
 
-    double maxRadius = 0.0;
-
-    float biggestCoord = -1.f;
-    for (const speck::Dataset::Entry& e : _dataset.entries) {
-        glm::vec3 transformedPos = glm::vec3(_transformationMatrix * glm::vec4(
-            e.position, 1.0
-        ));
-
-        float unitValue = 0.f;
-        // (abock, 2022-01-02)  This is vestigial from a previous rewrite. I just want to
-        // make it work for now and we can rewrite it properly later
-        switch (_unit) {
-            case DistanceUnit::Meter:
-                unitValue = 0.f;
-                break;
-            case DistanceUnit::Kilometer:
-                unitValue = 1.f;
-                break;
-            case DistanceUnit::Parsec:
-                unitValue = 2;
-                break;
-            case DistanceUnit::Kiloparsec:
-                unitValue = 3;
-                break;
-            case DistanceUnit::Megaparsec:
-                unitValue = 4;
-                break;
-            case DistanceUnit::Gigaparsec:
-                unitValue = 5;
-                break;
-            case DistanceUnit::Gigalightyear:
-                unitValue = 6;
-                break;
-            default:
-                throw ghoul::MissingCaseException();
-        }
-
-        glm::vec4 position(transformedPos, unitValue);
-
-        const double unitMeter = toMeter(_unit);
-        glm::dvec3 p = glm::dvec3(position) * unitMeter;
-        const double r = glm::length(p);
-        maxRadius = std::max(maxRadius, r);
-
-        if (_hasColorMapFile && _useColorMap && !_colorMap.entries.empty()) {
-            for (int j = 0; j < 4; ++j) {
-                result.push_back(position[j]);
-            }
-            biggestCoord = std::max(biggestCoord, glm::compMax(position));
-            // Note: if exact colormap option is not selected, the first color and the
-            // last color in the colormap file are the outliers colors.
-            float variableColor = e.data[colorMapInUse];
-
-            float cmax, cmin;
-            if (_colorRangeData.empty()) {
-                cmax = maxColorIdx; // Max value of datavar used for the index color
-                cmin = minColorIdx; // Min value of datavar used for the index color
-            }
-            else {
-                glm::vec2 currentColorRange = _colorRangeData[_colorOption.value()];
-                cmax = currentColorRange.y;
-                cmin = currentColorRange.x;
-            }
-
-            if (_isColorMapExact) {
-                int colorIndex = static_cast<int>(variableColor + cmin);
-                for (int j = 0; j < 4; ++j) {
-                    result.push_back(_colorMap.entries[colorIndex][j]);
-                }
-            }
-            else {
-                if (_useLinearFiltering) {
-                    float valueT = (variableColor - cmin) / (cmax - cmin); // in [0, 1)
-                    valueT = std::clamp(valueT, 0.f, 1.f);
-
-                    const float idx = valueT * (_colorMap.entries.size() - 1);
-                    const int floorIdx = static_cast<int>(std::floor(idx));
-                    const int ceilIdx = static_cast<int>(std::ceil(idx));
-
-                    const glm::vec4 floorColor = _colorMap.entries[floorIdx];
-                    const glm::vec4 ceilColor = _colorMap.entries[ceilIdx];
-
-                    if (floorColor != ceilColor) {
-                        const glm::vec4 c = floorColor + idx * (ceilColor - floorColor);
-                        result.push_back(c.r);
-                        result.push_back(c.g);
-                        result.push_back(c.b);
-                        result.push_back(c.a);
-                    }
-                    else {
-                        result.push_back(floorColor.r);
-                        result.push_back(floorColor.g);
-                        result.push_back(floorColor.b);
-                        result.push_back(floorColor.a);
-                    }
-                }
-                else {
-                    float ncmap = static_cast<float>(_colorMap.entries.size());
-                    float normalization = ((cmax != cmin) && (ncmap > 2.f)) ?
-                        (ncmap - 2.f) / (cmax - cmin) : 0;
-                    int colorIndex = static_cast<int>(
-                        (variableColor - cmin) * normalization + 1.f
-                    );
-                    colorIndex = colorIndex < 0 ? 0 : colorIndex;
-                    colorIndex = colorIndex >= ncmap ?
-                        static_cast<int>(ncmap - 1.f) : colorIndex;
-
-                    for (int j = 0; j < 4; ++j) {
-                        result.push_back(_colorMap.entries[colorIndex][j]);
-                    }
-                }
-            }
-
-            if (_hasDatavarSize) {
-                result.push_back(e.data[sizeScalingInUse]);
-            }
-        }
-        else if (_hasDatavarSize) {
-            result.push_back(e.data[sizeScalingInUse]);
-            for (int j = 0; j < 4; ++j) {
-                result.push_back(position[j]);
-            }
-        }
-        else {
-            for (int j = 0; j < 4; ++j) {
-                result.push_back(position[j]);
-            }
-        }
+    const GLint location = _program->attributeLocation(attribute);
+    if (location != -1) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, nComponents, GL_FLOAT, GL_FALSE, 0, nullptr);
     }
-    setBoundingSphere(maxRadius);
-    _fadeInDistances.setMaxValue(glm::vec2(10.f * biggestCoord));
-    return result;
 }
 
 void RenderableBillboardsCloud::createPolygonTexture() {
@@ -69,8 +69,14 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-
-    std::vector<float> createDataSlice();
+    /// A vertex buffer that holds a single attribute for all points
+    struct VertexStream {
+        GLuint vbo = 0;
+        GLsizeiptr size = 0;
+    };
+
+    void uploadStream(VertexStream& stream, const void* data, GLsizeiptr size,
+        const char* attribute, GLint nComponents);
     void createPolygonTexture();
     void renderToTexture(GLuint textureToRenderTo, GLuint textureWidth,
         GLuint textureHeight);
@@ -81,6 +87,8 @@ private:
 
     bool _hasSpeckFile = false;
     bool _dataIsDirty = true;
+    bool _colorDataIsDirty = true;
+    bool _sizeDataIsDirty = true;
     bool _hasSpriteTexture = false;
     bool _spriteTextureIsDirty = true;
     bool _hasColorMapFile = false;
@@ -144,7 +152,9 @@ private:
     glm::dmat4 _transformationMatrix = glm::dmat4(1.0);
 
     GLuint _vao = 0;
-    GLuint _vbo = 0;
+    VertexStream _positionStream;
+    VertexStream _colorStream;
+    VertexStream _sizeStream;
 
     // For polygons
     GLuint _polygonVao = 0;
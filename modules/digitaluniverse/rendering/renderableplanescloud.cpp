@@ -353,6 +353,10 @@ void RenderablePlanesCloud::initializeGL() {
 
     createPlanes();
     loadTextures();
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderablePlanesCloud::deleteDataGPUAndCPU() {
@@ -365,6 +369,10 @@ void RenderablePlanesCloud::deleteDataGPUAndCPU() {
 }
 
 void RenderablePlanesCloud::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     deleteDataGPUAndCPU();
 
     DigitalUniverseModule::ProgramObjectManager.release(
@@ -0,0 +1,264 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/exoplanets/exoplanetsindex.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr std::string_view _loggerCat = "ExoplanetsIndex";
+
+    constexpr uint32_t CurrentVersion = 1;
+
+    struct Header {
+        uint32_t version = CurrentVersion;
+        uint32_t nEntries = 0;
+    };
+
+    // The names are stored after all records and are referenced relative to the first
+    // character of the first name
+    struct Record {
+        uint64_t offset = 0;
+        uint32_t hostBegin = 0;
+        uint32_t hostLength = 0;
+        uint32_t nameBegin = 0;
+        uint32_t nameLength = 0;
+    };
+    static_assert(sizeof(Record) == 24, "Unexpected padding in the index record");
+
+    const Record& recordAt(const std::byte* data, size_t index) {
+        // The records follow the 8 byte header, so they are correctly aligned as long
+        // as the mapped file is, which it always is as mappings start on a page
+        return reinterpret_cast<const Record*>(data + sizeof(Header))[index];
+    }
+} // namespace
+
+namespace openspace::exoplanets {
+
+void ExoplanetsIndex::write(std::vector<Entry> entries, const std::filesystem::path& path)
+{
+    ZoneScoped;
+
+    std::stable_sort(
+        entries.begin(), entries.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.host < rhs.host; }
+    );
+
+    std::vector<Record> records;
+    records.reserve(entries.size());
+    std::string names;
+    for (const Entry& e : entries) {
+        Record r;
+        r.offset = e.offset;
+        // Planets of the same system share the name of their host star
+        if (!records.empty() && entries[records.size() - 1].host == e.host) {
+            r.hostBegin = records.back().hostBegin;
+        }
+        else {
+            r.hostBegin = static_cast<uint32_t>(names.size());
+            names += e.host;
+        }
+        r.hostLength = static_cast<uint32_t>(e.host.size());
+        r.nameBegin = static_cast<uint32_t>(names.size());
+        r.nameLength = static_cast<uint32_t>(e.name.size());
+        names += e.name;
+        records.push_back(r);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Error writing index file {}", path));
+    }
+
+    Header header;
+    header.nEntries = static_cast<uint32_t>(records.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(
+        reinterpret_cast<const char*>(records.data()),
+        records.size() * sizeof(Record)
+    );
+    file.write(names.data(), names.size());
+}
+
+std::vector<ExoplanetsIndex::Entry> ExoplanetsIndex::readLookUpTable(
+                                                       const std::filesystem::path& path)
+{
+    ZoneScoped;
+
+    std::ifstream file(path);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Failed to open look-up table {}", path));
+    }
+
+    std::vector<Entry> result;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t comma = line.rfind(',');
+        // The name ends with a space and the character of the planet's component
+        if (comma == std::string::npos || comma < 2) {
+            continue;
+        }
+
+        Entry e;
+        e.name = line.substr(0, comma);
+        e.host = e.name.substr(0, e.name.size() - 2);
+        const char* begin = line.data() + comma + 1;
+        const char* end = line.data() + line.size();
+        auto [p, ec] = std::from_chars(begin, end, e.offset);
+        if (ec != std::errc()) {
+            LWARNING(fmt::format("Invalid location in look-up table line '{}'", line));
+            continue;
+        }
+        result.push_back(std::move(e));
+    }
+    return result;
+}
+
+std::unique_ptr<ExoplanetsIndex> ExoplanetsIndex::loadWithCache(
+                                                const std::filesystem::path& lookUpTable)
+{
+    std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(lookUpTable);
+    if (std::filesystem::exists(cached)) {
+        try {
+            return std::make_unique<ExoplanetsIndex>(cached);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LWARNING(fmt::format("Removing invalid cached index: {}", e.message));
+            FileSys.cacheManager()->removeCacheFile(cached);
+        }
+    }
+
+    LINFO(fmt::format("Creating index for look-up table {}", lookUpTable));
+    write(readLookUpTable(lookUpTable), cached);
+    return std::make_unique<ExoplanetsIndex>(cached);
+}
+
+ExoplanetsIndex::ExoplanetsIndex(std::filesystem::path path)
+    : _file(std::move(path))
+{
+    if (_file.size() < sizeof(Header)) {
+        throw ghoul::RuntimeError(fmt::format("Index file {} is empty", _file.path()));
+    }
+
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (header.version != CurrentVersion) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Index file {} has version {} but version {} is expected",
+            _file.path(), header.version, CurrentVersion
+        ));
+    }
+
+    const size_t namesBegin = sizeof(Header) + header.nEntries * sizeof(Record);
+    if (_file.size() < namesBegin) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Index file {} is too small for {} entries", _file.path(), header.nEntries
+        ));
+    }
+    _nEntries = header.nEntries;
+
+    // Make sure that all names are inside the file so that they can be used unchecked
+    const size_t namesSize = _file.size() - namesBegin;
+    for (size_t i = 0; i < _nEntries; i++) {
+        const Record& r = recordAt(_file.data(), i);
+        const bool isValid =
+            static_cast<size_t>(r.hostBegin) + r.hostLength <= namesSize &&
+            static_cast<size_t>(r.nameBegin) + r.nameLength <= namesSize;
+        if (!isValid) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Index file {} has an invalid entry {}", _file.path(), i
+            ));
+        }
+    }
+}
+
+size_t ExoplanetsIndex::size() const {
+    return _nEntries;
+}
+
+ExoplanetsIndex::Planet ExoplanetsIndex::planet(size_t index) const {
+    ghoul_assert(index < _nEntries, "Index out of bounds");
+
+    const Record& r = recordAt(_file.data(), index);
+    const char* names = reinterpret_cast<const char*>(
+        _file.data() + sizeof(Header) + _nEntries * sizeof(Record)
+    );
+    return {
+        .host = std::string_view(names + r.hostBegin, r.hostLength),
+        .name = std::string_view(names + r.nameBegin, r.nameLength),
+        .offset = r.offset
+    };
+}
+
+size_t ExoplanetsIndex::lowerBound(std::string_view host) const {
+    size_t first = 0;
+    size_t count = _nEntries;
+    while (count > 0) {
+        const size_t step = count / 2;
+        if (planet(first + step).host < host) {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+std::vector<ExoplanetsIndex::Planet> ExoplanetsIndex::planets(std::string_view host) const
+{
+    std::vector<Planet> result;
+    for (size_t i = lowerBound(host); i < _nEntries; i++) {
+        Planet p = planet(i);
+        if (p.host != host) {
+            break;
+        }
+        result.push_back(p);
+    }
+    return result;
+}
+
+std::vector<std::string_view> ExoplanetsIndex::hosts() const {
+    std::vector<std::string_view> result;
+    for (size_t i = 0; i < _nEntries; i++) {
+        std::string_view host = planet(i).host;
+        if (result.empty() || result.back() != host) {
+            result.push_back(host);
+        }
+    }
+    return result;
+}
+
+} // namespace openspace::exoplanets
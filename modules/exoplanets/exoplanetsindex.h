@@ -0,0 +1,123 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
+#define __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace::exoplanets {
+
+/**
+ * A binary look-up table from the names of exoplanet host stars to the locations of
+ * their planets in the exoplanets data file. The entries are sorted by the name of the
+ * host star and the file is memory mapped, so finding the planets of a system is a
+ * binary search that does not read or parse the rest of the table.
+ *
+ * The file consists of a header with the version and the number of entries, followed by
+ * the fixed-size records of all entries and then by the names that are referenced by
+ * the records.
+ */
+class ExoplanetsIndex {
+public:
+    /// The information about a single planet that is stored in the index
+    struct Entry {
+        /// The name of the host star of the planet
+        std::string host;
+        /// The full name of the planet, including the host star name
+        std::string name;
+        /// The location of the planet's ExoplanetDataEntry in the data file
+        uint64_t offset = 0;
+    };
+
+    /// A planet as it is stored in the memory mapped index
+    struct Planet {
+        std::string_view host;
+        std::string_view name;
+        uint64_t offset = 0;
+    };
+
+    /**
+     * Writes the \p entries as a sorted index to the file at \p path. Planets of the
+     * same host star keep the order in which they appear in \p entries.
+     *
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    static void write(std::vector<Entry> entries, const std::filesystem::path& path);
+
+    /**
+     * Reads the text look-up table at \p path, which contains one `<name>,<offset>` line
+     * per planet. The name of a planet is its host star name followed by a space and the
+     * single character component of the planet.
+     *
+     * \throw ghoul::RuntimeError If the file could not be read
+     */
+    static std::vector<Entry> readLookUpTable(const std::filesystem::path& path);
+
+    /**
+     * Returns an index for the text look-up table at \p lookUpTable. The binary index is
+     * created once from the text table and stored in the cache.
+     *
+     * \throw ghoul::RuntimeError If neither the cached index nor the text look-up table
+     *        could be read
+     */
+    static std::unique_ptr<ExoplanetsIndex> loadWithCache(
+        const std::filesystem::path& lookUpTable);
+
+    /**
+     * Maps the index file at the provided \p path into memory.
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped or is not a valid index
+     */
+    explicit ExoplanetsIndex(std::filesystem::path path);
+
+    /// Returns the number of planets in the index
+    size_t size() const;
+
+    /// Returns the planet at position \p index, in the order of the host star names
+    Planet planet(size_t index) const;
+
+    /// Returns all planets of the host star with the name \p host
+    std::vector<Planet> planets(std::string_view host) const;
+
+    /// Returns the sorted names of all host stars without duplicates
+    std::vector<std::string_view> hosts() const;
+
+private:
+    /// Returns the position of the first planet whose host star is not less than \p host
+    size_t lowerBound(std::string_view host) const;
+
+    MemoryMappedFile _file;
+    size_t _nEntries = 0;
+};
+
+} // namespace openspace::exoplanets
+
+#endif // __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
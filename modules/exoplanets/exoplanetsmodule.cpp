@@ -25,6 +25,7 @@
 #include <modules/exoplanets/exoplanetsmodule.h>
 
 #include <modules/exoplanets/exoplanetshelper.h>
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <modules/exoplanets/rendering/renderableorbitdisc.h>
 #include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
 #include <openspace/engine/globals.h>
@@ -36,6 +37,7 @@
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/distanceconstants.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/memorymappedfile.h>
 #include <openspace/util/timeconversion.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -43,6 +45,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -147,6 +150,7 @@ namespace {
 
     constexpr std::string_view ExoplanetsDataFileName = "exoplanets_data.bin";
     constexpr std::string_view LookupTableFileName = "lookup.txt";
+    constexpr std::string_view LookupIndexFileName = "lookup.idx";
     constexpr std::string_view TeffToBvConversionFileName = "teff_bv.txt";
 
     struct [[codegen::Dictionary(ExoplanetsModule)]] Parameters {
@@ -247,6 +251,14 @@ std::string ExoplanetsModule::lookUpTablePath() const {
     ).string();
 }
 
+std::string ExoplanetsModule::lookUpIndexPath() const {
+    ghoul_assert(hasDataFiles(), "Data files not loaded");
+
+    return absPath(
+        fmt::format("{}/{}", _exoplanetsDataFolder.value(), LookupIndexFileName)
+    ).string();
+}
+
 std::string ExoplanetsModule::teffToBvConversionFilePath() const {
     ghoul_assert(hasDataFiles(), "Data files not loaded");
 
@@ -295,6 +307,46 @@ float ExoplanetsModule::habitableZoneOpacity() const {
     return _habitableZoneOpacity;
 }
 
+const ExoplanetsIndex* ExoplanetsModule::lookUpIndex() {
+    ghoul_assert(hasDataFiles(), "Data files not loaded");
+
+    if (_lookUpIndex) {
+        return _lookUpIndex.get();
+    }
+
+    try {
+        const std::filesystem::path indexPath = lookUpIndexPath();
+        if (std::filesystem::is_regular_file(indexPath)) {
+            _lookUpIndex = std::make_unique<ExoplanetsIndex>(indexPath);
+        }
+        else {
+            _lookUpIndex = ExoplanetsIndex::loadWithCache(lookUpTablePath());
+        }
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open exoplanets look-up table: {}", e.message));
+    }
+    return _lookUpIndex.get();
+}
+
+const MemoryMappedFile* ExoplanetsModule::exoplanetsData() {
+    ghoul_assert(hasDataFiles(), "Data files not loaded");
+
+    if (_exoplanetsData) {
+        return _exoplanetsData.get();
+    }
+
+    try {
+        _exoplanetsData = std::make_unique<MemoryMappedFile>(exoplanetsDataPath());
+    }
+    catch (const ghoul::RuntimeError&) {
+        LERROR(fmt::format(
+            "Failed to open exoplanets data file: '{}'", exoplanetsDataPath()
+        ));
+    }
+    return _exoplanetsData.get();
+}
+
 void ExoplanetsModule::internalInitialize(const ghoul::Dictionary& dict) {
     const Parameters p = codegen::bake<Parameters>(dict);
 
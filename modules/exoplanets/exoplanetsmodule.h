@@ -27,10 +27,13 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/util/memorymappedfile.h>
+#include <memory>
 
 namespace openspace {
 
@@ -44,6 +47,7 @@ public:
     bool hasDataFiles() const;
     std::string exoplanetsDataPath() const;
     std::string lookUpTablePath() const;
+    std::string lookUpIndexPath() const;
     std::string teffToBvConversionFilePath() const;
     std::string bvColormapPath() const;
     std::string starTexturePath() const;
@@ -56,6 +60,21 @@ public:
     bool useOptimisticZone() const;
     float habitableZoneOpacity() const;
 
+    /**
+     * Returns the binary look-up table of the configured data folder. It is opened on
+     * the first call and kept for all later calls. If the data folder only contains the
+     * text look-up table, the binary table is created from it and cached. Returns
+     * `nullptr` if the look-up table could not be opened.
+     */
+    const exoplanets::ExoplanetsIndex* lookUpIndex();
+
+    /**
+     * Returns the memory mapped exoplanets data file of the configured data folder. It
+     * is mapped on the first call and kept for all later calls. Returns `nullptr` if the
+     * file could not be mapped.
+     */
+    const MemoryMappedFile* exoplanetsData();
+
     scripting::LuaLibrary luaLibrary() const override;
     std::vector<documentation::Documentation> documentations() const override;
 
@@ -76,6 +95,9 @@ protected:
     properties::BoolProperty _useOptimisticZone;
 
     properties::FloatProperty _habitableZoneOpacity;
+
+    std::unique_ptr<exoplanets::ExoplanetsIndex> _lookUpIndex;
+    std::unique_ptr<MemoryMappedFile> _exoplanetsData;
 };
 
 } // namespace openspace
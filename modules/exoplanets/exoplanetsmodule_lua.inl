@@ -25,7 +25,9 @@
 #include <openspace/scene/scene.h>
 #include <ghoul/misc/csvreader.h>
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -42,62 +44,58 @@ std::string formatPathToLua(const std::string& path) {
     return resPath;
 }
 
+std::optional<openspace::exoplanets::ExoplanetDataEntry> readDataEntry(
+                                                 const openspace::MemoryMappedFile& data,
+                                                 uint64_t location)
+{
+    using namespace openspace::exoplanets;
+
+    if (location + sizeof(ExoplanetDataEntry) > data.size()) {
+        LERROR(fmt::format("Location {} is outside the exoplanets data file", location));
+        return std::nullopt;
+    }
+
+    ExoplanetDataEntry p;
+    std::memcpy(&p, data.data() + location, sizeof(ExoplanetDataEntry));
+    return p;
+}
+
 openspace::exoplanets::ExoplanetSystem findExoplanetSystemInData(
                                                                 std::string_view starName)
 {
     using namespace openspace;
     using namespace exoplanets;
 
-    const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
-
-    const std::string binPath = module->exoplanetsDataPath();
-    std::ifstream data(absPath(binPath), std::ios::in | std::ios::binary);
-    if (!data.good()) {
-        LERROR(fmt::format("Failed to open exoplanets data file: '{}'", binPath));
-        return ExoplanetSystem();
-    }
+    ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
 
-    const std::string lutPath = module->lookUpTablePath();
-    std::ifstream lut(absPath(lutPath));
-    if (!lut.good()) {
-        LERROR(fmt::format("Failed to open exoplanets look-up table: '{}'", lutPath));
+    const MemoryMappedFile* data = module->exoplanetsData();
+    const ExoplanetsIndex* index = module->lookUpIndex();
+    if (!data || !index) {
         return ExoplanetSystem();
     }
 
     ExoplanetSystem system;
 
-    // 1. search lut for the starname and return the corresponding location
-    // 2. go to that location in the data file
-    // 3. read sizeof(exoplanet) bytes into an exoplanet object.
-    ExoplanetDataEntry p;
-    std::string line;
-    while (std::getline(lut, line)) {
-        std::istringstream ss(line);
-        std::string name;
-        std::getline(ss, name, ',');
-
-        if (name.substr(0, name.length() - 2) != starName) {
+    // 1. search the look-up table for the starname and return the planet locations
+    // 2. read sizeof(exoplanet) bytes at each location into an exoplanet object
+    for (const ExoplanetsIndex::Planet& planet : index->planets(starName)) {
+        std::optional<ExoplanetDataEntry> p = readDataEntry(*data, planet.offset);
+        if (!p.has_value()) {
             continue;
         }
 
-        std::string location_s;
-        std::getline(ss, location_s);
-        long location = std::stol(location_s.c_str());
-
-        data.seekg(location);
-        data.read(reinterpret_cast<char*>(&p), sizeof(ExoplanetDataEntry));
-
+        std::string name = std::string(planet.name);
         sanitizeNameString(name);
 
-        if (!hasSufficientData(p)) {
+        if (!hasSufficientData(*p)) {
             LWARNING(fmt::format("Insufficient data for exoplanet: '{}'", name));
             continue;
         }
 
         system.planetNames.push_back(name);
-        system.planetsData.push_back(p);
+        system.planetsData.push_back(*p);
 
-        updateStarDataFromNewPlanet(system.starData, p);
+        updateStarDataFromNewPlanet(system.starData, *p);
     }
 
     system.starName = starName;
@@ -547,7 +545,7 @@ void createExoplanetSystem(const std::string& starName,
 std::vector<std::string> hostStarsWithSufficientData() {
     using namespace openspace;
     using namespace exoplanets;
-    const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
+    ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
 
     if (!module->hasDataFiles()) {
         // If no data file path has been configured at all, we just bail out early here
@@ -555,57 +553,27 @@ std::vector<std::string> hostStarsWithSufficientData() {
         return {};
     }
 
-    const std::string lutPath = module->lookUpTablePath();
-    std::ifstream lookupTableFile(absPath(lutPath));
-    if (!lookupTableFile.good()) {
-        LERROR(fmt::format("Failed to open lookup table file '{}'", lutPath));
-        return {};
-    }
-
-    const std::string binPath = module->exoplanetsDataPath();
-    std::ifstream data(absPath(binPath), std::ios::in | std::ios::binary);
-    if (!data.good()) {
-        LERROR(fmt::format("Failed to open data file '{}'", binPath));
+    const ExoplanetsIndex* index = module->lookUpIndex();
+    const MemoryMappedFile* data = module->exoplanetsData();
+    if (!index || !data) {
         return {};
     }
 
+    // The index is sorted by the name of the host star, so the names are added in order
     std::vector<std::string> names;
-    std::string line;
-
-    // Read number of lines
-    int nExoplanets = 0;
-    while (std::getline(lookupTableFile, line)) {
-        ++nExoplanets;
-    }
-    lookupTableFile.clear();
-    lookupTableFile.seekg(0);
-    names.reserve(nExoplanets);
-
-    ExoplanetDataEntry p;
-    while (std::getline(lookupTableFile, line)) {
-        std::stringstream ss(line);
-        std::string name;
-        std::getline(ss, name, ',');
-        // Remove the last two characters, that specify the planet
-        name = name.substr(0, name.size() - 2);
+    for (size_t i = 0; i < index->size(); i++) {
+        const ExoplanetsIndex::Planet planet = index->planet(i);
+        if (!names.empty() && names.back() == planet.host) {
+            continue;
+        }
 
         // Don't want to list systems where there is not enough data to visualize.
         // So, test if there is before adding the name to the list.
-        std::string location_s;
-        std::getline(ss, location_s);
-        long location = std::stol(location_s.c_str());
-
-        data.seekg(location);
-        data.read(reinterpret_cast<char*>(&p), sizeof(ExoplanetDataEntry));
-
-        if (hasSufficientData(p)) {
-            names.push_back(name);
+        std::optional<ExoplanetDataEntry> p = readDataEntry(*data, planet.offset);
+        if (p.has_value() && hasSufficientData(*p)) {
+            names.emplace_back(planet.host);
         }
     }
-
-    // For easier read, sort by names and remove duplicates
-    std::sort(names.begin(), names.end());
-    names.erase(std::unique(names.begin(), names.end()), names.end());
     return names;
 }
 
@@ -25,6 +25,7 @@
 #include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
 
 #include <modules/exoplanets/exoplanetshelper.h>
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/coordinateconversion.h>
@@ -33,13 +34,21 @@
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
 #include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "ExoplanetsDataPreparationTask";
 
+    // The minimum number of rows that is worth handing to a separate parsing thread
+    constexpr size_t MinRowsPerThread = 64;
+
     struct [[codegen::Dictionary(ExoplanetsDataPreparationTask)]] Parameters {
         // The csv file to extract data from
         std::string inputDataFile;
@@ -53,6 +62,12 @@ namespace {
         // The txt file to write look-up table into
         std::string outputLUT [[codegen::annotation("A valid filepath")]];
 
+        // The binary file to write the sorted, memory mappable look-up table into. If
+        // this value is not specified, the file is placed next to the text look-up table
+        // with the extension '.idx'
+        std::optional<std::string> outputIndex
+            [[codegen::annotation("A valid filepath")]];
+
         // The path to a teff to bv conversion file. Should be a txt file where each line
         // has the format 'teff,bv'
         std::string teffToBvFile;
@@ -75,6 +90,13 @@ ExoplanetsDataPreparationTask::ExoplanetsDataPreparationTask(
     _inputSpeckPath = absPath(p.inputSPECK);
     _outputBinPath = absPath(p.outputBIN);
     _outputLutPath = absPath(p.outputLUT);
+    if (p.outputIndex.has_value()) {
+        _outputIndexPath = absPath(*p.outputIndex);
+    }
+    else {
+        _outputIndexPath = _outputLutPath;
+        _outputIndexPath.replace_extension(".idx");
+    }
     _teffToBvFilePath = absPath(p.teffToBvFile);
 }
 
@@ -122,47 +144,112 @@ void ExoplanetsDataPreparationTask::perform(
     // later access
     std::vector<std::string> columnNames = readFirstDataRow(inputDataFile);
 
-    // Read total number of items
-    int total = 0;
+    std::vector<std::string> rows;
     std::string row;
     while (std::getline(inputDataFile, row)) {
-        ++total;
+        rows.push_back(std::move(row));
     }
-    inputDataFile.clear();
-    inputDataFile.seekg(0);
 
-    // The reading is restarted, so we need to read past the first line,
-    // containing the data names, again
-    readFirstDataRow(inputDataFile);
+    LINFO(fmt::format("Loading {} exoplanets", rows.size()));
+    progressCallback(0.f);
 
-    LINFO(fmt::format("Loading {} exoplanets", total));
-
-    int exoplanetCount = 0;
-    while (std::getline(inputDataFile, row)) {
-        ++exoplanetCount;
-        progressCallback(static_cast<float>(exoplanetCount) / static_cast<float>(total));
-
-        PlanetData planetData = parseDataRow(
-            row,
-            columnNames,
-            _inputSpeckPath,
-            _teffToBvFilePath
-        );
+    std::vector<PlanetData> planets = parseDataRows(
+        rows,
+        columnNames,
+        _inputSpeckPath,
+        _teffToBvFilePath
+    );
+    progressCallback(0.9f);
 
+    std::vector<ExoplanetsIndex::Entry> indexEntries;
+    indexEntries.reserve(planets.size());
+    for (PlanetData& planetData : planets) {
         // Create look-up table
         long pos = static_cast<long>(binFile.tellp());
         std::string planetName = planetData.host + " " + planetData.component;
-        lutFile << planetName << "," << pos << std::endl;
+        lutFile << planetName << "," << pos << '\n';
 
         binFile.write(
             reinterpret_cast<char*>(&planetData.dataEntry),
             sizeof(ExoplanetDataEntry)
         );
+
+        indexEntries.push_back({
+            .host = std::move(planetData.host),
+            .name = std::move(planetName),
+            .offset = static_cast<uint64_t>(pos)
+        });
+    }
+
+    try {
+        ExoplanetsIndex::write(std::move(indexEntries), _outputIndexPath);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        if (!std::filesystem::is_directory(_outputIndexPath.parent_path())) {
+            LERROR("Output directory does not exist");
+        }
+        return;
     }
 
     progressCallback(1.f);
 }
 
+std::vector<ExoplanetsDataPreparationTask::PlanetData>
+ExoplanetsDataPreparationTask::parseDataRows(const std::vector<std::string>& rows,
+                                             const std::vector<std::string>& columnNames,
+                                         const std::filesystem::path& positionSourceFile,
+                                   const std::filesystem::path& bvFromTeffConversionFile,
+                                             unsigned int nThreads)
+{
+    ZoneScoped;
+
+    auto parseRange = [&](size_t begin, size_t end) {
+        std::vector<PlanetData> result;
+        result.reserve(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            result.push_back(parseDataRow(
+                rows[i],
+                columnNames,
+                positionSourceFile,
+                bvFromTeffConversionFile
+            ));
+        }
+        return result;
+    };
+
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const size_t maxChunks = std::max<size_t>(rows.size() / MinRowsPerThread, 1);
+    const size_t nChunks = std::min<size_t>(nThreads, maxChunks);
+    if (nChunks == 1) {
+        return parseRange(0, rows.size());
+    }
+
+    const size_t nRows = rows.size();
+    auto chunkBegin = [nRows, nChunks](size_t chunk) {
+        return nRows * chunk / nChunks;
+    };
+
+    std::vector<std::future<std::vector<PlanetData>>> futures;
+    futures.reserve(nChunks - 1);
+    for (size_t chunk = 1; chunk < nChunks; chunk++) {
+        futures.push_back(std::async(
+            std::launch::async,
+            parseRange, chunkBegin(chunk), chunkBegin(chunk + 1)
+        ));
+    }
+
+    std::vector<PlanetData> result = parseRange(0, chunkBegin(1));
+    result.reserve(nRows);
+    for (std::future<std::vector<PlanetData>>& f : futures) {
+        std::vector<PlanetData> part = f.get();
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
 std::vector<std::string>
 ExoplanetsDataPreparationTask::readFirstDataRow(std::ifstream& file)
 {
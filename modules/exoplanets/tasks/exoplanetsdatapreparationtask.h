@@ -32,6 +32,7 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace openspace::exoplanets {
 
@@ -80,11 +81,24 @@ public:
         std::filesystem::path positionSourceFile,
         std::filesystem::path bvFromTeffConversionFile);
 
+    /**
+     * Parses all \p rows of the CSV file of exoplanets with parseDataRow. The rows are
+     * split into consecutive ranges that are parsed on up to \p nThreads threads, or on
+     * as many threads as the hardware supports if \p nThreads is 0. The result is in the
+     * same order as the \p rows regardless of the number of threads.
+     */
+    static std::vector<PlanetData> parseDataRows(const std::vector<std::string>& rows,
+        const std::vector<std::string>& columnNames,
+        const std::filesystem::path& positionSourceFile,
+        const std::filesystem::path& bvFromTeffConversionFile,
+        unsigned int nThreads = 0);
+
 private:
     std::filesystem::path _inputDataPath;
     std::filesystem::path _inputSpeckPath;
     std::filesystem::path _outputBinPath;
     std::filesystem::path _outputLutPath;
+    std::filesystem::path _outputIndexPath;
     std::filesystem::path _teffToBvFilePath;
 
     /**
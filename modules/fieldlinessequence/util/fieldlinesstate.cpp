@@ -418,6 +418,11 @@ void FieldlinesState::appendToExtra(size_t idx, float val) {
     _extraQuantities[idx].push_back(val);
 }
 
+void FieldlinesState::appendToExtra(size_t idx, const std::vector<float>& values) {
+    std::vector<float>& extra = _extraQuantities[idx];
+    extra.insert(extra.end(), values.begin(), values.end());
+}
+
 void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
     _extraQuantityNames = std::move(names);
     _extraQuantities.resize(_extraQuantityNames.size());
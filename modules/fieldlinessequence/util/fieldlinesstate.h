@@ -64,6 +64,7 @@ public:
 
     void addLine(std::vector<glm::vec3>& line);
     void appendToExtra(size_t idx, float val);
+    void appendToExtra(size_t idx, const std::vector<float>& values);
 
 private:
     bool _isMorphable = false;
@@ -29,7 +29,15 @@
 #include <openspace/util/spicemanager.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 
@@ -57,17 +65,52 @@ namespace {
     constexpr std::string_view JParallelB  = "Current: mag(J||B)";
     // [nPa]/[amu/cm^3] * ToKelvin => Temperature in Kelvin
     constexpr float ToKelvin = 72429735.6984f;
+
+    // The number of vertices for which the extra quantities are sampled by one worker in
+    // one go. Small enough to balance the load, large enough to amortize the scheduling
+    constexpr size_t VerticesPerChunk = 4096;
+
+    unsigned int numberOfThreads(unsigned int nThreads, size_t nWorkItems) {
+        if (nThreads == 0) {
+            nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return static_cast<unsigned int>(
+            std::clamp<size_t>(nWorkItems, 1, nThreads)
+        );
+    }
+
+    // Runs the work function on nThreads threads, of which the calling thread is the
+    // first one. The work function is passed the index of the thread it runs on
+    template <typename Func>
+    void runOnThreads(unsigned int nThreads, const Func& work) {
+        std::vector<std::future<void>> workers;
+        for (unsigned int i = 1; i < nThreads; i++) {
+            workers.push_back(std::async(std::launch::async, work, i));
+        }
+        work(0);
+        for (std::future<void>& worker : workers) {
+            worker.get();
+        }
+    }
 } // namespace
 
 namespace openspace::fls {
 
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+    // Returns the Kameleon object that the thread with the provided index uses, with the
+    // provided variables loaded
+    using KameleonForThread = std::function<
+        ccmc::Kameleon*(unsigned int, const std::vector<std::string>&)
+    >;
+
     bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string& tracingVar, FieldlinesState& state);
+        const std::string& tracingVar, FieldlinesState& state,
+        const KameleonForThread& kameleonForThread, unsigned int nThreads);
     void addExtraQuantities(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
-        FieldlinesState& state);
+        FieldlinesState& state, const KameleonForThread& kameleonForThread,
+        unsigned int nThreads);
     void prepareStateAndKameleonForExtras(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
@@ -88,6 +131,8 @@ namespace openspace::fls {
  * \param extraMagVars, variables which should be used for extracting magnitudes, must be
  *        a multiple of 3; e.g. "ux", "uy" & "uz" to get the magnitude of the velocity
  *        vector at each line vertex
+ * \param nThreads, the number of threads used for tracing and sampling; 0 uses all
+ *        available hardware threads. The result does not depend on the number of threads
  */
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
                                  const std::unordered_map<std::string,
@@ -95,7 +140,8 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
                                  double manualTimeOffset,
                                  const std::string& tracingVar,
                                  std::vector<std::string>& extraVars,
-                                 std::vector<std::string>& extraMagVars)
+                                 std::vector<std::string>& extraMagVars,
+                                 unsigned int nThreads)
 {
 #ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
     LERROR("CDF inputs provided but Kameleon module is deactivated");
@@ -115,14 +161,56 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
         cdfDoubleTime, "YYYYMMDDHRMNSC::RND"
     );
 
+    // ccmc does not guarantee that a Kameleon object, or the tracers and interpolators
+    // that read from it, can be used from several threads at the same time. So every
+    // thread except the calling one opens the file with its own Kameleon object and
+    // loads the variables it needs. Opening the file and loading variables goes through
+    // the CDF library, which is not thread-safe either, so that part is serialized
+    std::vector<std::unique_ptr<ccmc::Kameleon>> threadKameleons;
+    std::mutex kameleonMutex;
+    auto kameleonForThread = [&](unsigned int thread,
+                                 const std::vector<std::string>& variables)
+    {
+        std::lock_guard lock(kameleonMutex);
+        ccmc::Kameleon* k = kameleon.get();
+        if (thread > 0) {
+            if (threadKameleons.size() < thread) {
+                threadKameleons.resize(thread);
+            }
+            std::unique_ptr<ccmc::Kameleon>& threadKameleon = threadKameleons[thread - 1];
+            if (!threadKameleon) {
+                threadKameleon = kameleonHelper::createKameleonObject(cdfPath);
+            }
+            k = threadKameleon.get();
+        }
+        for (const std::string& variable : variables) {
+            k->loadVariable(variable);
+        }
+        return k;
+    };
+
     // use time as string for picking seedpoints from seedm
     std::vector<glm::vec3> seedPoints = seedMap.at(cdfStringTime);
-    bool success = addLinesToState(kameleon.get(), seedPoints, tracingVar, state);
+    bool success = addLinesToState(
+        kameleon.get(),
+        seedPoints,
+        tracingVar,
+        state,
+        kameleonForThread,
+        nThreads
+    );
     if (success) {
         // The line points are in their RAW format (unscaled & maybe spherical)
         // Before we scale to meters (and maybe cartesian) we must extract
         // the extraQuantites, as the iterpolator needs the unaltered positions
-        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state);
+        addExtraQuantities(
+            kameleon.get(),
+            extraVars,
+            extraMagVars,
+            state,
+            kameleonForThread,
+            nThreads
+        );
         switch (state.model()) {
             case fls::Model::Batsrus:
                 state.scalePositions(fls::ReToMeter);
@@ -141,16 +229,171 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 }
 
+std::vector<std::vector<glm::vec3>> traceLines(
+                                                 const std::vector<glm::vec3>& seedPoints,
+                                                        const TracerFactory& createTracer,
+                                                                    unsigned int nThreads)
+{
+    std::vector<std::vector<glm::vec3>> lines(seedPoints.size());
+    std::atomic<size_t> nextSeed = 0;
+    auto trace = [&](unsigned int thread) {
+        const LineTracer tracer = createTracer(thread);
+        for (size_t i = nextSeed++; i < seedPoints.size(); i = nextSeed++) {
+            lines[i] = tracer(seedPoints[i]);
+        }
+    };
+    runOnThreads(numberOfThreads(nThreads, seedPoints.size()), trace);
+    return lines;
+}
+
+std::vector<std::vector<float>> computeExtraQuantities(
+                                                  const std::vector<glm::vec3>& positions,
+                                                                              Model model,
+                                          const std::vector<std::string>& extraScalarVars,
+                                             const std::vector<std::string>& extraMagVars,
+                                                      const SamplerFactory& createSampler,
+                                                                    unsigned int nThreads)
+{
+    const size_t nXtraScalars = extraScalarVars.size();
+    const size_t nXtraMagnitudes = extraMagVars.size() / 3;
+
+    // Every variable that is needed by any of the quantities is only sampled once per
+    // vertex, even if it is used by several quantities
+    std::vector<std::string> variables;
+    auto variableIndex = [&variables](const std::string& name) {
+        auto it = std::find(variables.begin(), variables.end(), name);
+        if (it == variables.end()) {
+            variables.push_back(name);
+            return variables.size() - 1;
+        }
+        return static_cast<size_t>(std::distance(variables.begin(), it));
+    };
+
+    struct Scalar {
+        size_t variable = 0;
+        // Only used for the temperature derived from pressure and density
+        size_t density = 0;
+        bool isTemperature = false;
+        bool isEnlilDensity = false;
+    };
+    std::vector<Scalar> scalars;
+    for (const std::string& var : extraScalarVars) {
+        Scalar scalar;
+        if (var == TAsPOverRho) {
+            scalar.variable = variableIndex("p");
+            scalar.density = variableIndex("rho");
+            scalar.isTemperature = true;
+        }
+        else {
+            scalar.variable = variableIndex(var);
+            // When measuring density in ENLIL CCMC multiply by the radius^2
+            scalar.isEnlilDensity = var == "rho" && model == fls::Model::Enlil;
+        }
+        scalars.push_back(scalar);
+    }
+
+    struct Magnitude {
+        std::array<size_t, 3> components = {};
+        // Only used for the current parallel to the magnetic field
+        std::array<size_t, 3> magnetic = {};
+        bool isParallelToB = false;
+    };
+    std::vector<Magnitude> magnitudes;
+    for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+        Magnitude magnitude;
+        for (size_t c = 0; c < 3; c++) {
+            magnitude.components[c] = variableIndex(extraMagVars[i * 3 + c]);
+        }
+        // When looking at the current's magnitude in Batsrus, CCMC staff are
+        // only interested in the magnitude parallel to the magnetic field
+        if (model == fls::Model::Batsrus && extraMagVars[i * 3] == "jx" &&
+            extraMagVars[i * 3 + 1] == "jy" && extraMagVars[i * 3 + 2] == "jz")
+        {
+            magnitude.magnetic = {
+                variableIndex("bx"), variableIndex("by"), variableIndex("bz")
+            };
+            magnitude.isParallelToB = true;
+        }
+        magnitudes.push_back(magnitude);
+    }
+
+    const size_t nQuantities = nXtraScalars + nXtraMagnitudes;
+    std::vector<std::vector<float>> quantities(
+        nQuantities,
+        std::vector<float>(positions.size())
+    );
+
+    const size_t nChunks = (positions.size() + VerticesPerChunk - 1) / VerticesPerChunk;
+    std::atomic<size_t> nextChunk = 0;
+    auto sample = [&](unsigned int thread) {
+        const VariableSampler sampler = createSampler(thread, variables);
+
+        std::vector<float> samples(variables.size());
+        for (size_t chunk = nextChunk++; chunk < nChunks; chunk = nextChunk++) {
+            const size_t begin = chunk * VerticesPerChunk;
+            const size_t end = std::min(begin + VerticesPerChunk, positions.size());
+            for (size_t v = begin; v < end; v++) {
+                const glm::vec3& p = positions[v];
+                for (size_t i = 0; i < variables.size(); i++) {
+                    samples[i] = sampler(i, p);
+                }
+
+                // Load the scalars!
+                for (size_t i = 0; i < nXtraScalars; i++) {
+                    const Scalar& scalar = scalars[i];
+                    float val = samples[scalar.variable];
+                    if (scalar.isTemperature) {
+                        val *= ToKelvin;
+                        val /= samples[scalar.density];
+                    }
+                    else if (scalar.isEnlilDensity) {
+                        val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+                    }
+                    quantities[i][v] = val;
+                }
+                // Calculate and store the magnitudes!
+                for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+                    const Magnitude& magnitude = magnitudes[i];
+                    const float x = samples[magnitude.components[0]];
+                    const float y = samples[magnitude.components[1]];
+                    const float z = samples[magnitude.components[2]];
+                    float val;
+                    if (magnitude.isParallelToB) {
+                        const glm::vec3 normMagnetic = glm::normalize(glm::vec3(
+                            samples[magnitude.magnetic[0]],
+                            samples[magnitude.magnetic[1]],
+                            samples[magnitude.magnetic[2]]
+                        ));
+                        // Magnitude of the part of the current vector that's parallel to
+                        // the magnetic field vector!
+                        val = glm::dot(glm::vec3(x, y, z), normMagnetic);
+                    }
+                    else {
+                        val = std::sqrt(x*x + y*y + z*z);
+                    }
+                    quantities[nXtraScalars + i][v] = val;
+                }
+            }
+        }
+    };
+    runOnThreads(numberOfThreads(nThreads, nChunks), sample);
+
+    return quantities;
+}
+
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 /**
  * Traces and adds line vertices to state.
  * Vertices are not scaled to meters nor converted from spherical into cartesian
  * coordinates.
  * Note that extraQuantities will NOT be set!
+ * The seed points are traced on nThreads threads, but the lines are added to the state
+ * in the order of the seed points.
  */
 bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string& tracingVar, FieldlinesState& state) {
-
+                     const std::string& tracingVar, FieldlinesState& state,
+                     const KameleonForThread& kameleonForThread, unsigned int nThreads)
+{
     float innerBoundaryLimit;
 
     switch (state.model()) {
@@ -169,39 +412,51 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
     }
 
     // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
+    // The variable is loaded before the workers start so that a missing variable is
+    // reported once. The other threads load it into their own Kameleon objects
     if (!kameleon->loadVariable(tracingVar)) {
         LERROR("Failed to load tracing variable: " + tracingVar);
         return false;
     }
 
-    bool success = false;
     LINFO("Tracing field lines");
-    // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
-    for (const glm::vec3& seed : seedPoints) {
-        //--------------------------------------------------------------------------//
-        // We have to create a new tracer (or actually a new interpolator) for each //
-        // new line, otherwise some issues occur                                    //
-        //--------------------------------------------------------------------------//
-        auto interpolator = std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-        ccmc::Tracer tracer(kameleon, interpolator.get());
-        tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
-        ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
-            tracingVar,
-            seed.x,
-            seed.y,
-            seed.z
-        );
-        const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
+    auto createTracer = [&](unsigned int thread) -> LineTracer {
+        ccmc::Kameleon* k = kameleonForThread(thread, { tracingVar });
+        return [k, &tracingVar, innerBoundaryLimit](const glm::vec3& seed) {
+            //--------------------------------------------------------------------------//
+            // We have to create a new tracer (or actually a new interpolator) for each //
+            // new line, otherwise some issues occur                                    //
+            //--------------------------------------------------------------------------//
+            ccmc::KameleonInterpolator interpolator(k->model);
+            ccmc::Tracer tracer(k, &interpolator);
+            tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
+            ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
+                tracingVar,
+                seed.x,
+                seed.y,
+                seed.z
+            );
+            const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
 
-        const size_t nLinePoints = positions.size();
+            std::vector<glm::vec3> vertices;
+            vertices.reserve(positions.size());
+            for (const ccmc::Point3f& p : positions) {
+                vertices.emplace_back(p.component1, p.component2, p.component3);
+            }
+            return vertices;
+        };
+    };
+    std::vector<std::vector<glm::vec3>> lines = traceLines(
+        seedPoints,
+        createTracer,
+        nThreads
+    );
 
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
-        for (const ccmc::Point3f& p : positions) {
-            vertices.emplace_back(p.component1, p.component2, p.component3);
-        }
+    // CONVERT POINTS TO glm::vec3 AND STORE THEM IN THE ORDER OF THE SEED POINTS //
+    bool success = false;
+    for (std::vector<glm::vec3>& vertices : lines) {
+        success |= !vertices.empty();
         state.addLine(vertices);
-        success |= (nLinePoints > 0);
     }
 
     return success;
@@ -227,61 +482,33 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
 void addExtraQuantities(ccmc::Kameleon* kameleon,
                         std::vector<std::string>& extraScalarVars,
                         std::vector<std::string>& extraMagVars,
-                        FieldlinesState& state)
+                        FieldlinesState& state,
+                        const KameleonForThread& kameleonForThread, unsigned int nThreads)
 {
 
     prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
 
-    const size_t nXtraScalars = extraScalarVars.size();
-    const size_t nXtraMagnitudes = extraMagVars.size() / 3;
-
-    auto interpolator = std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-
     // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
-    for (const glm::vec3& p : state.vertexPositions()) {
-        // Load the scalars!
-        for (size_t i = 0; i < nXtraScalars; i++) {
-            float val;
-            if (extraScalarVars[i] == TAsPOverRho) {
-                val = interpolator->interpolate("p", p.x, p.y, p.z);
-                val *= ToKelvin;
-                val /= interpolator->interpolate("rho", p.x, p.y, p.z);
-            }
-            else {
-                val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
-
-                // When measuring density in ENLIL CCMC multiply by the radius^2
-                if (extraScalarVars[i] == "rho" && state.model() == fls::Model::Enlil) {
-                    val *= std::pow(p.x * fls::AuToMeter, 2.0f);
-                }
-            }
-            state.appendToExtra(i, val);
-        }
-        // Calculate and store the magnitudes!
-        for (size_t i = 0; i < nXtraMagnitudes; ++i) {
-            const size_t idx = i*3;
-
-            const float x = interpolator->interpolate(extraMagVars[idx]  , p.x, p.y, p.z);
-            const float y = interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
-            const float z = interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
-            float val;
-            // When looking at the current's magnitude in Batsrus, CCMC staff are
-            // only interested in the magnitude parallel to the magnetic field
-            if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
-                const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
-                        interpolator->interpolate("bx", p.x, p.y, p.z),
-                        interpolator->interpolate("by", p.x, p.y, p.z),
-                        interpolator->interpolate("bz", p.x, p.y, p.z)));
-                // Magnitude of the part of the current vector that's parallel to
-                // the magnetic field vector!
-                val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+    auto createSampler = [&](unsigned int thread,
+                             const std::vector<std::string>& variables) -> VariableSampler
+    {
+        ccmc::Kameleon* k = kameleonForThread(thread, variables);
+        auto interpolator = std::make_shared<ccmc::KameleonInterpolator>(k->model);
+        return [interpolator, &variables](size_t variable, const glm::vec3& p) {
+            return interpolator->interpolate(variables[variable], p.x, p.y, p.z);
+        };
+    };
+    std::vector<std::vector<float>> quantities = computeExtraQuantities(
+        state.vertexPositions(),
+        state.model(),
+        extraScalarVars,
+        extraMagVars,
+        createSampler,
+        nThreads
+    );
 
-            }
-            else {
-                val = std::sqrt(x*x + y*y + z*z);
-            }
-            state.appendToExtra(i + nXtraScalars, val);
-        }
+    for (size_t i = 0; i < quantities.size(); i++) {
+        state.appendToExtra(i, quantities[i]);
     }
 }
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
@@ -25,7 +25,9 @@
 #ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___KAMELEONFIELDLINEHELPER___H__
 #define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___KAMELEONFIELDLINEHELPER___H__
 
+#include <modules/fieldlinessequence/util/commons.h>
 #include <ghoul/glm.h>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -39,7 +41,54 @@ namespace fls {
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
     const std::unordered_map<std::string, std::vector<glm::vec3>>& seedMap,
     double manualTimeOffset, const std::string& tracingVar,
-    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars);
+    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars,
+    unsigned int nThreads = 0);
+
+/// Returns the vertices of the field line that passes through the provided seed point
+using LineTracer = std::function<std::vector<glm::vec3>(const glm::vec3&)>;
+/// Creates the LineTracer that is used by the thread with the provided index
+using TracerFactory = std::function<LineTracer(unsigned int)>;
+
+/**
+ * Traces one field line per seed point on up to \p nThreads threads, or on as many
+ * threads as the hardware supports if \p nThreads is 0. Every thread calls
+ * \p createTracer once with its own index, where the calling thread has index 0, and
+ * only uses the LineTracer it got back. The lines are returned in the order of the
+ * \p seedPoints, independent of the number of threads.
+ */
+std::vector<std::vector<glm::vec3>> traceLines(const std::vector<glm::vec3>& seedPoints,
+    const TracerFactory& createTracer, unsigned int nThreads = 0);
+
+/// Returns the value of the variable with the provided index at the provided position
+using VariableSampler = std::function<float(size_t, const glm::vec3&)>;
+/// Creates the VariableSampler that is used by the thread with the provided index. The
+/// variable indices passed to the sampler refer to the provided list of variable names
+using SamplerFactory = std::function<
+    VariableSampler(unsigned int, const std::vector<std::string>&)
+>;
+
+/**
+ * Computes the extra quantities at all \p positions on up to \p nThreads threads, or on
+ * as many threads as the hardware supports if \p nThreads is 0. Every variable is only
+ * sampled once per position, even if several quantities use it. Every thread calls
+ * \p createSampler once with its own index, where the calling thread has index 0, and
+ * only uses the VariableSampler it got back.
+ *
+ * \param positions The unaltered positions of the line vertices in model coordinates
+ * \param model The model of the data, which decides how some quantities are derived
+ * \param extraScalarVars The names of the scalar quantities
+ * \param extraMagVars The names of the components of the magnitude quantities, which
+ *        must be a multiple of 3
+ * \param createSampler The factory for the samplers of the threads
+ * \param nThreads The maximum number of threads
+ * \return One vector per quantity, in the order of the scalars followed by the
+ *         magnitudes, with one value per position
+ */
+std::vector<std::vector<float>> computeExtraQuantities(
+    const std::vector<glm::vec3>& positions, Model model,
+    const std::vector<std::string>& extraScalarVars,
+    const std::vector<std::string>& extraMagVars, const SamplerFactory& createSampler,
+    unsigned int nThreads = 0);
 
 } // namespace fls
 } // namespace openspace
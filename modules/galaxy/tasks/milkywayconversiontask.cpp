@@ -33,6 +33,8 @@
 #include <openspace/documentation/documentation.h>
 
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <cmath>
 
 namespace {
     constexpr std::string_view KeyInFilenamePrefix = "InFilenamePrefix";
@@ -75,6 +77,7 @@ std::string MilkywayConversionTask::description() {
 
 void MilkywayConversionTask::perform(const Task::ProgressCallback& onProgress) {
     using namespace openspace::volume;
+    using VoxelType = glm::tvec4<GLfloat>;
 
     std::vector<std::string> filenames;
     for (size_t i = 0; i < _inNSlices; i++) {
@@ -83,28 +86,56 @@ void MilkywayConversionTask::perform(const Task::ProgressCallback& onProgress) {
         );
     }
 
-    TextureSliceVolumeReader<glm::tvec4<GLfloat>> sliceReader(filenames, _inNSlices, 10);
+    TextureSliceVolumeReader<VoxelType> sliceReader(filenames, _inNSlices, 10);
     sliceReader.initialize();
 
-    RawVolumeWriter<glm::tvec4<GLfloat>> rawWriter(_outFilename);
+    RawVolumeWriter<VoxelType> rawWriter(_outFilename);
     rawWriter.setDimensions(_outDimensions);
 
     const glm::vec3 resolutionRatio = static_cast<glm::vec3>(sliceReader.dimensions()) /
                                       static_cast<glm::vec3>(rawWriter.dimensions());
 
-    VolumeSampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> sampler(
+    VolumeSampler<TextureSliceVolumeReader<VoxelType>> sampler(
         &sliceReader,
         resolutionRatio
     );
-    std::function<glm::tvec4<GLfloat>(glm::ivec3)> sampleFunction =
+    std::function<VoxelType(glm::ivec3)> sampleFunction =
         [resolutionRatio, sampler](glm::ivec3 outCoord) {
             const glm::vec3 inCoord = ((glm::vec3(outCoord) + glm::vec3(0.5f)) *
                                       resolutionRatio) - glm::vec3(0.5f);
-            const glm::tvec4<GLfloat> value = sampler.sample(inCoord);
+            const VoxelType value = sampler.sample(inCoord);
             return value;
         };
 
-    rawWriter.write(sampleFunction, onProgress);
+    // The sampler reads the input slices around the sample position, with the same
+    // odd filter size along the z axis as the VolumeSampler uses
+    const int filterSize = static_cast<int>((resolutionRatio.z - 1.f) * 0.5f) * 2 + 1;
+    const int nInputSlices = sliceReader.dimensions().z;
+    auto inputSlice = [&resolutionRatio](unsigned int outZ) {
+        const float inZ = (static_cast<float>(outZ) + 0.5f) * resolutionRatio.z - 0.5f;
+        return static_cast<int>(std::floor(inZ));
+    };
+
+    // All slices that are needed for a slab are loaded before the voxels are sampled,
+    // which makes sampling from multiple threads safe. One additional slice on either
+    // side guards against rounding differences to the sampler
+    auto prepareSlab = [&](unsigned int zBegin, unsigned int zEnd) {
+        const int begin = inputSlice(zBegin) - filterSize / 2 - 1;
+        const int end = inputSlice(zEnd - 1) - filterSize / 2 + filterSize + 2;
+        sliceReader.loadSlices(
+            std::clamp(begin, 0, nInputSlices),
+            std::clamp(end, 0, nInputSlices)
+        );
+    };
+
+    rawWriter.writeSlabs(
+        [&sampleFunction](const glm::uvec3& outCoord) {
+            return sampleFunction(glm::ivec3(outCoord));
+        },
+        prepareSlab,
+        0,
+        onProgress
+    );
 }
 
 documentation::Documentation MilkywayConversionTask::Documentation() {
@@ -25,20 +25,68 @@
 #include <modules/galaxy/tasks/milkywaypointsconversiontask.h>
 
 #include <openspace/documentation/documentation.h>
-
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
-#include <iostream>
+#include <future>
+#include <iterator>
+#include <string_view>
+#include <thread>
 #include <vector>
 
-namespace openspace {
+namespace {
+    constexpr std::string_view _loggerCat = "MilkywayPointsConversionTask";
+
+    constexpr std::string_view KeyInFilename = "InFilename";
+    constexpr std::string_view KeyOutFilename = "OutFilename";
+
+    // Each point consists of a position (x, y, z) and a color (r, g, b, a)
+    constexpr size_t NFloatsPerPoint = 7;
+
+    // The minimum number of points that is worth handing to a separate parsing thread
+    constexpr size_t MinPointsPerThread = 4096;
+
+    // How often the calling thread reports the progress while the workers are running
+    constexpr std::chrono::milliseconds ProgressInterval = std::chrono::milliseconds(100);
+
+    // Parses the values of a single point from the `line` into `values`. The line has to
+    // be followed by a null-terminated string, which is the case for all lines that are
+    // views into the same std::string
+    bool parsePoint(std::string_view line, float* values) {
+        const char* current = line.data();
+        const char* end = line.data() + line.size();
+        for (size_t i = 0; i < NFloatsPerPoint; i++) {
+            char* next = nullptr;
+            values[i] = std::strtof(current, &next);
+            // Leading whitespace is skipped, which might include the end of the line
+            if (next == current || next > end) {
+                return false;
+            }
+            current = next;
+        }
+        return true;
+    }
+} // namespace
 
-/*MilkywayPointsConversionTask::MilkywayPointsConversionTask(
-    const std::string& inFilename,
-    const std::string& outFilename)
-    : _inFilename(inFilename)
-    , _outFilename(outFilename) {}*/
+namespace openspace {
 
-MilkywayPointsConversionTask::MilkywayPointsConversionTask(const ghoul::Dictionary&) {}
+MilkywayPointsConversionTask::MilkywayPointsConversionTask(
+                                                      const ghoul::Dictionary& dictionary)
+{
+    if (dictionary.hasKey(KeyInFilename)) {
+        _inFilename = dictionary.value<std::string>(KeyInFilename);
+    }
+    if (dictionary.hasKey(KeyOutFilename)) {
+        _outFilename = dictionary.value<std::string>(KeyOutFilename);
+    }
+}
 
 std::string MilkywayPointsConversionTask::description() {
     return std::string();
@@ -46,48 +94,108 @@ std::string MilkywayPointsConversionTask::description() {
 
 void MilkywayPointsConversionTask::perform(const Task::ProgressCallback& progressCallback)
 {
-    std::ifstream in(_inFilename, std::ios::in);
-    std::ofstream out(_outFilename, std::ios::out | std::ios::binary);
+    std::ifstream in(_inFilename, std::ios::in | std::ios::binary);
+    if (!in.good()) {
+        LERROR(fmt::format("Failed to open input file {}", _inFilename));
+        return;
+    }
+    const std::string text = std::string(
+        std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>()
+    );
+    in.close();
 
-    std::string format;
-    int64_t nPoints;
-    in >> format >> nPoints;
-
-    size_t nFloats = nPoints * 7;
-
-    std::vector<float> pointData(nFloats);
-
-    float x;
-    float y;
-    float z;
-    float r;
-    float g;
-    float b;
-    float a;
-
-    for (int64_t i = 0; i < nPoints; ++i) {
-        in >> x >> y >> z >> r >> g >> b >> a;
-        if (in.good()) {
-            pointData[i * 7 + 0] = x;
-            pointData[i * 7 + 1] = y;
-            pointData[i * 7 + 2] = z;
-            pointData[i * 7 + 3] = r;
-            pointData[i * 7 + 4] = g;
-            pointData[i * 7 + 5] = b;
-            pointData[i * 7 + 6] = a;
-            progressCallback(static_cast<float>(i + 1) / nPoints);
+    // The header consists of the format followed by the number of points
+    const char* current = text.c_str();
+    auto skipWhitespace = [&current]() {
+        while (*current != '\0' && std::isspace(static_cast<unsigned char>(*current))) {
+            current++;
         }
-        else {
-            std::cout << "Failed to convert point data";
-            return;
+    };
+    skipWhitespace();
+    while (*current != '\0' && !std::isspace(static_cast<unsigned char>(*current))) {
+        current++;
+    }
+    char* headerEnd = nullptr;
+    const int64_t nPoints = std::strtoll(current, &headerEnd, 10);
+    if (headerEnd == current || nPoints < 0) {
+        LERROR(fmt::format("Failed to read the number of points in {}", _inFilename));
+        return;
+    }
+
+    // Every point is stored on a separate line
+    std::vector<std::string_view> lines;
+    lines.reserve(static_cast<size_t>(nPoints));
+    std::string_view remaining = std::string_view(headerEnd);
+    while (!remaining.empty() && lines.size() < static_cast<size_t>(nPoints)) {
+        const size_t lineEnd = std::min(remaining.find('\n'), remaining.size());
+        std::string_view line = remaining.substr(0, lineEnd);
+        const bool isEmpty = std::all_of(
+            line.begin(), line.end(),
+            [](char c) { return std::isspace(static_cast<unsigned char>(c)); }
+        );
+        if (!isEmpty) {
+            lines.push_back(line);
         }
+        remaining.remove_prefix(std::min(lineEnd + 1, remaining.size()));
+    }
+    if (lines.size() != static_cast<size_t>(nPoints)) {
+        LERROR("Failed to convert point data");
+        return;
     }
 
-    out.write(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
-    out.write(reinterpret_cast<char*>(pointData.data()), nFloats * sizeof(float));
+    std::vector<float> pointData(lines.size() * NFloatsPerPoint);
 
-    in.close();
+    // The points are parsed in contiguous ranges on separate threads
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t nChunks = std::clamp<size_t>(
+        lines.size() / MinPointsPerThread,
+        1,
+        nThreads
+    );
+    std::atomic<size_t> nParsed = 0;
+    auto parseRange = [&lines, &pointData, &nParsed](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!parsePoint(lines[i], &pointData[i * NFloatsPerPoint])) {
+                return false;
+            }
+            nParsed++;
+        }
+        return true;
+    };
+
+    std::vector<std::future<bool>> workers;
+    for (size_t chunk = 0; chunk < nChunks; chunk++) {
+        workers.push_back(std::async(
+            std::launch::async,
+            parseRange,
+            lines.size() * chunk / nChunks,
+            lines.size() * (chunk + 1) / nChunks
+        ));
+    }
+
+    bool success = true;
+    for (std::future<bool>& worker : workers) {
+        while (worker.wait_for(ProgressInterval) != std::future_status::ready) {
+            const float parsed = static_cast<float>(nParsed);
+            progressCallback(parsed / static_cast<float>(lines.size()));
+        }
+        success &= worker.get();
+    }
+    if (!success) {
+        LERROR("Failed to convert point data");
+        return;
+    }
+
+    std::ofstream out(_outFilename, std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&nPoints), sizeof(int64_t));
+    out.write(
+        reinterpret_cast<const char*>(pointData.data()),
+        pointData.size() * sizeof(float)
+    );
     out.close();
+
+    progressCallback(1.f);
 }
 
 documentation::Documentation MilkywayPointsConversionTask::Documentation() {
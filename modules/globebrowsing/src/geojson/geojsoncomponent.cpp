@@ -39,6 +39,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <filesystem>
@@ -58,6 +59,11 @@ namespace {
     constexpr std::string_view KeyName = "Name";
     constexpr std::string_view KeyDesc = "Description";
 
+    // The time per frame that is spent on adding newly parsed features and on
+    // recomputing the geometry and heights of features. Work that doesn't fit into this
+    // budget is postponed to the next frame
+    constexpr std::chrono::milliseconds UpdateBudget(4);
+
     constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
         "Enabled",
         "Enabled",
@@ -383,7 +389,7 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
 
     _forceUpdateHeightData.onChange([this]() {
         for (GlobeGeometryFeature& f : _geometryFeatures) {
-            f.updateHeightsFromHeightMap();
+            f.setHeightsDirty();
         }
     });
     addProperty(_forceUpdateHeightData);
@@ -420,7 +426,18 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
     _deletePropertyOwner.addProperty(_deleteThisComponent);
     addPropertySubOwner(_deletePropertyOwner);
 
-    readFile();
+    // Parsing and triangulating large files can take a long time, so it is done on a
+    // worker thread and the resulting features are added in the update function
+    _parsingResult = std::async(
+        std::launch::async,
+        [input = ParseInput {
+            .globe = _globeNode,
+            .defaultProperties = _defaultProperties,
+            .identifier = identifier(),
+            .file = p.file,
+            .ignoreHeightsFromFile = _ignoreHeightsFromFile
+        }]() { return readFile(input); }
+    );
 
     if (p.lightSources.has_value()) {
         std::vector<ghoul::Dictionary> lightsources = *p.lightSources;
@@ -448,7 +465,13 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
     addPropertySubOwner(_featuresPropertyOwner);
 }
 
-GeoJsonComponent::~GeoJsonComponent() {}
+GeoJsonComponent::~GeoJsonComponent() {
+    // The worker thread accesses the globe and the default properties, so we have to
+    // wait for it to finish before they are destroyed
+    if (_parsingResult.valid()) {
+        _parsingResult.wait();
+    }
+}
 
 bool GeoJsonComponent::enabled() const {
     return _enabled;
@@ -562,43 +585,67 @@ void GeoJsonComponent::render(const RenderData& data) {
 }
 
 void GeoJsonComponent::update() {
+    ZoneScoped;
+
+    using namespace std::chrono;
+    const steady_clock::time_point deadline = steady_clock::now() + UpdateBudget;
+
+    activateParsedFeatures(deadline);
+
+    if (_dataIsDirty || _heightOffsetIsDirty) {
+        // Update all features, including the disabled ones, so that they are up to date
+        // once they are enabled
+        const glm::vec3 offsets = glm::vec3(_latLongOffset.value(), _heightOffset);
+        for (GlobeGeometryFeature& g : _geometryFeatures) {
+            g.setOffsets(offsets);
+            if (_dataIsDirty) {
+                g.setGeometryDirty();
+            }
+        }
+        _dataIsDirty = false;
+        _heightOffsetIsDirty = false;
+    }
+
     if (!_enabled || !isVisible()) {
         return;
     }
 
-    glm::vec3 offsets = glm::vec3(_latLongOffset.value(), _heightOffset);
-
     for (size_t i = 0; i < _geometryFeatures.size(); ++i) {
         if (!_features[i]->enabled) {
             continue;
         }
         GlobeGeometryFeature& g = _geometryFeatures[i];
 
-        if (_dataIsDirty || _heightOffsetIsDirty) {
-            g.setOffsets(offsets);
-        }
-
         if (_textureIsDirty) {
             g.updateTexture();
         }
 
-        g.update(_dataIsDirty, _preventUpdatesFromHeightMap);
+        // Only the features whose geometry or heights are out of date are recomputed,
+        // and the work is spread over multiple frames if it doesn't fit in the budget
+        const bool hasTimeLeft = steady_clock::now() < deadline;
+        if (hasTimeLeft && g.hasPendingUpdate(_preventUpdatesFromHeightMap)) {
+            g.recompute();
+        }
+
+        g.update();
     }
 
     _textureIsDirty = false;
-    _dataIsDirty = false;
 }
 
-void GeoJsonComponent::readFile() {
-    std::ifstream file(_geoJsonFile);
+std::vector<GeoJsonComponent::ParsedFeature> GeoJsonComponent::readFile(
+                                                                  const ParseInput& input)
+{
+    ZoneScoped;
 
+    std::vector<ParsedFeature> result;
+
+    std::ifstream file(input.file);
     if (!file.good()) {
-        LERROR(fmt::format("Failed to open GeoJSON file: {}", _geoJsonFile.value()));
-        return;
+        LERROR(fmt::format("Failed to open GeoJSON file: {}", input.file));
+        return result;
     }
 
-    _geometryFeatures.clear();
-
     std::string content(
         (std::istreambuf_iterator<char>(file)),
         (std::istreambuf_iterator<char>())
@@ -613,31 +660,25 @@ void GeoJsonComponent::readFile() {
 
         int count = 1;
         for (const GeoJSONFeature& feature : fc.getFeatures()) {
-            parseSingleFeature(feature, count);
+            parseSingleFeature(input, feature, count, result);
             count++;
         }
-
-        if (_geometryFeatures.empty()) {
-            LWARNING(fmt::format(
-                "No GeoJson features could be successfully created for GeoJson layer "
-                "with identifier '{}'. Disabling layer.", identifier()
-            ));
-            _enabled = false;
-        }
     }
     catch (const geos::util::GEOSException& e) {
         LERROR(fmt::format(
             "Error creating GeoJson layer with identifier '{}'. Problem reading "
-            "GeoJson file '{}'. Error: '{}'", identifier(), _geoJsonFile.value(), e.what()
+            "GeoJson file '{}'. Error: '{}'", input.identifier, input.file, e.what()
         ));
     }
 
-    computeMainFeatureMetaPropeties();
+    return result;
 }
 
-void GeoJsonComponent::parseSingleFeature(const geos::io::GeoJSONFeature& feature,
-                                          int indexInFile
-) {
+void GeoJsonComponent::parseSingleFeature(const ParseInput& input,
+                                          const geos::io::GeoJSONFeature& feature,
+                                          int indexInFile,
+                                          std::vector<ParsedFeature>& result)
+{
     // Read the geometry
     const geos::geom::Geometry* geom = feature.getGeometry();
 
@@ -649,7 +690,7 @@ void GeoJsonComponent::parseSingleFeature(const geos::io::GeoJSONFeature& featur
         // Null geometry => no geometries to add
         LWARNING(fmt::format(
             "Feature {} in GeoJson file '{}' is a null geometry and will not be loaded",
-            indexInFile, _geoJsonFile.value()
+            indexInFile, input.file
         ));
         // @TODO (emmbr26) We should eventually support features with null geometry
     }
@@ -671,38 +712,52 @@ void GeoJsonComponent::parseSingleFeature(const geos::io::GeoJSONFeature& featur
     // Split other collection features into multiple individual rendered components
 
     for (const geos::geom::Geometry* geometry : geomsToAdd) {
-        const int index = static_cast<int>(_geometryFeatures.size());
+        const int index = static_cast<int>(result.size());
         try {
-            GlobeGeometryFeature g(_globeNode, _defaultProperties, propsFromFile);
-            g.createFromSingleGeosGeometry(geometry, index, _ignoreHeightsFromFile);
-            g.initializeGL(_pointsProgram.get(), _linesAndPolygonsProgram.get());
-            _geometryFeatures.push_back(std::move(g));
-
-            std::string name = _geometryFeatures.back().key();
-            std::string identifier = makeIdentifier(name);
-
-            // If there is already an owner with that name as an identifier, make a
-            // unique one
-            if (_featuresPropertyOwner.hasPropertySubOwner(identifier)) {
-                identifier = fmt::format("Feature{}-", index, identifier);
+            GlobeGeometryFeature g(input.globe, input.defaultProperties, propsFromFile);
+            g.createFromSingleGeosGeometry(geometry, index, input.ignoreHeightsFromFile);
+
+            ParsedFeature parsed = { .feature = std::move(g) };
+
+            std::unique_ptr<geos::geom::Point> centroid = geometry->getCentroid();
+            // Using `auto` here as on MacOS `getCoordinate` returns:
+            // geos::geom::Coordinate
+            // but on Windows it returns
+            // geos::geom::CoordinateXY
+            auto centroidCoord = *centroid->getCoordinate();
+            parsed.centroidLatLong = glm::vec2(centroidCoord.y, centroidCoord.x);
+
+            std::unique_ptr<geos::geom::Geometry> boundingbox = geometry->getEnvelope();
+            std::unique_ptr<geos::geom::CoordinateSequence> coords =
+                boundingbox->getCoordinates();
+            if (boundingbox->isRectangle()) {
+                // A rectangle has 5 coordinates, where the first and third are two
+                // corners
+                parsed.boundingboxLatLong = glm::vec4(
+                    (*coords)[0].y,
+                    (*coords)[0].x,
+                    (*coords)[2].y,
+                    (*coords)[2].x
+                );
+            }
+            else {
+                // Invalid boundingbox. Can happen e.g. for single points.
+                // Just add a degree to every direction from the centroid
+                parsed.boundingboxLatLong = glm::vec4(
+                    parsed.centroidLatLong.x - 1.f,
+                    parsed.centroidLatLong.y - 1.f,
+                    parsed.centroidLatLong.x + 1.f,
+                    parsed.centroidLatLong.y + 1.f
+                );
             }
 
-            properties::PropertyOwner::PropertyOwnerInfo info = {
-                identifier,
-                name
-                // @TODO: Use description from file, if any
-            };
-            _features.push_back(std::make_unique<SubFeatureProps>(info));
-
-            addMetaPropertiesToFeature(*_features.back(), index, geometry);
-
-            _featuresPropertyOwner.addPropertySubOwner(_features.back().get());
+            result.push_back(std::move(parsed));
         }
         catch (const ghoul::RuntimeError& error) {
             LERROR(fmt::format(
                 "Error creating GeoJson layer with identifier '{}'. Problem reading "
                 "feature {} in GeoJson file '{}'.",
-                identifier(), indexInFile, _geoJsonFile.value()
+                input.identifier, indexInFile, input.file
             ));
             LERRORC(error.component, error.message);
             // Do nothing
@@ -710,42 +765,87 @@ void GeoJsonComponent::parseSingleFeature(const geos::io::GeoJSONFeature& featur
     }
 }
 
-void GeoJsonComponent::addMetaPropertiesToFeature(SubFeatureProps& feature, int index,
-                                                  const geos::geom::Geometry* geometry)
+void GeoJsonComponent::activateParsedFeatures(
+                                     std::chrono::steady_clock::time_point deadline)
 {
-    std::unique_ptr<geos::geom::Point> centroid = geometry->getCentroid();
-    // Using `auto` here as on MacOS `getCoordinate` returns:
-    // geos::geom::Coordinate
-    // but on Windows it returns
-    // geos::geom::CoordinateXY
-    auto centroidCoord = *centroid->getCoordinate();
-    glm::vec2 centroidLatLong = glm::vec2(centroidCoord.y, centroidCoord.x);
-    feature.centroidLatLong = centroidLatLong;
-
-    std::unique_ptr<geos::geom::Geometry> boundingbox = geometry->getEnvelope();
-    std::unique_ptr<geos::geom::CoordinateSequence> coords =
-        boundingbox->getCoordinates();
-    glm::vec4 boundingboxLatLong;
-    if (boundingbox->isRectangle()) {
-        // A rectangle has 5 coordinates, where the first and third are two corners
-        boundingboxLatLong = glm::vec4(
-            (*coords)[0].y,
-            (*coords)[0].x,
-            (*coords)[2].y,
-            (*coords)[2].x
-        );
+    if (_parsingResult.valid()) {
+        using namespace std::chrono_literals;
+        if (_parsingResult.wait_for(0s) != std::future_status::ready) {
+            return;
+        }
+
+        _parsedFeatures = _parsingResult.get();
+        _nActivatedParsedFeatures = 0;
+
+        if (_parsedFeatures.empty()) {
+            LWARNING(fmt::format(
+                "No GeoJson features could be successfully created for GeoJson layer "
+                "with identifier '{}'. Disabling layer.", identifier()
+            ));
+            _enabled = false;
+        }
     }
-    else {
-        // Invalid boundingbox. Can happen e.g. for single points.
-        // Just add a degree to every direction from the centroid
-        boundingboxLatLong = glm::vec4(
-            centroidLatLong.x - 1.f,
-            centroidLatLong.y - 1.f,
-            centroidLatLong.x + 1.f,
-            centroidLatLong.y + 1.f
+
+    // The features can only be initialized once the programs have been created
+    if (_nActivatedParsedFeatures == _parsedFeatures.size() ||
+        !_linesAndPolygonsProgram || !_pointsProgram)
+    {
+        return;
+    }
+
+    const glm::vec3 offsets = glm::vec3(_latLongOffset.value(), _heightOffset);
+
+    // Always activate at least one feature per frame to guarantee progress
+    do {
+        ParsedFeature& parsed = _parsedFeatures[_nActivatedParsedFeatures];
+        _nActivatedParsedFeatures++;
+
+        const int index = static_cast<int>(_geometryFeatures.size());
+        GlobeGeometryFeature& g = _geometryFeatures.emplace_back(
+            std::move(parsed.feature)
         );
+        g.initializeGL(_pointsProgram.get(), _linesAndPolygonsProgram.get());
+        g.setOffsets(offsets);
+
+        std::string name = g.key();
+        std::string identifier = makeIdentifier(name);
+
+        // If there is already an owner with that name as an identifier, make a
+        // unique one
+        if (_featuresPropertyOwner.hasPropertySubOwner(identifier)) {
+            identifier = fmt::format("Feature{}-", index, identifier);
+        }
+
+        properties::PropertyOwner::PropertyOwnerInfo info = {
+            identifier,
+            name
+            // @TODO: Use description from file, if any
+        };
+        _features.push_back(std::make_unique<SubFeatureProps>(info));
+
+        addMetaPropertiesToFeature(*_features.back(), index, parsed);
+
+        _featuresPropertyOwner.addPropertySubOwner(_features.back().get());
+    } while (_nActivatedParsedFeatures < _parsedFeatures.size() &&
+             std::chrono::steady_clock::now() < deadline);
+
+    if (_nActivatedParsedFeatures == _parsedFeatures.size()) {
+        // All features have been moved out, so we can release the remaining storage
+        _parsedFeatures.clear();
+        _parsedFeatures.shrink_to_fit();
+        _nActivatedParsedFeatures = 0;
+
+        // The meta properties depend on all features, so they are only computed once
+        // the last one has been added
+        computeMainFeatureMetaPropeties();
     }
+}
 
+void GeoJsonComponent::addMetaPropertiesToFeature(SubFeatureProps& feature, int index,
+                                                  const ParsedFeature& parsedFeature)
+{
+    feature.centroidLatLong = parsedFeature.centroidLatLong;
+    const glm::vec4 boundingboxLatLong = parsedFeature.boundingboxLatLong;
     feature.boundingboxLatLong = boundingboxLatLong;
 
     // Compute the diagonal distance of the bounding box
@@ -42,7 +42,11 @@
 #include <openspace/rendering/helper.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/glm.h>
+#include <chrono>
+#include <filesystem>
+#include <future>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace openspace {
@@ -97,15 +101,54 @@ private:
         float boundingBoxDiagonal = 0.f;
     };
 
-    void readFile();
-    void parseSingleFeature(const geos::io::GeoJSONFeature& feature, int indexInFile);
+    /**
+     * A single geometry from the GeoJson file that has been parsed and triangulated on a
+     * worker thread, but which has not been added to the component yet
+     */
+    struct ParsedFeature {
+        GlobeGeometryFeature feature;
+        glm::vec2 centroidLatLong = glm::vec2(0.f);
+        glm::vec4 boundingboxLatLong = glm::vec4(0.f);
+    };
+
+    /**
+     * The values of the component that are needed to parse the GeoJson file. They are
+     * copied when the parsing starts so that the worker thread does not read the
+     * properties of the component while they might be changed
+     */
+    struct ParseInput {
+        /// The features only keep references to the globe and the default properties
+        /// and do not read them while they are being parsed
+        RenderableGlobe& globe;
+        GeoJsonProperties& defaultProperties;
+
+        std::string identifier;
+        std::filesystem::path file;
+        bool ignoreHeightsFromFile = false;
+    };
+
+    /**
+     * Reads and parses the GeoJson file and triangulates all of its features. This
+     * function is executed on a worker thread and only uses the provided \p input.
+     */
+    static std::vector<ParsedFeature> readFile(const ParseInput& input);
+    static void parseSingleFeature(const ParseInput& input,
+        const geos::io::GeoJSONFeature& feature, int indexInFile,
+        std::vector<ParsedFeature>& result);
+
+    /**
+     * Adds the features that have finished parsing to the component. To not stall the
+     * rendering for files with many features, the features are only added until the
+     * \p deadline has passed and the remaining ones are added in later frames
+     */
+    void activateParsedFeatures(std::chrono::steady_clock::time_point deadline);
 
     /**
      * Add meta properties to the feature, to allow things like flying to it,
      * identifying its location, etc
      */
     void addMetaPropertiesToFeature(SubFeatureProps& feature, int index,
-        const geos::geom::Geometry* geometry);
+        const ParsedFeature& parsedFeature);
 
     void computeMainFeatureMetaPropeties();
 
@@ -119,6 +162,10 @@ private:
 
     std::vector<GlobeGeometryFeature> _geometryFeatures;
 
+    std::future<std::vector<ParsedFeature>> _parsingResult;
+    std::vector<ParsedFeature> _parsedFeatures;
+    size_t _nActivatedParsedFeatures = 0;
+
     properties::BoolProperty _enabled;
     properties::StringProperty _geoJsonFile;
     properties::FloatProperty _heightOffset;
@@ -508,14 +508,36 @@ bool GlobeGeometryFeature::shouldUpdateDueToHeightMapChange() const {
     return false;
 }
 
-void GlobeGeometryFeature::update(bool dataIsDirty, bool preventHeightUpdates) {
-    if (!preventHeightUpdates && shouldUpdateDueToHeightMapChange()) {
-        updateHeightsFromHeightMap();
+void GlobeGeometryFeature::setGeometryDirty() {
+    _isGeometryDirty = true;
+}
+
+void GlobeGeometryFeature::setHeightsDirty() {
+    _areHeightsDirty = true;
+}
+
+bool GlobeGeometryFeature::hasPendingUpdate(bool preventHeightUpdates) {
+    if (_isGeometryDirty) {
+        // The heights are sampled as part of creating the geometry
+        return true;
+    }
+
+    if (!_areHeightsDirty && !preventHeightUpdates) {
+        _areHeightsDirty = shouldUpdateDueToHeightMapChange();
     }
-    else if (dataIsDirty) {
+    return _areHeightsDirty;
+}
+
+void GlobeGeometryFeature::recompute() {
+    if (_isGeometryDirty) {
         updateGeometry();
     }
+    else if (_areHeightsDirty) {
+        updateHeightsFromHeightMap();
+    }
+}
 
+void GlobeGeometryFeature::update() {
     if (_pointTexture) {
         _pointTexture->update();
     }
@@ -536,10 +558,12 @@ void GlobeGeometryFeature::updateGeometry() {
 
     // Compute new heights - to see if height map changed
     _lastControlHeights = getCurrentReferencePointsHeights();
+
+    _isGeometryDirty = false;
+    _areHeightsDirty = false;
 }
 
 void GlobeGeometryFeature::updateHeightsFromHeightMap() {
-    // @TODO: do the updating piece by piece, not all in one frame
     for (RenderFeature& f : _renderFeatures) {
         f.heights = geometryhelper::heightMapHeightsFromGeodetic2List(
             _globe,
@@ -548,7 +572,9 @@ void GlobeGeometryFeature::updateHeightsFromHeightMap() {
         bufferDynamicHeightData(f);
     }
 
+    _lastControlHeights = getCurrentReferencePointsHeights();
     _lastHeightUpdateTime = std::chrono::system_clock::now();
+    _areHeightsDirty = false;
 }
 
 std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
@@ -135,11 +135,32 @@ public:
 
     bool shouldUpdateDueToHeightMapChange() const;
 
-    void update(bool dataIsDirty, bool preventHeightUpdates);
+    /// Marks the geometry of this feature to be recreated in the next #recompute call
+    void setGeometryDirty();
+
+    /// Marks the heights of this feature to be resampled in the next #recompute call
+    void setHeightsDirty();
+
+    /**
+     * Returns `true` if the geometry or the heights of this feature have to be
+     * recomputed. Unless \p preventHeightUpdates is `true`, this also checks whether
+     * the height map below the feature has changed and marks the heights as dirty if it
+     * has.
+     */
+    bool hasPendingUpdate(bool preventHeightUpdates);
+
+    /**
+     * Recreates the geometry of the feature if it is dirty, or otherwise resamples the
+     * heights from the height map if they are dirty
+     */
+    void recompute();
+
+    void update();
+
+private:
     void updateGeometry();
     void updateHeightsFromHeightMap();
 
-private:
     void renderPoints(const RenderFeature& feature, const RenderData& renderData,
         const PointRenderMode& renderMode, float sizeScale) const;
 
@@ -210,6 +231,9 @@ private:
     std::vector<double> _lastControlHeights;
     std::chrono::system_clock::time_point _lastHeightUpdateTime;
 
+    bool _isGeometryDirty = true;
+    bool _areHeightsDirty = false;
+
     bool _hasTexture = false;
     std::unique_ptr<TextureComponent> _pointTexture;
 
@@ -30,8 +30,13 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/dictionary.h>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <future>
+#include <thread>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -56,6 +61,16 @@
 namespace {
     constexpr std::string_view _loggerCat = "KameleonVolumeReader";
 
+    // The side length of the bricks in which the volume is resampled. Consecutive
+    // samples inside a brick are close to each other in the model grid, which makes the
+    // interpolators' cell lookups cheap, and the rows of a brick are short enough to
+    // stay in the cache
+    constexpr unsigned int BrickSize = 16;
+
+    // How often the calling thread reports the progress while it waits for the workers
+    // after running out of bricks of its own
+    constexpr std::chrono::milliseconds ProgressInterval = std::chrono::milliseconds(100);
+
     template <typename T>
     T globalAttribute(ccmc::Model&, const std::string&) {
         static_assert(sizeof(T) == 0);
@@ -76,7 +91,10 @@ namespace {
 
 namespace openspace::kameleonvolume {
 
-KameleonVolumeReader::KameleonVolumeReader(std::string path) : _path(std::move(path)) {
+KameleonVolumeReader::KameleonVolumeReader(std::string path)
+    : _path(std::move(path))
+    , _kameleon(std::make_unique<ccmc::Kameleon>())
+{
     if (!std::filesystem::is_regular_file(_path)) {
         throw ghoul::FileNotFoundError(_path);
     }
@@ -99,7 +117,9 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                             const glm::uvec3 & dimensions,
                                                               const std::string& variable,
                                                         const glm::vec3& lowerDomainBound,
-                                                  const glm::vec3& upperDomainBound) const
+                                                        const glm::vec3& upperDomainBound,
+                                                                    unsigned int nThreads,
+                                          const ProgressCallback& progressCallback) const
 {
     float min, max;
     return readFloatVolume(
@@ -108,7 +128,9 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
         lowerDomainBound,
         upperDomainBound,
         min,
-        max
+        max,
+        nThreads,
+        progressCallback
     );
 }
 
@@ -118,30 +140,163 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                               const glm::vec3& lowerBound,
                                                               const glm::vec3& upperBound,
                                                                           float& minValue,
-                                                                    float& maxValue) const
+                                                                          float& maxValue,
+                                                                    unsigned int nThreads,
+                                          const ProgressCallback& progressCallback) const
 {
-    minValue = std::numeric_limits<float>::max();
-    maxValue = -std::numeric_limits<float>::max();
+    const glm::uvec3 nBricks = (dimensions + glm::uvec3(BrickSize - 1)) / BrickSize;
+    const size_t nTotalBricks = static_cast<size_t>(nBricks.x) * nBricks.y * nBricks.z;
+
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    nThreads = static_cast<unsigned int>(
+        std::min<size_t>(nThreads, std::max<size_t>(nTotalBricks, 1))
+    );
+
+    // The variable has to be loaded before the workers start, as loading it lazily from
+    // inside the interpolators would modify the model concurrently
+    _kameleon->loadVariable(variable);
+
+    // A model and its interpolators are not safe to share between threads, so every
+    // worker opens its own Kameleon object and creates its interpolator from that. The
+    // files are opened and the variable loaded here, one at a time, before any worker
+    // starts. If a file cannot be opened, the remaining bricks are left to the threads
+    // that already have one
+    std::vector<std::unique_ptr<ccmc::Kameleon>> kameleons;
+    std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators;
+    for (unsigned int i = 1; i < nThreads; i++) {
+        auto kameleon = std::make_unique<ccmc::Kameleon>();
+        if (kameleon->open(_path) != ccmc::FileReader::OK) {
+            LERROR(fmt::format(
+                "Failed to open file '{}' for worker thread {}", _path, i
+            ));
+            break;
+        }
+        kameleon->loadVariable(variable);
+        interpolators.emplace_back(kameleon->model->createNewInterpolator());
+        kameleons.push_back(std::move(kameleon));
+    }
+
+    auto sampler = [&variable](ccmc::Interpolator& interpolator) {
+        return [&variable, &interpolator](const glm::vec3& p) {
+            return interpolator.interpolate(variable, p.x, p.y, p.z);
+        };
+    };
+    std::vector<Sampler> samplers = { sampler(*_interpolator) };
+    for (std::unique_ptr<ccmc::Interpolator>& interpolator : interpolators) {
+        samplers.push_back(sampler(*interpolator));
+    }
+
+    return resampleVolume(
+        dimensions,
+        lowerBound,
+        upperBound,
+        samplers,
+        minValue,
+        maxValue,
+        progressCallback
+    );
+}
+
+std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::resampleVolume(
+                                                             const glm::uvec3& dimensions,
+                                                              const glm::vec3& lowerBound,
+                                                              const glm::vec3& upperBound,
+                                                     const std::vector<Sampler>& samplers,
+                                                                          float& minValue,
+                                                                          float& maxValue,
+                                                 const ProgressCallback& progressCallback)
+{
+    ghoul_precondition(!samplers.empty(), "At least one sampler must be provided");
 
     auto volume = std::make_unique<volume::RawVolume<float>>(dimensions);
 
     const glm::vec3 dims = volume->dimensions();
     const glm::vec3 diff = upperBound - lowerBound;
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
+    const glm::uvec3 nBricks = (dimensions + glm::uvec3(BrickSize - 1)) / BrickSize;
+    const size_t nTotalBricks = static_cast<size_t>(nBricks.x) * nBricks.y * nBricks.z;
+
+    struct Range {
+        float min = std::numeric_limits<float>::max();
+        float max = -std::numeric_limits<float>::max();
     };
 
+    std::atomic<size_t> nextBrick = 0;
+    std::atomic<size_t> nFinishedBricks = 0;
     float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); ++index) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+    auto reportProgress = [&]() {
+        const float nFinished = static_cast<float>(nFinishedBricks);
+        progressCallback(nFinished / static_cast<float>(nTotalBricks));
+    };
+    auto resample = [&](const Sampler& sampler, bool isReporting) {
+        Range range;
+        for (size_t b = nextBrick++; b < nTotalBricks; b = nextBrick++) {
+            const glm::uvec3 brick = glm::uvec3(
+                b % nBricks.x,
+                (b / nBricks.x) % nBricks.y,
+                b / (static_cast<size_t>(nBricks.x) * nBricks.y)
+            );
+            const glm::uvec3 begin = brick * BrickSize;
+            const glm::uvec3 end = glm::min(begin + BrickSize, dimensions);
+
+            for (unsigned int z = begin.z; z < end.z; z++) {
+                for (unsigned int y = begin.y; y < end.y; y++) {
+                    for (unsigned int x = begin.x; x < end.x; x++) {
+                        const glm::uvec3 voxel = glm::uvec3(x, y, z);
+                        const size_t index = volume->coordsToIndex(voxel);
+                        const glm::vec3 coords = voxel;
+                        const glm::vec3 coordsZeroToOne = coords / dims;
+                        const glm::vec3 volumeCoords =
+                            lowerBound + diff * coordsZeroToOne;
+
+                        data[index] = sampler(volumeCoords);
+
+                        range.min = glm::min(range.min, data[index]);
+                        range.max = glm::max(range.max, data[index]);
+                    }
+                }
+            }
+            nFinishedBricks++;
+            if (isReporting) {
+                reportProgress();
+            }
+        }
+        return range;
+    };
 
-        data[index] = interpolate(variable, volumeCoords);
+    std::vector<std::future<Range>> workers;
+    for (size_t i = 1; i < samplers.size(); i++) {
+        workers.push_back(
+            std::async(std::launch::async, resample, std::cref(samplers[i]), false)
+        );
+    }
+
+    // The first sampler always runs on the calling thread, which reports the progress
+    // of all workers after each of its own bricks
+    const bool isReporting = static_cast<bool>(progressCallback);
+    std::vector<Range> ranges = { resample(samplers[0], isReporting) };
+    for (std::future<Range>& worker : workers) {
+        if (isReporting) {
+            while (worker.wait_for(ProgressInterval) != std::future_status::ready) {
+                reportProgress();
+            }
+        }
+        ranges.push_back(worker.get());
+    }
+
+    // Taking the minimum and maximum is independent of the order, so the result is the
+    // same as when the voxels are visited serially
+    minValue = std::numeric_limits<float>::max();
+    maxValue = -std::numeric_limits<float>::max();
+    for (const Range& range : ranges) {
+        minValue = glm::min(minValue, range.min);
+        maxValue = glm::max(maxValue, range.max);
+    }
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
+    if (progressCallback) {
+        progressCallback(1.f);
     }
 
     return volume;
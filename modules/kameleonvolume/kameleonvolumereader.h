@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMEREADER___H__
 
 #include <ghoul/glm.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,17 +44,49 @@ namespace openspace::kameleonvolume {
 
 class KameleonVolumeReader {
 public:
+    /// Called with the fraction of voxels in [0, 1] that have been resampled so far
+    using ProgressCallback = std::function<void(float)>;
+    /// Returns the value of the resampled variable at the provided model coordinates
+    using Sampler = std::function<float(const glm::vec3&)>;
+
     KameleonVolumeReader(std::string path);
     ~KameleonVolumeReader();
 
+    /**
+     * Resamples the \p variable onto a regular grid with the provided \p dimensions
+     * that spans the domain between \p lowerDomainBound and \p upperDomainBound.
+     *
+     * The volume is divided into bricks that are resampled on \p nThreads threads, each
+     * with its own Kameleon object and interpolator. A value of 0 uses all available
+     * hardware threads. Each voxel is computed exactly as it would be serially, so the
+     * result does not depend on the number of threads. The \p progressCallback, if
+     * provided, is only called from the calling thread.
+     */
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
-        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound) const;
+        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound,
+        unsigned int nThreads = 0,
+        const ProgressCallback& progressCallback = ProgressCallback()) const;
 
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
-        float& maxValue) const;
+        float& maxValue, unsigned int nThreads = 0,
+        const ProgressCallback& progressCallback = ProgressCallback()) const;
+
+    /**
+     * Resamples a volume with the provided \p dimensions that spans the domain between
+     * \p lowerBound and \p upperBound in bricks. The bricks are distributed to one
+     * thread per sampler in \p samplers, where the first sampler is used on the calling
+     * thread. Every sampler is only ever called from a single thread, so it can keep
+     * state that is not safe to share. This is the implementation of readFloatVolume
+     * and does not depend on a CDF file.
+     */
+    static std::unique_ptr<volume::RawVolume<float>> resampleVolume(
+        const glm::uvec3& dimensions, const glm::vec3& lowerBound,
+        const glm::vec3& upperBound, const std::vector<Sampler>& samplers,
+        float& minValue, float& maxValue,
+        const ProgressCallback& progressCallback = ProgressCallback());
 
     ghoul::Dictionary readMetaData() const;
 
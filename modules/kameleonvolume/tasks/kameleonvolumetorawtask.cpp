@@ -123,14 +123,17 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         );
     }
 
+    // Resampling the volume is by far the most expensive part of the task
     std::unique_ptr<volume::RawVolume<float>> rawVolume = reader.readFloatVolume(
         _dimensions,
         _variable,
         _lowerDomainBound,
-        _upperDomainBound
+        _upperDomainBound,
+        0,
+        [&progressCallback](float progress) { progressCallback(0.8f * progress); }
     );
 
-    progressCallback(0.5f);
+    progressCallback(0.8f);
 
     volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath.string());
     writer.write(*rawVolume);
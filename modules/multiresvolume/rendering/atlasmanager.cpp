@@ -26,13 +26,35 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/texture.h>
+#include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+
+namespace {
+    constexpr std::string_view _loggerCat = "AtlasManager";
+
+    // Persistently mapped buffers are only available from OpenGL 4.4
+    constexpr ghoul::systemcapabilities::Version PersistentMappingVersion = {
+        .major = 4,
+        .minor = 4,
+        .release = 0
+    };
+} // namespace
 
 namespace openspace {
 
 AtlasManager::AtlasManager(TSP* tsp) : _tsp(tsp) {}
 
+AtlasManager::~AtlasManager() {
+    if (_streaming.valid()) {
+        _streaming.wait();
+    }
+}
+
 bool AtlasManager::initialize() {
     TSP::Header header = _tsp->header();
 
@@ -47,6 +69,7 @@ bool AtlasManager::initialize() {
     _brickSize = _nBrickVals * sizeof(float);
     _volumeSize = _brickSize * _nOtLeaves;
     _atlasMap = std::vector<unsigned int>(_nOtLeaves, NotUsedIndex);
+    _brickMap = std::vector<unsigned int>(_tsp->numTotalNodes(), NotUsedIndex);
     _nBricksInAtlas = _nBricksInMap;
 
     _freeAtlasCoords = std::vector<unsigned int>(_nBricksInAtlas, 0);
@@ -55,7 +78,7 @@ bool AtlasManager::initialize() {
         _freeAtlasCoords[i] = i;
     }
 
-    _textureAtlas = new ghoul::opengl::Texture(
+    _textureAtlas = std::make_unique<ghoul::opengl::Texture>(
         glm::size3_t(_atlasDim, _atlasDim, _atlasDim),
         GL_TEXTURE_3D,
         ghoul::opengl::Texture::Format::RGBA,
@@ -64,7 +87,36 @@ bool AtlasManager::initialize() {
     );
     _textureAtlas->uploadTexture();
 
-    glGenBuffers(2, _pboHandle);
+    // A single request can never contain more bricks than fit into the atlas, so each
+    // staging buffer has the size of the atlas
+    _usePersistentMapping = OpenGLCap.openGLVersion() >= PersistentMappingVersion;
+    glGenBuffers(2, _stagingBuffers.data());
+    for (size_t i = 0; i < _stagingBuffers.size(); i++) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[i]);
+        if (_usePersistentMapping) {
+            glBufferStorage(
+                GL_PIXEL_UNPACK_BUFFER,
+                _volumeSize,
+                nullptr,
+                GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+            );
+            _stagingPointers[i] = reinterpret_cast<float*>(glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER,
+                0,
+                _volumeSize,
+                GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT
+            ));
+            if (!_stagingPointers[i]) {
+                LERROR("Failed to map staging buffer");
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return false;
+            }
+        }
+        else {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     glGenBuffers(1, &_atlasMapBuffer);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
@@ -79,6 +131,33 @@ bool AtlasManager::initialize() {
     return true;
 }
 
+void AtlasManager::deinitialize() {
+    if (_streaming.valid()) {
+        _streaming.wait();
+        _streaming = std::future<void>();
+    }
+
+    for (size_t i = 0; i < _stagingBuffers.size(); i++) {
+        if (_stagingFences[i]) {
+            glDeleteSync(_stagingFences[i]);
+            _stagingFences[i] = nullptr;
+        }
+        if (_stagingPointers[i]) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[i]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            _stagingPointers[i] = nullptr;
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(2, _stagingBuffers.data());
+    _stagingBuffers = { 0, 0 };
+
+    glDeleteBuffers(1, &_atlasMapBuffer);
+    _atlasMapBuffer = 0;
+
+    _textureAtlas = nullptr;
+}
+
 const std::vector<unsigned int>& AtlasManager::atlasMap() const {
     return _atlasMap;
 }
@@ -87,65 +166,124 @@ unsigned int AtlasManager::atlasMapBuffer() const {
     return _atlasMapBuffer;
 }
 
-void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices) {
-    size_t nBrickIndices = brickIndices.size();
+void AtlasManager::updateAtlas(const std::vector<int>& brickIndices) {
+    ZoneScoped;
 
-    _requiredBricks.clear();
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _requiredBricks.insert(brickIndices[i]);
+    using namespace std::chrono_literals;
+    if (_streaming.valid() && _streaming.wait_for(0s) == std::future_status::ready) {
+        finishRequest();
     }
 
-    for (unsigned int it : _prevRequiredBricks) {
-        if (!_requiredBricks.count(it)) {
-            removeFromAtlas(it);
-        }
+    if (brickIndices == _requestedBrickIndices) {
+        return;
     }
 
-    // Stats
-    _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
-    _nStreamedBricks = 0;
-    _nDiskReads = 0;
-
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
-    float* mappedBuffer = reinterpret_cast<float*>(
-        glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)
-    );
+    // The latency is measured from the first time a new selection is seen, even if it
+    // can only be requested once a previous request has finished
+    if (!_selectionChangeTime.has_value()) {
+        _selectionChangeTime = std::chrono::steady_clock::now();
+    }
+
+    if (!_streaming.valid()) {
+        startRequest(brickIndices);
+    }
+}
 
-    if (!mappedBuffer) {
-        LERRORC("AtlasManager", "Failed to map PBO");
+void AtlasManager::startRequest(const std::vector<int>& brickIndices) {
+    ZoneScoped;
+
+    // A request never contains more bricks than fit into the atlas, so the staging
+    // buffer can be mapped before it is known how many bricks have to be streamed
+    const int stagingBuffer = _nextStagingBuffer;
+    float* staging = mapStagingBuffer(stagingBuffer);
+    if (!staging) {
+        LERROR("Failed to map PBO");
         return;
     }
+    _nextStagingBuffer = 1 - _nextStagingBuffer;
 
-    for (auto itStart = _requiredBricks.begin(); itStart != _requiredBricks.end();) {
-        int firstBrick = *itStart;
-        int lastBrick = firstBrick;
+    _requiredBricks.assign(brickIndices.begin(), brickIndices.end());
+    std::sort(_requiredBricks.begin(), _requiredBricks.end());
+    _requiredBricks.erase(
+        std::unique(_requiredBricks.begin(), _requiredBricks.end()),
+        _requiredBricks.end()
+    );
 
-        auto itEnd = itStart;
-        for (itEnd++;
-            itEnd != _requiredBricks.end() &&
-            *itEnd == static_cast<unsigned int>(lastBrick) + 1;
-            itEnd++)
-        {
-            lastBrick = *itEnd;
+    // Bricks that are no longer required free their space in the atlas. Their data is
+    // only overwritten in the same frame that the new atlas map is uploaded
+    std::vector<unsigned int> removedBricks;
+    std::set_difference(
+        _prevRequiredBricks.begin(), _prevRequiredBricks.end(),
+        _requiredBricks.begin(), _requiredBricks.end(),
+        std::back_inserter(removedBricks)
+    );
+    for (unsigned int brickIndex : removedBricks) {
+        const unsigned int atlasCoords = _brickMap[brickIndex] & 0x0FFFFFFF;
+        _freeAtlasCoords.push_back(atlasCoords);
+        _brickMap[brickIndex] = NotUsedIndex;
+    }
+
+    StreamRequest request;
+    request.nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
+    for (unsigned int brickIndex : _requiredBricks) {
+        if (_brickMap[brickIndex] != NotUsedIndex) {
+            continue;
         }
 
-        addToAtlas(firstBrick, lastBrick, mappedBuffer);
+        const unsigned int atlasCoords = _freeAtlasCoords.back();
+        _freeAtlasCoords.pop_back();
+        const int level = _nOtLevels - static_cast<int>(
+            floor(log1p((7.0 * (float(brickIndex % _nOtNodes))))/log(8)) - 1
+        );
+        ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
+        _brickMap[brickIndex] = (level << 28) + atlasCoords;
 
-        itStart = itEnd;
-    }
+        request.bricks.push_back(brickIndex);
+        request.atlasCoords.push_back(atlasCoords);
 
-    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        // Bricks that are consecutive in the file are read with a single copy
+        if (!request.ranges.empty() &&
+            request.ranges.back().lastBrick + 1 == brickIndex)
+        {
+            request.ranges.back().lastBrick = brickIndex;
+        }
+        else {
+            request.ranges.push_back({ brickIndex, brickIndex });
+        }
+    }
 
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _atlasMap[i] = _brickMap[brickIndices[i]];
+    request.atlasMap.resize(brickIndices.size());
+    for (size_t i = 0; i < brickIndices.size(); i++) {
+        request.atlasMap[i] = _brickMap[brickIndices[i]];
     }
 
     std::swap(_prevRequiredBricks, _requiredBricks);
+    _requestedBrickIndices = brickIndices;
+
+    request.requestTime = *_selectionChangeTime;
+    _selectionChangeTime = std::nullopt;
+
+    request.stagingBuffer = stagingBuffer;
+
+    _request = std::move(request);
+    _streaming = std::async(
+        std::launch::async,
+        &AtlasManager::streamBricks,
+        std::cref(*_tsp),
+        _request.ranges,
+        _nBrickVals,
+        staging
+    );
+}
+
+void AtlasManager::finishRequest() {
+    ZoneScoped;
+
+    _streaming.get();
 
-    pboToAtlas(bufferIndex);
+    uploadBricks(_request);
 
+    _atlasMap = std::move(_request.atlasMap);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     GLint* to = reinterpret_cast<GLint*>(
         glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY)
@@ -153,105 +291,98 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
     memcpy(to, _atlasMap.data(), sizeof(GLint)*_atlasMap.size());
     glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
 
-void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
-                              float* mappedBuffer)
-{
-    while (_brickMap.count(firstBrickIndex) && firstBrickIndex <= lastBrickIndex) {
-        firstBrickIndex++;
-    }
-    while (_brickMap.count(lastBrickIndex) && lastBrickIndex >= firstBrickIndex) {
-        lastBrickIndex--;
-    }
-    if (lastBrickIndex < firstBrickIndex) {
-        return;
-    }
+    // Stats
+    _nUsedBricks = _request.nUsedBricks;
+    _nStreamedBricks = static_cast<unsigned int>(_request.bricks.size());
+    _nDiskReads = static_cast<unsigned int>(_request.ranges.size());
+    _brickLatency = std::chrono::steady_clock::now() - _request.requestTime;
 
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
-
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) *
-                       static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
-
-    for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
-        if (!_brickMap.count(brickIndex)) {
-            unsigned int atlasCoords = _freeAtlasCoords.back();
-            _freeAtlasCoords.pop_back();
-            int level = _nOtLevels - static_cast<int>(
-                floor(log1p((7.0 * (float(brickIndex % _nOtNodes))))/log(8)) - 1
-            );
-            ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
-            unsigned int atlasData = (level << 28) + atlasCoords;
-            _brickMap.emplace(brickIndex, atlasData);
-            _nStreamedBricks++;
-            fillVolume(
-                &sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)],
-                mappedBuffer,
-                atlasCoords
+    _request = StreamRequest();
+}
+
+float* AtlasManager::mapStagingBuffer(int index) {
+    if (_usePersistentMapping) {
+        // The buffer stays mapped, but the GPU might still read from it
+        if (_stagingFences[index]) {
+            glClientWaitSync(
+                _stagingFences[index],
+                GL_SYNC_FLUSH_COMMANDS_BIT,
+                std::numeric_limits<GLuint64>::max()
             );
+            glDeleteSync(_stagingFences[index]);
+            _stagingFences[index] = nullptr;
         }
+        return _stagingPointers[index];
+    }
+    else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[index]);
+        float* mapped = reinterpret_cast<float*>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER,
+            0,
+            _volumeSize,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+        ));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return mapped;
     }
-
-    delete[] sequenceBuffer;
 }
 
-void AtlasManager::removeFromAtlas(int brickIndex) {
-    unsigned int atlasData = _brickMap[brickIndex];
-    unsigned int atlasCoords = atlasData & 0x0FFFFFFF;
-    _brickMap.erase(brickIndex);
-    _freeAtlasCoords.push_back(atlasCoords);
-}
+void AtlasManager::uploadBricks(const StreamRequest& request) {
+    const int index = request.stagingBuffer;
+    const size_t size = request.bricks.size() * _brickSize;
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
-    int x = linearAtlasCoords % _nBricksPerDim;
-    int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
-    int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
-
-    unsigned int xMin = x*_paddedBrickDim;
-    unsigned int yMin = y*_paddedBrickDim;
-    unsigned int zMin = z*_paddedBrickDim;
-    unsigned int xMax = xMin + _paddedBrickDim;
-    unsigned int yMax = yMin + _paddedBrickDim;
-    unsigned int zMax = zMin + _paddedBrickDim;
-
-    unsigned int from = 0;
-    for (unsigned int zValCoord = zMin; zValCoord<zMax; ++zValCoord) {
-        for (unsigned int yValCoord = yMin; yValCoord<yMax; ++yValCoord) {
-            for (unsigned int xValCoord = xMin; xValCoord<xMax; ++xValCoord) {
-                unsigned int idx = xValCoord + yValCoord * _atlasDim +
-                                   zValCoord * _atlasDim * _atlasDim;
-
-                out[idx] = in[from];
-                from++;
-            }
-        }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[index]);
+    if (_usePersistentMapping) {
+        glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size);
+    }
+    else {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
     }
-}
 
-void AtlasManager::pboToAtlas(BufferIndex bufferIndex) {
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glm::size3_t dim = _textureAtlas->dimensions();
+    // Only the new bricks are uploaded instead of the entire atlas
     glBindTexture(GL_TEXTURE_3D, *_textureAtlas);
-    glTexSubImage3D(
-        GL_TEXTURE_3D,
-        0,
-        0,
-        0,
-        0,
-        static_cast<GLsizei>(dim[0]),
-        static_cast<GLsizei>(dim[1]),
-        static_cast<GLsizei>(dim[2]),
-        GL_RED,
-        GL_FLOAT,
-        nullptr
-    );
+    for (size_t i = 0; i < request.bricks.size(); i++) {
+        const unsigned int linearAtlasCoords = request.atlasCoords[i];
+        const int x = linearAtlasCoords % _nBricksPerDim;
+        const int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
+        const int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
+
+        const size_t offset = i * _brickSize;
+        glTexSubImage3D(
+            GL_TEXTURE_3D,
+            0,
+            x * _paddedBrickDim,
+            y * _paddedBrickDim,
+            z * _paddedBrickDim,
+            _paddedBrickDim,
+            _paddedBrickDim,
+            _paddedBrickDim,
+            GL_RED,
+            GL_FLOAT,
+            reinterpret_cast<const void*>(offset)
+        );
+    }
     glBindTexture(GL_TEXTURE_3D, 0);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (_usePersistentMapping) {
+        _stagingFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void AtlasManager::streamBricks(const TSP& tsp, std::vector<ReadRange> ranges,
+                                size_t nBrickVals, float* staging)
+{
+    ZoneScoped;
+
+    // The bricks are written to the staging buffer in file order, so every range of
+    // consecutive bricks becomes a single sequential copy out of the mapped file
+    for (const ReadRange& range : ranges) {
+        const size_t nValues = (range.lastBrick - range.firstBrick + 1) * nBrickVals;
+        std::memcpy(staging, tsp.brickData(range.firstBrick), nValues * sizeof(float));
+        staging += nValues;
+    }
 }
 
 ghoul::opengl::Texture& AtlasManager::textureAtlas() {
@@ -271,6 +402,10 @@ unsigned int AtlasManager::numStreamedBricks() const {
     return _nStreamedBricks;
 }
 
+std::chrono::duration<double> AtlasManager::brickLatency() const {
+    return _brickLatency;
+}
+
 glm::size3_t AtlasManager::textureSize() const {
     return _textureAtlas->dimensions();
 }
@@ -26,10 +26,14 @@
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 
 #include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
 #include <glm/gtx/std_based_type.hpp>
-#include <map>
-#include <set>
-#include <string>
+#include <array>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace ghoul::opengl { class Texture; }
@@ -40,49 +44,100 @@ class TSP;
 
 class AtlasManager {
 public:
-    enum BufferIndex {
-        EVEN = 0,
-        ODD = 1
-    };
-
     AtlasManager(TSP* tsp);
-    ~AtlasManager() = default;
+    ~AtlasManager();
 
-    void updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices);
-    void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
-    void removeFromAtlas(int brickIndex);
     bool initialize();
+    void deinitialize();
+
+    /**
+     * Requests the bricks in \p brickIndices, which contains one brick index per octree
+     * leaf, to be shown. Bricks that are not yet in the atlas are read from the memory
+     * mapped TSP file on a background thread. The atlas and the atlas map are only
+     * updated once all bricks of a request are available, so the previous selection is
+     * shown until then. If the selection changes while a request is in flight, the
+     * newest selection is requested as soon as that request has finished.
+     */
+    void updateAtlas(const std::vector<int>& brickIndices);
     const std::vector<unsigned int>& atlasMap() const;
     unsigned int atlasMapBuffer() const;
 
-    void pboToAtlas(BufferIndex bufferIndex);
     ghoul::opengl::Texture& textureAtlas();
 
     unsigned int numDiskReads() const;
     unsigned int numUsedBricks() const;
     unsigned int numStreamedBricks() const;
 
+    /**
+     * Returns the time between a brick selection first being passed to #updateAtlas and
+     * all of its bricks being available in the atlas for the most recently finished
+     * request.
+     */
+    std::chrono::duration<double> brickLatency() const;
+
     glm::size3_t textureSize() const;
 
 private:
+    /// A range of bricks that are stored consecutively in the TSP file
+    struct ReadRange {
+        unsigned int firstBrick = 0;
+        unsigned int lastBrick = 0;
+    };
+
+    struct StreamRequest {
+        /// The bricks that have to be streamed, sorted by their index in the file
+        std::vector<unsigned int> bricks;
+        /// The linear atlas coordinates for each of the streamed bricks
+        std::vector<unsigned int> atlasCoords;
+        std::vector<ReadRange> ranges;
+        /// The atlas map that becomes valid once all bricks have been uploaded
+        std::vector<unsigned int> atlasMap;
+        unsigned int nUsedBricks = 0;
+        int stagingBuffer = 0;
+        std::chrono::steady_clock::time_point requestTime;
+    };
+
+    void startRequest(const std::vector<int>& brickIndices);
+    void finishRequest();
+    float* mapStagingBuffer(int index);
+    void uploadBricks(const StreamRequest& request);
+
+    static void streamBricks(const TSP& tsp, std::vector<ReadRange> ranges,
+        size_t nBrickVals, float* staging);
+
     const unsigned int NotUsedIndex = std::numeric_limits<unsigned int>::max();
 
     TSP* _tsp;
-    unsigned int _pboHandle[2];
-    unsigned int _atlasMapBuffer;
+    unsigned int _atlasMapBuffer = 0;
+
+    // The staging buffers are used alternately so that a new request can be filled
+    // while the previous request might still be read by the GPU
+    std::array<GLuint, 2> _stagingBuffers = { 0, 0 };
+    std::array<float*, 2> _stagingPointers = { nullptr, nullptr };
+    std::array<GLsync, 2> _stagingFences = { nullptr, nullptr };
+    bool _usePersistentMapping = false;
+    int _nextStagingBuffer = 0;
 
     std::vector<unsigned int> _atlasMap;
-    std::map<unsigned int, unsigned int> _brickMap;
+    /// The atlas data for every brick in the TSP, or NotUsedIndex if it is not in the
+    /// atlas
+    std::vector<unsigned int> _brickMap;
     std::vector<unsigned int> _freeAtlasCoords;
-    std::set<unsigned int> _requiredBricks;
-    std::set<unsigned int> _prevRequiredBricks;
+    std::vector<unsigned int> _requiredBricks;
+    std::vector<unsigned int> _prevRequiredBricks;
+
+    std::vector<int> _requestedBrickIndices;
+    std::optional<std::chrono::steady_clock::time_point> _selectionChangeTime;
+    StreamRequest _request;
+    std::future<void> _streaming;
 
-    ghoul::opengl::Texture* _textureAtlas;
+    std::unique_ptr<ghoul::opengl::Texture> _textureAtlas;
 
     // Stats
-    unsigned int _nUsedBricks;
-    unsigned int _nStreamedBricks;
-    unsigned int _nDiskReads;
+    unsigned int _nUsedBricks = 0;
+    unsigned int _nStreamedBricks = 0;
+    unsigned int _nDiskReads = 0;
+    std::chrono::duration<double> _brickLatency = std::chrono::duration<double>(0.0);
 
     unsigned int _nBricksPerDim;
     unsigned int _nOtLeaves;
@@ -95,8 +150,6 @@ private:
     unsigned int _nBricksInAtlas;
     unsigned int _nBricksInMap;
     unsigned int _atlasDim;
-
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
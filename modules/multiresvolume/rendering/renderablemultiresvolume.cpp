@@ -458,6 +458,10 @@ void RenderableMultiresVolume::initializeGL() {
 }
 
 void RenderableMultiresVolume::deinitializeGL() {
+    // The atlas manager might still be streaming bricks out of the TSP file
+    if (_atlasManager) {
+        _atlasManager->deinitialize();
+    }
     _tsp = nullptr;
     _transferFunction = nullptr;
 }
@@ -655,7 +659,8 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             << _uploadDuration.count() << " "
             << _nUsedBricks << " "
             << _nStreamedBricks << " "
-            << _nDiskReads;
+            << _nDiskReads << " "
+            << _brickLatency.count();
 
         ofs.close();
 
@@ -723,7 +728,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             uploadStart = selectionEnd;
         }
 
-        _atlasManager->updateAtlas(AtlasManager::EVEN, _brickIndices);
+        _atlasManager->updateAtlas(_brickIndices);
 
         if (_gatheringStats) {
             std::chrono::system_clock::time_point uploadEnd =
@@ -732,6 +737,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             _nDiskReads = _atlasManager->numDiskReads();
             _nUsedBricks = _atlasManager->numUsedBricks();
             _nStreamedBricks = _atlasManager->numStreamedBricks();
+            _brickLatency = _atlasManager->brickLatency();
         }
     }
 
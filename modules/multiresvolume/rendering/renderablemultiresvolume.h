@@ -111,6 +111,7 @@ private:
     std::chrono::system_clock::time_point _frameStart;
     std::chrono::duration<double> _selectionDuration;
     std::chrono::duration<double> _uploadDuration;
+    std::chrono::duration<double> _brickLatency;
     unsigned int _nDiskReads;
     unsigned int _nUsedBricks;
     unsigned int _nStreamedBricks;
@@ -24,12 +24,15 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
 #include <filesystem>
 #include <numeric>
 #include <queue>
@@ -58,6 +61,26 @@ bool TSP::load() {
         return false;
     }
 
+    try {
+        _mappedFile = std::make_unique<MemoryMappedFile>(_filename);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Could not map TSP file: {}", e.message));
+        return false;
+    }
+
+    const size_t brickSize =
+        static_cast<size_t>(_paddedBrickDim) * _paddedBrickDim * _paddedBrickDim;
+    const size_t requiredSize =
+        dataPosition() + static_cast<size_t>(_numTotalNodes) * brickSize * sizeof(float);
+    if (_mappedFile->size() < requiredSize) {
+        LERROR(fmt::format(
+            "TSP file {} is too small, expected {} bytes but got {}",
+            _filename, requiredSize, _mappedFile->size()
+        ));
+        return false;
+    }
+
     if (readCache()) {
         LINFO("Using cache");
     }
@@ -226,6 +249,16 @@ std::ifstream& TSP::file() {
     return _file;
 }
 
+const float* TSP::brickData(unsigned int brickIndex) const {
+    ghoul_assert(_mappedFile, "TSP file has not been loaded");
+    ghoul_assert(brickIndex < _numTotalNodes, "Brick index out of range");
+
+    const size_t brickSize =
+        static_cast<size_t>(_paddedBrickDim) * _paddedBrickDim * _paddedBrickDim;
+    const std::byte* data = _mappedFile->data() + dataPosition();
+    return reinterpret_cast<const float*>(data) + brickIndex * brickSize;
+}
+
 unsigned int TSP::numTotalNodes() const {
     return _numTotalNodes;
 }
@@ -28,11 +28,14 @@
 #include <ghoul/opengl/ghoul_gl.h>
 #include <fstream>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace openspace {
 
+class MemoryMappedFile;
+
 class TSP {
 public:
     struct Header {
@@ -71,6 +74,14 @@ public:
     const Header& header() const;
     static long long dataPosition();
     std::ifstream& file();
+
+    /**
+     * Returns a pointer to the voxel data of the brick with the provided \p brickIndex
+     * in the memory mapped TSP file. The data of consecutive bricks is stored
+     * consecutively, so the returned pointer can be used to access a range of bricks.
+     * This function is thread-safe and only valid after a successful call to #load.
+     */
+    const float* brickData(unsigned int brickIndex) const;
     unsigned int numTotalNodes() const;
     unsigned int numValuesPerNode() const;
     unsigned int numBSTNodes() const;
@@ -110,6 +121,7 @@ private:
 
     std::string _filename;
     std::ifstream _file;
+    std::unique_ptr<MemoryMappedFile> _mappedFile;
     std::streampos _dataOffset;
 
     // Holds the actual structure
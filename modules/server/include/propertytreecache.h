@@ -0,0 +1,150 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___PROPERTYTREECACHE___H__
+#define __OPENSPACE_MODULE_SERVER___PROPERTYTREECACHE___H__
+
+#include <openspace/json.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace openspace::properties { class PropertyOwner; }
+
+namespace openspace {
+
+/**
+ * This class keeps a JSON representation of the property tree that is updated
+ * incrementally from the main thread. The tree is stored as immutable Nodes that are
+ * shared between consecutive snapshots, so a snapshot that was retrieved through the
+ * #snapshot function can be serialized on any thread without touching the
+ * PropertyOwners it was created from.
+ *
+ * The structure of the tree (added or removed Propertys and sub-owners) is tracked
+ * through the PropertyOwner's structure versions, so that only the owners that have
+ * changed are serialized again. The values of the Propertys in the subtrees that are
+ * requested are refreshed when they are requested. All other values are prewarmed in a
+ * round-robin fashion with a fixed budget of Propertys per frame.
+ */
+class PropertyTreeCache {
+public:
+    struct Node {
+        /// The identifier of the PropertyOwner this Node represents
+        std::string identifier;
+        /// The JSON representation of the owner without its sub-owners
+        nlohmann::json data;
+        /// The Nodes of all sub-owners
+        std::vector<std::shared_ptr<const Node>> children;
+
+        /// The cache version in which this Node first appeared
+        uint64_t createdVersion = 0;
+        /// The cache version in which the data or the list of children last changed
+        uint64_t version = 0;
+        /// The highest #version of this Node or any Node in its subtree
+        uint64_t subtreeVersion = 0;
+
+        // Bookkeeping that is only accessed from the thread calling #update
+        const properties::PropertyOwner* owner = nullptr;
+        uint64_t ownerStructureVersion = 0;
+        uint64_t ownerSubtreeVersion = 0;
+    };
+
+    /**
+     * Brings the cached tree up to date with the \p root PropertyOwner. This function
+     * has to be called from the thread that modifies the property tree. The first call
+     * builds the entire tree, subsequent calls only serialize changed owners.
+     *
+     * \param root The PropertyOwner that is the root of the cached tree
+     * \param refreshedSubtrees The dot-separated URIs, relative to \p root, of subtrees
+     *        whose Property values are all refreshed in this call. An empty URI refers
+     *        to \p root itself. Values in all other subtrees might lag behind
+     */
+    void update(const properties::PropertyOwner& root,
+        const std::vector<std::string>& refreshedSubtrees = {});
+
+    /**
+     * Returns whether the cache has been requested at least once. Until then, #update
+     * does not perform any work.
+     */
+    bool isActive() const;
+
+    /**
+     * Marks the cache as being in use, which causes the following calls to #update to
+     * keep the tree up to date.
+     */
+    void activate();
+
+    /**
+     * Returns the most recent snapshot of the tree. This function is thread-safe.
+     */
+    std::shared_ptr<const Node> snapshot() const;
+
+    /**
+     * Returns the Node with the dot-separated \p uri relative to \p root or `nullptr`
+     * if no such Node exists. An empty \p uri returns \p root.
+     */
+    static const Node* find(const Node& root, std::string_view uri);
+
+    /**
+     * Returns the full JSON representation of the \p node and all of its children, in
+     * the same format that is used for serializing a PropertyOwner.
+     */
+    static nlohmann::json toJson(const Node& node);
+
+    /**
+     * Returns a list of all changes in the subtree of \p node that happened after the
+     * \p version. Each entry contains the `uri` of the changed owner and the `owner`
+     * itself. If the owner was added after \p version, `full` is `true` and the owner
+     * contains its entire subtree. Otherwise, the owner's `subowners` only list the
+     * identifiers of the current sub-owners, which can be used to detect removals.
+     */
+    static nlohmann::json changesSince(const Node& node, uint64_t version,
+        const std::string& uri);
+
+private:
+    std::shared_ptr<const Node> updateNode(const properties::PropertyOwner& owner,
+        std::shared_ptr<const Node> old);
+
+    bool _isActive = false;
+    uint64_t _version = 0;
+
+    /// Owners in the order in which their values are refreshed
+    std::vector<const properties::PropertyOwner*> _refreshOrder;
+    size_t _refreshCursor = 0;
+    /// The owners whose values are refreshed in the current call to #update
+    std::unordered_set<const properties::PropertyOwner*> _refreshOwners;
+    /// The refreshed owners and all of their owners
+    std::unordered_set<const properties::PropertyOwner*> _refreshPaths;
+
+    std::shared_ptr<const Node> _root;
+    mutable std::mutex _mutex;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___PROPERTYTREECACHE___H__
@@ -38,7 +38,12 @@ public:
     bool isDone() const override;
 
 private:
-    nlohmann::json allProperties();
+    /**
+     * Sends the cached property tree. The \p json can contain a `subtree` URI to only
+     * request a part of the tree and a `sinceVersion` to only request the owners that
+     * changed after the version that was returned in a previous response.
+     */
+    void sendAllProperties(const nlohmann::json& json);
     nlohmann::json propertyFromKey(const std::string& key);
 };
 
@@ -49,6 +49,7 @@ namespace openspace {
 ServerModule::ServerModule()
     : OpenSpaceModule(ServerModule::Name)
     , _interfaceOwner({"Interfaces", "Interfaces", "Server Interfaces"})
+    , _jobPool(1)
 {
     addPropertySubOwner(_interfaceOwner);
 
@@ -168,6 +169,9 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Keep the cached property tree up to date for the clients that requested it
+    _propertyTreeCache.update(*global::rootPropertyOwner);
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -258,4 +262,12 @@ void ServerModule::removePreSyncCallback(CallbackHandle handle) {
     _preSyncCallbacks.erase(it);
 }
 
+PropertyTreeCache& ServerModule::propertyTreeCache() {
+    return _propertyTreeCache;
+}
+
+void ServerModule::enqueueJob(std::function<void()> job) {
+    _jobPool.enqueue(std::move(job));
+}
+
 } // namespace openspace
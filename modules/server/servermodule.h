@@ -27,7 +27,9 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/server/include/propertytreecache.h>
 #include <modules/server/include/serverinterface.h>
+#include <openspace/util/threadpool.h>
 
 #include <deque>
 #include <memory>
@@ -62,6 +64,14 @@ public:
     CallbackHandle addPreSyncCallback(CallbackFunction cb);
     void removePreSyncCallback(CallbackHandle handle);
 
+    PropertyTreeCache& propertyTreeCache();
+
+    /**
+     * Enqueues the \p job to be executed on the server's worker thread. This is used for
+     * work that does not need to access the scene, such as serializing large responses.
+     */
+    void enqueueJob(std::function<void()> job);
+
 protected:
     void internalInitialize(const ghoul::Dictionary& configuration) override;
 
@@ -88,6 +98,9 @@ private:
     // Callbacks for tiggering topic
     int _nextCallbackHandle = 0;
     std::vector<std::pair<CallbackHandle, CallbackFunction>> _preSyncCallbacks;
+
+    PropertyTreeCache _propertyTreeCache;
+    ThreadPool _jobPool;
 };
 
 } // namespace openspace
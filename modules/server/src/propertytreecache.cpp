@@ -0,0 +1,314 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/propertytreecache.h>
+
+#include <modules/server/include/jsonconverters.h>
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+    // The number of Property values that are refreshed in the background in every call
+    // to update. Requested subtrees are always refreshed completely
+    constexpr size_t ValueRefreshBudget = 250;
+
+    nlohmann::json shallowJson(const openspace::properties::PropertyOwner& owner) {
+        return {
+            { "identifier", owner.identifier() },
+            { "guiName", owner.guiName() },
+            { "description", owner.description() },
+            { "properties", owner.properties() },
+            { "tag", owner.tags() }
+        };
+    }
+
+    void collectOwners(const openspace::properties::PropertyOwner& owner,
+                       std::vector<const openspace::properties::PropertyOwner*>& res)
+    {
+        res.push_back(&owner);
+        for (const openspace::properties::PropertyOwner* o : owner.propertySubOwners()) {
+            collectOwners(*o, res);
+        }
+    }
+
+    using openspace::properties::PropertyOwner;
+
+    const PropertyOwner* findOwner(const PropertyOwner& root, std::string_view uri) {
+        const PropertyOwner* owner = &root;
+        while (owner && !uri.empty()) {
+            const size_t separator = uri.find(PropertyOwner::URISeparator);
+            owner = owner->propertySubOwner(std::string(uri.substr(0, separator)));
+            uri = separator == std::string_view::npos ?
+                std::string_view() :
+                uri.substr(separator + 1);
+        }
+        return owner;
+    }
+} // namespace
+
+namespace openspace {
+
+bool PropertyTreeCache::isActive() const {
+    return _isActive;
+}
+
+void PropertyTreeCache::activate() {
+    _isActive = true;
+}
+
+void PropertyTreeCache::update(const properties::PropertyOwner& root,
+                               const std::vector<std::string>& refreshedSubtrees)
+{
+    ZoneScoped;
+
+    if (!_isActive) {
+        return;
+    }
+
+    const bool structureChanged =
+        !_root || _root->owner != &root ||
+        _root->ownerSubtreeVersion != root.subtreeVersion();
+    if (structureChanged) {
+        // Owners might have been removed, so the refresh order has to be recreated from
+        // the current tree before any of the pointers can be used again
+        _refreshOrder.clear();
+        collectOwners(root, _refreshOrder);
+        _refreshCursor = std::min(_refreshCursor, _refreshOrder.size());
+    }
+
+    // Select the owners whose values are refreshed in this update. The requested
+    // subtrees are refreshed completely so that their values are current
+    _refreshOwners.clear();
+    _refreshPaths.clear();
+    auto markRefreshed = [this](const properties::PropertyOwner* owner) {
+        _refreshOwners.insert(owner);
+        for (const properties::PropertyOwner* o = owner; o; o = o->owner()) {
+            if (!_refreshPaths.insert(o).second) {
+                // The rest of the path has already been inserted
+                break;
+            }
+        }
+    };
+    for (const std::string& uri : refreshedSubtrees) {
+        const properties::PropertyOwner* subtree = findOwner(root, uri);
+        if (!subtree) {
+            continue;
+        }
+        std::vector<const properties::PropertyOwner*> owners;
+        collectOwners(*subtree, owners);
+        for (const properties::PropertyOwner* owner : owners) {
+            markRefreshed(owner);
+        }
+    }
+
+    // Values outside of the requested subtrees are prewarmed in a round-robin fashion,
+    // which keeps the work for the next request small
+    if (_root && !_refreshOrder.empty()) {
+        size_t nProperties = 0;
+        size_t nOwners = 0;
+        while (nProperties < ValueRefreshBudget && nOwners < _refreshOrder.size()) {
+            if (_refreshCursor >= _refreshOrder.size()) {
+                _refreshCursor = 0;
+            }
+            const properties::PropertyOwner* owner = _refreshOrder[_refreshCursor];
+            _refreshCursor++;
+            nOwners++;
+
+            if (owner->properties().empty() || _refreshOwners.contains(owner)) {
+                continue;
+            }
+            nProperties += owner->properties().size();
+            markRefreshed(owner);
+        }
+    }
+
+    std::shared_ptr<const Node> newRoot = updateNode(root, _root);
+    if (newRoot == _root) {
+        return;
+    }
+
+    _version = std::max(_version, newRoot->subtreeVersion);
+    std::lock_guard lock(_mutex);
+    _root = std::move(newRoot);
+}
+
+std::shared_ptr<const PropertyTreeCache::Node> PropertyTreeCache::updateNode(
+                                                  const properties::PropertyOwner& owner,
+                                                  std::shared_ptr<const Node> old)
+{
+    if (old && old->owner != &owner) {
+        old = nullptr;
+    }
+
+    const bool isUnchanged =
+        old && old->ownerSubtreeVersion == owner.subtreeVersion() &&
+        _refreshPaths.find(&owner) == _refreshPaths.end();
+    if (isUnchanged) {
+        // The Node is shared with the previous snapshot, which is safe as it is immutable
+        return old;
+    }
+
+    const uint64_t nextVersion = _version + 1;
+
+    auto node = std::make_shared<Node>();
+    node->identifier = owner.identifier();
+    node->owner = &owner;
+    node->ownerStructureVersion = owner.structureVersion();
+    node->ownerSubtreeVersion = owner.subtreeVersion();
+
+    // Update the children, reusing the old Nodes for sub-owners that already existed
+    std::unordered_map<
+        const properties::PropertyOwner*, std::shared_ptr<const Node>
+    > oldChildren;
+    if (old) {
+        for (const std::shared_ptr<const Node>& child : old->children) {
+            oldChildren[child->owner] = child;
+        }
+    }
+    const std::vector<properties::PropertyOwner*>& subOwners = owner.propertySubOwners();
+    node->children.reserve(subOwners.size());
+    for (const properties::PropertyOwner* subOwner : subOwners) {
+        auto it = oldChildren.find(subOwner);
+        std::shared_ptr<const Node> oldChild =
+            it != oldChildren.end() ? it->second : nullptr;
+        node->children.push_back(updateNode(*subOwner, std::move(oldChild)));
+    }
+
+    // Update the data of the owner itself
+    if (!old || old->ownerStructureVersion != owner.structureVersion()) {
+        node->data = shallowJson(owner);
+    }
+    else {
+        node->data = old->data;
+        if (_refreshOwners.find(&owner) != _refreshOwners.end()) {
+            const std::vector<properties::Property*>& props = owner.properties();
+            nlohmann::json& jsonProps = node->data["properties"];
+            for (size_t i = 0; i < props.size(); i++) {
+                jsonProps[i]["Value"] = nlohmann::json::parse(props[i]->jsonValue());
+            }
+        }
+    }
+
+    const bool childrenChanged =
+        !old ||
+        !std::equal(
+            node->children.begin(), node->children.end(),
+            old->children.begin(), old->children.end(),
+            [](const std::shared_ptr<const Node>& lhs,
+               const std::shared_ptr<const Node>& rhs) { return lhs == rhs; }
+        );
+    const bool dataChanged = !old || node->data != old->data;
+
+    node->createdVersion = old ? old->createdVersion : nextVersion;
+    node->version = (childrenChanged || dataChanged) ? nextVersion : old->version;
+    node->subtreeVersion = node->version;
+    for (const std::shared_ptr<const Node>& child : node->children) {
+        node->subtreeVersion = std::max(node->subtreeVersion, child->subtreeVersion);
+    }
+    return node;
+}
+
+std::shared_ptr<const PropertyTreeCache::Node> PropertyTreeCache::snapshot() const {
+    std::lock_guard lock(_mutex);
+    return _root;
+}
+
+const PropertyTreeCache::Node* PropertyTreeCache::find(const Node& root,
+                                                       std::string_view uri)
+{
+    const Node* node = &root;
+    while (node && !uri.empty()) {
+        const size_t separator = uri.find(properties::PropertyOwner::URISeparator);
+        const std::string_view identifier = uri.substr(0, separator);
+        uri = separator == std::string_view::npos ?
+            std::string_view() :
+            uri.substr(separator + 1);
+
+        auto it = std::find_if(
+            node->children.begin(),
+            node->children.end(),
+            [identifier](const std::shared_ptr<const Node>& child) {
+                return child->identifier == identifier;
+            }
+        );
+        node = it != node->children.end() ? it->get() : nullptr;
+    }
+    return node;
+}
+
+nlohmann::json PropertyTreeCache::toJson(const Node& node) {
+    nlohmann::json res = node.data;
+    nlohmann::json subowners = nlohmann::json::array();
+    for (const std::shared_ptr<const Node>& child : node.children) {
+        subowners.push_back(toJson(*child));
+    }
+    res["subowners"] = std::move(subowners);
+    return res;
+}
+
+nlohmann::json PropertyTreeCache::changesSince(const Node& node, uint64_t version,
+                                               const std::string& uri)
+{
+    nlohmann::json res = nlohmann::json::array();
+    if (node.subtreeVersion <= version) {
+        return res;
+    }
+
+    if (node.createdVersion > version) {
+        res.push_back({
+            { "uri", uri },
+            { "full", true },
+            { "owner", toJson(node) }
+        });
+        return res;
+    }
+
+    if (node.version > version) {
+        nlohmann::json owner = node.data;
+        nlohmann::json subowners = nlohmann::json::array();
+        for (const std::shared_ptr<const Node>& child : node.children) {
+            subowners.push_back(child->identifier);
+        }
+        owner["subowners"] = std::move(subowners);
+        res.push_back({
+            { "uri", uri },
+            { "full", false },
+            { "owner", std::move(owner) }
+        });
+    }
+
+    for (const std::shared_ptr<const Node>& child : node.children) {
+        const std::string childUri =
+            uri.empty() ? child->identifier : uri + '.' + child->identifier;
+        nlohmann::json c = changesSince(*child, version, childUri);
+        res.insert(res.end(), c.begin(), c.end());
+    }
+    return res;
+}
+
+} // namespace openspace
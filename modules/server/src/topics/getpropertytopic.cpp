@@ -24,10 +24,13 @@
 
 #include <modules/server/include/topics/getpropertytopic.h>
 
+#include <modules/server/servermodule.h>
 #include <modules/server/include/connection.h>
 #include <modules/server/include/jsonconverters.h>
+#include <modules/server/include/propertytreecache.h>
 #include <modules/volume/transferfunctionhandler.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/navigation/navigationhandler.h>
 #include <openspace/network/parallelpeer.h>
@@ -37,6 +40,8 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scene/scene.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <optional>
 
 using nlohmann::json;
 
@@ -47,6 +52,9 @@ namespace {
     constexpr std::string_view AllScreenSpaceRenderablesValue =
         "__screenSpaceRenderables";
     constexpr std::string_view RootPropertyOwner = "__rootOwner";
+
+    constexpr std::string_view SubtreeKey = "subtree";
+    constexpr std::string_view SinceVersionKey = "sinceVersion";
 } // namespace
 
 namespace openspace {
@@ -56,7 +64,8 @@ void GetPropertyTopic::handleJson(const nlohmann::json& json) {
     LDEBUG("Getting property '" + requestedKey + "'...");
     nlohmann::json response;
     if (requestedKey == AllPropertiesValue) {
-        response = allProperties();
+        sendAllProperties(json);
+        return;
     }
     else if (requestedKey == AllNodesValue) {
         response = wrappedPayload(sceneGraph()->allSceneGraphNodes());
@@ -79,19 +88,88 @@ bool GetPropertyTopic::isDone() const {
     return true;
 }
 
-json GetPropertyTopic::allProperties() {
-    json payload {
+void GetPropertyTopic::sendAllProperties(const nlohmann::json& json) {
+    std::string subtree;
+    if (auto it = json.find(SubtreeKey); it != json.end() && it->is_string()) {
+        subtree = it->get<std::string>();
+    }
+    std::optional<uint64_t> sinceVersion;
+    if (auto it = json.find(SinceVersionKey); it != json.end() && it->is_number()) {
+        sinceVersion = it->get<uint64_t>();
+    }
+
+    // Without a subtree, the response only contains the same owners that were part of
+    // the response before the cache was introduced
+    std::vector<std::string> owners;
+    if (subtree.empty() && !sinceVersion.has_value()) {
+        owners = {
+            global::renderEngine->identifier(),
+            global::luaConsole->identifier(),
+            global::parallelPeer->identifier(),
+            global::navigationHandler->identifier()
+        };
+    }
+
+    // The first request builds the entire tree. Every request refreshes the values of
+    // the owners it asks for, so that they are never served from a stale cache entry
+    ServerModule* module = global::moduleEngine->module<ServerModule>();
+    PropertyTreeCache& cache = module->propertyTreeCache();
+    cache.activate();
+    if (owners.empty()) {
+        cache.update(*global::rootPropertyOwner, { subtree });
+    }
+    else {
+        cache.update(*global::rootPropertyOwner, owners);
+    }
+    std::shared_ptr<const PropertyTreeCache::Node> root = cache.snapshot();
+
+    // The serialization of the snapshot does not touch any PropertyOwner, so it can be
+    // done without blocking the main thread
+    module->enqueueJob(
+        [connection = _connection, topicId = _topicId, root = std::move(root),
+         subtree = std::move(subtree), sinceVersion, owners = std::move(owners)]()
         {
-            "value",
-            {
-                global::renderEngine,
-                global::luaConsole,
-                global::parallelPeer,
-                global::navigationHandler
+            ZoneScopedN("GetPropertyTopic::sendAllProperties");
+            using Node = PropertyTreeCache::Node;
+
+            const Node* node = PropertyTreeCache::find(*root, subtree);
+            if (!node) {
+                connection->sendJson({
+                    { "topic", topicId },
+                    { "status", "error" },
+                    { "message", fmt::format("Subtree '{}' not found", subtree) },
+                    { "code", 404 }
+                });
+                return;
+            }
+
+            nlohmann::json value;
+            if (sinceVersion.has_value()) {
+                value = PropertyTreeCache::changesSince(*node, *sinceVersion, subtree);
+            }
+            else if (!owners.empty()) {
+                value = nlohmann::json::array();
+                for (const std::string& owner : owners) {
+                    if (const Node* n = PropertyTreeCache::find(*root, owner); n) {
+                        value.push_back(PropertyTreeCache::toJson(*n));
+                    }
+                }
             }
+            else {
+                value = PropertyTreeCache::toJson(*node);
+            }
+
+            connection->sendJson({
+                { "topic", topicId },
+                {
+                    "payload", {
+                        { "value", std::move(value) },
+                        { "version", root->subtreeVersion }
+                    }
+                }
+            });
         }
-    };
-    return wrappedPayload(payload);
+    );
 }
 
 json GetPropertyTopic::propertyFromKey(const std::string& key) {
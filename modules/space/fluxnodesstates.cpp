@@ -0,0 +1,240 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/fluxnodesstates.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+    constexpr std::string_view _loggerCat = "FluxNodesStates";
+
+    constexpr uint32_t CurrentVersion = 1;
+
+    // The size of the blocks in which the source files are copied
+    constexpr size_t BlockSize = 16 * 1024 * 1024;
+
+    struct Header {
+        uint32_t version = CurrentVersion;
+        uint32_t nNodesPerState = 0;
+        uint32_t nStates = 0;
+        uint32_t padding = 0;
+    };
+    static_assert(sizeof(Header) == 16, "Unexpected padding in the states header");
+
+    // The offsets are measured in bytes from the beginning of the file
+    struct StateOffsets {
+        uint64_t positions = 0;
+        uint64_t fluxes = 0;
+        uint64_t radii = 0;
+    };
+    static_assert(sizeof(StateOffsets) == 24, "Unexpected padding in the offset table");
+
+    const StateOffsets& offsetsAt(const std::byte* data, size_t index) {
+        // The table follows the 16 byte header, so it is correctly aligned as long as
+        // the mapped file is, which it always is as mappings start on a page
+        return reinterpret_cast<const StateOffsets*>(data + sizeof(Header))[index];
+    }
+
+    std::ifstream openSourceFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        if (!file.good()) {
+            throw ghoul::RuntimeError(fmt::format("Could not read file {}", path));
+        }
+        return file;
+    }
+
+    void copyColumn(std::ifstream& source, const std::filesystem::path& sourcePath,
+                    std::ofstream& destination, size_t nBytes)
+    {
+        std::vector<char> buffer(std::min(BlockSize, nBytes));
+        while (nBytes > 0) {
+            const size_t n = std::min(buffer.size(), nBytes);
+            source.read(buffer.data(), n);
+            if (static_cast<size_t>(source.gcount()) != n) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "File {} is too small for the number of states", sourcePath
+                ));
+            }
+            destination.write(buffer.data(), n);
+            nBytes -= n;
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+void FluxNodesStates::convert(const std::filesystem::path& positions,
+                              const std::filesystem::path& fluxes,
+                              const std::filesystem::path& radii,
+                              const std::filesystem::path& destination)
+{
+    ZoneScoped;
+
+    std::ifstream positionsFile = openSourceFile(positions);
+    std::ifstream fluxesFile = openSourceFile(fluxes);
+    std::ifstream radiiFile = openSourceFile(radii);
+
+    Header header;
+    positionsFile.read(reinterpret_cast<char*>(&header.nNodesPerState), sizeof(uint32_t));
+    positionsFile.read(reinterpret_cast<char*>(&header.nStates), sizeof(uint32_t));
+    if (!positionsFile.good()) {
+        throw ghoul::RuntimeError(fmt::format("Could not read header of {}", positions));
+    }
+
+    const size_t nValues = static_cast<size_t>(header.nNodesPerState) * header.nStates;
+    const size_t positionsSize = nValues * sizeof(glm::vec3);
+    const size_t scalarsSize = nValues * sizeof(float);
+
+    const size_t positionsBegin =
+        sizeof(Header) + header.nStates * sizeof(StateOffsets);
+    const size_t fluxesBegin = positionsBegin + positionsSize;
+    const size_t radiiBegin = fluxesBegin + scalarsSize;
+
+    std::vector<StateOffsets> table(header.nStates);
+    for (uint32_t i = 0; i < header.nStates; i++) {
+        const size_t first = static_cast<size_t>(i) * header.nNodesPerState;
+        table[i].positions = positionsBegin + first * sizeof(glm::vec3);
+        table[i].fluxes = fluxesBegin + first * sizeof(float);
+        table[i].radii = radiiBegin + first * sizeof(float);
+    }
+
+    std::ofstream file(destination, std::ofstream::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Error writing file {}", destination));
+    }
+
+    try {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(
+            reinterpret_cast<const char*>(table.data()),
+            table.size() * sizeof(StateOffsets)
+        );
+        copyColumn(positionsFile, positions, file, positionsSize);
+        copyColumn(fluxesFile, fluxes, file, scalarsSize);
+        copyColumn(radiiFile, radii, file, scalarsSize);
+    }
+    catch (const ghoul::RuntimeError&) {
+        // Don't leave a partial file behind that would later be mistaken for a valid one
+        file.close();
+        std::filesystem::remove(destination);
+        throw;
+    }
+}
+
+std::unique_ptr<FluxNodesStates> FluxNodesStates::loadWithCache(
+                                                   const std::filesystem::path& positions,
+                                                      const std::filesystem::path& fluxes,
+                                                       const std::filesystem::path& radii)
+{
+    std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(positions);
+    if (std::filesystem::exists(cached)) {
+        try {
+            return std::make_unique<FluxNodesStates>(cached);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LWARNING(fmt::format("Removing invalid cached states: {}", e.message));
+            FileSys.cacheManager()->removeCacheFile(cached);
+        }
+    }
+
+    LINFO(fmt::format("Converting flux nodes {} into a single cached file", positions));
+    convert(positions, fluxes, radii, cached);
+    return std::make_unique<FluxNodesStates>(cached);
+}
+
+FluxNodesStates::FluxNodesStates(std::filesystem::path path)
+    : _file(std::move(path))
+{
+    if (_file.size() < sizeof(Header)) {
+        throw ghoul::RuntimeError(fmt::format("States file {} is empty", _file.path()));
+    }
+
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (header.version != CurrentVersion) {
+        throw ghoul::RuntimeError(fmt::format(
+            "States file {} has version {} but version {} is expected",
+            _file.path(), header.version, CurrentVersion
+        ));
+    }
+
+    const size_t tableEnd = sizeof(Header) + header.nStates * sizeof(StateOffsets);
+    if (_file.size() < tableEnd) {
+        throw ghoul::RuntimeError(fmt::format(
+            "States file {} is too small for {} states", _file.path(), header.nStates
+        ));
+    }
+    _nStates = header.nStates;
+    _nNodesPerState = header.nNodesPerState;
+
+    // Make sure that all states are inside the file so that they can be used unchecked
+    const size_t positionsSize = _nNodesPerState * sizeof(glm::vec3);
+    const size_t scalarsSize = _nNodesPerState * sizeof(float);
+    auto isValid = [this](uint64_t offset, size_t size) {
+        return offset % alignof(float) == 0 && offset <= _file.size() &&
+            size <= _file.size() - offset;
+    };
+    for (uint32_t i = 0; i < _nStates; i++) {
+        const StateOffsets& o = offsetsAt(_file.data(), i);
+        if (!isValid(o.positions, positionsSize) || !isValid(o.fluxes, scalarsSize) ||
+            !isValid(o.radii, scalarsSize))
+        {
+            throw ghoul::RuntimeError(fmt::format(
+                "States file {} has an invalid state {}", _file.path(), i
+            ));
+        }
+    }
+}
+
+uint32_t FluxNodesStates::nStates() const {
+    return _nStates;
+}
+
+uint32_t FluxNodesStates::nNodesPerState() const {
+    return _nNodesPerState;
+}
+
+FluxNodesStates::State FluxNodesStates::state(uint32_t index) const {
+    ghoul_assert(index < _nStates, "Index out of bounds");
+
+    const StateOffsets& o = offsetsAt(_file.data(), index);
+    return {
+        .positions = reinterpret_cast<const glm::vec3*>(_file.data() + o.positions),
+        .fluxes = reinterpret_cast<const float*>(_file.data() + o.fluxes),
+        .radii = reinterpret_cast<const float*>(_file.data() + o.radii),
+        .nNodes = _nNodesPerState
+    };
+}
+
+} // namespace openspace
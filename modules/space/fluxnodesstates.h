@@ -0,0 +1,110 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
+#define __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace openspace {
+
+/**
+ * The positions, flux values, and radii of all nodes of a FluxNodes sequence for a
+ * single energy bin, stored in one memory mapped file. The file is columnar: all
+ * positions of all states are followed by all flux values and then by all radii. A table
+ * at the beginning of the file contains the offsets of each state into the three
+ * columns, so a single state can be accessed without reading any other part of the file.
+ * As the file is memory mapped, only the pages of the states that are accessed are
+ * loaded by the operating system.
+ *
+ * The file consists of a header with the version, the number of nodes per state, and
+ * the number of states, followed by the offset table and then by the three columns.
+ */
+class FluxNodesStates {
+public:
+    /// The data of a single state, which points directly into the mapped file
+    struct State {
+        const glm::vec3* positions = nullptr;
+        const float* fluxes = nullptr;
+        const float* radii = nullptr;
+        /// The number of nodes, which is the number of elements in each of the arrays
+        uint32_t nNodes = 0;
+    };
+
+    /**
+     * Converts the three binary source files of one energy bin into a single file at
+     * \p destination. The \p positions file starts with the number of nodes per state
+     * and the number of states as 32-bit integers, followed by the positions of all
+     * states. The \p fluxes and \p radii files contain the values of all states without
+     * a header. The source files are copied in blocks, so they are never completely
+     * loaded into memory.
+     *
+     * \throw ghoul::RuntimeError If a source file could not be read or is too small, or
+     *        if the destination file could not be written
+     */
+    static void convert(const std::filesystem::path& positions,
+        const std::filesystem::path& fluxes, const std::filesystem::path& radii,
+        const std::filesystem::path& destination);
+
+    /**
+     * Returns the states for the provided source files, see #convert. The converted file
+     * is created once from the source files and stored in the cache, so all subsequent
+     * calls only map the cached file into memory.
+     *
+     * \throw ghoul::RuntimeError If neither the cached file nor the source files could
+     *        be read
+     */
+    static std::unique_ptr<FluxNodesStates> loadWithCache(
+        const std::filesystem::path& positions, const std::filesystem::path& fluxes,
+        const std::filesystem::path& radii);
+
+    /**
+     * Maps the converted file at the provided \p path into memory.
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped or is not a valid file
+     */
+    explicit FluxNodesStates(std::filesystem::path path);
+
+    /// Returns the number of states in the sequence
+    uint32_t nStates() const;
+
+    /// Returns the number of nodes in every state
+    uint32_t nNodesPerState() const;
+
+    /// Returns the state with the index \p index
+    State state(uint32_t index) const;
+
+private:
+    MemoryMappedFile _file;
+    uint32_t _nStates = 0;
+    uint32_t _nNodesPerState = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
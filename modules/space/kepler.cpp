@@ -30,13 +30,26 @@
 #include <ghoul/misc/misc.h>
 #include <scn/scn.h>
 #include <scn/tuple_return.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <optional>
 #include <sstream>
+#include <string_view>
+#include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "Kepler";
-    constexpr int8_t CurrentCacheVersion = 1;
+    constexpr int8_t CurrentCacheVersion = 2;
+
+    // The minimum number of objects that is worth handing to a separate parsing thread
+    constexpr size_t MinObjectsPerThread = 4096;
+
+    // The number of bytes at the beginning and the end of a source file that are part of
+    // its fingerprint for the cache
+    constexpr size_t FingerprintSampleSize = 64 * 1024;
 
     // The list of leap years only goes until 2056 as we need to touch this file then
     // again anyway ;)
@@ -381,23 +394,87 @@ namespace {
         return
             nSecondsSince2000 + totalSeconds + nLeapSecondsOffset - offset + date.seconds;
     }
-} // namespace
 
-namespace openspace::kepler {
+    std::string readText(const std::filesystem::path& file) {
+        std::ifstream f(file, std::ifstream::binary);
+        if (!f.good()) {
+            throw ghoul::RuntimeError(fmt::format("Failed to open file '{}'", file));
+        }
 
-std::vector<Parameters> readTleFile(std::filesystem::path file) {
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+        f.seekg(0, std::ifstream::end);
+        const std::streamoff size = f.tellg();
+        f.seekg(0, std::ifstream::beg);
+
+        std::string res;
+        res.resize(static_cast<size_t>(size));
+        f.read(res.data(), size);
+        return res;
+    }
+
+    // Splits the text into lines the same way as repeated calls to std::getline would
+    std::vector<std::string_view> splitLines(std::string_view text) {
+        std::vector<std::string_view> res;
+        res.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = text.find('\n', begin);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            res.push_back(text.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        return res;
+    }
+
+    // Parses the `nObjects` objects by calling `parseRange(begin, end)` for consecutive
+    // ranges of objects on up to `nThreads` threads. The results are concatenated in
+    // order, so the result is independent of the number of threads
+    template <typename Func>
+    std::vector<openspace::kepler::Parameters> parseParallel(size_t nObjects,
+                                                             unsigned int nThreads,
+                                                             Func parseRange)
+    {
+        using openspace::kepler::Parameters;
+
+        if (nThreads == 0) {
+            nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        const size_t maxChunks = std::max<size_t>(nObjects / MinObjectsPerThread, 1);
+        const size_t nChunks = std::min<size_t>(nThreads, maxChunks);
+        if (nChunks == 1) {
+            return parseRange(0, nObjects);
+        }
 
-    std::vector<Parameters> result;
+        auto chunkBegin = [nObjects, nChunks](size_t chunk) {
+            return nObjects * chunk / nChunks;
+        };
 
-    std::ifstream f;
-    f.open(file);
+        std::vector<std::future<std::vector<Parameters>>> futures;
+        futures.reserve(nChunks - 1);
+        for (size_t chunk = 1; chunk < nChunks; chunk++) {
+            futures.push_back(std::async(
+                std::launch::async,
+                parseRange, chunkBegin(chunk), chunkBegin(chunk + 1)
+            ));
+        }
 
-    int lineNum = 1;
+        std::vector<Parameters> res = parseRange(0, chunkBegin(1));
+        res.reserve(nObjects);
+        for (std::future<std::vector<Parameters>>& f : futures) {
+            std::vector<Parameters> part = f.get();
+            std::move(part.begin(), part.end(), std::back_inserter(res));
+        }
+        return res;
+    }
 
-    std::string header;
-    while (std::getline(f, header)) {
-        Parameters p;
+    openspace::kepler::Parameters parseTle(const std::string& header,
+                                           const std::string& firstLine,
+                                           const std::string& secondLine,
+                                           const std::filesystem::path& file,
+                                           size_t lineNum)
+    {
+        openspace::kepler::Parameters p;
 
         // Header
         p.name = header;
@@ -418,9 +495,7 @@ std::vector<Parameters> readTleFile(std::filesystem::path file) {
         //    12   63-63   The "Ephemeris type"
         //    13   65-68   Element set  number.Incremented when a new TLE is generated
         //    14   69-69   Checksum (modulo 10)
-        std::string firstLine;
-        std::getline(f, firstLine);
-        if (f.bad() || firstLine[0] != '1') {
+        if (firstLine.empty() || firstLine[0] != '1') {
             throw ghoul::RuntimeError(fmt::format(
                 "Malformed TLE file '{}' at line {}", file, lineNum + 1
             ));
@@ -450,11 +525,9 @@ std::vector<Parameters> readTleFile(std::filesystem::path file) {
         //     8      53-63   Mean Motion (revolutions per day)
         //     9      64-68   Revolution number at epoch (revolutions)
         //    10      69-69   Checksum (modulo 10)
-        std::string secondLine;
-        std::getline(f, secondLine);
-        if (f.bad() || secondLine[0] != '2') {
+        if (secondLine.empty() || secondLine[0] != '2') {
             throw ghoul::RuntimeError(fmt::format(
-                "Malformed TLE file '{}' at line {}", file, lineNum + 1
+                "Malformed TLE file '{}' at line {}", file, lineNum + 2
             ));
         }
 
@@ -493,129 +566,104 @@ std::vector<Parameters> readTleFile(std::filesystem::path file) {
 
         p.semiMajorAxis = calculateSemiMajorAxis(meanMotion);
         p.period = std::chrono::seconds(std::chrono::hours(24)).count() / meanMotion;
-
-        result.push_back(p);
-
-        lineNum = lineNum + 3;
+        return p;
     }
 
-    return result;
-}
-
-std::vector<Parameters> readOmmFile(std::filesystem::path file) {
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
-
-    std::vector<Parameters> result;
-
-    std::ifstream f;
-    f.open(file);
-
-    int lineNum = 1;
-    std::optional<Parameters> current = std::nullopt;
-    std::string line;
-    while (std::getline(f, line)) {
-        if (line.empty() || line == "\r") {
-            continue;
-        }
-
-        // Tokenize the line
-        std::vector<std::string> parts = ghoul::tokenizeString(line, '=');
-        for (std::string& p : parts) {
-            ghoul::trimWhitespace(p);
-        }
+    // Parses the OMM lines in [begin, end). `begin` has to be the first line of the file
+    // or a line that starts a new object
+    std::vector<openspace::kepler::Parameters> parseOmm(
+                                               const std::vector<std::string_view>& lines,
+                                                                 size_t begin, size_t end)
+    {
+        using openspace::kepler::Parameters;
+
+        std::vector<Parameters> result;
+        std::optional<Parameters> current = std::nullopt;
+        for (size_t i = begin; i < end; i++) {
+            const std::string line = std::string(lines[i]);
+            if (line.empty() || line == "\r") {
+                continue;
+            }
 
-        if (parts.size() != 2) {
-            throw ghoul::RuntimeError(fmt::format(
-                "Malformed line '{}' at {}", line, lineNum
-            ));
-        }
+            // Tokenize the line
+            std::vector<std::string> parts = ghoul::tokenizeString(line, '=');
+            for (std::string& p : parts) {
+                ghoul::trimWhitespace(p);
+            }
 
-        if (parts[0] == "CCSDS_OMM_VERS") {
-            if (parts[1] != "2.0") {
-                LWARNINGC(
-                    "OMM",
-                    fmt::format(
-                        "Only version 2.0 is currently supported but found {}. "
-                        "Parsing might fail",
-                        parts[1]
-                    )
-                );
+            if (parts.size() != 2) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "Malformed line '{}' at {}", line, i + 1
+                ));
             }
 
-            // We start a new value so we need to store the last one...
-            if (current.has_value()) {
-                result.push_back(*current);
+            if (parts[0] == "CCSDS_OMM_VERS") {
+                if (parts[1] != "2.0") {
+                    LWARNINGC(
+                        "OMM",
+                        fmt::format(
+                            "Only version 2.0 is currently supported but found {}. "
+                            "Parsing might fail",
+                            parts[1]
+                        )
+                    );
+                }
+
+                // We start a new value so we need to store the last one...
+                if (current.has_value()) {
+                    result.push_back(*current);
+                }
+
+                // ... and start a new one
+                current = Parameters();
             }
 
-            // ... and start a new one
-            current = Parameters();
-        }
+            ghoul_assert(current.has_value(), "No current element");
 
-        ghoul_assert(current.has_value(), "No current element");
+            if (parts[0] == "OBJECT_NAME") {
+                current->name = parts[1];
+            }
+            else if (parts[0] == "OBJECT_ID") {
+                current->id = parts[1];
+            }
+            else if (parts[0] == "EPOCH") {
+                current->epoch = epochFromOmmString(parts[1]);
+            }
+            else if (parts[0] == "MEAN_MOTION") {
+                float mm = std::stof(parts[1]);
+                current->semiMajorAxis = calculateSemiMajorAxis(mm);
+                current->period =
+                    std::chrono::seconds(std::chrono::hours(24)).count() / mm;
+            }
+            else if (parts[0] == "SEMI_MAJOR_AXIS") {
 
-        if (parts[0] == "OBJECT_NAME") {
-            current->name = parts[1];
-        }
-        else if (parts[0] == "OBJECT_ID") {
-            current->id = parts[1];
-        }
-        else if (parts[0] == "EPOCH") {
-            current->epoch = epochFromOmmString(parts[1]);
-        }
-        else if (parts[0] == "MEAN_MOTION") {
-            float mm = std::stof(parts[1]);
-            current->semiMajorAxis = calculateSemiMajorAxis(mm);
-            current->period = std::chrono::seconds(std::chrono::hours(24)).count() / mm;
+            }
+            else if (parts[0] == "ECCENTRICITY") {
+                current->eccentricity = std::stof(parts[1]);
+            }
+            else if (parts[0] == "INCLINATION") {
+                current->inclination = std::stof(parts[1]);
+            }
+            else if (parts[0] == "RA_OF_ASC_NODE") {
+                current->ascendingNode = std::stof(parts[1]);
+            }
+            else if (parts[0] == "ARG_OF_PERICENTER") {
+                current->argumentOfPeriapsis = std::stof(parts[1]);
+            }
+            else if (parts[0] == "MEAN_ANOMALY") {
+                current->meanAnomaly = std::stof(parts[1]);
+            }
         }
-        else if (parts[0] == "SEMI_MAJOR_AXIS") {
 
+        if (current.has_value()) {
+            result.push_back(*current);
         }
-        else if (parts[0] == "ECCENTRICITY") {
-            current->eccentricity = std::stof(parts[1]);
-        }
-        else if (parts[0] == "INCLINATION") {
-            current->inclination = std::stof(parts[1]);
-        }
-        else if (parts[0] == "RA_OF_ASC_NODE") {
-            current->ascendingNode = std::stof(parts[1]);
-        }
-        else if (parts[0] == "ARG_OF_PERICENTER") {
-            current->argumentOfPeriapsis = std::stof(parts[1]);
-        }
-        else if (parts[0] == "MEAN_ANOMALY") {
-            current->meanAnomaly = std::stof(parts[1]);
-        }
-    }
-
-    if (current.has_value()) {
-        result.push_back(*current);
-    }
-
-    return result;
-}
-
-std::vector<Parameters> readSbdbFile(std::filesystem::path file) {
-    constexpr int NDataFields = 9;
-    constexpr std::string_view ExpectedHeader = "full_name,epoch_cal,e,a,i,om,w,ma,per";
 
-    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
-
-    std::ifstream f;
-    f.open(file);
-
-    std::string line;
-    std::getline(f, line);
-    // Newer versions downloaded from the JPL SBDB website have " around variables
-    line.erase(remove(line.begin(), line.end(), '\"'), line.end());
-    if (line != ExpectedHeader) {
-        throw ghoul::RuntimeError(fmt::format(
-            "Expected JPL SBDB file to start with '{}' but found '{}' instead",
-            ExpectedHeader, line.substr(0, 100)
-        ));
+        return result;
     }
 
-    std::vector<Parameters> result;
-    while (std::getline(f, line)) {
+    openspace::kepler::Parameters parseSbdb(const std::string& line) {
+        constexpr int NDataFields = 9;
         constexpr double AuToKm = 1.496e8;
 
         std::vector<std::string> parts = ghoul::tokenizeString(line, ',');
@@ -624,7 +672,7 @@ std::vector<Parameters> readSbdbFile(std::filesystem::path file) {
                 "Malformed line {}, expected 8 data fields, got {}", line, parts.size()
             ));
         }
-        Parameters p;
+        openspace::kepler::Parameters p;
 
         ghoul::trimWhitespace(parts[0]);
         p.name = parts[0];
@@ -652,97 +700,329 @@ std::vector<Parameters> readSbdbFile(std::filesystem::path file) {
         p.meanAnomaly = importAngleValue(parts[7]);
         p.period =
             std::stod(parts[8]) * std::chrono::seconds(std::chrono::hours(24)).count();
+        return p;
+    }
+
+    // A fingerprint of the source file that is stored in the cache. Hashing the entire
+    // file would take about as long as parsing it, so only the size, the modification
+    // time, and the beginning and end of the file are considered
+    uint64_t sourceFingerprint(const std::filesystem::path& file,
+                               openspace::kepler::Format format)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        auto combine = [&hash](const char* data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 1099511628211ull;
+            }
+        };
+
+        const uint64_t size = std::filesystem::file_size(file);
+        combine(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+        const int64_t time = static_cast<int64_t>(
+            std::filesystem::last_write_time(file).time_since_epoch().count()
+        );
+        combine(reinterpret_cast<const char*>(&time), sizeof(int64_t));
+        const int f = static_cast<int>(format);
+        combine(reinterpret_cast<const char*>(&f), sizeof(int));
+
+        std::ifstream stream(file, std::ifstream::binary);
+        std::vector<char> buffer(FingerprintSampleSize);
+        stream.read(buffer.data(), buffer.size());
+        combine(buffer.data(), static_cast<size_t>(stream.gcount()));
+        if (size > 2 * FingerprintSampleSize) {
+            stream.clear();
+            stream.seekg(size - FingerprintSampleSize);
+            stream.read(buffer.data(), buffer.size());
+            combine(buffer.data(), static_cast<size_t>(stream.gcount()));
+        }
+        return hash;
+    }
+} // namespace
+
+namespace openspace::kepler {
+
+std::vector<Parameters> readTleFile(std::filesystem::path file, unsigned int nThreads) {
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
 
-        result.push_back(std::move(p));
+    const std::string text = readText(file);
+    const std::vector<std::string_view> lines = splitLines(text);
+
+    // Every object consists of a header line followed by two lines of elements
+    const size_t nObjects = (lines.size() + 2) / 3;
+    return parseParallel(
+        nObjects,
+        nThreads,
+        [&lines, &file](size_t begin, size_t end) {
+            std::vector<Parameters> result;
+            result.reserve(end - begin);
+            for (size_t i = begin; i < end; i++) {
+                const size_t line = 3 * i;
+                if (line + 2 >= lines.size()) {
+                    throw ghoul::RuntimeError(fmt::format(
+                        "Malformed TLE file '{}' at line {}", file, lines.size() + 1
+                    ));
+                }
+
+                result.push_back(parseTle(
+                    std::string(lines[line]),
+                    std::string(lines[line + 1]),
+                    std::string(lines[line + 2]),
+                    file,
+                    line + 1
+                ));
+            }
+            return result;
+        }
+    );
+}
+
+std::vector<Parameters> readOmmFile(std::filesystem::path file, unsigned int nThreads) {
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    const std::string text = readText(file);
+    const std::vector<std::string_view> lines = splitLines(text);
+
+    // Find the lines at which the objects start so that the file can be split at object
+    // boundaries. Anything before the first object is part of the first range
+    std::vector<size_t> starts = { 0 };
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::string_view line = lines[i];
+        const size_t first = line.find_first_not_of(" \t");
+        if (i > 0 && first != std::string_view::npos &&
+            line.substr(first).starts_with("CCSDS_OMM_VERS"))
+        {
+            starts.push_back(i);
+        }
     }
-    return result;
+    starts.push_back(lines.size());
+
+    return parseParallel(
+        starts.size() - 1,
+        nThreads,
+        [&lines, &starts](size_t begin, size_t end) {
+            return parseOmm(lines, starts[begin], starts[end]);
+        }
+    );
 }
 
-void saveCache(const std::vector<Parameters>& params, std::filesystem::path file) {
+std::vector<Parameters> readSbdbFile(std::filesystem::path file, unsigned int nThreads) {
+    constexpr std::string_view ExpectedHeader = "full_name,epoch_cal,e,a,i,om,w,ma,per";
+
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    const std::string text = readText(file);
+    const std::vector<std::string_view> lines = splitLines(text);
+
+    std::string line = lines.empty() ? "" : std::string(lines.front());
+    // Newer versions downloaded from the JPL SBDB website have " around variables
+    line.erase(remove(line.begin(), line.end(), '\"'), line.end());
+    if (line != ExpectedHeader) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Expected JPL SBDB file to start with '{}' but found '{}' instead",
+            ExpectedHeader, line.substr(0, 100)
+        ));
+    }
+
+    return parseParallel(
+        lines.size() - 1,
+        nThreads,
+        [&lines](size_t begin, size_t end) {
+            std::vector<Parameters> result;
+            result.reserve(end - begin);
+            for (size_t i = begin; i < end; i++) {
+                // The first line is the header
+                result.push_back(parseSbdb(std::string(lines[i + 1])));
+            }
+            return result;
+        }
+    );
+}
+
+void saveCache(const std::vector<Parameters>& params, uint64_t sourceHash,
+               std::filesystem::path file)
+{
+    // The cache stores the names and ids as two blobs followed by their lengths, and
+    // then the numerical values of all objects as one block so that it can be loaded
+    // with a few bulk reads
+    constexpr size_t NValues = 8;
+
+    std::vector<uint32_t> nameLengths;
+    nameLengths.reserve(params.size());
+    std::string names;
+    std::vector<uint32_t> idLengths;
+    idLengths.reserve(params.size());
+    std::string ids;
+    std::vector<double> values;
+    values.reserve(params.size() * NValues);
+    for (const Parameters& param : params) {
+        nameLengths.push_back(static_cast<uint32_t>(param.name.size()));
+        names += param.name;
+        idLengths.push_back(static_cast<uint32_t>(param.id.size()));
+        ids += param.id;
+
+        values.push_back(param.inclination);
+        values.push_back(param.semiMajorAxis);
+        values.push_back(param.ascendingNode);
+        values.push_back(param.eccentricity);
+        values.push_back(param.argumentOfPeriapsis);
+        values.push_back(param.meanAnomaly);
+        values.push_back(param.epoch);
+        values.push_back(param.period);
+    }
+
     std::ofstream stream(file, std::ofstream::binary);
 
     stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    stream.write(reinterpret_cast<const char*>(&sourceHash), sizeof(uint64_t));
 
     uint32_t size = static_cast<uint32_t>(params.size());
     stream.write(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
-    for (const Parameters& param : params) {
-        uint32_t nameLength = static_cast<uint32_t>(param.name.size());
-        stream.write(reinterpret_cast<const char*>(&nameLength), sizeof(uint32_t));
-        stream.write(param.name.data(), nameLength * sizeof(char));
-
-        uint32_t idLength = static_cast<uint32_t>(param.id.size());
-        stream.write(reinterpret_cast<const char*>(&idLength), sizeof(uint32_t));
-        stream.write(param.id.data(), idLength * sizeof(char));
-
-        stream.write(reinterpret_cast<const char*>(&param.inclination), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.semiMajorAxis), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.ascendingNode), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.eccentricity), sizeof(double));
-        stream.write(
-            reinterpret_cast<const char*>(&param.argumentOfPeriapsis),
-            sizeof(double)
-        );
-        stream.write(reinterpret_cast<const char*>(&param.meanAnomaly), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.epoch), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.period), sizeof(double));
-    }
+
+    uint64_t namesSize = names.size();
+    stream.write(reinterpret_cast<const char*>(&namesSize), sizeof(uint64_t));
+    stream.write(names.data(), namesSize);
+    stream.write(
+        reinterpret_cast<const char*>(nameLengths.data()),
+        nameLengths.size() * sizeof(uint32_t)
+    );
+
+    uint64_t idsSize = ids.size();
+    stream.write(reinterpret_cast<const char*>(&idsSize), sizeof(uint64_t));
+    stream.write(ids.data(), idsSize);
+    stream.write(
+        reinterpret_cast<const char*>(idLengths.data()),
+        idLengths.size() * sizeof(uint32_t)
+    );
+
+    stream.write(
+        reinterpret_cast<const char*>(values.data()),
+        values.size() * sizeof(double)
+    );
 }
 
-std::optional<std::vector<Parameters>> loadCache(std::filesystem::path file) {
-    std::ifstream stream(file, std::ifstream::binary);
+std::optional<std::vector<Parameters>> loadCache(std::filesystem::path file,
+                                                 uint64_t sourceHash)
+{
+    constexpr size_t NValues = 8;
+
+    const std::string buffer = readText(file);
+    const char* data = buffer.data();
+    size_t remaining = buffer.size();
+    auto read = [&data, &remaining](void* dst, size_t size) {
+        if (size > remaining) {
+            return false;
+        }
+        std::memcpy(dst, data, size);
+        data += size;
+        remaining -= size;
+        return true;
+    };
 
     int8_t version = 0;
-    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-    if (version != CurrentCacheVersion) {
+    if (!read(&version, sizeof(int8_t)) || version != CurrentCacheVersion) {
         LINFO("The format of the cached file has changed");
         return std::nullopt;
     }
 
+    uint64_t hash = 0;
+    if (!read(&hash, sizeof(uint64_t)) || hash != sourceHash) {
+        LINFO("The source file has changed since the cache was created");
+        return std::nullopt;
+    }
+
+    // The number of entries is checked against the remaining bytes before each array is
+    // allocated, so that a corrupt cache file cannot cause huge allocations
     uint32_t size = 0;
-    stream.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
-    std::vector<Parameters> res;
-    res.reserve(size);
+    if (!read(&size, sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    uint64_t namesSize = 0;
+    if (!read(&namesSize, sizeof(uint64_t)) || namesSize > remaining) {
+        return std::nullopt;
+    }
+    std::string_view names = std::string_view(data, namesSize);
+    data += namesSize;
+    remaining -= namesSize;
+    if (size * sizeof(uint32_t) > remaining) {
+        return std::nullopt;
+    }
+    std::vector<uint32_t> nameLengths(size);
+    if (!read(nameLengths.data(), size * sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    uint64_t idsSize = 0;
+    if (!read(&idsSize, sizeof(uint64_t)) || idsSize > remaining) {
+        return std::nullopt;
+    }
+    std::string_view ids = std::string_view(data, idsSize);
+    data += idsSize;
+    remaining -= idsSize;
+    if (size * sizeof(uint32_t) > remaining) {
+        return std::nullopt;
+    }
+    std::vector<uint32_t> idLengths(size);
+    if (!read(idLengths.data(), size * sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    if (size * NValues * sizeof(double) > remaining) {
+        return std::nullopt;
+    }
+    std::vector<double> values(size * NValues);
+    if (!read(values.data(), values.size() * sizeof(double))) {
+        return std::nullopt;
+    }
+
+    std::vector<Parameters> res(size);
+    size_t nameOffset = 0;
+    size_t idOffset = 0;
     for (uint32_t i = 0; i < size; i++) {
-        Parameters param;
-
-        uint32_t nameLength = 0;
-        stream.read(reinterpret_cast<char*>(&nameLength), sizeof(uint32_t));
-        param.name.resize(nameLength);
-        stream.read(param.name.data(), nameLength * sizeof(char));
-
-        uint32_t idLength = 0;
-        stream.read(reinterpret_cast<char*>(&idLength), sizeof(uint32_t));
-        param.id.resize(idLength);
-        stream.read(param.id.data(), idLength * sizeof(char));
-
-        stream.read(reinterpret_cast<char*>(&param.inclination), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.semiMajorAxis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.ascendingNode), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.eccentricity), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.argumentOfPeriapsis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.meanAnomaly), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.epoch), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.period), sizeof(double));
-
-        res.push_back(std::move(param));
+        Parameters& param = res[i];
+
+        if (nameOffset + nameLengths[i] > names.size() ||
+            idOffset + idLengths[i] > ids.size())
+        {
+            return std::nullopt;
+        }
+        param.name = names.substr(nameOffset, nameLengths[i]);
+        nameOffset += nameLengths[i];
+        param.id = ids.substr(idOffset, idLengths[i]);
+        idOffset += idLengths[i];
+
+        const double* v = values.data() + i * NValues;
+        param.inclination = v[0];
+        param.semiMajorAxis = v[1];
+        param.ascendingNode = v[2];
+        param.eccentricity = v[3];
+        param.argumentOfPeriapsis = v[4];
+        param.meanAnomaly = v[5];
+        param.epoch = v[6];
+        param.period = v[7];
     }
 
     return res;
 }
 
 std::vector<Parameters> readFile(std::filesystem::path file, Format format) {
+    const uint64_t sourceHash = sourceFingerprint(file, format);
+
     std::filesystem::path cachedFile = FileSys.cacheManager()->cachedFilename(file);
     if (std::filesystem::is_regular_file(cachedFile)) {
         LINFO(fmt::format(
             "Cached file {} used for Kepler file {}", cachedFile, file
         ));
 
-        std::optional<std::vector<Parameters>> res = loadCache(cachedFile);
+        std::optional<std::vector<Parameters>> res = loadCache(cachedFile, sourceHash);
         if (res.has_value()) {
             return *res;
         }
 
-        // If there is no value in the optional, the cached loading failed
+        // If there is no value in the optional, the cached loading failed and the cache
+        // file is overwritten below
     }
 
     std::vector<Parameters> res;
@@ -761,7 +1041,7 @@ std::vector<Parameters> readFile(std::filesystem::path file, Format format) {
     }
 
     LINFO(fmt::format("Saving cache {} for Kepler file {}", cachedFile, file));
-    saveCache(res, cachedFile);
+    saveCache(res, sourceHash, cachedFile);
     return res;
 }
 
@@ -53,24 +53,30 @@ struct Parameters {
  * values.
  *
  * \param file The file to the TLE file. This file must be a valid file
+ * \param nThreads The number of threads that parse the file. If this value is 0, one
+ *        thread per hardware thread is used. The result is independent of this value
  * \return Information about all of the contained objects in the \p file
  *
  * \pre \p file must be a file and must exist
  * \throw ghoul::RuntimeError If the provided \p file is not a valid TLE file
  */
-std::vector<Parameters> readTleFile(std::filesystem::path file);
+std::vector<Parameters> readTleFile(std::filesystem::path file,
+    unsigned int nThreads = 0);
 
 /**
  * Reads the object information from the provided \p file and returns them as individual
  * values.
  *
  * \param file The file to the OMM file. This file must be a valid file
+ * \param nThreads The number of threads that parse the file. If this value is 0, one
+ *        thread per hardware thread is used. The result is independent of this value
  * \return Information about all of the contained objects in the \p file
  *
  * \pre \p file must be a file and must exist
  * \throw ghoul::RuntimeError If the provided \p file is not a valid OMM file
  */
-std::vector<Parameters> readOmmFile(std::filesystem::path file);
+std::vector<Parameters> readOmmFile(std::filesystem::path file,
+    unsigned int nThreads = 0);
 
 /**
  * Reads the object information from a CSV file following JPL's Small Body Database
@@ -78,12 +84,15 @@ std::vector<Parameters> readOmmFile(std::filesystem::path file);
  * ascending node, argument of periapsis, mean anomaly, and period in that order.
  *
  * \param file The CSV file containing the information about the objects
+ * \param nThreads The number of threads that parse the file. If this value is 0, one
+ *        thread per hardware thread is used. The result is independent of this value
  * \return Information about all of the contained objects in the \p file
  *
  * \pre \p file must be a file and must exist
  * \throw ghoul::RuntimeError If the provided \p is not a valid JPL SBDB CSV format
  */
-std::vector<Parameters> readSbdbFile(std::filesystem::path file);
+std::vector<Parameters> readSbdbFile(std::filesystem::path file,
+    unsigned int nThreads = 0);
 
 /**
  * The different formats that the readFile function is capable of loading
@@ -94,7 +103,9 @@ enum class Format {
     SBDB
 };
 /**
- * Reads the object information from the provided file.
+ * Reads the object information from the provided file. The parsed objects are stored in
+ * a binary cache file that is used instead of the \p file as long as the size,
+ * modification time, and the beginning and end of the \p file remain unchanged.
  *
  * \param file The file containing the information about the objects
  * \param format The format of the provided \p file
@@ -0,0 +1,395 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/keplerpropagator.h>
+
+#include <openspace/util/threadpool.h>
+#include <ghoul/fmt.h>
+#include <ghoul/glm.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace {
+    // The number of orbits that a worker thread processes before fetching the next batch
+    constexpr size_t BatchSize = 256;
+
+    // The threads that help the calling thread with the orbit generation. They are kept
+    // alive between calls, as the orbits are regenerated whenever a property changes
+    openspace::ThreadPool& workerPool() {
+        static openspace::ThreadPool pool(
+            std::max(std::thread::hardware_concurrency(), 2u) - 1
+        );
+        return pool;
+    }
+
+    template <typename T>
+    T sign(T val) {
+        return val > T(0) ? T(1) : ((val < T(0)) ? T(-1) : T(0));
+    }
+
+    void generateOrbit(const openspace::kepler::OrbitElements& elements, size_t i,
+                       int nSegments, openspace::kepler::OrbitVertex* vertices,
+                       std::vector<double>& timeOffsets,
+                       std::vector<double>& meanAnomalies,
+                       std::vector<double>& eccentricAnomalies)
+    {
+        const size_t nVertices = static_cast<size_t>(nSegments) + 1;
+        timeOffsets.resize(nVertices);
+        meanAnomalies.resize(nVertices);
+        eccentricAnomalies.resize(nVertices);
+
+        const double period = elements.period[i];
+        const double m0 = elements.meanAnomaly[i];
+        const double n = elements.meanMotion[i];
+        for (size_t j = 0; j < nVertices; j++) {
+            timeOffsets[j] =
+                period * static_cast<double>(j) / static_cast<double>(nSegments);
+            meanAnomalies[j] = m0 + timeOffsets[j] * n;
+        }
+
+        const double e = elements.eccentricity[i];
+        openspace::kepler::eccentricAnomalies(
+            e,
+            meanAnomalies.data(),
+            eccentricAnomalies.data(),
+            nVertices
+        );
+
+        const double a = elements.semiMajorAxis[i];
+        const double b = a * std::sqrt(1.0 - e * e);
+        const double epoch = elements.epoch[i];
+        const glm::dvec3 p = glm::dvec3(elements.px[i], elements.py[i], elements.pz[i]);
+        const glm::dvec3 q = glm::dvec3(elements.qx[i], elements.qy[i], elements.qz[i]);
+        for (size_t j = 0; j < nVertices; j++) {
+            const double ea = eccentricAnomalies[j];
+            const glm::dvec3 pos = p * (a * (std::cos(ea) - e)) + q * (b * std::sin(ea));
+
+            openspace::kepler::OrbitVertex& v = vertices[j];
+            v.x = static_cast<float>(pos.x);
+            v.y = static_cast<float>(pos.y);
+            v.z = static_cast<float>(pos.z);
+            v.time = static_cast<float>(timeOffsets[j]);
+            v.epoch = epoch;
+            v.period = period;
+        }
+    }
+} // namespace
+
+namespace openspace::kepler {
+
+size_t OrbitElements::size() const {
+    return eccentricity.size();
+}
+
+OrbitElements orbitElements(const std::vector<Parameters>& parameters) {
+    ZoneScoped;
+
+    OrbitElements res;
+    const size_t n = parameters.size();
+    for (std::vector<double>* v : {
+            &res.eccentricity, &res.semiMajorAxis, &res.meanAnomaly, &res.meanMotion,
+            &res.epoch, &res.period, &res.px, &res.py, &res.pz, &res.qx, &res.qy,
+            &res.qz
+        })
+    {
+        v->resize(n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const Parameters& p = parameters[i];
+        if (p.eccentricity < 0.0 || p.eccentricity > 1.0) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Eccentricity {} of object '{}' out of range [0, 1]",
+                p.eccentricity, p.name
+            ));
+        }
+        if (p.inclination < 0.0 || p.inclination > 360.0) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Inclination {} of object '{}' out of range [0, 360]",
+                p.inclination, p.name
+            ));
+        }
+
+        res.eccentricity[i] = p.eccentricity;
+        res.semiMajorAxis[i] = p.semiMajorAxis * 1000.0;
+        res.meanAnomaly[i] = glm::radians(p.meanAnomaly);
+        res.meanMotion[i] = glm::two_pi<double>() / p.period;
+        res.epoch[i] = p.epoch;
+        res.period[i] = p.period;
+
+        // Same rotations as in KeplerTranslation::computeOrbitPlane
+        const glm::dmat3 rot = glm::dmat3(
+            glm::rotate(glm::radians(p.ascendingNode), glm::dvec3(0.0, 0.0, 1.0)) *
+            glm::rotate(glm::radians(p.inclination), glm::dvec3(1.0, 0.0, 0.0)) *
+            glm::rotate(glm::radians(p.argumentOfPeriapsis), glm::dvec3(0.0, 0.0, 1.0))
+        );
+        res.px[i] = rot[0].x;
+        res.py[i] = rot[0].y;
+        res.pz[i] = rot[0].z;
+        res.qx[i] = rot[1].x;
+        res.qy[i] = rot[1].y;
+        res.qz[i] = rot[1].z;
+    }
+    return res;
+}
+
+void eccentricAnomalies(double e, const double* meanAnomaly, double* result, size_t n) {
+    // The regimes and iteration counts have to match KeplerTranslation::eccentricAnomaly
+    if (e == 0.0) {
+        // In a circular orbit, the eccentric anomaly = mean anomaly
+        std::copy(meanAnomaly, meanAnomaly + n, result);
+    }
+    else if (e < 0.2) {
+        // For low eccentricity, using a first order solver sufficient
+        for (size_t i = 0; i < n; i++) {
+            const double m = meanAnomaly[i];
+            double x = m;
+            for (int it = 0; it < 5; it++) {
+                x = m + e * std::sin(x);
+            }
+            result[i] = x;
+        }
+    }
+    else if (e < 0.9) {
+        for (size_t i = 0; i < n; i++) {
+            const double m = meanAnomaly[i];
+            double x = m;
+            for (int it = 0; it < 6; it++) {
+                x = x + (m + e * std::sin(x) - x) / (1.0 - e * std::cos(x));
+            }
+            result[i] = x;
+        }
+    }
+    else if (e < 1.0) {
+        for (size_t i = 0; i < n; i++) {
+            const double m = meanAnomaly[i];
+            double x = m + 0.85 * e * sign(std::sin(m));
+            for (int it = 0; it < 8; it++) {
+                const double s = e * std::sin(x);
+                const double c = e * std::cos(x);
+                const double f = x - s - m;
+                const double f1 = 1 - c;
+                const double f2 = s;
+                x = x + (-5 * f / (f1 + sign(f1) *
+                    std::sqrt(std::abs(16 * f1 * f1 - 20 * f * f2))));
+            }
+            result[i] = x;
+        }
+    }
+    else {
+        std::fill(result, result + n, 0.0);
+    }
+}
+
+void generateOrbitVertices(const OrbitElements& elements,
+                           const std::vector<int>& nSegments,
+                           const std::vector<int>& firstVertex,
+                           OrbitVertex* vertices, unsigned int nThreads)
+{
+    ZoneScoped;
+
+    ghoul_precondition(
+        nSegments.size() == elements.size(),
+        "Segment sizes must match the number of orbits"
+    );
+    ghoul_precondition(
+        firstVertex.size() == elements.size(),
+        "First vertex indices must match the number of orbits"
+    );
+
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const size_t nBatches = (elements.size() + BatchSize - 1) / BatchSize;
+    nThreads = static_cast<unsigned int>(
+        std::min<size_t>(nThreads, std::max<size_t>(nBatches, 1))
+    );
+
+    // Each worker fetches batches of orbits until all of them are processed, which
+    // balances the load even if the number of segments differs between the orbits
+    std::atomic<size_t> nextBatch = 0;
+    auto worker = [&]() {
+        std::vector<double> timeOffsets;
+        std::vector<double> meanAnomalies;
+        std::vector<double> eccentricAnomalies;
+
+        for (size_t batch = nextBatch++; batch < nBatches; batch = nextBatch++) {
+            const size_t begin = batch * BatchSize;
+            const size_t end = std::min(begin + BatchSize, elements.size());
+            for (size_t i = begin; i < end; i++) {
+                generateOrbit(
+                    elements,
+                    i,
+                    nSegments[i],
+                    vertices + firstVertex[i],
+                    timeOffsets,
+                    meanAnomalies,
+                    eccentricAnomalies
+                );
+            }
+        }
+    };
+
+    // The calling thread works as well, so all batches are processed even if the pool
+    // is busy with other work
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 1; i < nThreads; i++) {
+        auto done = std::make_shared<std::promise<void>>();
+        futures.push_back(done->get_future());
+        workerPool().enqueue([&worker, done]() {
+            worker();
+            done->set_value();
+        });
+    }
+    worker();
+    for (std::future<void>& f : futures) {
+        f.get();
+    }
+}
+
+std::vector<OrbitRecord> orbitRecords(const OrbitElements& elements) {
+    ZoneScoped;
+
+    std::vector<OrbitRecord> res(elements.size());
+    for (size_t i = 0; i < elements.size(); i++) {
+        OrbitRecord& r = res[i];
+        r.epoch = elements.epoch[i];
+        r.period = elements.period[i];
+        r.eccentricity = static_cast<float>(elements.eccentricity[i]);
+        r.semiMajorAxis = static_cast<float>(elements.semiMajorAxis[i]);
+        r.meanAnomaly = static_cast<float>(elements.meanAnomaly[i]);
+        r.px = static_cast<float>(elements.px[i]);
+        r.py = static_cast<float>(elements.py[i]);
+        r.pz = static_cast<float>(elements.pz[i]);
+        r.qx = static_cast<float>(elements.qx[i]);
+        r.qy = static_cast<float>(elements.qy[i]);
+        r.qz = static_cast<float>(elements.qz[i]);
+    }
+    return res;
+}
+
+int numberOfSegments(double e, unsigned int quality) {
+    const double scale = static_cast<double>(quality) * 10.0;
+    return static_cast<int>(scale + (scale / std::pow(1.0 - e, 1.2)));
+}
+
+std::vector<OrbitBucket> orbitBuckets(const std::vector<float>& eccentricities,
+                                      unsigned int quality, double maxOverdraw)
+{
+    ghoul_precondition(
+        std::is_sorted(eccentricities.begin(), eccentricities.end()),
+        "Eccentricities must be sorted"
+    );
+    ghoul_precondition(maxOverdraw >= 1.0, "maxOverdraw must be at least 1");
+
+    std::vector<OrbitBucket> res;
+    size_t first = 0;
+    while (first < eccentricities.size()) {
+        const int minSegments = numberOfSegments(eccentricities[first], quality);
+        const double limit = static_cast<double>(minSegments) * maxOverdraw;
+
+        // Extend the range as long as the most eccentric orbit stays within the limit.
+        // The number of segments grows with the eccentricity, so the range always
+        // contains at least its first orbit
+        size_t last = first + 1;
+        int maxSegments = minSegments;
+        while (last < eccentricities.size()) {
+            const int n = numberOfSegments(eccentricities[last], quality);
+            if (static_cast<double>(n) > limit) {
+                break;
+            }
+            maxSegments = n;
+            last++;
+        }
+
+        // The shader evaluates the number of segments in single precision, so one
+        // additional vertex guards against it computing one more segment than we do.
+        // Surplus vertices collapse onto the end point of the orbit
+        res.push_back({
+            .first = first,
+            .count = last - first,
+            .nVertices = maxSegments + 2
+        });
+        first = last;
+    }
+    return res;
+}
+
+float orbitRecordMeanAnomaly(const OrbitRecord& record, double time) {
+    // Only the fraction of the current revolution is converted to single precision
+    const double revolutions = (time - record.epoch) / record.period;
+    const float fraction = static_cast<float>(revolutions - std::floor(revolutions));
+    return record.meanAnomaly + glm::two_pi<float>() * fraction;
+}
+
+glm::vec3 orbitRecordPosition(const OrbitRecord& record, float meanAnomaly) {
+    // This has to match the solver in orbitalkepler_gpu_vs.glsl
+    const float e = record.eccentricity;
+    const float m = meanAnomaly;
+    float x = m;
+    if (e == 0.f) {
+        x = m;
+    }
+    else if (e < 0.2f) {
+        for (int it = 0; it < 5; it++) {
+            x = m + e * std::sin(x);
+        }
+    }
+    else if (e < 0.9f) {
+        for (int it = 0; it < 6; it++) {
+            x = x + (m + e * std::sin(x) - x) / (1.f - e * std::cos(x));
+        }
+    }
+    else if (e < 1.f) {
+        x = m + 0.85f * e * sign(std::sin(m));
+        for (int it = 0; it < 8; it++) {
+            const float s = e * std::sin(x);
+            const float c = e * std::cos(x);
+            const float f = x - s - m;
+            const float f1 = 1.f - c;
+            const float f2 = s;
+            x = x + (-5.f * f / (f1 + sign(f1) *
+                std::sqrt(std::abs(16.f * f1 * f1 - 20.f * f * f2))));
+        }
+    }
+    else {
+        x = 0.f;
+    }
+
+    const float a = record.semiMajorAxis;
+    const float px = a * (std::cos(x) - e);
+    const float py = a * std::sin(x) * std::sqrt(1.f - e * e);
+    return glm::vec3(record.px, record.py, record.pz) * px +
+           glm::vec3(record.qx, record.qy, record.qz) * py;
+}
+
+} // namespace openspace::kepler
@@ -0,0 +1,208 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+
+#include <modules/space/kepler.h>
+#include <ghoul/glm.h>
+#include <cstddef>
+#include <vector>
+
+namespace openspace::kepler {
+
+/**
+ * The orbital elements of a list of objects stored as a structure of arrays, in the form
+ * that is needed to propagate the objects along their orbits. All vectors have the same
+ * length, with one entry per object.
+ */
+struct OrbitElements {
+    size_t size() const;
+
+    std::vector<double> eccentricity;
+    /// The semi-major axis in meters
+    std::vector<double> semiMajorAxis;
+    /// The mean anomaly at the epoch in radians
+    std::vector<double> meanAnomaly;
+    /// The mean motion in radians per second
+    std::vector<double> meanMotion;
+    /// The epoch in seconds past J2000
+    std::vector<double> epoch;
+    /// The orbital period in seconds
+    std::vector<double> period;
+
+    /// The direction towards the periapsis, the first column of the orbit plane rotation
+    std::vector<double> px;
+    std::vector<double> py;
+    std::vector<double> pz;
+    /// The second column of the orbit plane rotation, completing the orbit plane
+    std::vector<double> qx;
+    std::vector<double> qy;
+    std::vector<double> qz;
+};
+
+/**
+ * Converts the list of \p parameters into their structure of arrays representation. The
+ * orbit plane rotation is computed in the same way as in the KeplerTranslation.
+ *
+ * \param parameters The orbital parameters of the objects
+ * \return The orbital elements of all objects
+ *
+ * \throw ghoul::RuntimeError If an object has an eccentricity outside [0, 1] or an
+ *        inclination outside [0, 360]
+ */
+OrbitElements orbitElements(const std::vector<Parameters>& parameters);
+
+/**
+ * The layout of a vertex of an orbit, as it is used by the RenderableOrbitalKepler
+ */
+struct OrbitVertex {
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+    /// The time offset of the vertex relative to the epoch
+    float time = 0.f;
+    double epoch = 0.0;
+    double period = 0.0;
+};
+
+/**
+ * Computes the eccentric anomalies for the \p n mean anomalies \p meanAnomaly of an
+ * orbit with the eccentricity \p e and stores them in \p result. The solvers and number
+ * of iterations are the same as in KeplerTranslation::eccentricAnomaly, but as they only
+ * depend on the eccentricity, the same solver is applied to all values, which allows the
+ * compiler to vectorize the loop.
+ *
+ * \param e The eccentricity of the orbit
+ * \param meanAnomaly The mean anomalies in radians
+ * \param result The destination of the eccentric anomalies in radians
+ * \param n The number of values in \p meanAnomaly and \p result
+ */
+void eccentricAnomalies(double e, const double* meanAnomaly, double* result, size_t n);
+
+/**
+ * Generates the vertices for the closed orbits of all objects in \p elements and writes
+ * them into \p vertices. The orbit of object `i` is sampled at `nSegments[i] + 1`
+ * equidistant points in time starting at its epoch and covering one full period, and its
+ * vertices are written starting at `vertices[firstVertex[i]]`. The work is distributed
+ * across the calling thread and up to `nThreads - 1` threads of a shared thread pool.
+ *
+ * \param elements The orbital elements of all objects
+ * \param nSegments The number of line segments of each orbit
+ * \param firstVertex The index of the first vertex of each orbit in \p vertices
+ * \param vertices The destination of the vertices, which must be large enough
+ * \param nThreads The number of threads to use. If 0, the hardware concurrency is used
+ *
+ * \pre \p nSegments and \p firstVertex must have the same size as \p elements
+ */
+void generateOrbitVertices(const OrbitElements& elements,
+    const std::vector<int>& nSegments, const std::vector<int>& firstVertex,
+    OrbitVertex* vertices, unsigned int nThreads = 0);
+
+/**
+ * The per-object record that is uploaded to the GPU when the orbits are propagated in
+ * the vertex shader. The layout has to match the vertex attributes in
+ * `orbitalkepler_gpu_vs.glsl`. The functions orbitRecordMeanAnomaly and
+ * orbitRecordPosition implement the same math as the shader and serve as its reference.
+ */
+struct OrbitRecord {
+    /// The epoch in seconds past J2000
+    double epoch = 0.0;
+    /// The orbital period in seconds
+    double period = 0.0;
+    float eccentricity = 0.f;
+    /// The semi-major axis in meters
+    float semiMajorAxis = 0.f;
+    /// The mean anomaly at the epoch in radians
+    float meanAnomaly = 0.f;
+    /// The first column of the orbit plane rotation
+    float px = 0.f;
+    float py = 0.f;
+    float pz = 0.f;
+    /// The second column of the orbit plane rotation
+    float qx = 0.f;
+    float qy = 0.f;
+    float qz = 0.f;
+};
+
+/**
+ * Converts the orbital \p elements into the records that are uploaded to the GPU.
+ *
+ * \param elements The orbital elements of all objects
+ * \return One record per object
+ */
+std::vector<OrbitRecord> orbitRecords(const OrbitElements& elements);
+
+/**
+ * Returns the number of line segments that are used to render an orbit with the
+ * eccentricity \p e at the provided segment \p quality. This is the same number that is
+ * used for the baked orbits and in the vertex shader.
+ */
+int numberOfSegments(double e, unsigned int quality);
+
+/// A range of consecutive orbit records that are drawn with the same number of vertices
+struct OrbitBucket {
+    /// The index of the first record of the range
+    size_t first = 0;
+    /// The number of records in the range
+    size_t count = 0;
+    /// The number of vertices with which every orbit of the range is drawn
+    int nVertices = 0;
+};
+
+/**
+ * Splits orbits into ranges that can each be drawn with a single instanced draw call.
+ * The number of vertices of a range is large enough for its most eccentric orbit, and
+ * the number of segments of the least eccentric orbit in a range is at most a factor of
+ * \p maxOverdraw smaller, which limits the number of surplus vertices that the vertex
+ * shader has to process for the other orbits of the range.
+ *
+ * \param eccentricities The eccentricities of the orbits in ascending order
+ * \param quality The segment quality with which the orbits are drawn
+ * \param maxOverdraw The largest ratio between the number of vertices of a range and
+ *        the number of segments of any of its orbits
+ * \return The ranges, which cover all orbits in order
+ *
+ * \pre \p eccentricities must be sorted in ascending order
+ * \pre \p maxOverdraw must be at least 1
+ */
+std::vector<OrbitBucket> orbitBuckets(const std::vector<float>& eccentricities,
+    unsigned int quality, double maxOverdraw = 1.25);
+
+/**
+ * Computes the mean anomaly in radians of the object described by \p record at the
+ * \p time in seconds past J2000. The number of revolutions is computed in double
+ * precision before being reduced to a single period, as it is done in the shader.
+ */
+float orbitRecordMeanAnomaly(const OrbitRecord& record, double time);
+
+/**
+ * Computes the position in meters of the object described by \p record for the provided
+ * \p meanAnomaly in single precision, as it is done in the vertex shader.
+ */
+glm::vec3 orbitRecordPosition(const OrbitRecord& record, float meanAnomaly);
+
+} // namespace openspace::kepler
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
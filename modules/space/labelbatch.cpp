@@ -0,0 +1,352 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/labelbatch.h>
+
+#include <modules/space/spacemodule.h>
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/font/font.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <ghoul/opengl/openglstatecache.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/textureatlas.h>
+#include <ghoul/opengl/textureunit.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace {
+    constexpr std::string_view ProgramName = "LabelBatch";
+
+    constexpr std::array<const char*, 14> UniformNames = {
+        "modelViewProjection", "orthoRight", "orthoUp", "faceCamera", "cameraPosition",
+        "cameraLookUp", "scale", "lineHeight", "minSize", "maxSize", "viewportSize",
+        "color", "outlineColor", "fontTexture"
+    };
+
+    // The character that is used for invalid byte sequences in the label texts
+    constexpr wchar_t ReplacementCharacter = L'?';
+} // namespace
+
+namespace openspace::labelbatch {
+
+GlyphLookup glyphLookup(ghoul::fontrendering::Font& font) {
+    return [&font](wchar_t character) -> std::optional<GlyphMetrics> {
+        const ghoul::fontrendering::Font::Glyph* glyph = font.glyph(character);
+        if (!glyph) {
+            return std::nullopt;
+        }
+
+        return GlyphMetrics {
+            .leftBearing = glyph->leftBearing,
+            .topBearing = glyph->topBearing,
+            .width = glyph->width,
+            .height = glyph->height,
+            .advance = glyph->horizontalAdvance,
+            .texCoordTopLeft = glyph->topLeft,
+            .texCoordBottomRight = glyph->bottomRight,
+            .outlineTexCoordTopLeft = glyph->outlineTopLeft,
+            .outlineTexCoordBottomRight = glyph->outlineBottomRight
+        };
+    };
+}
+
+std::wstring decodeUtf8(std::string_view text) {
+    std::wstring result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char lead = static_cast<unsigned char>(text[i]);
+
+        uint32_t codePoint = 0;
+        size_t nBytes = 0;
+        if (lead < 0x80) {
+            codePoint = lead;
+            nBytes = 1;
+        }
+        else if ((lead & 0xE0) == 0xC0) {
+            codePoint = lead & 0x1F;
+            nBytes = 2;
+        }
+        else if ((lead & 0xF0) == 0xE0) {
+            codePoint = lead & 0x0F;
+            nBytes = 3;
+        }
+        else if ((lead & 0xF8) == 0xF0) {
+            codePoint = lead & 0x07;
+            nBytes = 4;
+        }
+        else {
+            // A continuation byte without a lead byte
+            result.push_back(ReplacementCharacter);
+            i++;
+            continue;
+        }
+
+        if (i + nBytes > text.size()) {
+            // The text ends in the middle of a character
+            result.push_back(ReplacementCharacter);
+            break;
+        }
+
+        bool isValid = true;
+        for (size_t j = 1; j < nBytes; j++) {
+            const unsigned char c = static_cast<unsigned char>(text[i + j]);
+            if ((c & 0xC0) != 0x80) {
+                isValid = false;
+                break;
+            }
+            codePoint = (codePoint << 6) | (c & 0x3F);
+        }
+
+        if (!isValid) {
+            // Skip only the lead byte so that the following character is not lost
+            result.push_back(ReplacementCharacter);
+            i++;
+            continue;
+        }
+        i += nBytes;
+
+        // On Windows, wchar_t only covers the basic multilingual plane
+        constexpr uint32_t MaxCharacter =
+            static_cast<uint32_t>(std::numeric_limits<wchar_t>::max());
+        if (codePoint > MaxCharacter) {
+            result.push_back(ReplacementCharacter);
+        }
+        else {
+            result.push_back(static_cast<wchar_t>(codePoint));
+        }
+    }
+    return result;
+}
+
+void appendLabel(Layout& layout, const glm::vec3& position, std::string_view text,
+                 float lineHeight, const GlyphLookup& glyph)
+{
+    const std::wstring characters = decodeUtf8(text);
+
+    // The pen starts on the baseline of the first line
+    glm::vec2 pen = glm::vec2(0.f);
+    for (wchar_t c : characters) {
+        if (c == L'\n') {
+            pen.x = 0.f;
+            pen.y -= lineHeight;
+            continue;
+        }
+
+        const std::optional<GlyphMetrics> g = glyph(c);
+        if (!g.has_value()) {
+            continue;
+        }
+
+        if (g->width > 0.f && g->height > 0.f) {
+            const float left = pen.x + g->leftBearing;
+            const float top = pen.y + g->topBearing;
+
+            GlyphInstance instance;
+            instance.labelPosition = position;
+            instance.rect = glm::vec4(left, top, left + g->width, top - g->height);
+            instance.texCoords = glm::vec4(g->texCoordTopLeft, g->texCoordBottomRight);
+            instance.outlineTexCoords = glm::vec4(
+                g->outlineTexCoordTopLeft,
+                g->outlineTexCoordBottomRight
+            );
+            layout.glyphs.push_back(instance);
+        }
+        pen.x += g->advance;
+    }
+
+    layout.nLabels++;
+}
+
+void LabelBatch::initializeGL() {
+    ZoneScoped;
+
+    _program = SpaceModule::ProgramObjectManager.request(
+        std::string(ProgramName),
+        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+            return global::renderEngine->buildRenderProgram(
+                std::string(ProgramName),
+                absPath("${MODULE_SPACE}/shaders/labelbatch_vs.glsl"),
+                absPath("${MODULE_SPACE}/shaders/labelbatch_fs.glsl")
+            );
+        }
+    );
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(1, &_vbo);
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    // All attributes advance once per instance, that is once per glyph. The four
+    // vertices of each glyph quad are generated in the vertex shader
+    constexpr GLsizei Stride = sizeof(GlyphInstance);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, labelPosition))
+    );
+    glVertexAttribDivisor(0, 1);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, rect))
+    );
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(
+        2,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, texCoords))
+    );
+    glVertexAttribDivisor(2, 1);
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(
+        3,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, outlineTexCoords))
+    );
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+}
+
+void LabelBatch::deinitializeGL() {
+    glDeleteBuffers(1, &_vbo);
+    _vbo = 0;
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+    _nGlyphs = 0;
+    _nLabels = 0;
+
+    if (_program) {
+        SpaceModule::ProgramObjectManager.release(
+            std::string(ProgramName),
+            [](ghoul::opengl::ProgramObject* p) {
+                global::renderEngine->removeRenderProgram(p);
+            }
+        );
+        _program = nullptr;
+    }
+}
+
+void LabelBatch::upload(const Layout& layout, float lineHeight) {
+    ZoneScoped;
+
+    ghoul_assert(isInitialized(), "LabelBatch must be initialized");
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        layout.glyphs.size() * sizeof(GlyphInstance),
+        layout.glyphs.data(),
+        GL_STATIC_DRAW
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _nGlyphs = static_cast<GLsizei>(layout.glyphs.size());
+    _nLabels = layout.nLabels;
+    _lineHeight = lineHeight;
+}
+
+void LabelBatch::render(ghoul::fontrendering::Font& font, const RenderInformation& info)
+{
+    ZoneScoped;
+
+    if (_nGlyphs == 0) {
+        return;
+    }
+
+    _program->activate();
+
+    _program->setUniform(_uniformCache.modelViewProjection, info.modelViewProjection);
+    _program->setUniform(_uniformCache.orthoRight, info.orthoRight);
+    _program->setUniform(_uniformCache.orthoUp, info.orthoUp);
+    _program->setUniform(_uniformCache.faceCamera, info.faceCamera);
+    _program->setUniform(_uniformCache.cameraPosition, info.cameraPosition);
+    _program->setUniform(_uniformCache.cameraLookUp, info.cameraLookUp);
+    _program->setUniform(_uniformCache.scale, info.scale);
+    _program->setUniform(_uniformCache.lineHeight, _lineHeight);
+    _program->setUniform(_uniformCache.minSize, info.minSize);
+    _program->setUniform(_uniformCache.maxSize, info.maxSize);
+    _program->setUniform(
+        _uniformCache.viewportSize,
+        glm::vec2(global::renderEngine->renderingResolution())
+    );
+    _program->setUniform(_uniformCache.color, info.color);
+    _program->setUniform(_uniformCache.outlineColor, info.outlineColor);
+
+    ghoul::opengl::TextureUnit fontUnit;
+    fontUnit.activate();
+    font.atlas().texture().bind();
+    _program->setUniform(_uniformCache.fontTexture, fontUnit);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(false);
+
+    glBindVertexArray(_vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _nGlyphs);
+    glBindVertexArray(0);
+
+    _program->deactivate();
+
+    global::renderEngine->openglStateCache().resetBlendState();
+    global::renderEngine->openglStateCache().resetDepthState();
+}
+
+bool LabelBatch::isInitialized() const {
+    return _program && _vao != 0;
+}
+
+int LabelBatch::nLabels() const {
+    return _nLabels;
+}
+
+} // namespace openspace::labelbatch
@@ -0,0 +1,175 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___LABELBATCH___H__
+#define __OPENSPACE_MODULE_SPACE___LABELBATCH___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ghoul::fontrendering { class Font; }
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace::labelbatch {
+
+/// The metrics of a single glyph of a font, in pixels of the font
+struct GlyphMetrics {
+    /// The horizontal distance from the pen position to the left edge of the glyph
+    float leftBearing = 0.f;
+
+    /// The vertical distance from the baseline to the top edge of the glyph
+    float topBearing = 0.f;
+
+    float width = 0.f;
+    float height = 0.f;
+
+    /// The horizontal distance from the pen position to the next pen position
+    float advance = 0.f;
+
+    /// The texture coordinates of the glyph in the font atlas
+    glm::vec2 texCoordTopLeft = glm::vec2(0.f);
+    glm::vec2 texCoordBottomRight = glm::vec2(0.f);
+
+    /// The texture coordinates of the glyph's outline in the font atlas
+    glm::vec2 outlineTexCoordTopLeft = glm::vec2(0.f);
+    glm::vec2 outlineTexCoordBottomRight = glm::vec2(0.f);
+};
+
+/**
+ * A function that returns the metrics for the provided character or `std::nullopt` if
+ * the font does not contain the character
+ */
+using GlyphLookup = std::function<std::optional<GlyphMetrics>(wchar_t)>;
+
+/// Returns a GlyphLookup that queries the glyphs of the provided \p font
+GlyphLookup glyphLookup(ghoul::fontrendering::Font& font);
+
+/**
+ * The per-instance data of a single glyph quad. The layout of this struct has to match
+ * the attributes of the `labelbatch_vs.glsl` shader
+ */
+struct GlyphInstance {
+    /// The position of the label that this glyph belongs to
+    glm::vec3 labelPosition = glm::vec3(0.f);
+
+    /// The corners of the glyph quad relative to the label position in pixels of the
+    /// font as (left, top, right, bottom)
+    glm::vec4 rect = glm::vec4(0.f);
+
+    /// The texture coordinates of the glyph as (left, top, right, bottom)
+    glm::vec4 texCoords = glm::vec4(0.f);
+
+    /// The texture coordinates of the glyph's outline as (left, top, right, bottom)
+    glm::vec4 outlineTexCoords = glm::vec4(0.f);
+};
+
+/// The glyphs of all labels of a label set, laid out once on the CPU
+struct Layout {
+    std::vector<GlyphInstance> glyphs;
+
+    /// The number of labels that were added to the layout
+    int nLabels = 0;
+};
+
+/**
+ * Decodes the UTF-8 encoded \p text into individual characters. Invalid byte sequences
+ * and characters that can not be represented by a `wchar_t` are replaced by a question
+ * mark.
+ */
+std::wstring decodeUtf8(std::string_view text);
+
+/**
+ * Lays out the glyphs of the \p text of a label at the provided \p position and appends
+ * them to the \p layout. The first line starts at the label position and each new line
+ * in the text moves the pen down by \p lineHeight. Characters that are missing from the
+ * font and glyphs without an area, such as spaces, only advance the pen.
+ */
+void appendLabel(Layout& layout, const glm::vec3& position, std::string_view text,
+    float lineHeight, const GlyphLookup& glyph);
+
+/**
+ * A set of labels whose glyphs are stored in a persistent GPU buffer and that are
+ * rendered with a single instanced draw call. The glyph layout is only created once and
+ * has to be uploaded again only when the labels change. The orientation and the size
+ * limits of the labels are applied in the vertex shader each frame.
+ */
+class LabelBatch {
+public:
+    struct RenderInformation {
+        glm::dmat4 modelViewProjection = glm::dmat4(1.0);
+
+        /// The right and up vectors of the labels if they are facing the camera
+        glm::vec3 orthoRight = glm::vec3(1.f, 0.f, 0.f);
+        glm::vec3 orthoUp = glm::vec3(0.f, 1.f, 0.f);
+
+        /// If `false`, the labels are oriented along the direction from the camera
+        bool faceCamera = true;
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        glm::vec3 cameraLookUp = glm::vec3(0.f, 1.f, 0.f);
+
+        /// The factor that converts pixels of the font into the label coordinate system
+        float scale = 1.f;
+
+        /// The minimum and maximum height of a line of text on screen in pixels
+        float minSize = 0.f;
+        float maxSize = 0.f;
+
+        glm::vec4 color = glm::vec4(1.f);
+        glm::vec4 outlineColor = glm::vec4(0.f, 0.f, 0.f, 1.f);
+    };
+
+    void initializeGL();
+    void deinitializeGL();
+
+    /// Replaces the glyphs that are stored in the GPU buffer with the \p layout
+    void upload(const Layout& layout, float lineHeight);
+
+    /// Renders all labels of this batch with the glyphs from the atlas of the \p font
+    void render(ghoul::fontrendering::Font& font, const RenderInformation& info);
+
+    bool isInitialized() const;
+    int nLabels() const;
+
+private:
+    ghoul::opengl::ProgramObject* _program = nullptr;
+    UniformCache(modelViewProjection, orthoRight, orthoUp, faceCamera, cameraPosition,
+        cameraLookUp, scale, lineHeight, minSize, maxSize, viewportSize, color,
+        outlineColor, fontTexture) _uniformCache;
+
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    GLsizei _nGlyphs = 0;
+    int _nLabels = 0;
+    float _lineHeight = 0.f;
+};
+
+} // namespace openspace::labelbatch
+
+#endif // __OPENSPACE_MODULE_SPACE___LABELBATCH___H__
@@ -27,10 +27,13 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/rendering/renderengine.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
+#include <ghoul/misc/profiling.h>
+#include <limits>
 #include <optional>
 
 namespace {
@@ -39,6 +42,11 @@ namespace {
     constexpr int RenderOptionFaceCamera = 0;
     constexpr int RenderOptionPositionNormal = 1;
 
+    // The font renderer skips labels that are smaller than the minimum size. As the size
+    // of a glyph is only estimated on the CPU, labels are only culled if they are smaller
+    // than this fraction of the minimum size to not lose labels that would be visible
+    constexpr double SizeCullingMargin = 0.5;
+
     constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
         "Enabled",
         "Enabled",
@@ -92,6 +100,17 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo RenderInstancedInfo = {
+        "InstancedRendering",
+        "Instanced Rendering",
+        "If enabled, the glyphs of all labels are laid out once and rendered with a "
+        "single draw call, and the orientation and size limits of the labels are "
+        "computed on the GPU. This path does not apply kerning and does not cull the "
+        "labels on the CPU. If disabled, only the labels that might be visible are laid "
+        "out and rendered individually every frame",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     constexpr openspace::properties::Property::PropertyInfo TransformationMatrixInfo = {
         "TransformationMatrix",
         "Transformation Matrix",
@@ -100,6 +119,21 @@ namespace {
         openspace::properties::Property::Visibility::Developer
     };
 
+    constexpr openspace::properties::Property::PropertyInfo DrawnLabelsInfo = {
+        "DrawnLabels",
+        "Drawn Labels",
+        "The number of labels that were rendered in the last frame",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CulledLabelsInfo = {
+        "CulledLabels",
+        "Culled Labels",
+        "The number of labels that were not rendered in the last frame as they were "
+        "either outside the view frustum or too small to be visible",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(LabelsComponent)]] Parameters {
         // [[codegen::verbatim(EnabledInfo.description)]]
         std::optional<bool> enabled;
@@ -136,6 +170,9 @@ namespace {
         // [[codegen::verbatim(FaceCameraInfo.description)]]
         std::optional<bool> faceCamera;
 
+        // [[codegen::verbatim(RenderInstancedInfo.description)]]
+        std::optional<bool> instancedRendering;
+
         // [[codegen::verbatim(TransformationMatrixInfo.description)]]
         std::optional<glm::dmat4x4> transformationMatrix;
     };
@@ -161,6 +198,9 @@ LabelsComponent::LabelsComponent(const ghoul::Dictionary& dictionary)
         glm::ivec2(1000)
     )
     , _faceCamera(FaceCameraInfo, true)
+    , _renderInstanced(RenderInstancedInfo, false)
+    , _nDrawnLabels(DrawnLabelsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _nCulledLabels(CulledLabelsInfo, 0, 0, std::numeric_limits<int>::max())
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -213,10 +253,21 @@ LabelsComponent::LabelsComponent(const ghoul::Dictionary& dictionary)
     }
     addProperty(_faceCamera);
 
+    _renderInstanced = p.instancedRendering.value_or(_renderInstanced);
+    addProperty(_renderInstanced);
+
     _transformationMatrix = p.transformationMatrix.value_or(_transformationMatrix);
+
+    _nDrawnLabels.setReadOnly(true);
+    addProperty(_nDrawnLabels);
+
+    _nCulledLabels.setReadOnly(true);
+    addProperty(_nCulledLabels);
 }
 
 speck::Labelset& LabelsComponent::labelSet() {
+    _isIndexDirty = true;
+    _isBatchDirty = true;
     return _labelset;
 }
 
@@ -231,11 +282,71 @@ void LabelsComponent::initialize() {
         ghoul::fontrendering::FontManager::Outline::Yes,
         ghoul::fontrendering::FontManager::LoadGlyphs::No
     );
+    _isBatchDirty = true;
+}
+
+void LabelsComponent::initializeGL() {
+    _batch.initializeGL();
+    _isBatchDirty = true;
+}
+
+void LabelsComponent::deinitializeGL() {
+    _batch.deinitializeGL();
 }
 
 void LabelsComponent::loadLabels() {
     LINFO(fmt::format("Loading label file {}", _labelFile));
     _labelset = speck::label::loadFileWithCache(_labelFile);
+    _isIndexDirty = true;
+    _isBatchDirty = true;
+}
+
+void LabelsComponent::buildIndex() {
+    ZoneScoped;
+
+    const float scale = static_cast<float>(toMeter(_unit));
+
+    std::vector<glm::vec3> positions;
+    positions.reserve(_labelset.entries.size());
+    std::vector<uint32_t> textLengths;
+    textLengths.reserve(_labelset.entries.size());
+    for (const speck::Labelset::Entry& e : _labelset.entries) {
+        // Transform and scale the labels
+        glm::vec3 transformedPos(_transformationMatrix * glm::dvec4(e.position, 1.0));
+        glm::vec3 scaledPos(transformedPos);
+        scaledPos *= scale;
+        positions.push_back(scaledPos);
+
+        // The number of bytes is an upper bound for the number of characters
+        textLengths.push_back(static_cast<uint32_t>(e.text.size()));
+    }
+
+    _index.build(std::move(positions), std::move(textLengths));
+    _isIndexDirty = false;
+}
+
+void LabelsComponent::updateBatch() {
+    ZoneScoped;
+
+    const float scale = static_cast<float>(toMeter(_unit));
+    const float lineHeight = _font->height();
+    const labelbatch::GlyphLookup glyph = labelbatch::glyphLookup(*_font);
+
+    labelbatch::Layout layout;
+    for (const speck::Labelset::Entry& e : _labelset.entries) {
+        if (!e.isEnabled) {
+            continue;
+        }
+
+        // Transform and scale the labels
+        glm::vec3 transformedPos(_transformationMatrix * glm::dvec4(e.position, 1.0));
+        glm::vec3 scaledPos(transformedPos);
+        scaledPos *= scale;
+        labelbatch::appendLabel(layout, scaledPos, e.text, lineHeight, glyph);
+    }
+
+    _batch.upload(layout, lineHeight);
+    _isBatchDirty = false;
 }
 
 bool LabelsComponent::isReady() const {
@@ -251,10 +362,40 @@ void LabelsComponent::render(const RenderData& data,
                              const glm::vec3& orthoRight, const glm::vec3& orthoUp,
                              float fadeInVariable)
 {
+    ZoneScoped;
+
     if (!_enabled) {
         return;
     }
-    float scale = static_cast<float>(toMeter(_unit));
+
+    if (_renderInstanced && _batch.isInitialized()) {
+        if (_isBatchDirty) {
+            updateBatch();
+        }
+
+        labelbatch::LabelBatch::RenderInformation info;
+        info.modelViewProjection = modelViewProjectionMatrix;
+        info.orthoRight = orthoRight;
+        info.orthoUp = orthoUp;
+        info.faceCamera = _faceCamera;
+        info.cameraPosition = data.camera.positionVec3();
+        info.cameraLookUp = data.camera.lookUpVectorWorldSpace();
+        info.scale = pow(10.f, _size);
+        info.minSize = static_cast<float>(_minMaxSize.value().x);
+        info.maxSize = static_cast<float>(_minMaxSize.value().y);
+        info.color = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
+        _batch.render(*_font, info);
+
+        // All labels are submitted to the GPU, where the labels outside the view are
+        // clipped, so none of them count as culled
+        _nDrawnLabels = _batch.nLabels();
+        _nCulledLabels = 0;
+        return;
+    }
+
+    if (_isIndexDirty) {
+        buildIndex();
+    }
 
     int renderOption = _faceCamera ? RenderOptionFaceCamera : RenderOptionPositionNormal;
 
@@ -271,26 +412,36 @@ void LabelsComponent::render(const RenderData& data,
     labelInfo.enableDepth = true;
     labelInfo.enableFalseDepth = false;
 
+    // The glyphs are scaled by the label scale relative to their size in the font, so
+    // their extent in the coordinate system of the labels is bounded by the font size
+    LabelsIndex::CullingParameters cullingParameters;
+    cullingParameters.modelViewProjection = modelViewProjectionMatrix;
+    cullingParameters.glyphSize = labelInfo.scale * _fontSize;
+    cullingParameters.viewportHeight = global::renderEngine->renderingResolution().y;
+    cullingParameters.minSize = labelInfo.minSize * SizeCullingMargin;
+    _index.cull(cullingParameters, _cullingResult);
+
     glm::vec4 textColor = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
 
-    for (const speck::Labelset::Entry& e : _labelset.entries) {
+    int nDrawn = 0;
+    for (uint32_t index : _cullingResult.visible) {
+        const speck::Labelset::Entry& e = _labelset.entries[index];
         if (!e.isEnabled) {
             continue;
         }
 
-        // Transform and scale the labels
-        glm::vec3 transformedPos(_transformationMatrix * glm::dvec4(e.position, 1.0));
-        glm::vec3 scaledPos(transformedPos);
-        scaledPos *= scale;
-
         ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
             *_font,
-            scaledPos,
+            _index.position(index),
             e.text,
             textColor,
             labelInfo
         );
+        nDrawn++;
     }
+
+    _nDrawnLabels = nDrawn;
+    _nCulledLabels = _cullingResult.nFrustumCulled + _cullingResult.nSizeCulled;
 }
 
 } // namespace openspace
@@ -28,9 +28,12 @@
 #include <openspace/properties/propertyowner.h>
 #include <openspace/rendering/fadeable.h>
 
+#include <modules/space/labelbatch.h>
+#include <modules/space/labelsindex.h>
 #include <modules/space/speckloader.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/ivec2property.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <openspace/util/distanceconversion.h>
@@ -49,10 +52,17 @@ public:
     explicit LabelsComponent(const ghoul::Dictionary& dictionary);
     ~LabelsComponent() override = default;
 
+    /**
+     * Returns the label set for modification. As the labels might change through the
+     * returned reference, the spatial index and the glyph batch of the labels are rebuilt
+     * before the next time the labels are rendered.
+     */
     speck::Labelset& labelSet();
     const speck::Labelset& labelSet() const;
 
     void initialize();
+    void initializeGL();
+    void deinitializeGL();
 
     void loadLabels();
 
@@ -66,6 +76,9 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    void buildIndex();
+    void updateBatch();
+
     std::filesystem::path _labelFile;
     DistanceUnit _unit = DistanceUnit::Parsec;
     speck::Labelset _labelset;
@@ -74,6 +87,13 @@ private:
 
     glm::dmat4 _transformationMatrix = glm::dmat4(1.0);
 
+    LabelsIndex _index;
+    bool _isIndexDirty = true;
+    LabelsIndex::CullingResult _cullingResult;
+
+    labelbatch::LabelBatch _batch;
+    bool _isBatchDirty = true;
+
     // Properties
     properties::BoolProperty _enabled;
     properties::Vec3Property _color;
@@ -81,6 +101,9 @@ private:
     properties::FloatProperty _fontSize;
     properties::IVec2Property _minMaxSize;
     properties::BoolProperty _faceCamera;
+    properties::BoolProperty _renderInstanced;
+    properties::IntProperty _nDrawnLabels;
+    properties::IntProperty _nCulledLabels;
 };
 
 } // namespace openspace
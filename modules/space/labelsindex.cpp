@@ -0,0 +1,317 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/labelsindex.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+    // The maximum number of labels in a leaf node of the octree
+    constexpr uint32_t MaxLeafSize = 32;
+
+    // The maximum depth of the octree, which prevents a degenerate subdivision in case
+    // many labels are placed at almost the same position
+    constexpr int MaxDepth = 16;
+
+    // The linear functions of the clip-space coordinates that have to be non-negative for
+    // a point to be inside the view frustum: left, right, bottom, top, near, and far
+    constexpr int NPlanes = 6;
+    double planeDistance(const glm::dvec4& c, int plane) {
+        switch (plane) {
+            case 0:  return c.w + c.x;
+            case 1:  return c.w - c.x;
+            case 2:  return c.w + c.y;
+            case 3:  return c.w - c.y;
+            case 4:  return c.w + c.z;
+            default: return c.w - c.z;
+        }
+    }
+
+    std::array<glm::dvec4, 8> clipCorners(const glm::dmat4& mvp, const glm::dvec3& bMin,
+                                           const glm::dvec3& bMax)
+    {
+        std::array<glm::dvec4, 8> res;
+        for (int i = 0; i < 8; i++) {
+            const glm::dvec3 corner = glm::dvec3(
+                (i & 1) ? bMax.x : bMin.x,
+                (i & 2) ? bMax.y : bMin.y,
+                (i & 4) ? bMax.z : bMin.z
+            );
+            res[i] = mvp * glm::dvec4(corner, 1.0);
+        }
+        return res;
+    }
+
+    double projectedSize(double clipSize, double w, double viewportHeight) {
+        // Converting the clip-space extent into normalized device coordinates, which
+        // span 2 units over the height of the viewport
+        return clipSize / w * viewportHeight * 0.5;
+    }
+} // namespace
+
+namespace openspace {
+
+void LabelsIndex::build(std::vector<glm::vec3> positions,
+                        std::vector<uint32_t> textLengths)
+{
+    ZoneScoped;
+
+    ghoul_precondition(
+        positions.size() == textLengths.size(),
+        "Positions and text lengths must have the same size"
+    );
+
+    _positions = std::move(positions);
+    _textLengths = std::move(textLengths);
+    _order.resize(_positions.size());
+    std::iota(_order.begin(), _order.end(), 0);
+    _nodes.clear();
+
+    if (_positions.empty()) {
+        return;
+    }
+
+    Node root;
+    root.first = 0;
+    root.count = static_cast<uint32_t>(_positions.size());
+    _nodes.push_back(root);
+    buildNode(0, 0);
+}
+
+void LabelsIndex::clear() {
+    _positions.clear();
+    _textLengths.clear();
+    _order.clear();
+    _nodes.clear();
+}
+
+size_t LabelsIndex::nLabels() const {
+    return _positions.size();
+}
+
+const glm::vec3& LabelsIndex::position(uint32_t index) const {
+    ghoul_assert(index < _positions.size(), "Index out of bounds");
+    return _positions[index];
+}
+
+void LabelsIndex::buildNode(uint32_t nodeIndex, int depth) {
+    // The _nodes vector grows while building the children, so we can't keep a reference
+    // to the node around
+    const uint32_t first = _nodes[nodeIndex].first;
+    const uint32_t count = _nodes[nodeIndex].count;
+
+    glm::dvec3 bMin = glm::dvec3(std::numeric_limits<double>::max());
+    glm::dvec3 bMax = glm::dvec3(-std::numeric_limits<double>::max());
+    uint32_t maxTextLength = 0;
+    for (uint32_t i = first; i < first + count; i++) {
+        const glm::dvec3 p = glm::dvec3(_positions[_order[i]]);
+        bMin = glm::min(bMin, p);
+        bMax = glm::max(bMax, p);
+        maxTextLength = std::max(maxTextLength, _textLengths[_order[i]]);
+    }
+    _nodes[nodeIndex].boundsMin = bMin;
+    _nodes[nodeIndex].boundsMax = bMax;
+    _nodes[nodeIndex].maxTextLength = maxTextLength;
+
+    if (count <= MaxLeafSize || depth >= MaxDepth || bMin == bMax) {
+        return;
+    }
+
+    // Partition the labels into the octants around the center of the bounding box. The
+    // labels are split along x first, then each half along y, and each quarter along z
+    const glm::dvec3 center = (bMin + bMax) * 0.5;
+    std::array<uint32_t, 9> bounds;
+    bounds[0] = first;
+    bounds[8] = first + count;
+    auto split = [this, &center](uint32_t begin, uint32_t end, int axis) {
+        auto it = std::partition(
+            _order.begin() + begin,
+            _order.begin() + end,
+            [this, &center, axis](uint32_t i) {
+                return static_cast<double>(_positions[i][axis]) < center[axis];
+            }
+        );
+        return static_cast<uint32_t>(std::distance(_order.begin(), it));
+    };
+    bounds[4] = split(bounds[0], bounds[8], 0);
+    bounds[2] = split(bounds[0], bounds[4], 1);
+    bounds[6] = split(bounds[4], bounds[8], 1);
+    for (int i = 0; i < 8; i += 2) {
+        bounds[i + 1] = split(bounds[i], bounds[i + 2], 2);
+    }
+
+    const uint32_t firstChild = static_cast<uint32_t>(_nodes.size());
+    uint32_t nChildren = 0;
+    for (int i = 0; i < 8; i++) {
+        if (bounds[i + 1] > bounds[i]) {
+            Node child;
+            child.first = bounds[i];
+            child.count = bounds[i + 1] - bounds[i];
+            _nodes.push_back(child);
+            nChildren++;
+        }
+    }
+    _nodes[nodeIndex].firstChild = firstChild;
+    _nodes[nodeIndex].nChildren = nChildren;
+
+    for (uint32_t i = 0; i < nChildren; i++) {
+        buildNode(firstChild + i, depth + 1);
+    }
+}
+
+void LabelsIndex::cull(const CullingParameters& parameters, CullingResult& result) const
+{
+    ZoneScoped;
+
+    result.visible.clear();
+    result.nFrustumCulled = 0;
+    result.nSizeCulled = 0;
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    // The glyph size is a length in model space, which is transformed into clip space by
+    // the upper 4x3 part of the matrix. Its Frobenius norm is an upper bound for the
+    // length of any transformed vector of unit length
+    const glm::dmat4& mvp = parameters.modelViewProjection;
+    double norm = 0.0;
+    for (int c = 0; c < 3; c++) {
+        for (int r = 0; r < 4; r++) {
+            norm += mvp[c][r] * mvp[c][r];
+        }
+    }
+    const double clipGlyphSize = parameters.glyphSize * std::sqrt(norm);
+
+    cullNode(_nodes.front(), parameters, clipGlyphSize, false, result);
+
+    // Nodes are traversed in octree order, but the labels should be rendered in the order
+    // in which they were defined so that overlapping labels are blended consistently
+    std::sort(result.visible.begin(), result.visible.end());
+}
+
+void LabelsIndex::cullNode(const Node& node, const CullingParameters& parameters,
+                           double clipGlyphSize, bool isInside,
+                           CullingResult& result) const
+{
+    const bool useSizeCulling =
+        parameters.minSize > 0.0 && parameters.viewportHeight > 0.0;
+
+    // The margin by which the frustum is expanded to account for the extent of the text
+    const double margin = clipGlyphSize * (node.maxTextLength + 1);
+
+    const std::array<glm::dvec4, 8> corners = clipCorners(
+        parameters.modelViewProjection,
+        node.boundsMin,
+        node.boundsMax
+    );
+
+    if (!isInside) {
+        bool allInside = true;
+        for (int p = 0; p < NPlanes; p++) {
+            bool allOutside = true;
+            for (const glm::dvec4& c : corners) {
+                const double d = planeDistance(c, p);
+                allOutside &= d < -margin;
+                allInside &= d >= margin;
+            }
+            if (allOutside) {
+                result.nFrustumCulled += node.count;
+                return;
+            }
+        }
+        isInside = allInside;
+    }
+
+    if (useSizeCulling) {
+        // The clip-space w is linear in the position, so its minimum over the box is
+        // attained at one of the corners. The largest projected glyph in this node can't
+        // be bigger than a glyph placed at that minimum
+        double minW = std::numeric_limits<double>::max();
+        for (const glm::dvec4& c : corners) {
+            minW = std::min(minW, c.w);
+        }
+        if (minW > 0.0) {
+            const double size = projectedSize(
+                clipGlyphSize,
+                minW,
+                parameters.viewportHeight
+            );
+            if (size < parameters.minSize) {
+                result.nSizeCulled += node.count;
+                return;
+            }
+        }
+    }
+
+    if (node.nChildren > 0) {
+        for (uint32_t i = 0; i < node.nChildren; i++) {
+            cullNode(
+                _nodes[node.firstChild + i],
+                parameters,
+                clipGlyphSize,
+                isInside,
+                result
+            );
+        }
+        return;
+    }
+
+    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+        const uint32_t index = _order[i];
+        const glm::dvec3 position = glm::dvec3(_positions[index]);
+        const glm::dvec4 c = parameters.modelViewProjection * glm::dvec4(position, 1.0);
+
+        if (!isInside) {
+            const double m = clipGlyphSize * (_textLengths[index] + 1);
+            bool isOutside = false;
+            for (int p = 0; p < NPlanes; p++) {
+                isOutside |= planeDistance(c, p) < -m;
+            }
+            if (isOutside) {
+                result.nFrustumCulled++;
+                continue;
+            }
+        }
+
+        if (useSizeCulling && c.w > 0.0) {
+            const double size =
+                projectedSize(clipGlyphSize, c.w, parameters.viewportHeight);
+            if (size < parameters.minSize) {
+                result.nSizeCulled++;
+                continue;
+            }
+        }
+
+        result.visible.push_back(index);
+    }
+}
+
+} // namespace openspace
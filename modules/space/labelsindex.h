@@ -0,0 +1,138 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___LABELSINDEX___H__
+#define __OPENSPACE_MODULE_SPACE___LABELSINDEX___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <vector>
+
+namespace openspace {
+
+namespace speck { struct Labelset; }
+
+/**
+ * An octree over the positions of a speck::Labelset that is used to decide which labels
+ * have to be submitted to the font renderer in a frame. The index is built once per
+ * label set and each call to #cull rejects whole subtrees that are outside the view
+ * frustum or whose labels would all be smaller on screen than the minimum label size.
+ *
+ * All tests are conservative, meaning that a label that might be visible is never culled.
+ * The extent of the text of a label is taken into account by expanding the frustum by
+ * the number of characters of each label times the clip-space size of a single glyph.
+ */
+class LabelsIndex {
+public:
+    /// The per-frame values that are needed to cull the labels
+    struct CullingParameters {
+        /// The matrix that transforms the indexed positions into clip space
+        glm::dmat4 modelViewProjection = glm::dmat4(1.0);
+
+        /// An upper bound on the length of a single glyph in the coordinate system of
+        /// the indexed positions
+        double glyphSize = 0.0;
+
+        /// The height of the viewport in pixels
+        double viewportHeight = 0.0;
+
+        /// Labels whose projected glyph size in pixels is smaller than this value are
+        /// culled. A value of 0 disables the projected-size culling
+        double minSize = 0.0;
+    };
+
+    /// The result of culling the labels for one frame
+    struct CullingResult {
+        /// The indices of the labels that survived the culling in ascending order
+        std::vector<uint32_t> visible;
+
+        /// The number of labels that were rejected by the frustum test
+        int nFrustumCulled = 0;
+
+        /// The number of labels that were rejected by the projected-size test
+        int nSizeCulled = 0;
+    };
+
+    /**
+     * Builds the octree over the label \p positions, which have to be provided in the
+     * same coordinate system that the labels are rendered in. \p textLengths contains
+     * the number of characters of each label and is used to bound the extent of the
+     * label on screen.
+     *
+     * \pre \p positions and \p textLengths must have the same size
+     */
+    void build(std::vector<glm::vec3> positions, std::vector<uint32_t> textLengths);
+
+    /// Removes all labels from the index
+    void clear();
+
+    /// Returns the number of labels in the index
+    size_t nLabels() const;
+
+    /// Returns the position of the label with the provided \p index as it was indexed
+    const glm::vec3& position(uint32_t index) const;
+
+    /**
+     * Tests the labels of the index against the view described by the \p parameters and
+     * stores the indices of all labels that have to be rendered into \p result. The
+     * vector in \p result is reused between frames to avoid reallocations.
+     */
+    void cull(const CullingParameters& parameters, CullingResult& result) const;
+
+private:
+    struct Node {
+        glm::dvec3 boundsMin = glm::dvec3(0.0);
+        glm::dvec3 boundsMax = glm::dvec3(0.0);
+
+        /// The range in the _order list that contains the labels of this node
+        uint32_t first = 0;
+        uint32_t count = 0;
+
+        /// The largest number of characters of any label in this node
+        uint32_t maxTextLength = 0;
+
+        /// The index of the first child node or 0 if this node is a leaf. The children
+        /// of a node are stored consecutively
+        uint32_t firstChild = 0;
+        uint32_t nChildren = 0;
+    };
+
+    /// Computes the bounds of the node with the provided index and recursively splits it
+    /// into child nodes until the leaves are small enough
+    void buildNode(uint32_t nodeIndex, int depth);
+
+    void cullNode(const Node& node, const CullingParameters& parameters,
+        double clipGlyphSize, bool isInside, CullingResult& result) const;
+
+    std::vector<glm::vec3> _positions;
+    std::vector<uint32_t> _textLengths;
+
+    /// The label indices ordered such that every node covers a contiguous range
+    std::vector<uint32_t> _order;
+    std::vector<Node> _nodes;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___LABELSINDEX___H__
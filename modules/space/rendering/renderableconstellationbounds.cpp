@@ -154,9 +154,17 @@ void RenderableConstellationBounds::initializeGL() {
     glVertexAttribPointer(positionAttrib, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 
     glBindVertexArray(0);
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableConstellationBounds::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
     glDeleteVertexArrays(1, &_vao);
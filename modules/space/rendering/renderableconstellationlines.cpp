@@ -224,9 +224,17 @@ void RenderableConstellationLines::initializeGL() {
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
 
     createConstellations();
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableConstellationLines::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     using ConstellationKeyValuePair = std::pair<const int, ConstellationLine>;
     for (const ConstellationKeyValuePair& pair : _renderingConstellationsMap)
     {
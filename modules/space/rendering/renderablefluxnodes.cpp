@@ -447,65 +447,34 @@ void RenderableFluxNodes::loadNodeData(int energybinOption) {
             break;
     }
 
-    std::string file = _binarySourceFolderPath.string() + "\\positions" + energybin;
-    std::string file2 = _binarySourceFolderPath.string() + "\\fluxes" + energybin;
-    std::string file3 = _binarySourceFolderPath.string() + "\\radiuses" + energybin;
-
-    std::ifstream fileStream(file, std::ifstream::binary);
-    std::ifstream fileStream2(file2, std::ifstream::binary);
-    std::ifstream fileStream3(file3, std::ifstream::binary);
-
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Could not read file '{}'", file));
+    // The previously uploaded state belongs to the other energy bin
+    _uploadedStateIndex = -1;
+    _nUploadedNodes = 0;
+    _states = nullptr;
+
+    // Each energy bin is converted into a single file once, after which switching to it
+    // only maps that file into memory again
+    try {
+        _states = FluxNodesStates::loadWithCache(
+            _binarySourceFolderPath / ("positions" + energybin),
+            _binarySourceFolderPath / ("fluxes" + energybin),
+            _binarySourceFolderPath / ("radiuses" + energybin)
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
         return;
     }
-
-    uint32_t nNodesPerTimestep = 0;
-    fileStream.read(reinterpret_cast<char*>(&nNodesPerTimestep), sizeof(uint32_t));
-
-    uint32_t nTimeSteps = 0;
-    fileStream.read(reinterpret_cast<char*>(&nTimeSteps), sizeof(uint32_t));
-    _nStates = nTimeSteps;
+    _nStates = _states->nStates();
 
     if (_nStates != _startTimes.size()) {
         LERROR(
             "Number of states, _nStates, and number of start times, _startTimes, "
             "do not match"
         );
+        _states = nullptr;
         return;
     }
-
-    _statesColor.clear();
-    _statesPos.clear();
-    _statesRadius.clear();
-
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexPositions.resize(nNodesPerTimestep);
-        fileStream.read(reinterpret_cast<char*>(
-            _vertexPositions.data()), nNodesPerTimestep * sizeof(glm::vec3)
-        );
-
-        _statesPos.push_back(_vertexPositions);
-        _vertexPositions.clear();
-    }
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexColor.resize(nNodesPerTimestep);
-        fileStream2.read(reinterpret_cast<char*>(
-            _vertexColor.data()), nNodesPerTimestep * sizeof(float)
-        );
-
-        _statesColor.push_back(_vertexColor);
-        _vertexColor.clear();
-    }
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexRadius.resize(nNodesPerTimestep);
-        fileStream3.read(reinterpret_cast<char*>(
-            _vertexRadius.data()), nNodesPerTimestep * sizeof(float)
-        );
-
-        _statesRadius.push_back(_vertexRadius);
-        _vertexRadius.clear();
-    }
 }
 
 void RenderableFluxNodes::setupProperties() {
@@ -761,11 +730,7 @@ void RenderableFluxNodes::render(const RenderData& data, RendererTasks&) {
 
     glBindVertexArray(_vertexArrayObject);
 
-    glDrawArrays(
-        GL_POINTS,
-        0,
-        static_cast<GLsizei>(_vertexPositions.size())
-    );
+    glDrawArrays(GL_POINTS, 0, _nUploadedNodes);
 
     glBindVertexArray(0);
     _shaderProgram->deactivate();
@@ -819,14 +784,15 @@ void RenderableFluxNodes::update(const UpdateData& data) {
         needsUpdate = false;
     }
 
-    if (needsUpdate && !_statesPos[_activeTriggerTimeIndex].empty()) {
-        _vertexPositions = _statesPos[_activeTriggerTimeIndex];
-        _vertexColor = _statesColor[_activeTriggerTimeIndex];
-        _vertexRadius = _statesRadius[_activeTriggerTimeIndex];
-        needsUpdate = false;
-        updatePositionBuffer();
-        updateVertexColorBuffer();
-        updateVertexFilteringBuffer();
+    // Only the active state is uploaded, directly from the mapped file, and only when
+    // it differs from the state that is already in the vertex buffers
+    if (needsUpdate && _states && _activeTriggerTimeIndex != _uploadedStateIndex) {
+        const FluxNodesStates::State state = _states->state(_activeTriggerTimeIndex);
+        updatePositionBuffer(state);
+        updateVertexColorBuffer(state);
+        updateVertexFilteringBuffer(state);
+        _uploadedStateIndex = _activeTriggerTimeIndex;
+        _nUploadedNodes = static_cast<GLsizei>(state.nNodes);
     }
 
     if (_shaderProgram->isDirty()) {
@@ -839,14 +805,14 @@ void RenderableFluxNodes::update(const UpdateData& data) {
     }
 }
 
-void RenderableFluxNodes::updatePositionBuffer() {
+void RenderableFluxNodes::updatePositionBuffer(const FluxNodesStates::State& state) {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexPositions.size() * sizeof(glm::vec3),
-        _vertexPositions.data(),
+        state.nNodes * sizeof(glm::vec3),
+        state.positions,
         GL_STATIC_DRAW
     );
 
@@ -858,14 +824,14 @@ void RenderableFluxNodes::updatePositionBuffer() {
     glBindVertexArray(0);
 }
 
-void RenderableFluxNodes::updateVertexColorBuffer() {
+void RenderableFluxNodes::updateVertexColorBuffer(const FluxNodesStates::State& state) {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexColor.size() * sizeof(float),
-        _vertexColor.data(),
+        state.nNodes * sizeof(float),
+        state.fluxes,
         GL_STATIC_DRAW
     );
 
@@ -876,14 +842,16 @@ void RenderableFluxNodes::updateVertexColorBuffer() {
     glBindVertexArray(0);
 }
 
-void RenderableFluxNodes::updateVertexFilteringBuffer() {
+void RenderableFluxNodes::updateVertexFilteringBuffer(
+                                                      const FluxNodesStates::State& state)
+{
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexFilteringBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexRadius.size() * sizeof(float),
-        _vertexRadius.data(),
+        state.nNodes * sizeof(float),
+        state.radii,
         GL_STATIC_DRAW
     );
 
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/space/fluxnodesstates.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/stringproperty.h>
@@ -62,9 +63,9 @@ private:
     void updateActiveTriggerTimeIndex(double currentTime);
 
     void loadNodeData(int energybinOption);
-    void updatePositionBuffer();
-    void updateVertexColorBuffer();
-    void updateVertexFilteringBuffer();
+    void updatePositionBuffer(const FluxNodesStates::State& state);
+    void updateVertexColorBuffer(const FluxNodesStates::State& state);
+    void updateVertexFilteringBuffer(const FluxNodesStates::State& state);
 
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
@@ -109,6 +110,10 @@ private:
 
     // Active index of _startTimes
     int _activeTriggerTimeIndex = -1;
+    // Index of the state whose nodes are currently stored in the vertex buffers
+    int _uploadedStateIndex = -1;
+    // Number of nodes in the vertex buffers
+    GLsizei _nUploadedNodes = 0;
     // Number of states in the sequence
     uint32_t _nStates = 0;
 
@@ -132,18 +137,9 @@ private:
     std::vector<std::string> _binarySourceFiles;
     // Contains the _triggerTimes for all streams in the sequence
     std::vector<double> _startTimes;
-    // Contains vertexPositions
-    std::vector<glm::vec3> _vertexPositions;
-    // Contains vertex flux values for color
-    std::vector<float> _vertexColor;
-    // Contains radius of vertices
-    std::vector<float> _vertexRadius;
-    // Stores the states position
-    std::vector<std::vector<glm::vec3>> _statesPos;
-    // Stores the states color
-    std::vector<std::vector<float>> _statesColor;
-    // Stores the states radius
-    std::vector<std::vector<float>> _statesRadius;
+    // The memory mapped positions, flux values, and radii of all states of the
+    // selected energy bin
+    std::unique_ptr<FluxNodesStates> _states;
 
     // Group to hold properties regarding distance to earth
     properties::PropertyOwner _earthdistGroup;
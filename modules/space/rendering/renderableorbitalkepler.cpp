@@ -38,13 +38,21 @@
 #include <ghoul/misc/csvreader.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <math.h>
 #include <random>
 #include <vector>
 
 namespace {
+    enum PropagationMode {
+        BakedTrails = 0,
+        GpuTrails,
+        GpuPoints
+    };
+
     constexpr openspace::properties::Property::PropertyInfo PathInfo = {
         "Path",
         "Path",
@@ -112,6 +120,18 @@ namespace {
         openspace::properties::Property::Visibility::User
     };
 
+    constexpr openspace::properties::Property::PropertyInfo PropagationModeInfo = {
+        "PropagationMode",
+        "Propagation Mode",
+        "Determines where the orbits are propagated. 'Baked Trails' computes all trail "
+        "vertices on the CPU and stores them on the GPU. 'GPU Trails' only stores the "
+        "orbital elements of each object and computes the trail vertices in the vertex "
+        "shader, which uses a fraction of the memory and makes changes to the segment "
+        "quality instant. 'GPU Points' renders only the current position of each object, "
+        "which is computed in the vertex shader every frame",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(RenderableOrbitalKepler)]] Parameters {
         // [[codegen::verbatim(PathInfo.description)]]
         std::filesystem::path path;
@@ -147,6 +167,14 @@ namespace {
 
         // [[codegen::verbatim(ContiguousModeInfo.description)]]
         std::optional<bool> contiguousMode;
+
+        enum class [[codegen::map(PropagationMode)]] PropagationMode {
+            BakedTrails [[codegen::key("Baked Trails")]],
+            GpuTrails [[codegen::key("GPU Trails")]],
+            GpuPoints [[codegen::key("GPU Points")]]
+        };
+        // [[codegen::verbatim(PropagationModeInfo.description)]]
+        std::optional<PropagationMode> propagationMode;
     };
 #include "renderableorbitalkepler_codegen.cpp"
 } // namespace
@@ -162,6 +190,10 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     , _segmentQuality(SegmentQualityInfo, 2, 1, 10)
     , _startRenderIdx(StartRenderIdxInfo, 0, 0, 1)
     , _sizeRender(RenderSizeInfo, 1, 1, 2)
+    , _propagationMode(
+        PropagationModeInfo,
+        properties::OptionProperty::DisplayType::Dropdown
+    )
     , _path(PathInfo)
     , _contiguousMode(ContiguousModeInfo, false)
 {
@@ -170,7 +202,15 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     addProperty(Fadeable::_opacity);
 
     _segmentQuality = static_cast<unsigned int>(p.segmentQuality);
-    _segmentQuality.onChange([this]() { updateBuffers(); });
+    _segmentQuality.onChange([this]() {
+        if (_propagationMode == PropagationMode::BakedTrails) {
+            updateBuffers();
+        }
+        else {
+            // The shader computes the segments, so only the vertex counts change
+            _gpuBuckets = kepler::orbitBuckets(_gpuEccentricities, _segmentQuality);
+        }
+    });
     addProperty(_segmentQuality);
 
     _appearance.lineColor = p.color;
@@ -209,6 +249,17 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     _contiguousMode = p.contiguousMode.value_or(false);
     _contiguousMode.onChange([this]() { _updateDataBuffersAtNextRender = true; });
     addProperty(_contiguousMode);
+
+    _propagationMode.addOptions({
+        { PropagationMode::BakedTrails, "Baked Trails" },
+        { PropagationMode::GpuTrails, "GPU Trails" },
+        { PropagationMode::GpuPoints, "GPU Points" }
+    });
+    if (p.propagationMode.has_value()) {
+        _propagationMode = codegen::map<PropagationMode>(*p.propagationMode);
+    }
+    _propagationMode.onChange([this]() { _updateDataBuffersAtNextRender = true; });
+    addProperty(_propagationMode);
 }
 
 void RenderableOrbitalKepler::initializeGL() {
@@ -216,6 +267,8 @@ void RenderableOrbitalKepler::initializeGL() {
     ghoul_assert(_vertexBuffer == 0, "Vertex buffer object already existed");
     glGenVertexArrays(1, &_vertexArray);
     glGenBuffers(1, &_vertexBuffer);
+    glGenVertexArrays(1, &_gpuVertexArray);
+    glGenBuffers(1, &_gpuOrbitBuffer);
 
     _programObject = SpaceModule::ProgramObjectManager.request(
         "OrbitalKepler",
@@ -235,12 +288,36 @@ void RenderableOrbitalKepler::initializeGL() {
     _uniformCache.color = _programObject->uniformLocation("color");
     _uniformCache.opacity = _programObject->uniformLocation("opacity");
 
+    _gpuProgramObject = SpaceModule::ProgramObjectManager.request(
+        "OrbitalKeplerGpu",
+        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+            return global::renderEngine->buildRenderProgram(
+                "OrbitalKeplerGpu",
+                absPath("${MODULE_SPACE}/shaders/orbitalkepler_gpu_vs.glsl"),
+                absPath("${MODULE_SPACE}/shaders/debrisViz_fs.glsl")
+            );
+        }
+    );
+
+    ghoul::opengl::ProgramObject* gpu = _gpuProgramObject;
+    _gpuUniformCache.modelView = gpu->uniformLocation("modelViewTransform");
+    _gpuUniformCache.projection = gpu->uniformLocation("projectionTransform");
+    _gpuUniformCache.lineFade = gpu->uniformLocation("lineFade");
+    _gpuUniformCache.inGameTime = gpu->uniformLocation("inGameTime");
+    _gpuUniformCache.color = gpu->uniformLocation("color");
+    _gpuUniformCache.opacity = gpu->uniformLocation("opacity");
+    _gpuUniformCache.segmentQuality = gpu->uniformLocation("segmentQuality");
+    _gpuUniformCache.renderPoints = gpu->uniformLocation("renderPoints");
+    _gpuUniformCache.pointSize = gpu->uniformLocation("pointSize");
+
     updateBuffers();
 }
 
 void RenderableOrbitalKepler::deinitializeGL() {
     glDeleteBuffers(1, &_vertexBuffer);
     glDeleteVertexArrays(1, &_vertexArray);
+    glDeleteBuffers(1, &_gpuOrbitBuffer);
+    glDeleteVertexArrays(1, &_gpuVertexArray);
 
     SpaceModule::ProgramObjectManager.release(
         "OrbitalKepler",
@@ -249,10 +326,18 @@ void RenderableOrbitalKepler::deinitializeGL() {
         }
     );
     _programObject = nullptr;
+
+    SpaceModule::ProgramObjectManager.release(
+        "OrbitalKeplerGpu",
+        [](ghoul::opengl::ProgramObject* p) {
+            global::renderEngine->removeRenderProgram(p);
+        }
+    );
+    _gpuProgramObject = nullptr;
 }
 
 bool RenderableOrbitalKepler::isReady() const {
-    return _programObject != nullptr;
+    return _programObject != nullptr && _gpuProgramObject != nullptr;
 }
 
 void RenderableOrbitalKepler::update(const UpdateData&) {
@@ -263,6 +348,15 @@ void RenderableOrbitalKepler::update(const UpdateData&) {
 }
 
 void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
+    if (_propagationMode == PropagationMode::BakedTrails) {
+        renderBaked(data);
+    }
+    else {
+        renderGpu(data);
+    }
+}
+
+void RenderableOrbitalKepler::renderBaked(const RenderData& data) {
     if (_vertexBufferData.empty()) {
         return;
     }
@@ -295,6 +389,69 @@ void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
     _programObject->deactivate();
 }
 
+void RenderableOrbitalKepler::renderGpu(const RenderData& data) {
+    if (_nGpuOrbits == 0) {
+        return;
+    }
+
+    const bool renderPoints = (_propagationMode == PropagationMode::GpuPoints);
+
+    _gpuProgramObject->activate();
+    _gpuProgramObject->setUniform(_gpuUniformCache.opacity, opacity());
+    // The time stays in double precision as the shader computes the number of
+    // revolutions since the epoch itself
+    _gpuProgramObject->setUniform(_gpuUniformCache.inGameTime, data.time.j2000Seconds());
+    _gpuProgramObject->setUniform(
+        _gpuUniformCache.modelView,
+        static_cast<glm::mat4>(calcModelViewTransform(data))
+    );
+
+    const float fade = pow(_appearance.lineFade.maxValue() - _appearance.lineFade, 2.f);
+
+    _gpuProgramObject->setUniform(
+        _gpuUniformCache.projection,
+        data.camera.projectionMatrix()
+    );
+    _gpuProgramObject->setUniform(_gpuUniformCache.color, _appearance.lineColor);
+    _gpuProgramObject->setUniform(_gpuUniformCache.lineFade, fade);
+    _gpuProgramObject->setUniform(
+        _gpuUniformCache.segmentQuality,
+        static_cast<int>(_segmentQuality)
+    );
+    _gpuProgramObject->setUniform(_gpuUniformCache.renderPoints, renderPoints);
+    _gpuProgramObject->setUniform(
+        _gpuUniformCache.pointSize,
+        static_cast<float>(_appearance.pointSize)
+    );
+
+    glBindVertexArray(_gpuVertexArray);
+    if (renderPoints) {
+        setGpuAttributes(0);
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glDrawArraysInstanced(GL_POINTS, 0, 1, _nGpuOrbits);
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+    else {
+        glLineWidth(_appearance.lineWidth);
+        // Orbits with a similar number of segments are drawn together, and the shader
+        // collapses the few surplus vertices of an orbit onto its end point. The base
+        // instance of a draw call requires OpenGL 4.2, so the attributes are pointed at
+        // the first record of each range instead
+        for (const kepler::OrbitBucket& bucket : _gpuBuckets) {
+            setGpuAttributes(bucket.first);
+            glDrawArraysInstanced(
+                GL_LINE_STRIP,
+                0,
+                bucket.nVertices,
+                static_cast<GLsizei>(bucket.count)
+            );
+        }
+    }
+    glBindVertexArray(0);
+
+    _gpuProgramObject->deactivate();
+}
+
 void RenderableOrbitalKepler::updateBuffers() {
     std::vector<kepler::Parameters> parameters = kepler::readFile(
        _path.value(),
@@ -351,14 +508,42 @@ void RenderableOrbitalKepler::updateBuffers() {
         );
     }
 
+    double maxSemiMajorAxis = 0.0;
+    for (const kepler::Parameters& kp : parameters) {
+        if (kp.semiMajorAxis > maxSemiMajorAxis) {
+            maxSemiMajorAxis = kp.semiMajorAxis;
+        }
+    }
+    setBoundingSphere(maxSemiMajorAxis * 1000);
+
+    const kepler::OrbitElements elements = kepler::orbitElements(parameters);
+    if (_propagationMode != PropagationMode::BakedTrails) {
+        // Release the baked vertices, only one record per orbit is needed
+        _vertexBufferData = std::vector<TrailVBOLayout>();
+        _segmentSize = std::vector<GLint>();
+        _startIndex = std::vector<GLint>();
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        updateGpuBuffers(elements);
+        return;
+    }
+
+    // Release the per-orbit records that are only used when propagating on the GPU
+    _nGpuOrbits = 0;
+    _gpuEccentricities.clear();
+    _gpuBuckets.clear();
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuOrbitBuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     _segmentSize.clear();
     _startIndex.clear();
     _startIndex.push_back(0);
     for (int i = 0; i < parameters.size(); ++i) {
-        const double scale = static_cast<double>(_segmentQuality) * 10.0;
-        const kepler::Parameters& p = parameters[i];
         _segmentSize.push_back(
-            static_cast<size_t>(scale + (scale / pow(1 - p.eccentricity, 1.2)))
+            kepler::numberOfSegments(parameters[i].eccentricity, _segmentQuality)
         );
         _startIndex.push_back(_startIndex[i] + static_cast<GLint>(_segmentSize[i]) + 1);
     }
@@ -372,42 +557,13 @@ void RenderableOrbitalKepler::updateBuffers() {
     }
     _vertexBufferData.resize(nVerticesTotal);
 
-    size_t vertexBufIdx = 0;
-    KeplerTranslation keplerTranslator;
-    for (int orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
-        const kepler::Parameters& orbit = parameters[orbitIdx];
-
-        keplerTranslator.setKeplerElements(
-            orbit.eccentricity,
-            orbit.semiMajorAxis,
-            orbit.inclination,
-            orbit.ascendingNode,
-            orbit.argumentOfPeriapsis,
-            orbit.meanAnomaly,
-            orbit.period,
-            orbit.epoch
-        );
-
-        for (size_t j = 0 ; j < (_segmentSize[orbitIdx] + 1); ++j) {
-            double timeOffset = orbit.period *
-                static_cast<double>(j) / static_cast<double>(_segmentSize[orbitIdx]);
-
-            glm::dvec3 position = keplerTranslator.position({
-                {},
-                Time(timeOffset + orbit.epoch),
-                Time(0.0)
-            });
-
-            _vertexBufferData[vertexBufIdx].x = static_cast<float>(position.x);
-            _vertexBufferData[vertexBufIdx].y = static_cast<float>(position.y);
-            _vertexBufferData[vertexBufIdx].z = static_cast<float>(position.z);
-            _vertexBufferData[vertexBufIdx].time = static_cast<float>(timeOffset);
-            _vertexBufferData[vertexBufIdx].epoch = orbit.epoch;
-            _vertexBufferData[vertexBufIdx].period = orbit.period;
-
-            vertexBufIdx++;
-        }
-    }
+    // Propagate all orbits in parallel directly into the vertex buffer
+    kepler::generateOrbitVertices(
+        elements,
+        _segmentSize,
+        _startIndex,
+        _vertexBufferData.data()
+    );
 
     glBindVertexArray(_vertexArray);
 
@@ -433,14 +589,84 @@ void RenderableOrbitalKepler::updateBuffers() {
     );
 
     glBindVertexArray(0);
+}
 
-    double maxSemiMajorAxis = 0.0;
-    for (const kepler::Parameters& kp : parameters) {
-        if (kp.semiMajorAxis > maxSemiMajorAxis) {
-            maxSemiMajorAxis = kp.semiMajorAxis;
+void RenderableOrbitalKepler::updateGpuBuffers(const kepler::OrbitElements& elements) {
+    std::vector<kepler::OrbitRecord> records = kepler::orbitRecords(elements);
+    _nGpuOrbits = static_cast<GLsizei>(records.size());
+
+    // Sorting by eccentricity places orbits with a similar number of segments next to
+    // each other, so that they can be drawn with a single call
+    std::stable_sort(
+        records.begin(), records.end(),
+        [](const kepler::OrbitRecord& lhs, const kepler::OrbitRecord& rhs) {
+            return lhs.eccentricity < rhs.eccentricity;
         }
+    );
+    _gpuEccentricities.resize(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        _gpuEccentricities[i] = records[i].eccentricity;
     }
-    setBoundingSphere(maxSemiMajorAxis * 1000);
+    _gpuBuckets = kepler::orbitBuckets(_gpuEccentricities, _segmentQuality);
+
+    glBindVertexArray(_gpuVertexArray);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuOrbitBuffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        records.size() * sizeof(kepler::OrbitRecord),
+        records.data(),
+        GL_STATIC_DRAW
+    );
+
+    // All attributes advance once per instance, that is once per orbit
+    for (GLuint i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    setGpuAttributes(0);
+
+    glBindVertexArray(0);
+}
+
+void RenderableOrbitalKepler::setGpuAttributes(size_t first) {
+    // Expects the vertex array to be bound
+    constexpr GLsizei Stride = sizeof(kepler::OrbitRecord);
+    const size_t base = first * sizeof(kepler::OrbitRecord);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuOrbitBuffer);
+    glVertexAttribLPointer(
+        0,
+        2,
+        GL_DOUBLE,
+        Stride,
+        reinterpret_cast<GLvoid*>(base + offsetof(kepler::OrbitRecord, epoch))
+    );
+    glVertexAttribPointer(
+        1,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(base + offsetof(kepler::OrbitRecord, eccentricity))
+    );
+    glVertexAttribPointer(
+        2,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(base + offsetof(kepler::OrbitRecord, px))
+    );
+    glVertexAttribPointer(
+        3,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<GLvoid*>(base + offsetof(kepler::OrbitRecord, qx))
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 } // namespace opensapce
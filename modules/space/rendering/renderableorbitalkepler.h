@@ -29,7 +29,9 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 #include <modules/space/kepler.h>
+#include <modules/space/keplerpropagator.h>
 #include <modules/space/translation/keplertranslation.h>
+#include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/uintproperty.h>
 #include <ghoul/glm.h>
@@ -55,6 +57,11 @@ public:
 
 private:
     void updateBuffers();
+    void updateGpuBuffers(const kepler::OrbitElements& elements);
+    void renderBaked(const RenderData& data);
+    void renderGpu(const RenderData& data);
+    /// Points the per-orbit vertex attributes at the record with index \p first
+    void setGpuAttributes(size_t first);
 
     bool _updateDataBuffersAtNextRender = false;
     std::streamoff _numObjects;
@@ -63,16 +70,10 @@ private:
     properties::UIntProperty _segmentQuality;
     properties::UIntProperty _startRenderIdx;
     properties::UIntProperty _sizeRender;
+    properties::OptionProperty _propagationMode;
 
     /// The layout of the VBOs
-    struct TrailVBOLayout {
-        float x = 0.f;
-        float y = 0.f;
-        float z = 0.f;
-        float time = 0.f;
-        double epoch = 0.0;
-        double period = 0.0;
-    };
+    using TrailVBOLayout = kepler::OrbitVertex;
 
     /// The backend storage for the vertex buffer object containing all points
     std::vector<TrailVBOLayout> _vertexBufferData;
@@ -80,7 +81,19 @@ private:
     GLuint _vertexArray;
     GLuint _vertexBuffer;
 
+    /// The number of orbits that are stored in the per-orbit buffer that is used when
+    /// propagating on the GPU. The records are sorted by eccentricity
+    GLsizei _nGpuOrbits = 0;
+    /// The eccentricities of the records in the per-orbit buffer, in the same order
+    std::vector<float> _gpuEccentricities;
+    /// The ranges of records that are drawn with the same number of vertices
+    std::vector<kepler::OrbitBucket> _gpuBuckets;
+
+    GLuint _gpuVertexArray = 0;
+    GLuint _gpuOrbitBuffer = 0;
+
     ghoul::opengl::ProgramObject* _programObject;
+    ghoul::opengl::ProgramObject* _gpuProgramObject = nullptr;
     properties::StringProperty _path;
     properties::BoolProperty _contiguousMode;
     kepler::Format _format;
@@ -88,6 +101,8 @@ private:
 
     UniformCache(modelView, projection, lineFade, inGameTime, color, opacity,
         numberOfSegments) _uniformCache;
+    UniformCache(modelView, projection, lineFade, inGameTime, color, opacity,
+        segmentQuality, renderPoints, pointSize) _gpuUniformCache;
 };
 
 } // namespace openspace
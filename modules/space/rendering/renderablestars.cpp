@@ -33,6 +33,8 @@
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/opengl/openglstatecache.h>
@@ -40,6 +42,7 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
@@ -79,44 +82,6 @@ namespace {
 
     constexpr double PARSEC = 0.308567756E17;
 
-    struct ColorVBOLayout {
-        std::array<float, 3> position;
-        float value;
-        float luminance;
-        float absoluteMagnitude;
-        float apparentMagnitude;
-    };
-
-    struct VelocityVBOLayout {
-        std::array<float, 3> position;
-        float value;
-        float luminance;
-        float absoluteMagnitude;
-        float apparentMagnitude;
-
-        float vx; // v_x
-        float vy; // v_y
-        float vz; // v_z
-    };
-
-    struct SpeedVBOLayout {
-        std::array<float, 3> position;
-        float value;
-        float luminance;
-        float absoluteMagnitude;
-        float apparentMagnitude;
-
-        float speed;
-    };
-
-    struct OtherDataLayout {
-        std::array<float, 3> position;
-        float value;
-        float luminance;
-        float absoluteMagnitude;
-        float apparentMagnitude;
-    };
-
     constexpr openspace::properties::Property::PropertyInfo SpeckFileInfo = {
         "SpeckFile",
         "Speck File",
@@ -576,35 +541,35 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     addProperty(Fadeable::_opacity);
 
     _dataMapping.bvColor = p.dataMapping.bv.value_or("");
-    _dataMapping.bvColor.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.bvColor.onChange([this]() { markStreamDirty(Values); });
     _dataMappingContainer.addProperty(_dataMapping.bvColor);
 
     _dataMapping.luminance = p.dataMapping.luminance.value_or("");
-    _dataMapping.luminance.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.luminance.onChange([this]() { markStreamDirty(Values); });
     _dataMappingContainer.addProperty(_dataMapping.luminance);
 
     _dataMapping.absoluteMagnitude = p.dataMapping.absoluteMagnitude.value_or("");
-    _dataMapping.absoluteMagnitude.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.absoluteMagnitude.onChange([this]() { markStreamDirty(Values); });
     _dataMappingContainer.addProperty(_dataMapping.absoluteMagnitude);
 
     _dataMapping.apparentMagnitude = p.dataMapping.apparentMagnitude.value_or("");
-    _dataMapping.apparentMagnitude.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.apparentMagnitude.onChange([this]() { markStreamDirty(Values); });
     _dataMappingContainer.addProperty(_dataMapping.apparentMagnitude);
 
     _dataMapping.vx = p.dataMapping.vx.value_or("");
-    _dataMapping.vx.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.vx.onChange([this]() { markStreamDirty(Velocities); });
     _dataMappingContainer.addProperty(_dataMapping.vx);
 
     _dataMapping.vy = p.dataMapping.vy.value_or("");
-    _dataMapping.vy.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.vy.onChange([this]() { markStreamDirty(Velocities); });
     _dataMappingContainer.addProperty(_dataMapping.vy);
 
     _dataMapping.vz = p.dataMapping.vz.value_or("");
-    _dataMapping.vz.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.vz.onChange([this]() { markStreamDirty(Velocities); });
     _dataMappingContainer.addProperty(_dataMapping.vz);
 
     _dataMapping.speed = p.dataMapping.speed.value_or("");
-    _dataMapping.speed.onChange([this]() { _dataIsDirty = true; });
+    _dataMapping.speed.onChange([this]() { markStreamDirty(Speeds); });
     _dataMappingContainer.addProperty(_dataMapping.speed);
 
     addPropertySubOwner(_dataMappingContainer);
@@ -654,7 +619,7 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
                 break;
         }
     }
-    _colorOption.onChange([&] { _dataIsDirty = true; });
+    // The streams that are needed for the new option are created in the next update
     addProperty(_colorOption);
 
     _colorTexturePath.onChange([&] {
@@ -670,7 +635,6 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
 
     _queuedOtherData = p.otherData.value_or(_queuedOtherData);
 
-    _otherDataOption.onChange([this]() { _dataIsDirty = true; });
     addProperty(_otherDataOption);
 
     _otherDataRange.setViewOption(properties::Property::ViewOptions::MinMaxRange);
@@ -785,15 +749,8 @@ bool RenderableStars::isReady() const {
     return _program && _pointSpreadFunctionTexture;
 }
 
-void RenderableStars::initializeGL() {
-    _program = global::renderEngine->buildRenderProgram(
-        "Star",
-        absPath("${MODULE_SPACE}/shaders/star_vs.glsl"),
-        absPath("${MODULE_SPACE}/shaders/star_fs.glsl"),
-        absPath("${MODULE_SPACE}/shaders/star_ge.glsl")
-    );
-
-    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+void RenderableStars::initializeData() {
+    ZoneScoped;
 
     loadData();
 
@@ -812,6 +769,23 @@ void RenderableStars::initializeGL() {
     }
     _speckFileIsDirty = false;
 
+    // The vertex streams do not depend on OpenGL, so they are already created here and
+    // uploaded in the first update after they are finished
+    if (!_dataset.entries.empty()) {
+        startSlicing();
+    }
+}
+
+void RenderableStars::initializeGL() {
+    _program = global::renderEngine->buildRenderProgram(
+        "Star",
+        absPath("${MODULE_SPACE}/shaders/star_vs.glsl"),
+        absPath("${MODULE_SPACE}/shaders/star_fs.glsl"),
+        absPath("${MODULE_SPACE}/shaders/star_ge.glsl")
+    );
+
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+
     LDEBUG("Creating Polygon Texture");
 
     glGenVertexArrays(1, &_psfVao);
@@ -883,8 +857,13 @@ void RenderableStars::initializeGL() {
 }
 
 void RenderableStars::deinitializeGL() {
-    glDeleteBuffers(1, &_vbo);
-    _vbo = 0;
+    if (_slicing.valid()) {
+        _slicing.wait();
+    }
+    for (VertexStream& stream : _streams) {
+        glDeleteBuffers(2, stream.vbos.data());
+        stream = VertexStream();
+    }
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
@@ -1033,6 +1012,19 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     if (_dataset.entries.empty()) {
         return;
     }
+    // While the streams for the selected color option are created in the background,
+    // the stars are rendered with the last color option whose streams are complete
+    int colorOption = _colorOption;
+    if (hasStreamsFor(colorOption)) {
+        _renderedColorOption = colorOption;
+    }
+    else if (_renderedColorOption.has_value() && hasStreamsFor(*_renderedColorOption)) {
+        colorOption = *_renderedColorOption;
+    }
+    else {
+        // Nothing has been uploaded yet
+        return;
+    }
 
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glDepthMask(false);
@@ -1059,7 +1051,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
         _uniformCache.cameraViewProjectionMatrix,
         static_cast<glm::mat4>(cameraViewProjectionMatrix)
     );
-    _program->setUniform(_uniformCache.colorOption, _colorOption);
+    _program->setUniform(_uniformCache.colorOption, colorOption);
     _program->setUniform(_uniformCache.magnitudeExponent, _magnitudeExponent);
 
     _program->setUniform(_uniformCache.psfParamConf, _psfMultiplyOption.value());
@@ -1067,7 +1059,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     _program->setUniform(_uniformCache.radiusCent, _radiusCent);
     _program->setUniform(_uniformCache.brightnessCent, _brightnessCent);
 
-    if (_colorOption == ColorOption::FixedColor) {
+    if (colorOption == ColorOption::FixedColor) {
         if (_uniformCache.fixedColor == -1) {
             _uniformCache.fixedColor = _program->uniformLocation("fixedColor");
         }
@@ -1111,7 +1103,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     }
 
     ghoul::opengl::TextureUnit otherDataUnit;
-    if (_colorOption == ColorOption::OtherData && _otherDataColorMapTexture) {
+    if (colorOption == ColorOption::OtherData && _otherDataColorMapTexture) {
         otherDataUnit.activate();
         _otherDataColorMapTexture->bind();
         _program->setUniform(_uniformCache.otherDataTexture, otherDataUnit);
@@ -1139,160 +1131,33 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
 }
 
 void RenderableStars::update(const UpdateData&) {
-    if (_speckFileIsDirty) {
+    using namespace std::chrono_literals;
+    if (_slicing.valid() && _slicing.wait_for(0s) == std::future_status::ready) {
+        uploadSlices(_slicing.get());
+    }
+
+    // The dataset can only be replaced when it is not read by the worker
+    if (_speckFileIsDirty && !_slicing.valid()) {
         loadData();
         _speckFileIsDirty = false;
-        _dataIsDirty = true;
+        // The old buffers are sized for the previous dataset and must not stay attached
+        // to the vertex array object
+        for (int i = 0; i < NumberOfStreams; i++) {
+            glDeleteBuffers(2, _streams[i].vbos.data());
+            _streams[i] = VertexStream();
+            markStreamDirty(Stream(i));
+        }
+        glDeleteVertexArrays(1, &_vao);
+        _vao = 0;
+        _uploadedOtherDataIdx = std::nullopt;
     }
 
     if (_dataset.entries.empty()) {
         return;
     }
 
-    if (_dataIsDirty) {
-        const int value = _colorOption;
-        LDEBUG("Regenerating data");
-
-        std::vector<float> slice = createDataSlice(ColorOption(value));
-
-        if (_vao == 0) {
-            glGenVertexArrays(1, &_vao);
-        }
-        if (_vbo == 0) {
-            glGenBuffers(1, &_vbo);
-        }
-        glBindVertexArray(_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            slice.size() * sizeof(GLfloat),
-            slice.data(),
-            GL_STATIC_DRAW
-        );
-
-        GLint positionAttrib = _program->attributeLocation("in_position");
-        // bvLumAbsMagAppMag = bv color, luminosity, abs magnitude and app magnitude
-        GLint bvLumAbsMagAppMagAttrib = _program->attributeLocation(
-            "in_bvLumAbsMagAppMag"
-        );
-
-        const size_t nStars = _dataset.entries.size();
-        const size_t nValues = slice.size() / nStars;
-
-        GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
-
-        glEnableVertexAttribArray(positionAttrib);
-        glEnableVertexAttribArray(bvLumAbsMagAppMagAttrib);
-        const int colorOption = _colorOption;
-        switch (colorOption) {
-            case ColorOption::Color:
-            case ColorOption::FixedColor:
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(ColorVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(ColorVBOLayout, value))
-                );
-
-                break;
-            case ColorOption::Velocity:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(VelocityVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(VelocityVBOLayout, value))
-                );
-
-                GLint velocityAttrib = _program->attributeLocation("in_velocity");
-                glEnableVertexAttribArray(velocityAttrib);
-                glVertexAttribPointer(
-                    velocityAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_TRUE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(VelocityVBOLayout, vx))
-                );
-
-                break;
-            }
-            case ColorOption::Speed:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(SpeedVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(SpeedVBOLayout, value))
-                );
-
-                GLint speedAttrib = _program->attributeLocation("in_speed");
-                glEnableVertexAttribArray(speedAttrib);
-                glVertexAttribPointer(
-                    speedAttrib,
-                    1,
-                    GL_FLOAT,
-                    GL_TRUE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(SpeedVBOLayout, speed))
-                );
-                break;
-            }
-            case ColorOption::OtherData:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(OtherDataLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(OtherDataLayout, value))
-                );
-            }
-        }
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
-        _dataIsDirty = false;
+    if (!_slicing.valid()) {
+        startSlicing();
     }
 
     if (_pointSpreadFunctionTextureIsDirty) {
@@ -1373,147 +1238,270 @@ void RenderableStars::loadData() {
     }
 }
 
-std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
-    const int bvIdx = std::max(_dataset.index(_dataMapping.bvColor.value()), 0);
-    const int lumIdx = std::max(_dataset.index(_dataMapping.luminance.value()), 0);
-    const int absMagIdx = std::max(
-        _dataset.index(_dataMapping.absoluteMagnitude.value()),
-        0
-    );
-    const int appMagIdx = std::max(
-        _dataset.index(_dataMapping.apparentMagnitude.value()),
-        0
-    );
-    const int vxIdx = std::max(_dataset.index(_dataMapping.vx.value()), 0);
-    const int vyIdx = std::max(_dataset.index(_dataMapping.vy.value()), 0);
-    const int vzIdx = std::max(_dataset.index(_dataMapping.vz.value()), 0);
-    const int speedIdx = std::max(_dataset.index(_dataMapping.speed.value()), 0);
-
-    _otherDataRange = glm::vec2(
-        std::numeric_limits<float>::max(),
-        -std::numeric_limits<float>::max()
+void RenderableStars::markStreamDirty(Stream stream) {
+    _streamVersions[stream]++;
+}
+
+bool RenderableStars::isStreamCurrent(Stream stream) const {
+    const VertexStream& s = _streams[stream];
+    if (!s.isUploaded || s.version != _streamVersions[stream]) {
+        return false;
+    }
+    if (stream == Values) {
+        // The values either start with the bv color or with the selected other data
+        if (_colorOption == ColorOption::OtherData) {
+            return _uploadedOtherDataIdx == _otherDataOption.value();
+        }
+        return !_uploadedOtherDataIdx.has_value();
+    }
+    return true;
+}
+
+bool RenderableStars::isStreamNeeded(Stream stream) const {
+    switch (stream) {
+        case Positions:
+        case Values:
+            return true;
+        case Velocities:
+            return _colorOption == ColorOption::Velocity;
+        case Speeds:
+            return _colorOption == ColorOption::Speed;
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+bool RenderableStars::hasStreamsFor(int colorOption) const {
+    if (!_streams[Positions].isUploaded || !_streams[Values].isUploaded) {
+        return false;
+    }
+    // The values contain either the bv color or the other data column
+    const bool isOtherData = colorOption == ColorOption::OtherData;
+    if (_uploadedOtherDataIdx.has_value() != isOtherData) {
+        return false;
+    }
+    switch (colorOption) {
+        case ColorOption::Velocity:
+            return _streams[Velocities].isUploaded;
+        case ColorOption::Speed:
+            return _streams[Speeds].isUploaded;
+        default:
+            return true;
+    }
+}
+
+void RenderableStars::startSlicing() {
+    SliceParameters parameters;
+    bool hasWork = false;
+    for (int i = 0; i < NumberOfStreams; i++) {
+        const Stream stream = Stream(i);
+        parameters.isIncluded[i] = isStreamNeeded(stream) && !isStreamCurrent(stream);
+        parameters.versions[i] = _streamVersions[i];
+        hasWork |= parameters.isIncluded[i];
+    }
+    if (!hasWork) {
+        return;
+    }
+
+    auto index = [this](const std::string& name) {
+        return std::max(_dataset.index(name), 0);
+    };
+    parameters.bvIdx = index(_dataMapping.bvColor);
+    parameters.lumIdx = index(_dataMapping.luminance);
+    parameters.absMagIdx = index(_dataMapping.absoluteMagnitude);
+    parameters.appMagIdx = index(_dataMapping.apparentMagnitude);
+    parameters.vxIdx = index(_dataMapping.vx);
+    parameters.vyIdx = index(_dataMapping.vy);
+    parameters.vzIdx = index(_dataMapping.vz);
+    parameters.speedIdx = index(_dataMapping.speed);
+    if (_colorOption == ColorOption::OtherData) {
+        parameters.otherDataIdx = _otherDataOption.value();
+    }
+    parameters.staticFilterValue = _staticFilterValue;
+    parameters.staticFilterReplacementValue = _staticFilterReplacementValue;
+
+    LDEBUG("Regenerating data");
+    _slicing = std::async(
+        std::launch::async,
+        &RenderableStars::createSlices,
+        std::cref(_dataset),
+        parameters
     );
+}
 
-    double maxRadius = 0.0;
-
-    std::vector<float> result;
-    // 7 for the default Color option of 3 positions + bv + lum + abs + app magnitude
-    result.reserve(_dataset.entries.size() * 7);
-    for (const speck::Dataset::Entry& e : _dataset.entries) {
-        glm::dvec3 position = glm::dvec3(e.position) * distanceconstants::Parsec;
-        maxRadius = std::max(maxRadius, glm::length(position));
-
-        switch (option) {
-            case ColorOption::Color:
-            case ColorOption::FixedColor:
-            {
-                union {
-                    ColorVBOLayout value;
-                    std::array<float, sizeof(ColorVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = { {
-                    static_cast<float>(position[0]),
-                    static_cast<float>(position[1]),
-                    static_cast<float>(position[2])
-                }};
-
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
-
-                result.insert(result.end(), layout.data.begin(), layout.data.end());
-                break;
-            }
-            case ColorOption::Velocity:
-            {
-                union {
-                    VelocityVBOLayout value;
-                    std::array<float, sizeof(VelocityVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = {{
-                    static_cast<float>(position[0]),
-                    static_cast<float>(position[1]),
-                    static_cast<float>(position[2])
-                }};
-
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
-
-                layout.value.vx = e.data[vxIdx];
-                layout.value.vy = e.data[vyIdx];
-                layout.value.vz = e.data[vzIdx];
-
-                result.insert(result.end(), layout.data.begin(), layout.data.end());
-                break;
-            }
-            case ColorOption::Speed:
-            {
-                union {
-                    SpeedVBOLayout value;
-                    std::array<float, sizeof(SpeedVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = {{
-                    static_cast<float>(position[0]),
-                    static_cast<float>(position[1]),
-                    static_cast<float>(position[2])
-                }};
-
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
-                layout.value.speed = e.data[speedIdx];
-
-                result.insert(result.end(), layout.data.begin(), layout.data.end());
-                break;
-            }
-            case ColorOption::OtherData:
-            {
-                union {
-                    OtherDataLayout value;
-                    std::array<float, sizeof(OtherDataLayout)> data;
-                } layout = {};
-
-                layout.value.position = {{
-                    static_cast<float>(position[0]),
-                    static_cast<float>(position[1]),
-                    static_cast<float>(position[2])
-                }};
-
-                int index = _otherDataOption.value();
-                // plus 3 because of the position
-                layout.value.value = e.data[index];
-
-                if (_staticFilterValue.has_value() && e.data[index] == _staticFilterValue)
-                {
-                    layout.value.value = _staticFilterReplacementValue;
-                }
+void RenderableStars::uploadSlices(const Slices& slices) {
+    const SliceParameters& parameters = slices.parameters;
+
+    if (_vao == 0) {
+        glGenVertexArrays(1, &_vao);
+    }
+    glBindVertexArray(_vao);
+
+    if (parameters.isIncluded[Positions]) {
+        uploadStream(
+            Positions,
+            slices.positions.data(),
+            slices.positions.size() * sizeof(glm::vec3),
+            "in_position",
+            3,
+            GL_FALSE
+        );
+        setBoundingSphere(slices.maxRadius);
+    }
+    if (parameters.isIncluded[Values]) {
+        // bvLumAbsMagAppMag = bv color, luminosity, abs magnitude and app magnitude
+        uploadStream(
+            Values,
+            slices.values.data(),
+            slices.values.size() * sizeof(glm::vec4),
+            "in_bvLumAbsMagAppMag",
+            4,
+            GL_FALSE
+        );
+        _uploadedOtherDataIdx = parameters.otherDataIdx;
+        if (parameters.otherDataIdx.has_value()) {
+            const glm::vec2 range = slices.otherDataRange;
+            _otherDataRange = range;
+            _otherDataRange.setMinValue(glm::vec2(range.x));
+            _otherDataRange.setMaxValue(glm::vec2(range.y));
+        }
+    }
+    if (parameters.isIncluded[Velocities]) {
+        uploadStream(
+            Velocities,
+            slices.velocities.data(),
+            slices.velocities.size() * sizeof(glm::vec3),
+            "in_velocity",
+            3,
+            GL_TRUE
+        );
+    }
+    if (parameters.isIncluded[Speeds]) {
+        uploadStream(
+            Speeds,
+            slices.speeds.data(),
+            slices.speeds.size() * sizeof(float),
+            "in_speed",
+            1,
+            GL_TRUE
+        );
+    }
 
-                glm::vec2 range = _otherDataRange;
-                range.x = std::min(range.x, layout.value.value);
-                range.y = std::max(range.y, layout.value.value);
-                _otherDataRange = range;
-                _otherDataRange.setMinValue(glm::vec2(range.x));
-                _otherDataRange.setMaxValue(glm::vec2(range.y));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
+    for (int i = 0; i < NumberOfStreams; i++) {
+        if (parameters.isIncluded[i]) {
+            // If the mapping changed while the worker was busy, the version is outdated
+            // and the stream will be created again, but it can be rendered until then
+            _streams[i].isUploaded = true;
+            _streams[i].version = parameters.versions[i];
+        }
+    }
+}
 
-                result.insert(result.end(), layout.data.begin(), layout.data.end());
-                break;
+void RenderableStars::uploadStream(Stream stream, const void* data, GLsizeiptr size,
+                                   const char* attribute, GLint nComponents,
+                                   GLboolean normalized)
+{
+    VertexStream& s = _streams[stream];
+    const int back = 1 - s.front;
+    if (s.vbos[back] == 0) {
+        glGenBuffers(1, &s.vbos[back]);
+    }
+
+    // The front buffer might still be in use by the GPU, so the new data goes into the
+    // back buffer, which then becomes the front buffer
+    glBindBuffer(GL_ARRAY_BUFFER, s.vbos[back]);
+    glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+    if (s.vbos[s.front] != 0) {
+        // Orphan the previous data so that the driver can release its storage once the
+        // GPU has finished the draw calls that use it, instead of keeping two copies
+        glBindBuffer(GL_ARRAY_BUFFER, s.vbos[s.front]);
+        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, s.vbos[back]);
+    }
+    s.front = back;
+
+    const GLint location = _program->attributeLocation(attribute);
+    if (location != -1) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, nComponents, GL_FLOAT, normalized, 0, nullptr);
+    }
+}
+
+RenderableStars::Slices RenderableStars::createSlices(const speck::Dataset& dataset,
+                                                      const SliceParameters& parameters)
+{
+    ZoneScoped;
+
+    const SliceParameters& p = parameters;
+    const size_t nStars = dataset.entries.size();
+
+    Slices slices;
+    slices.parameters = parameters;
+
+    if (p.isIncluded[Positions]) {
+        slices.positions.reserve(nStars);
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            glm::dvec3 position = glm::dvec3(e.position) * distanceconstants::Parsec;
+            slices.maxRadius = std::max(slices.maxRadius, glm::length(position));
+            slices.positions.emplace_back(
+                static_cast<float>(position[0]),
+                static_cast<float>(position[1]),
+                static_cast<float>(position[2])
+            );
+        }
+    }
+
+    if (p.isIncluded[Values]) {
+        slices.values.reserve(nStars);
+        glm::vec2 range = glm::vec2(
+            std::numeric_limits<float>::max(),
+            -std::numeric_limits<float>::max()
+        );
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            float value = e.data[p.bvIdx];
+            if (p.otherDataIdx.has_value()) {
+                const int index = *p.otherDataIdx;
+                value = e.data[index];
+                if (p.staticFilterValue.has_value() &&
+                    e.data[index] == p.staticFilterValue)
+                {
+                    value = p.staticFilterReplacementValue;
+                }
+                range.x = std::min(range.x, value);
+                range.y = std::max(range.y, value);
             }
+            slices.values.emplace_back(
+                value,
+                e.data[p.lumIdx],
+                e.data[p.absMagIdx],
+                e.data[p.appMagIdx]
+            );
+        }
+        slices.otherDataRange = range;
+    }
+
+    if (p.isIncluded[Velocities]) {
+        slices.velocities.reserve(nStars);
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            slices.velocities.emplace_back(
+                e.data[p.vxIdx],
+                e.data[p.vyIdx],
+                e.data[p.vzIdx]
+            );
+        }
+    }
+
+    if (p.isIncluded[Speeds]) {
+        slices.speeds.reserve(nStars);
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            slices.speeds.push_back(e.data[p.speedIdx]);
         }
     }
 
-    setBoundingSphere(maxRadius);
-    return result;
+    return slices;
 }
 
 } // namespace openspace
@@ -37,6 +37,8 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <array>
+#include <future>
 #include <optional>
 
 namespace ghoul::filesystem { class File; }
@@ -54,6 +56,7 @@ public:
     explicit RenderableStars(const ghoul::Dictionary& dictionary);
     ~RenderableStars() override;
 
+    void initializeData() override;
     void initializeGL() override;
     void deinitializeGL() override;
 
@@ -75,8 +78,65 @@ private:
         FixedColor = 4
     };
 
+    /// The attributes of the stars, each of which is stored in its own vertex buffer
+    enum Stream {
+        Positions = 0,
+        Values,
+        Velocities,
+        Speeds,
+        NumberOfStreams
+    };
+
+    /// A snapshot of the data mapping that is used to create the streams on the worker
+    struct SliceParameters {
+        std::array<bool, NumberOfStreams> isIncluded = {};
+        std::array<uint64_t, NumberOfStreams> versions = {};
+        int bvIdx = 0;
+        int lumIdx = 0;
+        int absMagIdx = 0;
+        int appMagIdx = 0;
+        int vxIdx = 0;
+        int vyIdx = 0;
+        int vzIdx = 0;
+        int speedIdx = 0;
+        /// The column that is used instead of the bv color, if any
+        std::optional<int> otherDataIdx;
+        std::optional<float> staticFilterValue;
+        float staticFilterReplacementValue = 0.f;
+    };
+
+    /// The streams that were created on the worker thread
+    struct Slices {
+        SliceParameters parameters;
+        std::vector<glm::vec3> positions;
+        double maxRadius = 0.0;
+        std::vector<glm::vec4> values;
+        glm::vec2 otherDataRange = glm::vec2(0.f);
+        std::vector<glm::vec3> velocities;
+        std::vector<float> speeds;
+    };
+
+    /// The two buffers of a stream. Rendering uses the front buffer while the back
+    /// buffer receives the next version of the stream
+    struct VertexStream {
+        std::array<GLuint, 2> vbos = { 0, 0 };
+        int front = 0;
+        bool isUploaded = false;
+        uint64_t version = 0;
+    };
+
     void loadData();
-    std::vector<float> createDataSlice(ColorOption option);
+    void markStreamDirty(Stream stream);
+    bool isStreamCurrent(Stream stream) const;
+    bool isStreamNeeded(Stream stream) const;
+    /// Returns whether all streams that are needed to render \p colorOption are uploaded
+    bool hasStreamsFor(int colorOption) const;
+    void startSlicing();
+    void uploadSlices(const Slices& slices);
+    void uploadStream(Stream stream, const void* data, GLsizeiptr size,
+        const char* attribute, GLint nComponents, GLboolean normalized);
+    static Slices createSlices(const speck::Dataset& dataset,
+        const SliceParameters& parameters);
 
     properties::StringProperty _speckFile;
 
@@ -140,18 +200,27 @@ private:
     bool _pointSpreadFunctionTextureIsDirty = true;
     bool _colorTextureIsDirty = true;
     //bool _shapeTextureIsDirty = true;
-    bool _dataIsDirty = true;
     bool _otherDataColorMapIsDirty = true;
 
     speck::Dataset _dataset;
 
+    // Each stream is only rebuilt when its version is newer than the uploaded one
+    std::array<uint64_t, NumberOfStreams> _streamVersions = {};
+    std::array<VertexStream, NumberOfStreams> _streams;
+    // The column that the uploaded values were created from, if it was not bv color
+    std::optional<int> _uploadedOtherDataIdx;
+    // The color option of the last frame whose streams were all uploaded
+    std::optional<int> _renderedColorOption;
+    // The streams are created on a worker thread while the old ones are still rendered.
+    // This has to be declared after the dataset, as the worker reads from it
+    std::future<Slices> _slicing;
+
     std::string _queuedOtherData;
 
     std::optional<float> _staticFilterValue;
     float _staticFilterReplacementValue = 0.f;
 
     GLuint _vao = 0;
-    GLuint _vbo = 0;
     GLuint _psfVao = 0;
     GLuint _psfVbo = 0;
     GLuint _psfTexture = 0;
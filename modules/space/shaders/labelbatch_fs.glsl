@@ -0,0 +1,55 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "fragment.glsl"
+
+in vec2 vs_texCoords;
+in vec2 vs_outlineTexCoords;
+in float vs_screenSpaceDepth;
+
+uniform sampler2D fontTexture;
+uniform vec4 color;
+uniform vec4 outlineColor;
+
+
+Fragment getFragment() {
+  float inside = texture(fontTexture, vs_texCoords).r;
+  float outline = texture(fontTexture, vs_outlineTexCoords).r;
+
+  // The outline is drawn behind the glyph and both fade with the label color
+  float alpha = max(inside, outline * outlineColor.a) * color.a;
+  if (alpha == 0.0) {
+    discard;
+  }
+
+  Fragment frag;
+  frag.color = vec4(mix(outlineColor.rgb, color.rgb, inside), alpha);
+  frag.depth = vs_screenSpaceDepth;
+  // Setting the position of the labels to not interact with the ATM
+  frag.gPosition = vec4(-1e32, -1e32, -1e32, 1.0);
+  frag.gNormal = vec4(0.0, 0.0, 0.0, 1.0);
+
+  return frag;
+}
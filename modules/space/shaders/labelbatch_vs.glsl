@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScaling_vs.hglsl"
+
+// One record per glyph, see labelbatch::GlyphInstance
+layout (location = 0) in vec3 in_labelPosition;
+layout (location = 1) in vec4 in_rect; // left, top, right, bottom
+layout (location = 2) in vec4 in_texCoords; // left, top, right, bottom
+layout (location = 3) in vec4 in_outlineTexCoords; // left, top, right, bottom
+
+out vec2 vs_texCoords;
+out vec2 vs_outlineTexCoords;
+out float vs_screenSpaceDepth;
+
+uniform dmat4 modelViewProjection;
+uniform vec3 orthoRight;
+uniform vec3 orthoUp;
+uniform bool faceCamera;
+uniform dvec3 cameraPosition;
+uniform vec3 cameraLookUp;
+uniform float scale;
+uniform float lineHeight;
+uniform float minSize;
+uniform float maxSize;
+uniform vec2 viewportSize;
+
+
+void main() {
+  dvec3 labelPosition = dvec3(in_labelPosition);
+
+  vec3 right = orthoRight;
+  vec3 up = orthoUp;
+  if (!faceCamera) {
+    vec3 normal = normalize(vec3(cameraPosition - labelPosition));
+    right = normalize(cross(cameraLookUp, normal));
+    up = normalize(cross(normal, right));
+  }
+
+  // The height of one line of text on screen in pixels, which is used to limit the
+  // size of the labels
+  dvec4 anchor = modelViewProjection * dvec4(labelPosition, 1.0);
+  dvec3 lineTop = labelPosition + dvec3(up * scale * lineHeight);
+  dvec4 top = modelViewProjection * dvec4(lineTop, 1.0);
+  vec2 anchorNdc = vec2(anchor.xy / anchor.w);
+  vec2 topNdc = vec2(top.xy / top.w);
+  float textHeight = length((topNdc - anchorNdc) * viewportSize * 0.5);
+
+  vs_texCoords = vec2(0.0);
+  vs_outlineTexCoords = vec2(0.0);
+  vs_screenSpaceDepth = 0.0;
+  if (anchor.w <= 0.0 || textHeight < minSize) {
+    // Labels behind the camera or that are too small are moved outside the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    return;
+  }
+
+  float labelScale = scale;
+  if (textHeight > maxSize) {
+    labelScale *= maxSize / textHeight;
+  }
+
+  // The four vertices of the triangle strip span the glyph quad
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  vec2 offset = mix(in_rect.xy, in_rect.zw, corner);
+  vs_texCoords = mix(in_texCoords.xy, in_texCoords.zw, corner);
+  vs_outlineTexCoords = mix(in_outlineTexCoords.xy, in_outlineTexCoords.zw, corner);
+
+  dvec3 position = labelPosition + dvec3(labelScale * (offset.x * right + offset.y * up));
+  vec4 positionClipSpace = vec4(modelViewProjection * dvec4(position, 1.0));
+  vec4 positionScreenSpace = z_normalization(positionClipSpace);
+
+  vs_screenSpaceDepth = positionScreenSpace.w;
+  gl_Position = positionScreenSpace;
+}
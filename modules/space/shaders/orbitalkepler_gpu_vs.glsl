@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScalingMath.hglsl"
+
+// One record per orbit, see kepler::OrbitRecord
+layout (location = 0) in dvec2 orbitTime; // 1: epoch, 2: period
+layout (location = 1) in vec3 orbitShape; // 1: eccentricity, 2: semi-major axis, 3: M0
+layout (location = 2) in vec3 orbitP; // First column of the orbit plane rotation
+layout (location = 3) in vec3 orbitQ; // Second column of the orbit plane rotation
+
+out vec4 viewSpacePosition;
+out float viewSpaceDepth;
+out float periodFraction;
+out float offsetPeriods;
+
+uniform mat4 modelViewTransform;
+uniform mat4 projectionTransform;
+uniform double inGameTime;
+uniform int segmentQuality;
+uniform bool renderPoints;
+uniform float pointSize;
+
+const float TwoPi = 6.28318530718;
+
+
+// This has to match kepler::orbitRecordPosition
+float eccentricAnomaly(float e, float m) {
+  float x = m;
+  if (e == 0.0) {
+    x = m;
+  }
+  else if (e < 0.2) {
+    for (int i = 0; i < 5; i++) {
+      x = m + e * sin(x);
+    }
+  }
+  else if (e < 0.9) {
+    for (int i = 0; i < 6; i++) {
+      x = x + (m + e * sin(x) - x) / (1.0 - e * cos(x));
+    }
+  }
+  else if (e < 1.0) {
+    x = m + 0.85 * e * sign(sin(m));
+    for (int i = 0; i < 8; i++) {
+      float s = e * sin(x);
+      float c = e * cos(x);
+      float f = x - s - m;
+      float f1 = 1.0 - c;
+      float f2 = s;
+      x = x + (-5.0 * f / (f1 + sign(f1) * sqrt(abs(16.0 * f1 * f1 - 20.0 * f * f2))));
+    }
+  }
+  else {
+    x = 0.0;
+  }
+  return x;
+}
+
+
+void main() {
+  float e = orbitShape.x;
+  float a = orbitShape.y;
+  float meanAnomalyAtEpoch = orbitShape.z;
+
+  // The number of revolutions is computed in double precision and only the fraction of
+  // the current revolution is used in single precision
+  double revolutions = (inGameTime - orbitTime.x) / orbitTime.y;
+  periodFraction = float(revolutions - floor(revolutions));
+
+  float meanAnomaly;
+  if (renderPoints) {
+    // The current location of the object
+    meanAnomaly = meanAnomalyAtEpoch + TwoPi * periodFraction;
+    offsetPeriods = periodFraction;
+    gl_PointSize = pointSize;
+  }
+  else {
+    // Same number of segments as kepler::numberOfSegments. All orbits of a draw call are
+    // drawn with the same number of vertices, see kepler::orbitBuckets, so the surplus
+    // vertices collapse onto the end point
+    float scale = float(segmentQuality) * 10.0;
+    int nSegments = int(scale + (scale / pow(1.0 - e, 1.2)));
+    int vertex = min(gl_VertexID, nSegments);
+    offsetPeriods = float(vertex) / float(nSegments);
+    meanAnomaly = meanAnomalyAtEpoch + TwoPi * offsetPeriods;
+  }
+
+  float ea = eccentricAnomaly(e, meanAnomaly);
+  vec3 position =
+    orbitP * (a * (cos(ea) - e)) + orbitQ * (a * sin(ea) * sqrt(1.0 - e * e));
+
+  viewSpacePosition = vec4(modelViewTransform * dvec4(position, 1));
+  vec4 vs_position = z_normalization(projectionTransform * viewSpacePosition);
+  gl_Position = vs_position;
+  viewSpaceDepth = vs_position.w;
+}
@@ -141,6 +141,10 @@ glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
     return interpolatedPos;
 }
 
+bool HorizonsTranslation::supportsConcurrentEvaluation() const {
+    return true;
+}
+
 void HorizonsTranslation::loadData() {
     for (const std::string& filePath : _horizonsTextFiles.value()) {
         std::filesystem::path file = absPath(filePath);
@@ -72,6 +72,7 @@ public:
     HorizonsTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool supportsConcurrentEvaluation() const override;
 
     static documentation::Documentation Documentation();
 
@@ -276,6 +276,10 @@ glm::dvec3 KeplerTranslation::position(const UpdateData& data) const {
     return _orbitPlaneRotation * p;
 }
 
+bool KeplerTranslation::supportsConcurrentEvaluation() const {
+    return true;
+}
+
 void KeplerTranslation::computeOrbitPlane() const {
     // We assume the following coordinate system:
     // z = axis of rotation
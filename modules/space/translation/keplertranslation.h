@@ -69,6 +69,7 @@ public:
     * \param time The time to use when doing the position lookup
     */
     glm::dvec3 position(const UpdateData& data) const override;
+    bool supportsConcurrentEvaluation() const override;
 
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictionary
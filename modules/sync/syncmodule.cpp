@@ -46,6 +46,8 @@
 #include "syncmodule_lua.inl"
 
 namespace {
+    constexpr int DefaultMaxConcurrentDownloads = 8;
+
     struct [[codegen::Dictionary(SyncModule)]] Parameters {
         // The list of all repository URLs that are used to fetch data from for
         // HTTPSynchronizations
@@ -53,6 +55,10 @@ namespace {
 
         // The folder where all of the synchronizations are stored
         std::string synchronizationRoot;
+
+        // The maximum number of files that HttpSynchronizations download at the same
+        // time. This limit is shared between all synchronizations
+        std::optional<int> maxConcurrentDownloads [[codegen::greater(0)]];
     };
 #include "syncmodule_codegen.cpp"
 } // namespace
@@ -70,6 +76,10 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
 
     _synchronizationRoot = absPath(p.synchronizationRoot);
 
+    _downloadEngine = std::make_unique<HttpDownloadEngine>(
+        p.maxConcurrentDownloads.value_or(DefaultMaxConcurrentDownloads)
+    );
+
     ghoul::TemplateFactory<ResourceSynchronization>* fSynchronization =
         FactoryManager::ref().factory<ResourceSynchronization>();
     ghoul_assert(fSynchronization, "ResourceSynchronization factory was not created");
@@ -82,14 +92,16 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
                 return new (ptr) HttpSynchronization(
                     dictionary,
                     _synchronizationRoot,
-                    _synchronizationRepositories
+                    _synchronizationRepositories,
+                    *_downloadEngine
                 );
             }
             else {
                 return new HttpSynchronization(
                     dictionary,
                     _synchronizationRoot,
-                    _synchronizationRepositories
+                    _synchronizationRepositories,
+                    *_downloadEngine
                 );
             }
         }
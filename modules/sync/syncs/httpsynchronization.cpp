@@ -29,13 +29,49 @@
 #include <openspace/util/httprequest.h>
 #include <ghoul/ext/assimp/contrib/zip/src/zip.h>
 #include <ghoul/logging/logmanager.h>
-#include <unordered_map>
+#include <cctype>
+#include <unordered_set>
 
 namespace {
     constexpr std::string_view _loggerCat = "HttpSynchronization";
 
     constexpr int ApplicationVersion = 1;
 
+    constexpr std::string_view FileScheme = "file://";
+
+    // Converts a local path into a file:// URL, escaping all characters that are not
+    // allowed to appear in a URL
+    std::string fileUrl(const std::filesystem::path& path) {
+        const std::string p = std::filesystem::absolute(path).generic_string();
+        std::string url = std::string(FileScheme);
+        if (!p.starts_with('/')) {
+            // Windows paths start with a drive letter rather than a /
+            url += '/';
+        }
+        for (char c : p) {
+            const unsigned char uc = static_cast<unsigned char>(c);
+            if (std::isalnum(uc) || c == '-' || c == '.' || c == '_' || c == '~' ||
+                c == '/' || c == ':')
+            {
+                url += c;
+            }
+            else {
+                url += fmt::format("%{:02X}", uc);
+            }
+        }
+        return url;
+    }
+
+    // Returns the local directory that a file:// repository URL is pointing to
+    std::filesystem::path mirrorDirectory(std::string_view url) {
+        std::string_view path = url.substr(FileScheme.size());
+        if (path.size() > 2 && path[0] == '/' && path[2] == ':') {
+            // file:///C:/... on Windows
+            path.remove_prefix(1);
+        }
+        return std::filesystem::path(path);
+    }
+
     struct [[codegen::Dictionary(HttpSynchronization)]] Parameters {
         // The unique identifier for this resource that is used to request a set of files
         // from the synchronization servers
@@ -65,10 +101,11 @@ documentation::Documentation HttpSynchronization::Documentation() {
 
 HttpSynchronization::HttpSynchronization(const ghoul::Dictionary& dict,
                                          std::filesystem::path synchronizationRoot,
-                                      std::vector<std::string> synchronizationRepositories
-)
+                                   std::vector<std::string> synchronizationRepositories,
+                                                     HttpDownloadEngine& downloadEngine)
     : ResourceSynchronization(std::move(synchronizationRoot))
     , _syncRepositories(std::move(synchronizationRepositories))
+    , _downloadEngine(downloadEngine)
 {
     const Parameters p = codegen::bake<Parameters>(dict);
 
@@ -110,7 +147,9 @@ void HttpSynchronization::start() {
     _syncThread = std::thread(
         [this](const std::string& q) {
             for (const std::string& url : _syncRepositories) {
-                const bool success = trySyncFromUrl(url + q);
+                const bool success = url.starts_with(FileScheme) ?
+                    trySyncFromMirror(mirrorDirectory(url)) :
+                    trySyncFromUrl(url + q);
                 if (success) {
                     createSyncFile();
                     _state = State::Resolved;
@@ -148,27 +187,10 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
         return false;
     }
 
-    _nSynchronizedBytes = 0;
-    _nTotalBytes = 0;
-    _nTotalBytesKnown = false;
-
     std::istringstream fileList(std::string(buffer.begin(), buffer.end()));
 
-    struct SizeData {
-        int64_t downloadedBytes = 0;
-        std::optional<int64_t> totalBytes;
-    };
-
-    std::unordered_map<std::string, SizeData> sizeData;
-    std::mutex mutex;
-
-    std::atomic_bool startedAllDownloads = false;
-
-    // Yes, it should be possible to store this in a std::vector<HttpFileDownload> but
-    // C++ really doesn't like that even though all of the move constructors, move
-    // assignments and everything is automatically constructed
-    std::vector<std::unique_ptr<HttpFileDownload>> downloads;
-
+    std::vector<HttpDownloadEngine::File> files;
+    std::unordered_set<std::string> urls;
     std::string line;
     while (fileList >> line) {
         if (line.empty() || line[0] == '#') {
@@ -176,112 +198,106 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
             continue;
         }
 
-        std::string filename = std::filesystem::path(line).filename().string();
-        std::filesystem::path destination = directory() / (filename + ".tmp");
-
-        if (sizeData.find(line) != sizeData.end()) {
+        if (urls.find(line) != urls.end()) {
             LWARNING(fmt::format("{}: Duplicate entry for {}", _identifier, line));
             continue;
         }
+        urls.insert(line);
 
-        auto download = std::make_unique<HttpFileDownload>(
-            line,
-            destination,
-            HttpFileDownload::Overwrite::Yes
-        );
-        HttpFileDownload* dl = download.get();
-        downloads.push_back(std::move(download));
-
-        sizeData[line] = SizeData();
-
-        dl->onProgress(
-            [this, line, &sizeData, &mutex, &startedAllDownloads](int64_t downloadedBytes,
-                                                        std::optional<int64_t> totalBytes)
-        {
-            if (!totalBytes.has_value() || !startedAllDownloads) {
-                return !_shouldCancel;
-            }
-
-            std::lock_guard guard(mutex);
-
-            sizeData[line] = { downloadedBytes, totalBytes };
-
-            _nTotalBytesKnown = true;
-            _nTotalBytes = 0;
-            _nSynchronizedBytes = 0;
-            for (const std::pair<const std::string, SizeData>& sd : sizeData) {
-                _nTotalBytesKnown = _nTotalBytesKnown && sd.second.totalBytes.has_value();
-                _nTotalBytes += sd.second.totalBytes.value_or(0);
-                _nSynchronizedBytes += sd.second.downloadedBytes;
-            }
+        std::string filename = std::filesystem::path(line).filename().string();
+        files.push_back({ line, directory() / filename });
+    }
 
-            return !_shouldCancel;
-        });
+    return downloadFiles(std::move(files));
+}
 
-        dl->start();
+bool HttpSynchronization::trySyncFromMirror(const std::filesystem::path& mirror) {
+    const std::filesystem::path source = mirror / _identifier / std::to_string(_version);
+    if (!std::filesystem::is_directory(source)) {
+        LDEBUG(fmt::format("Mirror {} does not contain {}", mirror, generateUid()));
+        return false;
     }
-    startedAllDownloads = true;
-
-    bool failed = false;
-    for (const std::unique_ptr<HttpFileDownload>& d : downloads) {
-        d->wait();
-        if (!d->hasSucceeded()) {
-            LERROR(fmt::format("Error downloading file from URL {}", d->url()));
-            failed = true;
+
+    std::vector<HttpDownloadEngine::File> files;
+    namespace fs = std::filesystem;
+    for (const fs::directory_entry& e : fs::recursive_directory_iterator(source)) {
+        if (!e.is_regular_file() || e.path().extension() == ".tmp") {
             continue;
         }
 
-        // If we are forcing the override, we download to a temporary file first, so when
-        // we are done here, we need to rename the file to the original name
+        const fs::path relative = fs::relative(e.path(), source);
+        files.push_back({ fileUrl(e.path()), directory() / relative });
+    }
+
+    return downloadFiles(std::move(files));
+}
+
+bool HttpSynchronization::downloadFiles(std::vector<HttpDownloadEngine::File> files) {
+    _nSynchronizedBytes = 0;
+    _nTotalBytes = 0;
+    _nTotalBytesKnown = false;
 
-        std::filesystem::path tempName = d->destination();
-        std::filesystem::path originalName = tempName;
-        // Remove the .tmp extension
-        originalName.replace_extension("");
+    std::vector<std::filesystem::path> destinations;
+    destinations.reserve(files.size());
+    for (const HttpDownloadEngine::File& file : files) {
+        destinations.push_back(file.destination);
+    }
+
+    std::shared_ptr<HttpDownloadEngine::Batch> batch =
+        _downloadEngine.download(std::move(files));
 
-        if (std::filesystem::is_regular_file(originalName)) {
-            std::filesystem::remove(originalName);
+    auto updateProgress = [this, &batch]() {
+        _nTotalBytesKnown = batch->isTotalBytesKnown();
+        _nTotalBytes = batch->nTotalBytes();
+        _nSynchronizedBytes = batch->nDownloadedBytes();
+    };
+    while (!batch->waitFor(std::chrono::milliseconds(50))) {
+        if (_shouldCancel) {
+            batch->cancel();
         }
-        std::error_code ec;
-        std::filesystem::rename(tempName, originalName, ec);
-        if (ec) {
-            LERROR(fmt::format("Error renaming {} to {}", tempName, originalName));
-            failed = true;
+        updateProgress();
+    }
+    updateProgress();
+
+    const std::vector<std::string> failedUrls = batch->failedUrls();
+    for (const std::string& url : failedUrls) {
+        LERROR(fmt::format("Error downloading file from URL {}", url));
+    }
+    if (!failedUrls.empty() || !_unzipFiles) {
+        return failedUrls.empty();
+    }
+
+    for (const std::filesystem::path& destination : destinations) {
+        if (destination.extension() != ".zip") {
+            continue;
         }
 
-        if (_unzipFiles && originalName.extension() == ".zip") {
-            std::string source = originalName.string();
-            std::string dest =
-                _unzipFilesDestination.has_value() ?
-                (originalName.parent_path() / *_unzipFilesDestination).string() :
-                originalName.replace_extension().string();;
-
-            struct zip_t* z = zip_open(source.c_str(), 0, 'r');
-            const bool is64 = zip_is64(z);
-            zip_close(z);
-
-            if (is64) {
-                LERROR(fmt::format(
-                    "Error while unzipping {}: Zip64 archives are not supported", source
-                ));
-                continue;
-            }
+        std::string source = destination.string();
+        std::string dest =
+            _unzipFilesDestination.has_value() ?
+            (destination.parent_path() / *_unzipFilesDestination).string() :
+            std::filesystem::path(destination).replace_extension().string();
 
-            int ret = zip_extract(source.c_str(), dest.c_str(), nullptr, nullptr);
-            if (ret != 0) {
-                LERROR(fmt::format("Error {} while unzipping {}", ret, source));
-                continue;
-            }
+        struct zip_t* z = zip_open(source.c_str(), 0, 'r');
+        const bool is64 = zip_is64(z);
+        zip_close(z);
 
-            std::filesystem::remove(source);
+        if (is64) {
+            LERROR(fmt::format(
+                "Error while unzipping {}: Zip64 archives are not supported", source
+            ));
+            continue;
         }
-    }
-    if (failed) {
-        for (const std::unique_ptr<HttpFileDownload>& d : downloads) {
-            d->cancel();
+
+        int ret = zip_extract(source.c_str(), dest.c_str(), nullptr, nullptr);
+        if (ret != 0) {
+            LERROR(fmt::format("Error {} while unzipping {}", ret, source));
+            continue;
         }
+
+        std::filesystem::remove(source);
     }
-    return !failed;
+    return true;
 }
 
 } // namespace openspace
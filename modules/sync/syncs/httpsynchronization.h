@@ -27,6 +27,7 @@
 
 #include <openspace/util/resourcesynchronization.h>
 
+#include <openspace/util/httpdownloadengine.h>
 #include <thread>
 #include <optional>
 #include <vector>
@@ -45,6 +46,13 @@ namespace openspace {
  * application version). The identifier is denoting the group of files that is requested,
  * the file version is the specific version of this set of files, and the application
  * version is reserved for changes in the data transfer format.
+ *
+ * A repository can also be a `file://` URL pointing to a local mirror directory. In that
+ * case no file list is requested and instead all files in the subfolder
+ * `<identifier>/<version>` of the mirror are copied, which is the same layout as the
+ * #directory of the synchronization.
+ *
+ * All files are downloaded through a shared HttpDownloadEngine.
  */
 class HttpSynchronization : public ResourceSynchronization {
 public:
@@ -62,10 +70,13 @@ public:
      *        path is constructed
      * \param synchronizationRepositories The list of repositories that will be asked to
      *        resolve the identifier request
+     * \param downloadEngine The engine that is used to download the files. It has to
+     *        outlive this synchronization
      */
     HttpSynchronization(const ghoul::Dictionary& dict,
         std::filesystem::path synchronizationRoot,
-        std::vector<std::string> synchronizationRepositories);
+        std::vector<std::string> synchronizationRepositories,
+        HttpDownloadEngine& downloadEngine);
 
     /// Destructor that will close the asynchronous file transfer, if it is still ongoing
     ~HttpSynchronization() override;
@@ -96,6 +107,12 @@ private:
     /// Tries to get a reply from the provided URL and returns that success to the caller
     bool trySyncFromUrl(std::string url);
 
+    /// Tries to copy the files from a local mirror directory
+    bool trySyncFromMirror(const std::filesystem::path& mirror);
+
+    /// Downloads all \p files, updates the progress, and unzips the downloaded files
+    bool downloadFiles(std::vector<HttpDownloadEngine::File> files);
+
     /// Contains a flag whether the current transfer should be cancelled
     std::atomic_bool _shouldCancel = false;
 
@@ -108,6 +125,9 @@ private:
     // The list of all repositories that we'll try to sync from
     const std::vector<std::string> _syncRepositories;
 
+    // The engine that performs all file downloads
+    HttpDownloadEngine& _downloadEngine;
+
     // The thread that will be doing the synchronization
     std::thread _syncThread;
 };
@@ -46,6 +46,13 @@ public:
     ValueType& get(const KeyType& key);
     void evict();
     size_t capacity() const;
+    size_t size() const;
+
+    /// Removes the entry for \p key from the cache if it exists
+    void remove(const KeyType& key);
+
+    /// Returns the key that would be removed by the next call to evict
+    const KeyType& leastRecentlyUsedKey() const;
 
 private:
     void insert(const KeyType& key, const ValueType& value);
@@ -58,4 +65,6 @@ private:
 
 } // namespace openspace::volume
 
+#include "lrucache.inl"
+
 #endif // __OPENSPACE_MODULE_VOLUME___LRUCACHE___H__
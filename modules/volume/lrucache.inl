@@ -22,6 +22,8 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <ghoul/misc/assert.h>
+
 namespace openspace::volume {
 
 template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
@@ -40,7 +42,7 @@ void LruCache<KeyType, ValueType, ContainerType>::set(const KeyType& key, ValueT
     auto prev = _cache.find(key);
     if (prev != _cache.end()) {
         prev->second.first = value;
-        std::list<KeyType>::iterator trackerIter = prev->second.second;
+        typename std::list<KeyType>::iterator trackerIter = prev->second.second;
         _tracker.splice(_tracker.end(), _tracker, trackerIter);
     }
     else {
@@ -51,7 +53,7 @@ void LruCache<KeyType, ValueType, ContainerType>::set(const KeyType& key, ValueT
 template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
 ValueType& LruCache<KeyType, ValueType, ContainerType>::use(const KeyType& key) {
     auto iter = _cache.find(key);
-    std::list<KeyType>::iterator trackerIter = iter->second.second;
+    typename std::list<KeyType>::iterator trackerIter = iter->second.second;
     _tracker.splice(_tracker.end(), _tracker, trackerIter);
     return iter->second.first;
 }
@@ -73,6 +75,27 @@ size_t LruCache<KeyType, ValueType, ContainerType>::capacity() const {
     return _capacity;
 }
 
+template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
+size_t LruCache<KeyType, ValueType, ContainerType>::size() const {
+    return _cache.size();
+}
+
+template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
+void LruCache<KeyType, ValueType, ContainerType>::remove(const KeyType& key) {
+    auto iter = _cache.find(key);
+    if (iter == _cache.end()) {
+        return;
+    }
+    _tracker.erase(iter->second.second);
+    _cache.erase(iter);
+}
+
+template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
+const KeyType& LruCache<KeyType, ValueType, ContainerType>::leastRecentlyUsedKey() const {
+    ghoul_assert(!_tracker.empty(), "Cache must not be empty");
+    return _tracker.front();
+}
+
 template <typename KeyType, typename ValueType, template<typename...> class ContainerType>
 void LruCache<KeyType, ValueType, ContainerType>::insert(const KeyType& key,
                                                          const ValueType& value)
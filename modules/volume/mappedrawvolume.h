@@ -0,0 +1,110 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+#define __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <filesystem>
+#include <memory>
+
+namespace openspace::volume {
+
+template <typename T> class RawVolume;
+
+/**
+ * A raw volume whose voxels are not read into memory but accessed directly in a memory
+ * mapped file. Only the parts of the file that are accessed are loaded by the operating
+ * system, and sub-bricks of the volume can be accessed without copying any data.
+ */
+template <typename Type>
+class MappedRawVolume {
+public:
+    using VoxelType = Type;
+
+    /**
+     * A box of voxels inside a MappedRawVolume. The voxels are not copied, so the brick
+     * is only valid for as long as the volume that created it exists.
+     */
+    struct Brick {
+        /// Returns the voxel at the \p coordinates that are relative to the brick
+        VoxelType get(const glm::uvec3& coordinates) const;
+        /// Copies the voxels of the brick into the tightly packed \p destination
+        void copyTo(VoxelType* destination) const;
+        /// Returns the number of voxels in the brick
+        size_t nCells() const;
+
+        /// The first voxel of the brick
+        const VoxelType* data = nullptr;
+        /// The location of the first voxel of the brick in the volume
+        glm::uvec3 offset = glm::uvec3(0);
+        /// The number of voxels of the brick in each dimension
+        glm::uvec3 dimensions = glm::uvec3(0);
+        /// The distance between two consecutive rows of the brick in voxels
+        size_t rowStride = 0;
+        /// The distance between two consecutive slices of the brick in voxels
+        size_t sliceStride = 0;
+    };
+
+    /**
+     * Maps the raw volume at the \p path with the provided \p dimensions.
+     *
+     * \throw ghoul::RuntimeError If the file cannot be mapped or is too small for the
+     *        provided \p dimensions
+     */
+    MappedRawVolume(std::filesystem::path path, const glm::uvec3& dimensions);
+
+    glm::uvec3 dimensions() const;
+    size_t nCells() const;
+    VoxelType get(const glm::uvec3& coordinates) const;
+    VoxelType get(size_t index) const;
+    const VoxelType* data() const;
+    size_t coordsToIndex(const glm::uvec3& cartesian) const;
+    glm::uvec3 indexToCoords(size_t linear) const;
+
+    /**
+     * Returns the box of voxels that starts at \p offset and has the size \p dimensions
+     * without copying the voxels.
+     *
+     * \pre The brick must be fully contained in the volume
+     */
+    Brick brick(const glm::uvec3& offset, const glm::uvec3& dimensions) const;
+
+    /**
+     * Copies the entire volume into memory. If \p invertZ is `true`, the order of the
+     * slices along the z axis is reversed.
+     */
+    std::unique_ptr<RawVolume<VoxelType>> copy(bool invertZ = false) const;
+
+private:
+    glm::uvec3 _dimensions;
+    MemoryMappedFile _file;
+};
+
+} // namespace openspace::volume
+
+#include "mappedrawvolume.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumeutils.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstring>
+
+namespace openspace::volume {
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::Brick::get(const glm::uvec3& coordinates) const {
+    ghoul_assert(
+        glm::all(glm::lessThan(coordinates, dimensions)),
+        "Coordinates must be inside the brick"
+    );
+    return data[coordinates.z * sliceStride + coordinates.y * rowStride + coordinates.x];
+}
+
+template <typename VoxelType>
+void MappedRawVolume<VoxelType>::Brick::copyTo(VoxelType* destination) const {
+    for (unsigned int z = 0; z < dimensions.z; z++) {
+        for (unsigned int y = 0; y < dimensions.y; y++) {
+            const VoxelType* row = data + z * sliceStride + y * rowStride;
+            std::copy(row, row + dimensions.x, destination);
+            destination += dimensions.x;
+        }
+    }
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::Brick::nCells() const {
+    return static_cast<size_t>(dimensions.x) * static_cast<size_t>(dimensions.y) *
+        static_cast<size_t>(dimensions.z);
+}
+
+template <typename VoxelType>
+MappedRawVolume<VoxelType>::MappedRawVolume(std::filesystem::path path,
+                                            const glm::uvec3& dimensions)
+    : _dimensions(dimensions)
+    , _file(std::move(path))
+{
+    if (_file.size() < nCells() * sizeof(VoxelType)) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Volume file '{}' is too small for dimensions ({}, {}, {})",
+            _file.path(), dimensions.x, dimensions.y, dimensions.z
+        ));
+    }
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::dimensions() const {
+    return _dimensions;
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::nCells() const {
+    return static_cast<size_t>(_dimensions.x) * static_cast<size_t>(_dimensions.y) *
+        static_cast<size_t>(_dimensions.z);
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(const glm::uvec3& coordinates) const {
+    return get(coordsToIndex(coordinates));
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(size_t index) const {
+    return data()[index];
+}
+
+template <typename VoxelType>
+const VoxelType* MappedRawVolume<VoxelType>::data() const {
+    return reinterpret_cast<const VoxelType*>(_file.data());
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
+    return volume::coordsToIndex(cartesian, dimensions());
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::indexToCoords(size_t linear) const {
+    return volume::indexToCoords(linear, dimensions());
+}
+
+template <typename VoxelType>
+typename MappedRawVolume<VoxelType>::Brick
+MappedRawVolume<VoxelType>::brick(const glm::uvec3& offset,
+                                  const glm::uvec3& brickDimensions) const
+{
+    ghoul_precondition(
+        glm::all(glm::lessThanEqual(offset + brickDimensions, _dimensions)),
+        "Brick must be inside the volume"
+    );
+
+    Brick b;
+    b.data = data() + coordsToIndex(offset);
+    b.offset = offset;
+    b.dimensions = brickDimensions;
+    b.rowStride = _dimensions.x;
+    b.sliceStride = static_cast<size_t>(_dimensions.x) * _dimensions.y;
+    return b;
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>> MappedRawVolume<VoxelType>::copy(
+                                                                      bool invertZ) const
+{
+    auto volume = std::make_unique<RawVolume<VoxelType>>(_dimensions);
+    if (!invertZ) {
+        std::memcpy(volume->data(), data(), nCells() * sizeof(VoxelType));
+        return volume;
+    }
+
+    // Inverting the z axis reverses the order of the slices
+    const size_t sliceSize = static_cast<size_t>(_dimensions.x) * _dimensions.y;
+    for (size_t z = 0; z < _dimensions.z; z++) {
+        std::memcpy(
+            volume->data() + (_dimensions.z - z - 1) * sliceSize,
+            data() + z * sliceSize,
+            sliceSize * sizeof(VoxelType)
+        );
+    }
+    return volume;
+}
+
+} // namespace openspace::volume
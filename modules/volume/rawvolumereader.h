@@ -31,6 +31,7 @@
 
 namespace openspace::volume {
 
+template <typename T> class MappedRawVolume;
 template <typename T> class RawVolume;
 
 template <typename Type>
@@ -48,6 +49,12 @@ public:
     //VoxelType get(const size_t index) const; // TODO: Implement this
     std::unique_ptr<RawVolume<VoxelType>> read(bool invertZ = false);
 
+    /**
+     * Maps the volume file into memory instead of reading it. The voxels are only loaded
+     * as they are accessed and sub-bricks of the volume can be accessed without copying.
+     */
+    std::unique_ptr<MappedRawVolume<VoxelType>> map() const;
+
 private:
     size_t coordsToIndex(const glm::uvec3& cartesian) const;
     glm::uvec3 indexToCoords(size_t linear) const;
@@ -22,8 +22,9 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <modules/volume/mappedrawvolume.h>
+#include <modules/volume/rawvolume.h>
 #include <ghoul/misc/exception.h>
-#include <fstream>
 
 namespace openspace::volume {
 
@@ -79,47 +80,23 @@ glm::uvec3 RawVolumeReader<VoxelType>::indexToCoords(size_t linear) const {
 
 template <typename VoxelType>
 std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::read(bool invertZ) {
-    glm::uvec3 dims = dimensions();
-    auto volume = std::make_unique<RawVolume<VoxelType>>(dims);
-
-    std::ifstream file(_path, std::ios::binary);
-    char* buffer = reinterpret_cast<char*>(volume->data());
-
-    if (file.fail()) {
+    if (!std::filesystem::is_regular_file(_path)) {
         throw ghoul::FileNotFoundError("Volume file not found");
     }
 
-    size_t length = static_cast<size_t>(dims.x) *
-                    static_cast<size_t>(dims.y) *
-                    static_cast<size_t>(dims.z) *
-                    sizeof(VoxelType);
-
-    file.read(buffer, length);
-
-    if (file.fail()) {
+    std::unique_ptr<MappedRawVolume<VoxelType>> mapped;
+    try {
+        mapped = map();
+    }
+    catch (const ghoul::RuntimeError&) {
         throw ghoul::RuntimeError("Error reading volume file");
     }
+    return mapped->copy(invertZ);
+}
 
-    if (invertZ) {
-        std::unique_ptr<RawVolume<VoxelType>> newVolume =
-            std::make_unique<RawVolume<VoxelType>>(dims);
-
-        for (size_t i = 0; i < volume->nCells(); ++i) {
-            const glm::uvec3& coords = volume->indexToCoords(i);
-            glm::uvec3 newcoords = glm::uvec3(coords.x, coords.y, dims.z - coords.z - 1);
-
-            // @TODO (emmbr, 2022-02-10) Not sure why they are here, but commented them
-            // out for now as they aren't used
-            //size_t newIndex = volume->coordsToIndex(newcoords);
-            //size_t oldIndex = volume->coordsToIndex(coords);
-
-            newVolume->set(newcoords, volume->get(coords));
-        }
-        return newVolume;
-    }
-    else {
-        return volume;
-    }
+template <typename VoxelType>
+std::unique_ptr<MappedRawVolume<VoxelType>> RawVolumeReader<VoxelType>::map() const {
+    return std::make_unique<MappedRawVolume<VoxelType>>(_path, dimensions());
 }
 
 } // namespace openspace::volume
@@ -45,6 +45,38 @@ public:
                const std::function<void(float)>& onProgress = [](float) {});
     void write(const RawVolume<VoxelType>& volume);
 
+    /**
+     * Writes the volume in slabs of consecutive slices along the z axis. Each slab
+     * contains as many slices as are needed to fill the buffer, but at least one. The
+     * voxels of a slab are computed by calling \p fn on up to \p nThreads threads, or on
+     * as many threads as the hardware supports if \p nThreads is 0, so \p fn has to be
+     * safe to call concurrently. The previous slab is written to disk while the next one
+     * is computed, so at most two slabs are kept in memory.
+     *
+     * \param fn The function that computes the value of the voxel at the provided
+     *        coordinates
+     * \param prepareSlab Called on the calling thread with the first and one past the
+     *        last slice of a slab before its voxels are computed. It can be used to load
+     *        the data that \p fn needs for these slices
+     * \param nThreads The maximum number of threads that compute voxels
+     * \param onProgress Called on the calling thread after each slab
+     */
+    void writeSlabs(const std::function<VoxelType(const glm::uvec3&)>& fn,
+        const std::function<void(unsigned int, unsigned int)>& prepareSlab,
+        unsigned int nThreads = 0,
+        const std::function<void(float)>& onProgress = [](float) {});
+
+    /**
+     * Same as above, but \p fn is additionally passed the index of the thread that calls
+     * it. The index is smaller than the number of threads and is never used by two
+     * threads at the same time, so \p fn can use it to pick per-thread state that is not
+     * safe to share, such as a Lua state or a running minimum and maximum.
+     */
+    void writeSlabs(const std::function<VoxelType(const glm::uvec3&, unsigned int)>& fn,
+        const std::function<void(unsigned int, unsigned int)>& prepareSlab,
+        unsigned int nThreads = 0,
+        const std::function<void(float)>& onProgress = [](float) {});
+
     size_t coordsToIndex(const glm::uvec3& coords) const;
     glm::ivec3 indexToCoords(size_t linear) const;
 
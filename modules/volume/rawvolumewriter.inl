@@ -26,7 +26,11 @@
 #include <modules/volume/volumeutils.h>
 #include <ghoul/misc/exception.h>
 #include <ghoul/fmt.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <thread>
 
 namespace openspace::volume {
 
@@ -107,4 +111,112 @@ void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     file.close();
 }
 
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::writeSlabs(
+                                    const std::function<VoxelType(const glm::uvec3&)>& fn,
+                       const std::function<void(unsigned int, unsigned int)>& prepareSlab,
+                                                                    unsigned int nThreads,
+                                            const std::function<void(float)>& onProgress)
+{
+    writeSlabs(
+        [&fn](const glm::uvec3& coords, unsigned int) { return fn(coords); },
+        prepareSlab,
+        nThreads,
+        onProgress
+    );
+}
+
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::writeSlabs(
+                      const std::function<VoxelType(const glm::uvec3&, unsigned int)>& fn,
+                       const std::function<void(unsigned int, unsigned int)>& prepareSlab,
+                                                                    unsigned int nThreads,
+                                            const std::function<void(float)>& onProgress)
+{
+    const glm::uvec3 dims = dimensions();
+    const size_t sliceSize = static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y);
+    if (sliceSize == 0 || dims.z == 0) {
+        return;
+    }
+
+    const unsigned int slabDepth = static_cast<unsigned int>(std::clamp<size_t>(
+        (_bufferSize + sliceSize - 1) / sliceSize,
+        1,
+        dims.z
+    ));
+    const unsigned int nRowsPerSlice = dims.y;
+
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::ofstream file(_path, std::ios::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Could not create file {}", _path));
+    }
+
+    // One buffer is filled while the other one is written to disk
+    std::vector<VoxelType> buffers[2] = {
+        std::vector<VoxelType>(sliceSize * slabDepth),
+        std::vector<VoxelType>(sliceSize * slabDepth)
+    };
+    std::future<void> pendingWrite;
+
+    const unsigned int nSlabs = (dims.z + slabDepth - 1) / slabDepth;
+    for (unsigned int slab = 0; slab < nSlabs; slab++) {
+        const unsigned int zBegin = slab * slabDepth;
+        const unsigned int zEnd = std::min(zBegin + slabDepth, dims.z);
+        if (prepareSlab) {
+            prepareSlab(zBegin, zEnd);
+        }
+
+        std::vector<VoxelType>& buffer = buffers[slab % 2];
+
+        // The rows of the slab are handed out one at a time, which keeps the threads
+        // busy even if some parts of the volume are more expensive to compute
+        const unsigned int nRows = (zEnd - zBegin) * nRowsPerSlice;
+        std::atomic<unsigned int> nextRow = 0;
+        auto computeRows = [&](unsigned int worker) {
+            for (unsigned int row = nextRow++; row < nRows; row = nextRow++) {
+                const unsigned int y = row % nRowsPerSlice;
+                const unsigned int z = zBegin + row / nRowsPerSlice;
+                VoxelType* rowData = buffer.data() + static_cast<size_t>(row) * dims.x;
+                for (unsigned int x = 0; x < dims.x; x++) {
+                    rowData[x] = fn(glm::uvec3(x, y, z), worker);
+                }
+            }
+        };
+
+        const unsigned int nWorkers = std::min(nThreads, nRows) - 1;
+        std::vector<std::future<void>> workers;
+        workers.reserve(nWorkers);
+        for (unsigned int i = 0; i < nWorkers; i++) {
+            workers.push_back(std::async(std::launch::async, computeRows, i + 1));
+        }
+        computeRows(0);
+        for (std::future<void>& worker : workers) {
+            worker.get();
+        }
+
+        // The previous slab has to be on disk before this one is written after it
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+        const size_t nBytes = static_cast<size_t>(nRows) * dims.x * sizeof(VoxelType);
+        pendingWrite = std::async(
+            std::launch::async,
+            [&file, &buffer, nBytes]() {
+                file.write(reinterpret_cast<const char*>(buffer.data()), nBytes);
+            }
+        );
+
+        onProgress(static_cast<float>(slab + 1) / static_cast<float>(nSlabs));
+    }
+
+    pendingWrite.get();
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Error writing to file {}", _path));
+    }
+}
+
 } // namespace openspace::volume
@@ -27,6 +27,8 @@
 #include <modules/volume/rendering/basicvolumeraycaster.h>
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <modules/volume/transferfunctionhandler.h>
+#include <modules/volume/lrucache.h>
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/volumegridtype.h>
@@ -37,6 +39,9 @@
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/histogram.h>
 #include <openspace/rendering/transferfunction.h>
+#include <openspace/util/concurrentjobmanager.h>
+#include <openspace/util/job.h>
+#include <openspace/util/threadpool.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/updatestructures.h>
@@ -44,6 +49,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 
@@ -52,6 +58,8 @@ namespace {
 
     const float SecondsInOneDay = 60 * 60 * 24;
 
+    constexpr size_t BytesPerMegabyte = 1024 * 1024;
+
     constexpr openspace::properties::Property::PropertyInfo StepSizeInfo = {
         "StepSize",
         "Step Size",
@@ -112,6 +120,23 @@ namespace {
         openspace::properties::Property::Visibility::User
     };
 
+    constexpr openspace::properties::Property::PropertyInfo CacheBudgetInfo = {
+        "CacheBudget",
+        "Cache Budget (MB)",
+        "The maximum amount of memory in megabytes that is used to keep loaded "
+        "timesteps in memory and on the GPU. The least recently displayed timesteps are "
+        "unloaded when the budget is exceeded, but the displayed timestep is always kept",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchCountInfo = {
+        "PrefetchCount",
+        "Prefetch Count",
+        "The number of timesteps that are loaded ahead of the current timestep in the "
+        "direction in which time is moving",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     constexpr openspace::properties::Property::PropertyInfo BrightnessInfo = {
         "Brightness",
         "Brightness",
@@ -163,12 +188,72 @@ namespace {
 
         // @TODO Missing documentation
         std::optional<ghoul::Dictionary> clipPlanes;
+
+        // [[codegen::verbatim(CacheBudgetInfo.description)]]
+        std::optional<int> cacheBudget [[codegen::greater(0)]];
+
+        // [[codegen::verbatim(PrefetchCountInfo.description)]]
+        std::optional<int> prefetchCount [[codegen::inrange(0, 16)]];
     };
 #include "renderabletimevaryingvolume_codegen.cpp"
 } // namespace
 
 namespace openspace::volume {
 
+/**
+ * Reads, normalizes and computes the histogram of a single timestep. The job only
+ * captures values so that it can run on the worker thread without touching the
+ * renderable.
+ */
+class RenderableTimeVaryingVolume::LoadJob
+    : public Job<std::shared_ptr<RenderableTimeVaryingVolume::LoadedVolume>>
+{
+public:
+    LoadJob(int index, std::filesystem::path path, RawVolumeMetadata metadata,
+            bool invertZ)
+        : _path(std::move(path))
+        , _metadata(std::move(metadata))
+        , _invertZ(invertZ)
+    {
+        _volume = std::make_shared<LoadedVolume>();
+        _volume->index = index;
+    }
+
+    void execute() override {
+        try {
+            RawVolumeReader<float> reader(_path, _metadata.dimensions);
+            _volume->rawVolume = reader.map()->copy(_invertZ);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            _volume->error = fmt::format("Error loading '{}': {}", _path, e.message);
+            return;
+        }
+
+        const float min = _metadata.minValue;
+        const float diff = _metadata.maxValue - _metadata.minValue;
+        float* data = _volume->rawVolume->data();
+        _volume->histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
+        for (size_t i = 0; i < _volume->rawVolume->nCells(); ++i) {
+            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+            _volume->histogram->add(data[i]);
+        }
+        // TODO: handle normalization properly for different timesteps + transfer function
+
+        // The volume is kept in memory while its texture is on the GPU
+        _volume->nBytes = 2 * _volume->rawVolume->nCells() * sizeof(float);
+    }
+
+    std::shared_ptr<LoadedVolume> product() override {
+        return _volume;
+    }
+
+private:
+    std::filesystem::path _path;
+    RawVolumeMetadata _metadata;
+    bool _invertZ;
+    std::shared_ptr<LoadedVolume> _volume;
+};
+
 documentation::Documentation RenderableTimeVaryingVolume::Documentation() {
     return codegen::doc<Parameters>("volume_renderable_timevaryingvolume");
 }
@@ -187,6 +272,8 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _transferFunctionPath(TransferFunctionInfo)
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
+    , _cacheBudget(CacheBudgetInfo, 2048, 64, 65536)
+    , _prefetchCount(PrefetchCountInfo, 2, 0, 16)
     , _invertDataAtZ(false)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
@@ -211,6 +298,8 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     _brightness = p.brightness.value_or(_brightness);
     _secondsBefore = p.secondsBefore.value_or(_secondsBefore);
     _secondsAfter = p.secondsAfter;
+    _cacheBudget = p.cacheBudget.value_or(_cacheBudget);
+    _prefetchCount = p.prefetchCount.value_or(_prefetchCount);
 
     ghoul::Dictionary clipPlanesDictionary = p.clipPlanes.value_or(ghoul::Dictionary());
     _clipPlanes = std::make_shared<volume::VolumeClipPlanes>(clipPlanesDictionary);
@@ -243,44 +332,14 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        std::string path = fmt::format(
-            "{}/{}.rawvolume", _sourceDirectory.value(), t.baseName
-        );
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read(_invertDataAtZ);
-
-        float min = t.metadata.minValue;
-        float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            GL_TEXTURE_3D,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
-    }
+    // The timesteps are loaded on demand in the update function, so only the cache and
+    // the worker that reads the volumes are created here
+    _loadedTimesteps = std::make_unique<
+        LruCache<int, std::shared_ptr<LoadedVolume>, std::unordered_map>
+    >(std::max<size_t>(_volumeTimesteps.size(), 1));
+    _loadJobs = std::make_unique<ConcurrentJobManager<std::shared_ptr<LoadedVolume>>>(
+        ThreadPool(1)
+    );
 
     _clipPlanes->initialize();
 
@@ -317,6 +376,8 @@ void RenderableTimeVaryingVolume::initializeGL() {
 
     addProperty(_triggerTimeJump);
     addProperty(_jumpToTimestep);
+    addProperty(_cacheBudget);
+    addProperty(_prefetchCount);
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
     addProperty(_gridType);
@@ -352,8 +413,6 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     Timestep t;
     t.metadata = metadata;
     t.baseName = std::filesystem::path(path).stem().string();
-    t.inRam = false;
-    t.onGpu = false;
 
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
@@ -427,47 +486,162 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     }
 }
 
-void RenderableTimeVaryingVolume::update(const UpdateData&) {
+void RenderableTimeVaryingVolume::requestTimestep(int index) {
+    if (index < 0 || index >= static_cast<int>(_volumeTimesteps.size())) {
+        return;
+    }
+
+    Timestep* t = timestepFromIndex(index);
+    if (!t || t->inRam || t->isLoading || t->hasFailed) {
+        return;
+    }
+
+    t->isLoading = true;
+    std::filesystem::path path = fmt::format(
+        "{}/{}.rawvolume", _sourceDirectory.value(), t->baseName
+    );
+    _loadJobs->enqueueJob(
+        std::make_shared<LoadJob>(index, std::move(path), t->metadata, _invertDataAtZ)
+    );
+}
+
+void RenderableTimeVaryingVolume::handleLoadedTimesteps() {
+    while (_loadJobs->numFinishedJobs() > 0) {
+        std::shared_ptr<LoadedVolume> volume = _loadJobs->popFinishedJob()->product();
+        Timestep* t = timestepFromIndex(volume->index);
+        t->isLoading = false;
+
+        if (!volume->error.empty()) {
+            LERROR(volume->error);
+            t->hasFailed = true;
+            continue;
+        }
+        if (t->inRam) {
+            // The timestep was requested again after a jump while it was being loaded
+            continue;
+        }
+
+        volume->texture = std::make_shared<ghoul::opengl::Texture>(
+            t->metadata.dimensions,
+            GL_TEXTURE_3D,
+            ghoul::opengl::Texture::Format::Red,
+            GL_RED,
+            GL_FLOAT,
+            ghoul::opengl::Texture::FilterMode::Linear,
+            ghoul::opengl::Texture::WrappingMode::Clamp
+        );
+        volume->texture->setPixelData(
+            reinterpret_cast<void*>(volume->rawVolume->data()),
+            ghoul::opengl::Texture::TakeOwnership::No
+        );
+        volume->texture->uploadTexture();
+
+        t->inRam = true;
+        t->onGpu = true;
+        _loadedBytes += volume->nBytes;
+        _loadedTimesteps->set(volume->index, volume);
+    }
+}
+
+void RenderableTimeVaryingVolume::evictTimesteps() {
+    const size_t budget = static_cast<size_t>(_cacheBudget) * BytesPerMegabyte;
+    while (_loadedBytes > budget && _loadedTimesteps->size() > 1) {
+        int index = _loadedTimesteps->leastRecentlyUsedKey();
+        if (index == _displayedTimestep) {
+            // Never unload the timestep that is currently being displayed
+            _loadedTimesteps->use(index);
+            continue;
+        }
+
+        _loadedBytes -= _loadedTimesteps->get(index)->nBytes;
+        _loadedTimesteps->remove(index);
+        Timestep* t = timestepFromIndex(index);
+        t->inRam = false;
+        t->onGpu = false;
+    }
+}
+
+void RenderableTimeVaryingVolume::update(const UpdateData& data) {
     _transferFunction->update();
 
-    if (_raycaster) {
-        Timestep* t = currentTimestep();
-
-        // Set scale and translation matrices:
-        // The original data cube is a unit cube centered in 0
-        // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
-        if (t && t->texture) {
-            if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
-                glm::dvec3 scale = t->metadata.upperDomainBound -
-                    t->metadata.lowerDomainBound;
-                glm::dvec3 translation =
-                    (t->metadata.lowerDomainBound + t->metadata.upperDomainBound) * 0.5f;
-
-                glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), translation);
-                glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
-                modelTransform = modelTransform * scaleMatrix;
-                _raycaster->setModelTransform(glm::mat4(modelTransform));
-            }
-            else {
-                // The diameter is two times the maximum radius.
-                // No translation: the sphere is always centered in (0, 0, 0)
-                _raycaster->setModelTransform(
-                    glm::scale(
-                        glm::dmat4(1.0),
-                        glm::dvec3(2.0 * t->metadata.upperDomainBound[0])
-                    )
-                );
-            }
-            _raycaster->setVolumeTexture(t->texture);
+    if (!_raycaster) {
+        return;
+    }
+
+    handleLoadedTimesteps();
+
+    const double dt = data.time.j2000Seconds() - data.previousFrameTime.j2000Seconds();
+    if (dt != 0.0) {
+        _playbackDirection = dt > 0.0 ? 1 : -1;
+    }
+
+    Timestep* t = currentTimestep();
+    const int current = timestepIndex(t);
+    if (t && !t->inRam && !t->isLoading) {
+        // We jumped to a timestep that is neither loaded nor on its way, so whatever is
+        // still waiting in the queue is no longer interesting
+        _loadJobs->clearEnqueuedJobs();
+        for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+            p.second.isLoading = false;
+        }
+    }
+    if (t) {
+        requestTimestep(current);
+        for (int i = 1; i <= _prefetchCount; i++) {
+            requestTimestep(current + i * _playbackDirection);
+        }
+    }
+
+    // Until the current timestep has been loaded, the previous one remains visible
+    if (!t) {
+        _displayedTimestep = -1;
+    }
+    else if (t->inRam) {
+        _displayedTimestep = current;
+    }
+
+    Timestep* displayed = _displayedTimestep != -1 ?
+        timestepFromIndex(_displayedTimestep) :
+        nullptr;
+
+    // Set scale and translation matrices:
+    // The original data cube is a unit cube centered in 0
+    // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
+    if (displayed && displayed->inRam) {
+        const RawVolumeMetadata& metadata = displayed->metadata;
+        if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
+            glm::dvec3 scale = metadata.upperDomainBound - metadata.lowerDomainBound;
+            glm::dvec3 translation =
+                (metadata.lowerDomainBound + metadata.upperDomainBound) * 0.5f;
+
+            glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), translation);
+            glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
+            modelTransform = modelTransform * scaleMatrix;
+            _raycaster->setModelTransform(glm::mat4(modelTransform));
         }
         else {
-            _raycaster->setVolumeTexture(nullptr);
+            // The diameter is two times the maximum radius.
+            // No translation: the sphere is always centered in (0, 0, 0)
+            _raycaster->setModelTransform(
+                glm::scale(
+                    glm::dmat4(1.0),
+                    glm::dvec3(2.0 * metadata.upperDomainBound[0])
+                )
+            );
         }
-        _raycaster->setStepSize(_stepSize);
-        _raycaster->setBrightness(_brightness * opacity());
-        _raycaster->setRNormalization(_rNormalization);
-        _raycaster->setRUpperBound(_rUpperBound);
+        _raycaster->setVolumeTexture(
+            _loadedTimesteps->use(_displayedTimestep)->texture
+        );
+    }
+    else {
+        _raycaster->setVolumeTexture(nullptr);
     }
+    _raycaster->setStepSize(_stepSize);
+    _raycaster->setBrightness(_brightness * opacity());
+    _raycaster->setRNormalization(_rNormalization);
+    _raycaster->setRUpperBound(_rUpperBound);
+
+    evictTimesteps();
 }
 
 void RenderableTimeVaryingVolume::render(const RenderData& data, RendererTasks& tasks) {
@@ -481,6 +655,16 @@ bool RenderableTimeVaryingVolume::isReady() const {
 }
 
 void RenderableTimeVaryingVolume::deinitializeGL() {
+    // The volumes that have not started loading yet are dropped, so destroying the job
+    // manager only has to wait for the volume that is currently being loaded
+    if (_loadJobs) {
+        _loadJobs->clearEnqueuedJobs();
+        _loadJobs = nullptr;
+    }
+    _loadedTimesteps = nullptr;
+    _loadedBytes = 0;
+    _displayedTimestep = -1;
+
     if (_raycaster) {
         global::raycasterManager->detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
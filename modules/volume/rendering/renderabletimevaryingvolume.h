@@ -34,8 +34,11 @@
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
 #include <openspace/rendering/transferfunction.h>
+#include <memory>
+#include <unordered_map>
 
 namespace openspace {
+    template <typename P> class ConcurrentJobManager;
     class Histogram;
     struct RenderData;
 } // namespace openspace
@@ -44,6 +47,8 @@ namespace openspace::volume {
 
 //class TransferFunction;
 class BasicVolumeRaycaster;
+template <typename KeyType, typename ValueType, template<typename...> class Container>
+class LruCache;
 template <typename T> class RawVolume;
 class VolumeClipPlanes;
 
@@ -63,13 +68,23 @@ public:
 private:
     struct Timestep {
         std::string baseName;
-        bool inRam;
-        bool onGpu;
+        bool inRam = false;
+        bool onGpu = false;
+        bool isLoading = false;
+        bool hasFailed = false;
         RawVolumeMetadata metadata;
-        std::shared_ptr<RawVolume<float>> rawVolume;
+    };
+
+    /// The data of a timestep that is kept in the cache while it is loaded
+    struct LoadedVolume {
+        int index = -1;
+        std::unique_ptr<RawVolume<float>> rawVolume;
         std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<Histogram> histogram;
+        std::string error;
+        size_t nBytes = 0;
     };
+    class LoadJob;
 
     Timestep* currentTimestep();
     int timestepIndex(const Timestep* t) const;
@@ -78,6 +93,15 @@ private:
 
     void loadTimestepMetadata(const std::string& path);
 
+    /// Enqueues the loading of the timestep with the provided \p index on the worker
+    void requestTimestep(int index);
+
+    /// Creates the textures for all timesteps that have finished loading
+    void handleLoadedTimesteps();
+
+    /// Evicts the least recently used timesteps until the cache fits into the budget
+    void evictTimesteps();
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
@@ -92,8 +116,16 @@ private:
 
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
+    properties::IntProperty _cacheBudget;
+    properties::IntProperty _prefetchCount;
 
     std::map<double, Timestep> _volumeTimesteps;
+    std::unique_ptr<LruCache<int, std::shared_ptr<LoadedVolume>, std::unordered_map>>
+        _loadedTimesteps;
+    size_t _loadedBytes = 0;
+    std::unique_ptr<ConcurrentJobManager<std::shared_ptr<LoadedVolume>>> _loadJobs;
+    int _displayedTimestep = -1;
+    int _playbackDirection = 1;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
     bool _invertDataAtZ;
 
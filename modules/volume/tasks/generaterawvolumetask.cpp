@@ -24,7 +24,6 @@
 
 #include <modules/volume/tasks/generaterawvolumetask.h>
 
-#include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumemetadata.h>
 #include <modules/volume/rawvolumewriter.h>
 #include <openspace/documentation/verifier.h>
@@ -38,8 +37,12 @@
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
 #include <ghoul/misc/defer.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 namespace {
     struct [[codegen::Dictionary(GenerateRawVolumeTask)]] Parameters {
@@ -111,36 +114,48 @@ void GenerateRawVolumeTask::perform(const Task::ProgressCallback& progressCallba
         SpiceManager::ref().unloadKernel(kernel);
     };
 
-    volume::RawVolume<float> rawVolume(_dimensions);
     progressCallback(0.1f);
 
-    ghoul::lua::LuaState state;
-    ghoul::lua::runScript(state, _valueFunctionLua);
+    // Lua states cannot be shared between threads, so every thread that evaluates the
+    // value function gets its own state with its own copy of the function
+    const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    struct Worker {
+        ghoul::lua::LuaState state;
+        int functionReference = LUA_NOREF;
+        float minVal = std::numeric_limits<float>::max();
+        float maxVal = std::numeric_limits<float>::min();
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+    workers.reserve(nThreads);
+    for (unsigned int i = 0; i < nThreads; i++) {
+        std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+        ghoul::lua::runScript(worker->state, _valueFunctionLua);
 
 #if (defined(NDEBUG) || defined(DEBUG))
-    ghoul::lua::verifyStackSize(state, 1);
+        ghoul::lua::verifyStackSize(worker->state, 1);
 #endif
 
-    int functionReference = luaL_ref(state, LUA_REGISTRYINDEX);
+        worker->functionReference = luaL_ref(worker->state, LUA_REGISTRYINDEX);
 
 #if (defined(NDEBUG) || defined(DEBUG))
-    ghoul::lua::verifyStackSize(state, 0);
+        ghoul::lua::verifyStackSize(worker->state, 0);
 #endif
+        workers.push_back(std::move(worker));
+    }
 
     glm::vec3 domainSize = _upperDomainBound - _lowerDomainBound;
 
+    auto value = [&](const glm::uvec3& cell, unsigned int workerIndex) {
+        Worker& worker = *workers[workerIndex];
+        lua_State* state = worker.state;
 
-    float minVal = std::numeric_limits<float>::max();
-    float maxVal = std::numeric_limits<float>::min();
-
-    rawVolume.forEachVoxel([&](glm::uvec3 cell, float) {
         glm::vec3 coord = _lowerDomainBound +
             glm::vec3(cell) / glm::vec3(_dimensions) * domainSize;
 
 #if (defined(NDEBUG) || defined(DEBUG))
         ghoul::lua::verifyStackSize(state, 0);
 #endif
-        lua_rawgeti(state, LUA_REGISTRYINDEX, functionReference);
+        lua_rawgeti(state, LUA_REGISTRYINDEX, worker.functionReference);
 
         lua_pushnumber(state, coord.x);
         lua_pushnumber(state, coord.y);
@@ -151,26 +166,44 @@ void GenerateRawVolumeTask::perform(const Task::ProgressCallback& progressCallba
 #endif
 
         if (lua_pcall(state, 3, 1, 0) != LUA_OK) {
-            return;
+            // Cells for which the function fails keep the initial value of 0
+            lua_pop(state, 1);
+            return 0.f;
         }
 
-        float value = static_cast<float>(luaL_checknumber(state, 1));
+        float v = static_cast<float>(luaL_checknumber(state, 1));
         lua_pop(state, 1);
-        rawVolume.set(cell, value);
-
-        minVal = std::min(minVal, value);
-        maxVal = std::max(maxVal, value);
-    });
 
-    luaL_unref(state, LUA_REGISTRYINDEX, functionReference);
+        worker.minVal = std::min(worker.minVal, v);
+        worker.maxVal = std::max(worker.maxVal, v);
+        return v;
+    };
 
     const std::filesystem::path directory = _rawVolumeOutputPath.parent_path();
     if (!std::filesystem::is_directory(directory)) {
         std::filesystem::create_directories(directory);
     }
 
+    // The volume is evaluated and written slab by slab, so it never has to be kept in
+    // memory as a whole
     volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath.string());
-    writer.write(rawVolume);
+    writer.setDimensions(_dimensions);
+    writer.writeSlabs(
+        value,
+        nullptr,
+        nThreads,
+        [&progressCallback](float progress) { progressCallback(0.1f + 0.8f * progress); }
+    );
+
+    // The minimum and maximum are independent of the order in which the cells were
+    // evaluated, so they are the same as for a serial evaluation
+    float minVal = std::numeric_limits<float>::max();
+    float maxVal = std::numeric_limits<float>::min();
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        minVal = std::min(minVal, worker->minVal);
+        maxVal = std::max(maxVal, worker->maxVal);
+        luaL_unref(worker->state, LUA_REGISTRYINDEX, worker->functionReference);
+    }
 
     progressCallback(0.9f);
 
@@ -45,6 +45,20 @@ public:
 
     void initialize();
 
+    /**
+     * Loads the slices in the range [\p begin, \p end) and releases all slices outside
+     * of that range that were loaded by a previous call. Slices that are already loaded
+     * are kept. The slices are loaded on the calling thread, as creating a texture
+     * issues OpenGL calls. While the range is not changed, get can be called
+     * concurrently for coordinates inside the range, as these do not touch the cache.
+     */
+    void loadSlices(int begin, int end);
+
+    /**
+     * Returns the voxel at the provided \p coordinates. Slices that are not in the range
+     * of the last call to loadSlices are loaded through a cache, which is not safe to do
+     * from multiple threads at the same time.
+     */
     VoxelType get(const glm::ivec3& coordinates) const;
     virtual glm::ivec3 dimensions() const;
     void setPaths(std::vector<std::string> paths);
@@ -53,6 +67,10 @@ private:
     ghoul::opengl::Texture& getSlice(int sliceIndex) const;
     std::vector<std::string> _paths;
     mutable LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>> _cache;
+
+    // The slices that were loaded by the last call to loadSlices
+    std::vector<std::shared_ptr<ghoul::opengl::Texture>> _loadedSlices;
+    int _loadedSlicesBegin = 0;
     glm::ivec2 _sliceDimensions = glm::ivec2(0);
     bool _isInitialized = false;
 };
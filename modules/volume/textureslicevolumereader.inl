@@ -52,10 +52,60 @@ void TextureSliceVolumeReader<VoxelType>::initialize() {
     _cache.set(0, firstSlice);
 }
 
+template <typename VoxelType>
+void TextureSliceVolumeReader<VoxelType>::loadSlices(int begin, int end) {
+    ghoul_assert(_isInitialized, "Volume is not initialized");
+    ghoul_assert(
+        begin >= 0 && begin <= end && end <= static_cast<int>(_paths.size()),
+        "Slice range is outside the volume"
+    );
+
+    // Keep the slices that are still needed and only load the new ones
+    std::vector<std::shared_ptr<ghoul::opengl::Texture>> slices(end - begin);
+    for (int i = begin; i < end; i++) {
+        const int previous = i - _loadedSlicesBegin;
+        if (previous >= 0 && previous < static_cast<int>(_loadedSlices.size())) {
+            slices[i - begin] = std::move(_loadedSlices[previous]);
+        }
+        else if (_cache.has(i)) {
+            slices[i - begin] = _cache.get(i);
+        }
+    }
+
+    std::vector<int> missing;
+    for (int i = begin; i < end; i++) {
+        if (!slices[i - begin]) {
+            missing.push_back(i);
+        }
+    }
+
+    // Creating a Texture issues OpenGL calls, so the slices are loaded on the calling
+    // thread. Only the reads from the loaded slices are safe to do concurrently
+    for (int i : missing) {
+        std::shared_ptr<ghoul::opengl::Texture> texture =
+            ghoul::io::TextureReader::ref().loadTexture(_paths[i], 2);
+        ghoul_assert(
+            glm::ivec2(texture->dimensions()) == _sliceDimensions,
+            "Slice dimensions do not agree"
+        );
+        slices[i - begin] = std::move(texture);
+    }
+
+    _loadedSlices = std::move(slices);
+    _loadedSlicesBegin = begin;
+}
+
 template <typename VoxelType>
 VoxelType TextureSliceVolumeReader<VoxelType>::get(const glm::ivec3& coordinates) const {
+    const glm::uvec2 texel = glm::uvec2(coordinates.x, coordinates.y);
+
+    const int loaded = coordinates.z - _loadedSlicesBegin;
+    if (loaded >= 0 && loaded < static_cast<int>(_loadedSlices.size())) {
+        return _loadedSlices[loaded]->texel<VoxelType>(texel);
+    }
+
     ghoul::opengl::Texture& slice = getSlice(coordinates.z);
-    return slice.texel<VoxelType>(glm::uvec2(coordinates.x, coordinates.y));
+    return slice.texel<VoxelType>(texel);
 }
 
 template <typename VoxelType>
@@ -401,6 +401,9 @@ void initialize() {
     rootPropertyOwner->addPropertySubOwner(global::userPropertyOwner);
     rootPropertyOwner->addPropertySubOwner(global::openSpaceEngine);
 
+    // All property lookups by URI go through the root, so it keeps an index of the URIs
+    rootPropertyOwner->enableUriIndex();
+
     syncEngine->addSyncable(global::scriptEngine);
 }
 
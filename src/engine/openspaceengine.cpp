@@ -708,11 +708,9 @@ void OpenSpaceEngine::loadAssets() {
 
     std::unique_ptr<SceneInitializer> sceneInitializer;
     if (global::configuration->useMultithreadedInitialization) {
-        unsigned int nAvailableThreads = std::min(
-            std::thread::hardware_concurrency() - 1,
-            4u
-        );
-        unsigned int nThreads = nAvailableThreads == 0 ? 2 : nAvailableThreads;
+        // The data of the renderables is loaded on these threads, so all cores except
+        // for the one running the main thread are used
+        unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 3u) - 1;
         sceneInitializer = std::make_unique<MultiThreadedSceneInitializer>(nThreads);
     }
     else {
@@ -873,6 +871,7 @@ void OpenSpaceEngine::loadAssets() {
     _loadingScreen = nullptr;
 
     global::renderEngine->updateScene();
+    _scene->logLoadTimes();
 
     global::syncEngine->addSyncables(global::timeManager->syncables());
     if (_scene && _scene->camera()) {
@@ -1118,12 +1117,13 @@ void OpenSpaceEngine::preSynchronization() {
 
         global::timeManager->preSynchronization(dt);
 
-        std::vector<std::string> scheduledScripts = global::scriptScheduler->progressTo(
-            global::timeManager->time().j2000Seconds()
-        );
-        for (const std::string& script : scheduledScripts) {
+        std::vector<std::string_view> scheduledScripts =
+            global::scriptScheduler->progressTo(
+                global::timeManager->time().j2000Seconds()
+            );
+        for (std::string_view script : scheduledScripts) {
             global::scriptEngine->queueScript(
-                script,
+                std::string(script),
                 scripting::ScriptEngine::ShouldBeSynchronized::Yes,
                 scripting::ScriptEngine::ShouldSendToRemote::Yes
             );
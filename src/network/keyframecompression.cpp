@@ -0,0 +1,286 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/keyframecompression.h>
+
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // The number of seconds after which a keyframe with an absolute position and the
+    // name of the focus node is sent, so that peers that joined later can start decoding
+    constexpr double SyncInterval = 2.0;
+
+    // The factor between the range of the three smallest components of a normalized
+    // quaternion [-1/sqrt(2), 1/sqrt(2)] and the range of the 16 bit integers
+    const double RotationQuantization =
+        std::numeric_limits<int16_t>::max() * std::sqrt(2.0);
+} // namespace
+
+namespace openspace::datamessagestructures {
+
+void quantizeRotation(const glm::dquat& rotation, uint8_t& index,
+                      std::array<int16_t, 3>& components)
+{
+    const glm::dquat q = glm::normalize(rotation);
+    std::array<double, 4> c = { q.x, q.y, q.z, q.w };
+
+    index = 0;
+    for (uint8_t i = 1; i < 4; i++) {
+        if (std::abs(c[i]) > std::abs(c[index])) {
+            index = i;
+        }
+    }
+
+    // q and -q represent the same rotation, so we can always make the omitted component
+    // positive and reconstruct it from the other three
+    const double sign = c[index] < 0.0 ? -1.0 : 1.0;
+    int j = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (i == index) {
+            continue;
+        }
+        const double v = std::clamp(
+            std::round(sign * c[i] * RotationQuantization),
+            static_cast<double>(std::numeric_limits<int16_t>::min()),
+            static_cast<double>(std::numeric_limits<int16_t>::max())
+        );
+        components[j] = static_cast<int16_t>(v);
+        j++;
+    }
+}
+
+glm::dquat dequantizeRotation(uint8_t index, const std::array<int16_t, 3>& components)
+{
+    std::array<double, 4> c;
+    double sumSquared = 0.0;
+    int j = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (i == index) {
+            continue;
+        }
+        c[i] = components[j] / RotationQuantization;
+        sumSquared += c[i] * c[i];
+        j++;
+    }
+    c[std::min<uint8_t>(index, 3)] = std::sqrt(std::max(0.0, 1.0 - sumSquared));
+
+    return glm::normalize(glm::dquat(c[3], c[0], c[1], c[2]));
+}
+
+std::vector<CompactCameraKeyframe> CameraKeyframeEncoder::encode(
+                                                          const CameraKeyframe& keyframe)
+{
+    std::vector<CompactCameraKeyframe> res;
+    if (!_lastSent.has_value()) {
+        res.push_back(compress(keyframe));
+        return res;
+    }
+
+    const CameraKeyframe last = *_lastSent;
+    const bool isDiscontinuous =
+        keyframe._focusNode != last._focusNode ||
+        keyframe._followNodeRotation != last._followNodeRotation;
+    if (isDiscontinuous) {
+        // Interpolating in the space of two different anchors is not meaningful, so we
+        // send the last pose before the change followed by the current pose
+        if (!_pending.empty()) {
+            const CameraKeyframe previous = _pending.back();
+            res.push_back(compress(previous));
+        }
+        res.push_back(compress(keyframe));
+        return res;
+    }
+
+    const bool canInterpolate = std::all_of(
+        _pending.begin(),
+        _pending.end(),
+        [&](const CameraKeyframe& sample) {
+            return isInterpolatable(last, keyframe, sample);
+        }
+    );
+    if (!canInterpolate) {
+        if (_pending.empty()) {
+            res.push_back(compress(keyframe));
+        }
+        else {
+            // The previous pose was the last one that could be reached by interpolation,
+            // so it becomes the next keyframe and the current pose starts a new segment
+            const CameraKeyframe previous = _pending.back();
+            res.push_back(compress(previous));
+            _pending.push_back(keyframe);
+        }
+        return res;
+    }
+
+    const bool isMoving = !isInterpolatable(last, last, keyframe);
+    const bool isIntervalExceeded =
+        keyframe._timestamp - last._timestamp >= _maximumInterval;
+    const bool isSyncRequired = keyframe._timestamp - _lastSyncTimestamp >= SyncInterval;
+    if ((isMoving && isIntervalExceeded) || isSyncRequired) {
+        res.push_back(compress(keyframe));
+        return res;
+    }
+
+    _pending.push_back(keyframe);
+    return res;
+}
+
+void CameraKeyframeEncoder::reset() {
+    _lastSent = std::nullopt;
+    _pending.clear();
+    _focusNodeIndices.clear();
+    _lastSyncTimestamp = 0.0;
+}
+
+void CameraKeyframeEncoder::setTolerance(double tolerance) {
+    _tolerance = tolerance;
+}
+
+void CameraKeyframeEncoder::setMaximumInterval(double interval) {
+    _maximumInterval = interval;
+}
+
+CompactCameraKeyframe CameraKeyframeEncoder::compress(const CameraKeyframe& keyframe) {
+    const bool isSyncPoint =
+        !_lastSent.has_value() ||
+        keyframe._timestamp - _lastSyncTimestamp >= SyncInterval;
+
+    CompactCameraKeyframe res;
+
+    auto it = _focusNodeIndices.find(keyframe._focusNode);
+    const bool isNewFocusNode = it == _focusNodeIndices.end();
+    if (isNewFocusNode) {
+        if (_focusNodeIndices.size() > std::numeric_limits<uint16_t>::max()) {
+            _focusNodeIndices.clear();
+        }
+        const uint16_t index = static_cast<uint16_t>(_focusNodeIndices.size());
+        it = _focusNodeIndices.emplace(keyframe._focusNode, index).first;
+    }
+    res._focusNodeIndex = it->second;
+    if (isNewFocusNode || isSyncPoint) {
+        res._flags |= CompactCameraKeyframe::HasFocusNodeName;
+        res._focusNodeName = keyframe._focusNode;
+    }
+
+    if (keyframe._followNodeRotation) {
+        res._flags |= CompactCameraKeyframe::FollowNodeRotation;
+    }
+
+    glm::dvec3 position;
+    if (isSyncPoint) {
+        res._flags |= CompactCameraKeyframe::AbsolutePosition;
+        res._position = keyframe._position;
+        position = keyframe._position;
+        _lastSyncTimestamp = keyframe._timestamp;
+    }
+    else {
+        // The difference is computed against the reconstructed position of the receiver
+        // to not accumulate the rounding errors of the single precision differences
+        res._positionDelta = glm::vec3(keyframe._position - _lastSent->_position);
+        position = _lastSent->_position + glm::dvec3(res._positionDelta);
+    }
+
+    quantizeRotation(keyframe._rotation, res._rotationIndex, res._rotation);
+    res._scale = keyframe._scale;
+    res._timestamp = keyframe._timestamp;
+
+    CameraKeyframe reconstructed = keyframe;
+    reconstructed._position = position;
+    reconstructed._rotation = dequantizeRotation(res._rotationIndex, res._rotation);
+    _lastSent = std::move(reconstructed);
+    _pending.clear();
+
+    return res;
+}
+
+bool CameraKeyframeEncoder::isInterpolatable(const CameraKeyframe& begin,
+                                             const CameraKeyframe& end,
+                                             const CameraKeyframe& sample) const
+{
+    double t = 1.0;
+    if (end._timestamp > begin._timestamp) {
+        t = (sample._timestamp - begin._timestamp) / (end._timestamp - begin._timestamp);
+        t = std::clamp(t, 0.0, 1.0);
+    }
+
+    // Same interpolation as in the KeyframeNavigator
+    const glm::dvec3 position = begin._position * (1.0 - t) + end._position * t;
+    const double positionError = glm::length(position - sample._position);
+    if (positionError > _tolerance * glm::length(sample._position)) {
+        return false;
+    }
+
+    const glm::dquat rotation = glm::slerp(begin._rotation, end._rotation, t);
+    const double d = std::min(std::abs(glm::dot(rotation, sample._rotation)), 1.0);
+    const double rotationError = 2.0 * std::acos(d);
+    if (rotationError > _tolerance) {
+        return false;
+    }
+
+    const double scale = begin._scale * (1.0 - t) + end._scale * t;
+    const double scaleError = std::abs(scale - sample._scale);
+    return scaleError <= _tolerance * std::abs(sample._scale);
+}
+
+std::optional<CameraKeyframe> CameraKeyframeDecoder::decode(
+                                                   const CompactCameraKeyframe& keyframe)
+{
+    if (keyframe._flags & CompactCameraKeyframe::HasFocusNodeName) {
+        _focusNodes[keyframe._focusNodeIndex] = keyframe._focusNodeName;
+    }
+    if (keyframe._flags & CompactCameraKeyframe::AbsolutePosition) {
+        _position = keyframe._position;
+    }
+    else if (_position.has_value()) {
+        *_position = *_position + glm::dvec3(keyframe._positionDelta);
+    }
+    else {
+        // We have not received a sync point yet
+        return std::nullopt;
+    }
+
+    auto it = _focusNodes.find(keyframe._focusNodeIndex);
+    if (it == _focusNodes.end()) {
+        return std::nullopt;
+    }
+
+    CameraKeyframe res;
+    res._position = *_position;
+    res._rotation = dequantizeRotation(keyframe._rotationIndex, keyframe._rotation);
+    res._followNodeRotation = keyframe._flags & CompactCameraKeyframe::FollowNodeRotation;
+    res._focusNode = it->second;
+    res._scale = keyframe._scale;
+    res._timestamp = keyframe._timestamp;
+    return res;
+}
+
+void CameraKeyframeDecoder::reset() {
+    _focusNodes.clear();
+    _position = std::nullopt;
+}
+
+} // namespace openspace::datamessagestructures
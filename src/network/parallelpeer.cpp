@@ -29,6 +29,7 @@
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/events/event.h>
 #include <openspace/events/eventengine.h>
+#include <openspace/network/messagestructureshelper.h>
 #include <openspace/navigation/keyframenavigator.h>
 #include <openspace/navigation/navigationhandler.h>
 #include <openspace/navigation/orbitalnavigator.h>
@@ -109,12 +110,26 @@ namespace {
     constexpr openspace::properties::Property::PropertyInfo CameraKeyFrameInfo = {
         "CameraKeyframeInterval",
         "Camera Keyframe interval",
-        "Determines how often the information about the camera position and orientation "
-        "is sent (in seconds). Lower values mean more accurate representation of the "
-        "time, but also more internet traffic",
+        "Determines the maximum time between two camera keyframes (in seconds) while the "
+        "camera is moving. Camera keyframes are only sent when the interpolation on the "
+        "receiving side would deviate from the camera path by more than the "
+        "'CameraKeyframeTolerance', or when this interval has passed. This value should "
+        "be lower than the 'BufferTime' of the receiving peers",
         // @VISIBILITY(3.5)
         openspace::properties::Property::Visibility::AdvancedUser
     };
+
+    constexpr openspace::properties::Property::PropertyInfo CameraKeyframeToleranceInfo =
+    {
+        "CameraKeyframeTolerance",
+        "Camera Keyframe Tolerance",
+        "The maximum error that the interpolation between two camera keyframes is "
+        "allowed to have before a new keyframe is sent. The value is used both as the "
+        "position error relative to the distance to the anchor node and as the rotation "
+        "error in radians. Lower values mean more accurate representation of the camera "
+        "path, but also more internet traffic",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
 } // namespace
 
 namespace openspace {
@@ -129,6 +144,7 @@ ParallelPeer::ParallelPeer()
     , _bufferTime(BufferTimeInfo, 0.2f, 0.01f, 5.0f)
     , _timeKeyframeInterval(TimeKeyFrameInfo, 0.1f, 0.f, 1.f)
     , _cameraKeyframeInterval(CameraKeyFrameInfo, 0.1f, 0.f, 1.f)
+    , _cameraKeyframeTolerance(CameraKeyframeToleranceInfo, 5e-4f, 0.f, 0.1f)
     , _connectionEvent(std::make_shared<ghoul::Event<>>())
     , _connection(nullptr)
 {
@@ -142,6 +158,7 @@ ParallelPeer::ParallelPeer()
 
     addProperty(_timeKeyframeInterval);
     addProperty(_cameraKeyframeInterval);
+    addProperty(_cameraKeyframeTolerance);
 }
 
 ParallelPeer::~ParallelPeer() {
@@ -324,68 +341,34 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
     switch (static_cast<datamessagestructures::Type>(type)) {
         case datamessagestructures::Type::CameraData: {
             datamessagestructures::CameraKeyframe kf(buffer);
-            const double convertedTimestamp = convertTimestamp(kf._timestamp);
-
-            global::navigationHandler->keyframeNavigator().removeKeyframesAfter(
-                convertedTimestamp
-            );
-
-            interaction::KeyframeNavigator::CameraPose pose;
-            pose.focusNode = kf._focusNode;
-            pose.position = kf._position;
-            pose.rotation = kf._rotation;
-            pose.scale = kf._scale;
-            pose.followFocusNodeRotation = kf._followNodeRotation;
-
-            global::navigationHandler->keyframeNavigator().addKeyframe(
-                convertedTimestamp,
-                pose
-            );
+            addCameraKeyframe(kf);
+            break;
+        }
+        case datamessagestructures::Type::CompactCameraData: {
+            datamessagestructures::CompactCameraKeyframe compactKf(buffer);
+            std::optional<datamessagestructures::CameraKeyframe> kf =
+                _cameraKeyframeDecoder.decode(compactKf);
+            if (kf.has_value()) {
+                addCameraKeyframe(*kf);
+            }
             break;
         }
         case datamessagestructures::Type::TimelineData: {
-            const double now = global::windowDelegate->applicationTime();
             datamessagestructures::TimeTimeline timelineMessage(buffer);
-
-            if (timelineMessage._clear) {
-                global::timeManager->removeKeyframesAfter(
-                    convertTimestamp(timestamp),
-                    true
-                );
-            }
-
-            const std::vector<datamessagestructures::TimeKeyframe>& keyframesMessage =
-                timelineMessage._keyframes;
-
-            // If there are new keyframes incoming, make sure to erase all keyframes
-            // that already exist after the first new keyframe.
-            if (!keyframesMessage.empty()) {
-                const double convertedTimestamp =
-                    convertTimestamp(keyframesMessage[0]._timestamp);
-
-                global::timeManager->removeKeyframesAfter(convertedTimestamp, true);
-            }
-
-            for (const datamessagestructures::TimeKeyframe& kfMessage : keyframesMessage)
-            {
-                TimeKeyframeData timeKeyframeData;
-                timeKeyframeData.delta = kfMessage._dt;
-                timeKeyframeData.pause = kfMessage._paused;
-                timeKeyframeData.time = Time(kfMessage._time);
-                timeKeyframeData.jump = kfMessage._requiresTimeJump;
-
-                const double kfTimestamp = convertTimestamp(kfMessage._timestamp);
-
-                // We only need at least one keyframe before the current timestamp,
-                // so we can remove any other previous ones
-                if (kfTimestamp < now) {
-                    global::timeManager->removeKeyframesBefore(kfTimestamp, true);
-                }
-                global::timeManager->addKeyframe(
-                    kfTimestamp,
-                    timeKeyframeData
-                );
-            }
+            addTimeKeyframes(
+                timelineMessage._keyframes,
+                timelineMessage._clear,
+                timestamp
+            );
+            break;
+        }
+        case datamessagestructures::Type::CompactTimelineData: {
+            datamessagestructures::CompactTimeTimeline timelineMessage(buffer);
+            addTimeKeyframes(
+                timelineMessage._keyframes,
+                timelineMessage._clear,
+                timestamp
+            );
             break;
         }
         case datamessagestructures::Type::ScriptData: {
@@ -410,6 +393,58 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
     }
 }
 
+void ParallelPeer::addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf) {
+    const double convertedTimestamp = convertTimestamp(kf._timestamp);
+
+    global::navigationHandler->keyframeNavigator().removeKeyframesAfter(
+        convertedTimestamp
+    );
+
+    interaction::KeyframeNavigator::CameraPose pose;
+    pose.focusNode = kf._focusNode;
+    pose.position = kf._position;
+    pose.rotation = kf._rotation;
+    pose.scale = kf._scale;
+    pose.followFocusNodeRotation = kf._followNodeRotation;
+
+    global::navigationHandler->keyframeNavigator().addKeyframe(convertedTimestamp, pose);
+}
+
+void ParallelPeer::addTimeKeyframes(
+                        const std::vector<datamessagestructures::TimeKeyframe>& keyframes,
+                                    bool clear, double timestamp)
+{
+    const double now = global::windowDelegate->applicationTime();
+
+    if (clear) {
+        global::timeManager->removeKeyframesAfter(convertTimestamp(timestamp), true);
+    }
+
+    // If there are new keyframes incoming, make sure to erase all keyframes
+    // that already exist after the first new keyframe.
+    if (!keyframes.empty()) {
+        const double convertedTimestamp = convertTimestamp(keyframes[0]._timestamp);
+        global::timeManager->removeKeyframesAfter(convertedTimestamp, true);
+    }
+
+    for (const datamessagestructures::TimeKeyframe& kfMessage : keyframes) {
+        TimeKeyframeData timeKeyframeData;
+        timeKeyframeData.delta = kfMessage._dt;
+        timeKeyframeData.pause = kfMessage._paused;
+        timeKeyframeData.time = Time(kfMessage._time);
+        timeKeyframeData.jump = kfMessage._requiresTimeJump;
+
+        const double kfTimestamp = convertTimestamp(kfMessage._timestamp);
+
+        // We only need at least one keyframe before the current timestamp,
+        // so we can remove any other previous ones
+        if (kfTimestamp < now) {
+            global::timeManager->removeKeyframesBefore(kfTimestamp, true);
+        }
+        global::timeManager->addKeyframe(kfTimestamp, timeKeyframeData);
+    }
+}
+
 void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& message) {
     if (message.size() < 2 * sizeof(uint8_t)) {
         LERROR("Malformed connection status message");
@@ -455,6 +490,7 @@ void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& mess
 
     global::navigationHandler->keyframeNavigator().clearKeyframes();
     global::timeManager->clearKeyframes();
+    _cameraKeyframeDecoder.reset();
 }
 
 void ParallelPeer::nConnectionsMessageReceived(const std::vector<char>& message) {
@@ -565,10 +601,8 @@ void ParallelPeer::preSynchronization() {
     if (isHost()) {
         double now = global::windowDelegate->applicationTime();
 
-        if (_lastCameraKeyframeTimestamp + _cameraKeyframeInterval < now) {
-            sendCameraKeyframe();
-            _lastCameraKeyframeTimestamp = now;
-        }
+        // The camera keyframe encoder decides whether the current pose has to be sent
+        sendCameraKeyframe();
         if (_timeTimelineChanged ||
             _lastTimeKeyframeTimestamp + _timeKeyframeInterval < now)
         {
@@ -588,6 +622,7 @@ void ParallelPeer::setStatus(ParallelConnection::Status status) {
         ParallelConnection::Status prevStatus = _status;
         _status = status;
         _timeJumped = true;
+        _shouldResetKeyframeEncoder = true;
         _connectionEvent->publish("statusChanged");
 
 
@@ -661,6 +696,8 @@ ParallelConnection::Status ParallelPeer::status() {
 void ParallelPeer::setNConnections(size_t nConnections) {
     if (_nConnections != nConnections) {
         _nConnections = nConnections;
+        // A new peer needs a sync point to be able to decode the camera keyframes
+        _shouldResetKeyframeEncoder = true;
         _connectionEvent->publish("nConnectionsChanged");
     }
 }
@@ -685,46 +722,34 @@ const std::string& ParallelPeer::hostName() {
 }
 
 void ParallelPeer::sendCameraKeyframe() {
-    interaction::NavigationHandler& navHandler = *global::navigationHandler;
-
-    const SceneGraphNode* focusNode =
-        navHandler.orbitalNavigator().anchorNode();
-    if (!focusNode) {
+    if (!global::navigationHandler->orbitalNavigator().anchorNode()) {
         return;
     }
 
-    // Create a keyframe with current position and orientation of camera
-    datamessagestructures::CameraKeyframe kf;
-    kf._position = navHandler.orbitalNavigator().anchorNodeToCameraVector();
-
-    kf._followNodeRotation = navHandler.orbitalNavigator().followingAnchorRotation();
-    if (kf._followNodeRotation) {
-        kf._position = glm::inverse(focusNode->worldRotationMatrix()) * kf._position;
-        kf._rotation = navHandler.orbitalNavigator().anchorNodeToCameraRotation();
-    }
-    else {
-        kf._rotation = navHandler.camera()->rotationQuaternion();
+    if (_shouldResetKeyframeEncoder.exchange(false)) {
+        _cameraKeyframeEncoder.reset();
     }
+    _cameraKeyframeEncoder.setTolerance(_cameraKeyframeTolerance);
+    _cameraKeyframeEncoder.setMaximumInterval(_cameraKeyframeInterval);
 
-    kf._focusNode = focusNode->identifier();
-    kf._scale = navHandler.camera()->scaling();
-
-    // Timestamp as current runtime of OpenSpace instance
-    kf._timestamp = global::windowDelegate->applicationTime();
-
-    // Create a buffer for the keyframe
-    std::vector<char> buffer;
-
-    // Fill the keyframe buffer
-    kf.serialize(buffer);
+    // Create a keyframe with current position and orientation of camera and let the
+    // encoder decide whether it, or a previous pose, has to be sent
+    const datamessagestructures::CameraKeyframe kf =
+        datamessagestructures::generateCameraKeyframe();
+    const std::vector<datamessagestructures::CompactCameraKeyframe> keyframes =
+        _cameraKeyframeEncoder.encode(kf);
 
     const double timestamp = global::windowDelegate->applicationTime();
-    // Send message
-    _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::CameraData,
-        timestamp,
-        buffer
-    ));
+    for (const datamessagestructures::CompactCameraKeyframe& keyframe : keyframes) {
+        std::vector<char> buffer;
+        keyframe.serialize(buffer);
+
+        _connection.sendDataMessage(ParallelConnection::DataMessage(
+            datamessagestructures::Type::CompactCameraData,
+            timestamp,
+            std::move(buffer)
+        ));
+    }
 }
 
 void ParallelPeer::sendTimeTimeline() {
@@ -732,7 +757,7 @@ void ParallelPeer::sendTimeTimeline() {
     const Timeline<TimeKeyframeData>& timeline = global::timeManager->timeline();
     std::deque<Keyframe<TimeKeyframeData>> keyframes = timeline.keyframes();
 
-    datamessagestructures::TimeTimeline timelineMessage;
+    datamessagestructures::CompactTimeTimeline timelineMessage;
     timelineMessage._clear = true;
     timelineMessage._keyframes.reserve(timeline.nKeyframes());
 
@@ -770,7 +795,7 @@ void ParallelPeer::sendTimeTimeline() {
     double timestamp = global::windowDelegate->applicationTime();
     // Send message
     _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::TimelineData,
+        datamessagestructures::Type::CompactTimelineData,
         timestamp,
         buffer
     ));
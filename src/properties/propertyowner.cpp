@@ -36,11 +36,40 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/invariants.h>
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 namespace {
     constexpr std::string_view _loggerCat = "PropertyOwner";
 
+    // Shared source for the structure versions of all PropertyOwners
+    std::atomic<uint64_t> StructureVersionCounter = 0;
+
+    // Returns the part that an owner with the provided `identifier` contributes to the
+    // URIs of the Propertys below it. Owners without an identifier do not contribute to
+    // the URI, which mirrors the behavior of Property::fullyQualifiedIdentifier
+    std::string uriPrefix(const std::string& identifier) {
+        using openspace::properties::PropertyOwner;
+        if (identifier.empty()) {
+            return std::string();
+        }
+        return identifier + PropertyOwner::URISeparator;
+    }
+
+    void collectPropertyUris(const openspace::properties::PropertyOwner& owner,
+                             const std::string& prefix,
+               std::vector<std::pair<std::string, openspace::properties::Property*>>& res)
+    {
+        using namespace openspace::properties;
+
+        for (Property* p : owner.properties()) {
+            res.emplace_back(prefix + p->identifier(), p);
+        }
+        for (const PropertyOwner* o : owner.propertySubOwners()) {
+            collectPropertyUris(*o, prefix + uriPrefix(o->identifier()), res);
+        }
+    }
+
     nlohmann::json createJson(openspace::properties::PropertyOwner* owner) {
         ZoneScoped;
 
@@ -116,7 +145,53 @@ std::vector<Property*> PropertyOwner::propertiesRecursive() const {
     return props;
 }
 
+std::vector<std::pair<std::string, Property*>> PropertyOwner::propertiesWithUri() const {
+    std::vector<std::pair<std::string, Property*>> res;
+    collectPropertyUris(*this, "", res);
+    return res;
+}
+
+void PropertyOwner::enableUriIndex() {
+    if (_uriIndex) {
+        return;
+    }
+
+    std::vector<std::pair<std::string, Property*>> props;
+    collectPropertyUris(*this, "", props);
+
+    _uriIndex = std::make_shared<UriIndex>();
+    _uriIndex->properties.insert(props.begin(), props.end());
+}
+
+bool PropertyOwner::isUriIndexed() const {
+    for (const PropertyOwner* o = this; o; o = o->_owner) {
+        if (o->_uriIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PropertyOwner::updateUriIndices(
+                         const std::function<void(UriIndex&, const std::string&)>& update)
+{
+    std::string prefix;
+    for (PropertyOwner* o = this; o; o = o->_owner) {
+        if (o->_uriIndex) {
+            std::lock_guard lock(o->_uriIndex->mutex);
+            update(*o->_uriIndex, prefix);
+        }
+        prefix = uriPrefix(o->_identifier) + prefix;
+    }
+}
+
 Property* PropertyOwner::property(const std::string& uri) const {
+    if (_uriIndex) {
+        std::lock_guard lock(_uriIndex->mutex);
+        auto it = _uriIndex->properties.find(uri);
+        return it != _uriIndex->properties.end() ? it->second : nullptr;
+    }
+
     auto it = std::find_if(
         _properties.begin(),
         _properties.end(),
@@ -237,6 +312,10 @@ void PropertyOwner::addProperty(Property* prop) {
         else {
             _properties.push_back(prop);
             prop->setPropertyOwner(this);
+            notifyStructureChange();
+            updateUriIndices([prop](UriIndex& index, const std::string& prefix) {
+                index.properties[prefix + prop->identifier()] = prop;
+            });
         }
     }
 }
@@ -282,6 +361,17 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         else {
             _subOwners.push_back(owner);
             owner->setPropertyOwner(this);
+            notifyStructureChange();
+
+            if (isUriIndexed()) {
+                std::vector<std::pair<std::string, Property*>> props;
+                collectPropertyUris(*owner, uriPrefix(owner->identifier()), props);
+                updateUriIndices([&props](UriIndex& index, const std::string& prefix) {
+                    for (const std::pair<std::string, Property*>& p : props) {
+                        index.properties[prefix + p.first] = p.second;
+                    }
+                });
+            }
         }
     }
 }
@@ -302,8 +392,12 @@ void PropertyOwner::removeProperty(Property* prop) {
 
     // If we found the property identifier, we can delete it
     if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
+        updateUriIndices([prop](UriIndex& index, const std::string& prefix) {
+            index.properties.erase(prefix + prop->identifier());
+        });
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
+        notifyStructureChange();
     }
     else {
         LERROR(fmt::format(
@@ -330,7 +424,22 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
 
     // If we found the propertyowner, we can delete it
     if (it != _subOwners.end() && (*it)->identifier() == owner->identifier()) {
+        if (isUriIndexed()) {
+            std::vector<std::pair<std::string, Property*>> props;
+            collectPropertyUris(**it, uriPrefix((*it)->identifier()), props);
+            updateUriIndices([&props](UriIndex& index, const std::string& prefix) {
+                for (const std::pair<std::string, Property*>& p : props) {
+                    index.properties.erase(prefix + p.first);
+                }
+            });
+        }
+        // Detach the sub-owner so that later changes in its subtree no longer reach
+        // our indices
+        if ((*it)->_owner == this) {
+            (*it)->setPropertyOwner(nullptr);
+        }
         _subOwners.erase(it);
+        notifyStructureChange();
     }
     else {
         LERROR(fmt::format(
@@ -347,7 +456,35 @@ void PropertyOwner::setIdentifier(std::string identifier) {
     if (identifier.find_first_of(". \t\n") != std::string::npos) {
         throw ghoul::RuntimeError("Identifier must not contain any dots or whitespaces");
     }
+
+    // The URIs of all Propertys in this subtree change in the indices of our owners
+    const bool isIndexed = _owner && _owner->isUriIndexed();
+    std::vector<std::pair<std::string, Property*>> props;
+    if (isIndexed) {
+        collectPropertyUris(*this, "", props);
+        const std::string oldPrefix = uriPrefix(_identifier);
+        _owner->updateUriIndices(
+            [&props, &oldPrefix](UriIndex& index, const std::string& prefix) {
+                for (const std::pair<std::string, Property*>& p : props) {
+                    index.properties.erase(prefix + oldPrefix + p.first);
+                }
+            }
+        );
+    }
+
     _identifier = std::move(identifier);
+    notifyStructureChange();
+
+    if (isIndexed) {
+        const std::string newPrefix = uriPrefix(_identifier);
+        _owner->updateUriIndices(
+            [&props, &newPrefix](UriIndex& index, const std::string& prefix) {
+                for (const std::pair<std::string, Property*>& p : props) {
+                    index.properties[prefix + newPrefix + p.first] = p.second;
+                }
+            }
+        );
+    }
 }
 
 const std::string& PropertyOwner::identifier() const {
@@ -360,6 +497,7 @@ const std::string& PropertyOwner::type() const {
 
 void PropertyOwner::setGuiName(std::string guiName) {
     _guiName = std::move(guiName);
+    notifyStructureChange();
 }
 
 const std::string& PropertyOwner::guiName() const {
@@ -368,6 +506,7 @@ const std::string& PropertyOwner::guiName() const {
 
 void PropertyOwner::setDescription(std::string description) {
     _description = std::move(description);
+    notifyStructureChange();
 }
 
 const std::string& PropertyOwner::description() const {
@@ -380,10 +519,28 @@ const std::vector<std::string>& PropertyOwner::tags() const {
 
 void PropertyOwner::addTag(std::string tag) {
     _tags.push_back(std::move(tag));
+    notifyStructureChange();
 }
 
 void PropertyOwner::removeTag(const std::string& tag) {
     _tags.erase(std::remove(_tags.begin(), _tags.end(), tag), _tags.end());
+    notifyStructureChange();
+}
+
+uint64_t PropertyOwner::structureVersion() const {
+    return _structureVersion;
+}
+
+uint64_t PropertyOwner::subtreeVersion() const {
+    return _subtreeVersion;
+}
+
+void PropertyOwner::notifyStructureChange() {
+    const uint64_t version = ++StructureVersionCounter;
+    _structureVersion = version;
+    for (PropertyOwner* o = this; o; o = o->_owner) {
+        o->_subtreeVersion = version;
+    }
 }
 
 nlohmann::json PropertyOwner::generateJson() const {
@@ -0,0 +1,224 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/properties/propertyurimatcher.h>
+
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    // The maximum number of search results that are kept in the cache. If the number is
+    // exceeded, the entire cache is cleared
+    constexpr size_t MaxCachedSearches = 256;
+
+    struct CachedSearch {
+        const openspace::properties::PropertyOwner* root = nullptr;
+        uint64_t version = 0;
+        std::vector<std::pair<std::string, openspace::properties::Property*>> matches;
+    };
+
+    std::mutex CacheMutex;
+    std::unordered_map<std::string, CachedSearch> Cache;
+
+    bool hasOwnerWithTag(const openspace::properties::Property& prop,
+                         const std::string& tag)
+    {
+        using namespace openspace::properties;
+
+        for (const PropertyOwner* o = prop.owner(); o; o = o->owner()) {
+            const std::vector<std::string>& tags = o->tags();
+            if (std::find(tags.begin(), tags.end(), tag) != tags.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+namespace openspace::properties {
+
+PropertyUriMatcher::PropertyUriMatcher(std::string expression, std::string groupName)
+    : _expression(std::move(expression))
+    , _groupName(std::move(groupName))
+{
+    _key = _groupName + '\n' + _expression;
+
+    const size_t wildPos = _expression.find_first_of('*');
+    if (wildPos != std::string::npos) {
+        _nodeName = _expression.substr(0, wildPos);
+        _propertyName = _expression.substr(wildPos + 1);
+
+        // If none then malformed regular expression
+        if (_propertyName.empty() && _nodeName.empty()) {
+            _error = fmt::format(
+                "Malformed regular expression: '{}': Empty both before and after '*'",
+                _expression
+            );
+        }
+
+        // Currently do not support several wildcards
+        if (_expression.find_first_of('*', wildPos + 1) != std::string::npos) {
+            _error = fmt::format(
+                "Malformed regular expression: '{}': Currently only one '*' is supported",
+                _expression
+            );
+        }
+    }
+    // Literal or tag
+    else {
+        _propertyName = _expression;
+        _isLiteral = _groupName.empty();
+    }
+}
+
+bool PropertyUriMatcher::isValid() const {
+    return _error.empty();
+}
+
+const std::string& PropertyUriMatcher::error() const {
+    return _error;
+}
+
+bool PropertyUriMatcher::isLiteral() const {
+    return _isLiteral;
+}
+
+const std::string& PropertyUriMatcher::expression() const {
+    return _expression;
+}
+
+const std::string& PropertyUriMatcher::key() const {
+    return _key;
+}
+
+bool PropertyUriMatcher::matches(const std::string& uri, const Property& prop) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    const bool isGroupMode = !_groupName.empty();
+    if (_isLiteral) {
+        return uri == _propertyName;
+    }
+    else if (!_propertyName.empty()) {
+        const size_t propertyPos = uri.find(_propertyName);
+        if (propertyPos == std::string::npos) {
+            return false;
+        }
+
+        // Check that the propertyName fully matches the property in the URI
+        if ((propertyPos + _propertyName.length() + 1) < uri.length()) {
+            return false;
+        }
+
+        // Match node name
+        if (!_nodeName.empty() && uri.find(_nodeName) == std::string::npos) {
+            return false;
+        }
+
+        return !isGroupMode || hasOwnerWithTag(prop, _groupName);
+    }
+    else {
+        const size_t nodePos = uri.find(_nodeName);
+        if (nodePos == std::string::npos) {
+            return false;
+        }
+
+        if (isGroupMode) {
+            return hasOwnerWithTag(prop, _groupName);
+        }
+        else {
+            // Check that the nodeName fully matches the node in the URI
+            return nodePos == 0;
+        }
+    }
+}
+
+std::vector<std::pair<std::string, Property*>> PropertyUriMatcher::findMatches(
+                                                         const PropertyOwner& root) const
+{
+    ZoneScoped;
+
+    std::vector<std::pair<std::string, Property*>> res;
+    if (!isValid()) {
+        return res;
+    }
+
+    std::vector<std::pair<std::string, Property*>> props = root.propertiesWithUri();
+    for (std::pair<std::string, Property*>& p : props) {
+        if (matches(p.first, *p.second)) {
+            res.push_back(std::move(p));
+        }
+    }
+    return res;
+}
+
+std::vector<std::pair<std::string, Property*>> matchingProperties(
+                                                               const PropertyOwner& root,
+                                                       const PropertyUriMatcher& matcher)
+{
+    ZoneScoped;
+
+    if (!matcher.isValid()) {
+        return {};
+    }
+
+    if (matcher.isLiteral()) {
+        // The URI can be looked up directly, which is a single hash lookup for owners
+        // that have their URI index enabled
+        Property* prop = root.property(matcher.expression());
+        if (prop) {
+            return { { matcher.expression(), prop } };
+        }
+        return {};
+    }
+
+    const uint64_t version = root.subtreeVersion();
+    {
+        std::lock_guard lock(CacheMutex);
+        auto it = Cache.find(matcher.key());
+        if (it != Cache.end() && it->second.root == &root &&
+            it->second.version == version)
+        {
+            return it->second.matches;
+        }
+    }
+
+    std::vector<std::pair<std::string, Property*>> matches = matcher.findMatches(root);
+
+    std::lock_guard lock(CacheMutex);
+    if (Cache.size() >= MaxCachedSearches) {
+        Cache.clear();
+    }
+    Cache[matcher.key()] = { &root, version, matches };
+    return matches;
+}
+
+} // namespace openspace::properties
@@ -206,6 +206,8 @@ Renderable::Renderable(const ghoul::Dictionary& dictionary, RenderableSettings s
 
 void Renderable::initialize() {}
 
+void Renderable::initializeData() {}
+
 void Renderable::initializeGL() {}
 
 void Renderable::deinitialize() {}
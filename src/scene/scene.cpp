@@ -52,6 +52,7 @@
 #include <ghoul/misc/misc.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <algorithm>
 #include <string>
 #include <stack>
 
@@ -270,6 +271,47 @@ bool Scene::isInitializing() const {
     return _initializer->isInitializing();
 }
 
+void Scene::logLoadTimes(int nEntries) const {
+    using LoadTimes = SceneGraphNode::LoadTimes;
+    auto total = [](const LoadTimes& t) { return t.initialize + t.data + t.gl; };
+
+    std::vector<const SceneGraphNode*> nodes = {
+        _topologicallySortedNodes.begin(),
+        _topologicallySortedNodes.end()
+    };
+    std::sort(
+        nodes.begin(),
+        nodes.end(),
+        [&total](const SceneGraphNode* lhs, const SceneGraphNode* rhs) {
+            return total(lhs->loadTimes()) > total(rhs->loadTimes());
+        }
+    );
+
+    std::chrono::duration<double, std::milli> sum =
+        std::chrono::duration<double, std::milli>(0.0);
+    for (const SceneGraphNode* node : nodes) {
+        sum += total(node->loadTimes());
+    }
+    LINFO(fmt::format(
+        "Loading {} scene graph nodes took {:.1f} ms in total", nodes.size(), sum.count()
+    ));
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const LoadTimes& t = nodes[i]->loadTimes();
+        std::string message = fmt::format(
+            "{}: {:.1f} ms (initialize: {:.1f} ms, data: {:.1f} ms, OpenGL: {:.1f} ms)",
+            nodes[i]->identifier(), total(t).count(), t.initialize.count(),
+            t.data.count(), t.gl.count()
+        );
+        if (i < static_cast<size_t>(nEntries)) {
+            LINFO(message);
+        }
+        else {
+            LDEBUG(message);
+        }
+    }
+}
+
 void Scene::update(const UpdateData& data) {
     ZoneScoped;
 
@@ -606,7 +648,6 @@ void Scene::setPropertiesFromProfile(const Profile& p) {
         applyRegularExpression(
             L,
             uriOrRegex,
-            allProperties(),
             0.0,
             groupName,
             ghoul::EasingFunction::Linear,
@@ -777,7 +818,7 @@ PropertyValueType Scene::propertyValueType(const std::string& value) {
 std::vector<properties::Property*> Scene::propertiesMatchingRegex(
                                                               std::string propertyString)
 {
-    return findMatchesInAllProperties(propertyString, allProperties(), "");
+    return findMatchesInAllProperties(propertyString, "");
 }
 
 std::vector<std::string> Scene::allTags() {
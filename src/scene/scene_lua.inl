@@ -25,6 +25,7 @@
 #include <openspace/engine/globals.h>
 #include <openspace/scene/scene.h>
 #include <openspace/properties/propertyowner.h>
+#include <openspace/properties/propertyurimatcher.h>
 #include <openspace/properties/matrix/dmat2property.h>
 #include <openspace/properties/matrix/dmat3property.h>
 #include <openspace/properties/matrix/dmat4property.h>
@@ -59,146 +60,30 @@
 
 namespace {
 
-template <class T>
-openspace::properties::PropertyOwner* findPropertyOwnerWithMatchingGroupTag(T* prop,
-                                                            const std::string& tagToMatch)
-{
-    using namespace openspace;
-
-    properties::PropertyOwner* tagMatchOwner = nullptr;
-    properties::PropertyOwner* owner = prop->owner();
-
-    if (owner) {
-        const std::vector<std::string>& tags = owner->tags();
-        for (const std::string& currTag : tags) {
-            if (tagToMatch == currTag) {
-                tagMatchOwner = owner;
-                break;
-            }
-        }
-
-        // Call recursively until we find an owner with matching tag or the top of the
-        // ownership list
-        if (tagMatchOwner == nullptr) {
-            tagMatchOwner = findPropertyOwnerWithMatchingGroupTag(owner, tagToMatch);
-        }
-    }
-    return tagMatchOwner;
-}
-
 std::vector<openspace::properties::Property*> findMatchesInAllProperties(
                                                                 const std::string& regex,
-                         const std::vector<openspace::properties::Property*>& properties,
                                                             const std::string& groupName)
 {
     using namespace openspace;
 
-    std::vector<properties::Property*> matches;
-    const bool isGroupMode = !groupName.empty();
-    bool isLiteral = false;
-
-    // Extract the property and node name to be searched for from regex
-    std::string propertyName;
-    std::string nodeName;
-    size_t wildPos = regex.find_first_of("*");
-    if (wildPos != std::string::npos) {
-        nodeName = regex.substr(0, wildPos);
-        propertyName = regex.substr(wildPos + 1, regex.length());
-
-        // If none then malformed regular expression
-        if (propertyName.empty() && nodeName.empty()) {
-            LERRORC(
-                "findMatchesInAllProperties",
-                fmt::format(
-                    "Malformed regular expression: '{}': Empty both before and after '*'",
-                    regex
-                )
-            );
-            return matches;
-        }
-
-        // Currently do not support several wildcards
-        if (regex.find_first_of("*", wildPos + 1) != std::string::npos) {
-            LERRORC(
-                "findMatchesInAllProperties",
-                fmt::format(
-                    "Malformed regular expression: '{}': Currently only one '*' is "
-                    "supported", regex
-                )
-            );
-            return matches;
-        }
-    }
-    // Literal or tag
-    else {
-        propertyName = regex;
-        if (!isGroupMode) {
-            isLiteral = true;
-        }
+    const properties::PropertyUriMatcher matcher(regex, groupName);
+    if (!matcher.isValid()) {
+        LERRORC("findMatchesInAllProperties", matcher.error());
+        return {};
     }
 
-    // Stores whether we found at least one matching property. If this is false at the end
-    // of the loop, the property name regex was probably misspelled.
-    for (properties::Property* prop : properties) {
-        // Check the regular expression for all properties
-        const std::string id = prop->fullyQualifiedIdentifier();
-
-        if (isLiteral && id != propertyName) {
-            continue;
-        }
-        else if (!propertyName.empty()) {
-            size_t propertyPos = id.find(propertyName);
-            if (propertyPos != std::string::npos) {
-                // Check that the propertyName fully matches the property in id
-                if ((propertyPos + propertyName.length() + 1) < id.length()) {
-                    continue;
-                }
+    std::vector<std::pair<std::string, properties::Property*>> matches =
+        properties::matchingProperties(*global::rootPropertyOwner, matcher);
 
-                // Match node name
-                if (!nodeName.empty() && id.find(nodeName) == std::string::npos) {
-                    continue;
-                }
-
-                // Check tag
-                if (isGroupMode) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        else if (!nodeName.empty()) {
-            size_t nodePos = id.find(nodeName);
-            if (nodePos != std::string::npos) {
-                // Check tag
-                if (isGroupMode) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-                // Check that the nodeName fully matches the node in id
-                else if (nodePos != 0) {
-                    continue;
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        matches.push_back(prop);
+    std::vector<properties::Property*> res;
+    res.reserve(matches.size());
+    for (const std::pair<std::string, properties::Property*>& match : matches) {
+        res.push_back(match.second);
     }
-    return matches;
+    return res;
 }
 
 void applyRegularExpression(lua_State* L, const std::string& regex,
-                          const std::vector<openspace::properties::Property*>& properties,
                                                              double interpolationDuration,
                                                              const std::string& groupName,
                                                      ghoul::EasingFunction easingFunction,
@@ -212,7 +97,6 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
 
     std::vector<properties::Property*> matchingProps = findMatchesInAllProperties(
         regex,
-        properties,
         groupName
     );
 
@@ -441,7 +325,6 @@ int propertySetValue(lua_State* L) {
         applyRegularExpression(
             L,
             uriOrRegex,
-            allProperties(),
             interpolationDuration,
             groupName,
             easingMethod,
@@ -506,100 +389,20 @@ namespace {
         regex = removeGroupNameFromUri(regex);
     }
 
-    // Extract the property and node name to be searched for from regex
-    bool isLiteral = false;
-    std::string propertyName;
-    std::string nodeName;
-    size_t wildPos = regex.find_first_of("*");
-    if (wildPos != std::string::npos) {
-        nodeName = regex.substr(0, wildPos);
-        propertyName = regex.substr(wildPos + 1, regex.length());
-
-        // If none then malformed regular expression
-        if (propertyName.empty() && nodeName.empty()) {
-            throw ghoul::lua::LuaError(fmt::format(
-                "Malformed regular expression: '{}': Empty both before and after '*'",
-                regex
-            ));
-        }
-
-        // Currently do not support several wildcards
-        if (regex.find_first_of("*", wildPos + 1) != std::string::npos) {
-            throw ghoul::lua::LuaError(fmt::format(
-                "Malformed regular expression: '{}': Currently only one '*' is supported",
-                regex
-            ));
-        }
-    }
-    // Literal or tag
-    else {
-        propertyName = regex;
-        if (groupName.empty()) {
-            isLiteral = true;
-        }
+    const properties::PropertyUriMatcher matcher(regex, groupName);
+    if (!matcher.isValid()) {
+        throw ghoul::lua::LuaError(matcher.error());
     }
 
     // Get all matching property uris and save to res
-    std::vector<properties::Property*> props = allProperties();
-    std::vector<std::string> res;
-    for (properties::Property* prop : props) {
-        // Check the regular expression for all properties
-        const std::string& id = prop->fullyQualifiedIdentifier();
+    std::vector<std::pair<std::string, properties::Property*>> matches =
+        properties::matchingProperties(*global::rootPropertyOwner, matcher);
 
-        if (isLiteral && id != propertyName) {
-            continue;
-        }
-        else if (!propertyName.empty()) {
-            size_t propertyPos = id.find(propertyName);
-            if (propertyPos != std::string::npos) {
-                // Check that the propertyName fully matches the property in id
-                if ((propertyPos + propertyName.length() + 1) < id.length()) {
-                    continue;
-                }
-
-                // Match node name
-                if (!nodeName.empty() && id.find(nodeName) == std::string::npos) {
-                    continue;
-                }
-
-                // Check tag
-                if (!groupName.empty()) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        else if (!nodeName.empty()) {
-            size_t nodePos = id.find(nodeName);
-            if (nodePos != std::string::npos) {
-
-                // Check tag
-                if (!groupName.empty()) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-                // Check that the nodeName fully matches the node in id
-                else if (nodePos != 0) {
-                    continue;
-                }
-            }
-            else {
-                continue;
-            }
-        }
-
-        res.push_back(id);
+    std::vector<std::string> res;
+    res.reserve(matches.size());
+    for (std::pair<std::string, properties::Property*>& match : matches) {
+        res.push_back(std::move(match.first));
     }
-
     return res;
 }
 
@@ -591,6 +591,7 @@ void SceneGraphNode::initialize() {
     ZoneName(identifier().c_str(), identifier().size());
 
     LDEBUG(fmt::format("Initializing: {}", identifier()));
+    const auto start = std::chrono::steady_clock::now();
 
     if (_renderable) {
         _renderable->initialize();
@@ -606,15 +607,33 @@ void SceneGraphNode::initialize() {
         _transform.scale->initialize();
     }
     _state = State::Initialized;
+    _loadTimes.initialize = std::chrono::steady_clock::now() - start;
 
     LDEBUG(fmt::format("Finished initializing: {}", identifier()));
 }
 
+void SceneGraphNode::initializeData() {
+    ZoneScoped;
+    ZoneName(identifier().c_str(), identifier().size());
+
+    LDEBUG(fmt::format("Initializing data: {}", identifier()));
+    const auto start = std::chrono::steady_clock::now();
+
+    if (_renderable) {
+        _renderable->initializeData();
+    }
+
+    _loadTimes.data = std::chrono::steady_clock::now() - start;
+
+    LDEBUG(fmt::format("Finished initializing data: {}", identifier()));
+}
+
 void SceneGraphNode::initializeGL() {
     ZoneScoped;
     ZoneName(identifier().c_str(), identifier().size());
 
     LDEBUG(fmt::format("Initializing GL: {}", identifier()));
+    const auto start = std::chrono::steady_clock::now();
 
     if (_renderable) {
         _renderable->initializeGL();
@@ -639,6 +658,7 @@ void SceneGraphNode::initializeGL() {
     }
 
     _state = State::GLInitialized;
+    _loadTimes.gl = std::chrono::steady_clock::now() - start;
 
     LDEBUG(fmt::format("Finished initializating GL: {}", identifier()));
 }
@@ -1101,6 +1121,10 @@ bool SceneGraphNode::hasGuiHintHidden() const {
     return _guiHidden;
 }
 
+const SceneGraphNode::LoadTimes& SceneGraphNode::loadTimes() const {
+    return _loadTimes;
+}
+
 glm::dvec3 SceneGraphNode::calculateWorldPosition() const {
     // recursive up the hierarchy if there are parents available
     if (_parent) {
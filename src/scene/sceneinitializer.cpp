@@ -34,6 +34,7 @@ namespace openspace {
 
 void SingleThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
     node->initialize();
+    node->initializeData();
     _initializedNodes.push_back(node);
 }
 
@@ -65,8 +66,11 @@ void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
             );
         }
 
+        // Both the initialization and the loading of the data happen on the worker
+        // thread so that only the upload of the data is left for the main thread
         try {
             node->initialize();
+            node->initializeData();
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.message);
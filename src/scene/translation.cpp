@@ -69,6 +69,10 @@ bool Translation::initialize() {
     return true;
 }
 
+bool Translation::supportsConcurrentEvaluation() const {
+    return false;
+}
+
 void Translation::update(const UpdateData& data) {
     if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
         return;
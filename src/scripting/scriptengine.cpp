@@ -35,6 +35,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/defer.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/ext/assimp/contrib/zip/src/zip.h>
 #include <filesystem>
@@ -46,6 +47,10 @@ namespace {
 
     constexpr int TableOffset = -3; // top-first argument-second argument
 
+    // Scripts longer than this are compiled every time instead of being cached, as they
+    // are typically one-off scripts, such as entire asset or profile files
+    constexpr size_t MaxCachedScriptLength = 64 * 1024;
+
     struct [[codegen::Dictionary(Documentation)]] Parameters {
         std::string name;
         std::map<std::string, std::string> arguments;
@@ -132,6 +137,7 @@ void ScriptEngine::initialize() {
 void ScriptEngine::deinitialize() {
     ZoneScoped;
 
+    shrinkChunkCache(0);
     _registeredLibraries.clear();
 }
 
@@ -203,15 +209,42 @@ bool ScriptEngine::runScript(const std::string& script, ScriptCallback callback)
         writeLog(script);
     }
 
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
     try {
+        if (!pushCompiledChunk(script)) {
+            LERROR(fmt::format(
+                "Error loading script: {}", ghoul::lua::value<std::string>(_state)
+            ));
+            if (callback) {
+                callback(ghoul::Dictionary());
+            }
+            return false;
+        }
+
+        if (lua_pcall(_state, 0, callback ? LUA_MULTRET : 0, 0) != LUA_OK) {
+            LERROR(fmt::format(
+                "Error executing script: {}", ghoul::lua::value<std::string>(_state)
+            ));
+            if (callback) {
+                callback(ghoul::Dictionary());
+            }
+            return false;
+        }
+
         if (callback) {
-            ghoul::Dictionary returnValue =
-                ghoul::lua::loadArrayDictionaryFromString(script, _state);
+            // Collect all return values into an array, the same way that
+            // ghoul::lua::loadArrayDictionaryFromString would return them
+            const int nResults = lua_gettop(_state) - top;
+            lua_createtable(_state, nResults, 0);
+            for (int i = 1; i <= nResults; i++) {
+                lua_pushvalue(_state, top + i);
+                lua_rawseti(_state, -2, i);
+            }
+            ghoul::Dictionary returnValue = ghoul::lua::luaDictionaryFromState(_state);
             callback(returnValue);
         }
-        else {
-            ghoul::lua::runScript(_state, script);
-        }
     }
     catch (const ghoul::lua::LuaLoadingException& e) {
         LERRORC(e.component, e.message);
@@ -238,6 +271,80 @@ bool ScriptEngine::runScript(const std::string& script, ScriptCallback callback)
     return true;
 }
 
+bool ScriptEngine::pushCompiledChunk(const std::string& script) {
+    ZoneScoped;
+
+    const bool isCacheable =
+        _chunkCacheSize > 0 && script.size() <= MaxCachedScriptLength;
+    const size_t hash = std::hash<std::string>()(script);
+
+    if (isCacheable) {
+        auto it = _chunkCacheIndex.find(hash);
+        // Compare the script itself as well to guard against hash collisions
+        if (it != _chunkCacheIndex.end() && it->second->script == script) {
+            // Move the chunk to the front as it is now the most recently used
+            _chunkCache.splice(_chunkCache.begin(), _chunkCache, it->second);
+            _chunkCacheStatistics.hits++;
+            _chunkCacheStatistics.compileTimeSaved += it->second->compileTime;
+            lua_rawgeti(_state, LUA_REGISTRYINDEX, it->second->reference);
+            return true;
+        }
+    }
+
+    // Using the script as the chunk name mirrors the error messages of luaL_loadstring
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    const int res = luaL_loadbuffer(_state, script.data(), script.size(), script.c_str());
+    const auto compileTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - t0
+    );
+    _chunkCacheStatistics.misses++;
+    _chunkCacheStatistics.compileTime += compileTime;
+    if (res != LUA_OK) {
+        return false;
+    }
+
+    if (isCacheable) {
+        auto it = _chunkCacheIndex.find(hash);
+        if (it != _chunkCacheIndex.end()) {
+            // A different script with the same hash is replaced
+            luaL_unref(_state, LUA_REGISTRYINDEX, it->second->reference);
+            _chunkCache.erase(it->second);
+            _chunkCacheIndex.erase(it);
+        }
+        else {
+            shrinkChunkCache(_chunkCacheSize - 1);
+        }
+
+        // luaL_ref pops the value, so we duplicate it to leave it on the stack
+        lua_pushvalue(_state, -1);
+        const int reference = luaL_ref(_state, LUA_REGISTRYINDEX);
+        _chunkCache.push_front({ script, reference, compileTime });
+        _chunkCacheIndex[hash] = _chunkCache.begin();
+        _chunkCacheStatistics.size = _chunkCache.size();
+    }
+    return true;
+}
+
+void ScriptEngine::shrinkChunkCache(size_t size) {
+    while (_chunkCache.size() > size) {
+        const CompiledChunk& chunk = _chunkCache.back();
+        luaL_unref(_state, LUA_REGISTRYINDEX, chunk.reference);
+        _chunkCacheIndex.erase(std::hash<std::string>()(chunk.script));
+        _chunkCache.pop_back();
+        _chunkCacheStatistics.evictions++;
+    }
+    _chunkCacheStatistics.size = _chunkCache.size();
+}
+
+void ScriptEngine::setChunkCacheSize(size_t size) {
+    _chunkCacheSize = size;
+    shrinkChunkCache(size);
+}
+
+ScriptEngine::ChunkCacheStatistics ScriptEngine::chunkCacheStatistics() const {
+    return _chunkCacheStatistics;
+}
+
 bool ScriptEngine::runScriptFile(const std::filesystem::path& filename) {
     ZoneScoped;
 
@@ -712,7 +819,8 @@ void ScriptEngine::addBaseLibrary() {
             codegen::lua::WalkDirectoryFiles,
             codegen::lua::WalkDirectoryFolders,
             codegen::lua::DirectoryForPath,
-            codegen::lua::UnzipFile
+            codegen::lua::UnzipFile,
+            codegen::lua::ScriptCacheStatistics
         }
     };
     addLibrary(lib);
@@ -241,6 +241,33 @@ std::vector<std::string> walkCommon(std::string path, bool recursive, bool sorte
     }
 }
 
+/**
+ * Returns statistics about the cache of compiled scripts. The returned table contains the
+ * number of cache 'Hits' and 'Misses', the 'HitRate', the number of 'Evictions', the
+ * current 'Size' of the cache, the total 'CompileTime' in milliseconds, and the
+ * 'CompileTimeSaved' in milliseconds that was avoided by reusing compiled scripts.
+ */
+[[codegen::luawrap]] ghoul::Dictionary scriptCacheStatistics() {
+    using namespace openspace;
+
+    scripting::ScriptEngine::ChunkCacheStatistics stats =
+        global::scriptEngine->chunkCacheStatistics();
+
+    const uint64_t total = stats.hits + stats.misses;
+    ghoul::Dictionary res;
+    res.setValue("Hits", static_cast<int>(stats.hits));
+    res.setValue("Misses", static_cast<int>(stats.misses));
+    res.setValue(
+        "HitRate",
+        total > 0 ? static_cast<double>(stats.hits) / static_cast<double>(total) : 0.0
+    );
+    res.setValue("Evictions", static_cast<int>(stats.evictions));
+    res.setValue("Size", static_cast<int>(stats.size));
+    res.setValue("CompileTime", stats.compileTime.count() / 1000.0);
+    res.setValue("CompileTimeSaved", stats.compileTimeSaved.count() / 1000.0);
+    return res;
+}
+
 #include "scriptengine_lua_codegen.cpp"
 
 } // namespace
@@ -30,6 +30,9 @@
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/time.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <limits>
 
 #include "scriptscheduler_lua.inl"
 
@@ -108,140 +111,135 @@ ScriptScheduler::ScheduledScript::ScheduledScript(const ghoul::Dictionary& dict)
     group = p.group.value_or(group);
 }
 
-void ScriptScheduler::loadScripts(std::vector<ScheduledScript> scheduledScripts) {
-    // Sort scripts by time; use a stable_sort as the user might have had an intention
-    // specifying multiple scripts for the same time in a specific order
-    std::stable_sort(
-        scheduledScripts.begin(),
-        scheduledScripts.end(),
-        [](const ScheduledScript& lhs, const ScheduledScript& rhs) {
-            return lhs.time < rhs.time;
-        }
-    );
+bool ScriptScheduler::EntryKey::operator<(const EntryKey& rhs) const {
+    return time < rhs.time || (time == rhs.time && order < rhs.order);
+}
 
+void ScriptScheduler::loadScripts(std::vector<ScheduledScript> scheduledScripts) {
+    // Every script is merged into the timeline individually. The load order is part of
+    // the key, so scripts that are scheduled for the same time are executed in the order
+    // in which they were specified, with previously loaded scripts first
     for (ScheduledScript& script : scheduledScripts) {
-        _scripts.push_back(script);
+        std::string forward = script.universalScript.empty() ?
+            script.forwardScript :
+            script.universalScript + "; " + script.forwardScript;
+        std::string backward = script.universalScript.empty() ?
+            script.backwardScript :
+            script.universalScript + "; " + script.backwardScript;
+
+        const EntryKey key = { script.time, _nextOrder++ };
+        const int group = script.group;
+        Entry entry = {
+            .script = std::move(script),
+            .forwardScript = internScript(std::move(forward)),
+            .backwardScript = internScript(std::move(backward))
+        };
+        auto it = _timeline.emplace_hint(_timeline.end(), key, std::move(entry));
+        _groups[group].push_back(it);
     }
 
-    // Re-sort so it is always in sorted order in regards to time
-    std::stable_sort(
-        _scripts.begin(),
-        _scripts.end(),
-        [](const ScheduledScript& lhs, const ScheduledScript& rhs) {
-            return lhs.time < rhs.time;
-        }
-    );
-
-    // Ensure _currentIndex and _currentTime is accurate after new scripts was added
-    const double lastTime = _currentTime;
-    rewind();
-    progressTo(lastTime);
+    // Ensure the position is accurate after new scripts was added
+    updatePosition();
 }
 
 void ScriptScheduler::rewind() {
-    _currentIndex = 0;
+    _position = _timeline.begin();
     _currentTime = -std::numeric_limits<double>::max();
 }
 
 void ScriptScheduler::clearSchedule(std::optional<int> group) {
     if (group.has_value()) {
-        for (auto it = _scripts.begin(); it < _scripts.end();) {
-            if (it->group == *group) {
-                it = _scripts.erase(it);
-            }
-            else {
-                ++it;
-            }
+        auto it = _groups.find(*group);
+        if (it == _groups.end()) {
+            return;
         }
 
-        // Ensure _currentIndex and _currentTime is accurate after scripts was removed
-        const double lastTime = _currentTime;
-        rewind();
-        progressTo(lastTime);
+        for (Timeline::iterator entry : it->second) {
+            eraseEntry(entry);
+        }
+        _groups.erase(it);
+
+        // Ensure the position is accurate after scripts was removed
+        updatePosition();
     }
     else {
         rewind();
-        _scripts.clear();
+        _timeline.clear();
+        _groups.clear();
+        _scriptBodies.clear();
+        _position = _timeline.end();
     }
 }
 
-std::vector<std::string> ScriptScheduler::progressTo(double newTime) {
-    std::vector<std::string> result;
-    if (!_enabled || newTime == _currentTime || _scripts.empty()) {
+std::vector<std::string_view> ScriptScheduler::progressTo(double newTime) {
+    std::vector<std::string_view> result;
+    if (!_enabled || newTime == _currentTime || _timeline.empty()) {
         // Update the new time
         _currentTime = newTime;
         return result;
     }
 
     if (newTime > _currentTime) {
-        // Moving forward in time; we need to find the highest entry in the timings
-        // vector that is still smaller than the newTime
-        size_t prevIndex = _currentIndex;
-        const auto it = std::upper_bound(
-            _scripts.begin() + prevIndex, // We only need to start at the previous time
-            _scripts.end(),
-            newTime,
-            [](const double value, const ScheduledScript& item) {
-                return value < item.time;
-            }
-         );
-
-        // How many values did we pass over?
-        const ptrdiff_t n = std::distance(_scripts.begin() + prevIndex, it);
-        _currentIndex = static_cast<int>(prevIndex + n);
-
-        // Update the new time
-        _currentTime = newTime;
-
-        // Construct result
-        for (auto iter = _scripts.begin() + prevIndex;
-            iter < (_scripts.begin() + _currentIndex);
-            ++iter)
-        {
-            std::string script = iter->universalScript.empty() ?
-                iter->forwardScript :
-                iter->universalScript + "; " + iter->forwardScript;
-            result.push_back(script);
+        // Moving forward in time; we pass over all entries starting at the current
+        // position whose time is smaller or equal to the newTime
+        while (_position != _timeline.end() && _position->first.time <= newTime) {
+            result.push_back(_position->second.forwardScript);
+            ++_position;
         }
-
-        return result;
     }
     else {
-        // Moving backward in time; the need to find the lowest entry that is still bigger
-        // than the newTime
-        const size_t prevIndex = _currentIndex;
-        const auto it = std::lower_bound(
-            _scripts.begin(),
-            _scripts.begin() + prevIndex, // We can stop at the previous time
-            newTime,
-            [](const ScheduledScript& item, const double value) {
-                return item.time < value;
+        // Moving backward in time; we pass over all entries before the current position
+        // whose time is bigger or equal to the newTime. These are returned in reverse
+        // order
+        while (_position != _timeline.begin()) {
+            Timeline::iterator prev = std::prev(_position);
+            if (prev->first.time < newTime) {
+                break;
             }
-        );
+            result.push_back(prev->second.backwardScript);
+            _position = prev;
+        }
+    }
 
-        // How many values did we pass over?
-        const ptrdiff_t n = std::distance(it, _scripts.begin() + prevIndex);
-        _currentIndex = static_cast<int>(prevIndex - n);
+    // Update the new time
+    _currentTime = newTime;
+    return result;
+}
 
-        // Update the new time
-        _currentTime = newTime;
+std::string_view ScriptScheduler::internScript(std::string script) {
+    // The keys of an unordered_map are never moved, so the view stays valid until the
+    // entry is erased
+    auto it = _scriptBodies.try_emplace(std::move(script), 0).first;
+    it->second++;
+    return it->first;
+}
 
-        // Construct result
-        const size_t startOffset = prevIndex == 0 ? prevIndex : prevIndex - 1;
-        auto start = _scripts.begin() + startOffset;
-        auto end = it;
-        for (auto iter = start; iter != _scripts.end() && iter >= end; --iter) {
-            std::string script = iter->universalScript.empty() ?
-                iter->backwardScript :
-                iter->universalScript + "; " + iter->backwardScript;
-            result.push_back(script);
-
-            if (iter == _scripts.begin()) {
-                break;
-            }
-        }
+void ScriptScheduler::releaseScript(std::string_view script) {
+    auto it = _scriptBodies.find(std::string(script));
+    ghoul_assert(it != _scriptBodies.end(), "Script was not interned");
+    it->second--;
+    if (it->second == 0) {
+        _scriptBodies.erase(it);
+    }
+}
 
-        return result;
+void ScriptScheduler::eraseEntry(Timeline::iterator it) {
+    releaseScript(it->second.forwardScript);
+    releaseScript(it->second.backwardScript);
+    _timeline.erase(it);
+}
+
+void ScriptScheduler::updatePosition() {
+    // This is the position that rewinding and progressing to the current time would
+    // result in. If the scheduler is disabled or is at the beginning of time, progressing
+    // does not move the position
+    if (!_enabled || _currentTime == -std::numeric_limits<double>::max()) {
+        _position = _timeline.begin();
+    }
+    else {
+        _position = _timeline.upper_bound(
+            { _currentTime, std::numeric_limits<uint64_t>::max() }
+        );
     }
 }
 
@@ -254,14 +252,16 @@ double ScriptScheduler::currentTime() const {
 }
 
 void ScriptScheduler::setCurrentTime(double time) {
-    // Ensure _currentIndex and _currentTime is accurate after time jump
-    std::vector<std::string> scheduledScripts = progressTo(time);
+    // Move the timeline position past all scripts between the previous time and the new
+    // time and update _currentTime, so that the next call to progressTo continues from
+    // the new time. The scripts that were passed over are only run if requested
+    std::vector<std::string_view> scheduledScripts = progressTo(time);
 
     if (_shouldRunAllTimeJump) {
         // Queue all scripts for the time jump
-        for (const std::string& script : scheduledScripts) {
+        for (std::string_view script : scheduledScripts) {
             global::scriptEngine->queueScript(
-                script,
+                std::string(script),
                 scripting::ScriptEngine::ShouldBeSynchronized::Yes,
                 scripting::ScriptEngine::ShouldSendToRemote::Yes
             );
@@ -273,9 +273,30 @@ std::vector<ScriptScheduler::ScheduledScript> ScriptScheduler::allScripts(
                                                            std::optional<int> group) const
 {
     std::vector<ScheduledScript> result;
-    for (const ScheduledScript& script : _scripts) {
-        if (!group.has_value() || script.group == *group) {
-            result.push_back(script);
+    if (group.has_value()) {
+        auto it = _groups.find(*group);
+        if (it == _groups.end()) {
+            return result;
+        }
+
+        // The entries of a group are stored in load order, so we have to sort them
+        std::vector<Timeline::iterator> entries = it->second;
+        std::sort(
+            entries.begin(),
+            entries.end(),
+            [](Timeline::iterator lhs, Timeline::iterator rhs) {
+                return lhs->first < rhs->first;
+            }
+        );
+        result.reserve(entries.size());
+        for (Timeline::iterator entry : entries) {
+            result.push_back(entry->second.script);
+        }
+    }
+    else {
+        result.reserve(_timeline.size());
+        for (const std::pair<const EntryKey, Entry>& entry : _timeline) {
+            result.push_back(entry.second.script);
         }
     }
     return result;
@@ -0,0 +1,600 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/httpdownloadengine.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <optional>
+#include <string_view>
+
+namespace {
+    constexpr std::string_view _loggerCat = "HttpDownloadEngine";
+
+    // The maximum time the transfer thread waits for network activity before it checks
+    // for new or cancelled transfers
+    constexpr int PollTimeout = 100;
+
+    // Returns the value of the header \p name if the \p line contains that header
+    std::optional<std::string> headerValue(std::string_view line, std::string_view name)
+    {
+        if (line.size() <= name.size() || line[name.size()] != ':') {
+            return std::nullopt;
+        }
+        for (size_t i = 0; i < name.size(); i++) {
+            if (std::tolower(static_cast<unsigned char>(line[i])) != name[i]) {
+                return std::nullopt;
+            }
+        }
+
+        std::string_view value = line.substr(name.size() + 1);
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front())))
+        {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+            value.remove_suffix(1);
+        }
+        return std::string(value);
+    }
+} // namespace
+
+namespace openspace {
+
+struct HttpDownloadEngine::Transfer {
+    File file;
+    std::shared_ptr<Batch> batch;
+    std::filesystem::path temporary;
+    /// Contains the validator of the server's version of the file that is partially
+    /// stored in the temporary file
+    std::filesystem::path validatorFile;
+    std::ofstream stream;
+    CURL* handle = nullptr;
+    /// Additional request headers, which have to outlive the transfer
+    curl_slist* headers = nullptr;
+
+    /// The size of the temporary file from which the transfer was resumed
+    int64_t resumeOffset = 0;
+
+    /// The ETag or Last-Modified value of the response that is currently received
+    std::string validator;
+
+    /// The number of bytes of this transfer that are included in the batch's progress
+    int64_t reportedBytes = 0;
+
+    /// The total size of this transfer that is included in the batch's total size
+    int64_t reportedTotal = 0;
+    bool isTotalKnown = false;
+
+    bool hasFailedWrite = false;
+    bool hasRetried = false;
+};
+
+bool HttpDownloadEngine::Batch::wait() {
+    std::unique_lock lock(_mutex);
+    _finishedCondition.wait(lock, [this]() { return _nRemaining == 0; });
+    return _failedUrls.empty();
+}
+
+bool HttpDownloadEngine::Batch::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(_mutex);
+    return _finishedCondition.wait_for(
+        lock,
+        timeout,
+        [this]() { return _nRemaining == 0; }
+    );
+}
+
+bool HttpDownloadEngine::Batch::isFinished() const {
+    std::lock_guard lock(_mutex);
+    return _nRemaining == 0;
+}
+
+void HttpDownloadEngine::Batch::cancel() {
+    _shouldCancel = true;
+}
+
+int64_t HttpDownloadEngine::Batch::nDownloadedBytes() const {
+    return _nDownloadedBytes;
+}
+
+int64_t HttpDownloadEngine::Batch::nTotalBytes() const {
+    return _nTotalBytes;
+}
+
+bool HttpDownloadEngine::Batch::isTotalBytesKnown() const {
+    return _nUnknownTotals == 0;
+}
+
+std::vector<std::string> HttpDownloadEngine::Batch::failedUrls() const {
+    std::lock_guard lock(_mutex);
+    return _failedUrls;
+}
+
+HttpDownloadEngine::HttpDownloadEngine(int maxConcurrentTransfers)
+    : _maxConcurrentTransfers(maxConcurrentTransfers)
+{
+    ghoul_precondition(
+        maxConcurrentTransfers > 0,
+        "maxConcurrentTransfers must be positive"
+    );
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        throw ghoul::RuntimeError(
+            "Could not create curl multi handle",
+            "HttpDownloadEngine"
+        );
+    }
+
+    curl_multi_setopt(
+        multi,
+        CURLMOPT_MAX_TOTAL_CONNECTIONS,
+        static_cast<long>(_maxConcurrentTransfers)
+    );
+    // Keep enough connections alive that every transfer slot can reuse one
+    curl_multi_setopt(
+        multi,
+        CURLMOPT_MAXCONNECTS,
+        static_cast<long>(_maxConcurrentTransfers)
+    );
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    _multiHandle = multi;
+}
+
+HttpDownloadEngine::~HttpDownloadEngine() {
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+    }
+    _wakeUpCondition.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    curl_multi_cleanup(reinterpret_cast<CURLM*>(_multiHandle));
+    curl_global_cleanup();
+}
+
+std::shared_ptr<HttpDownloadEngine::Batch> HttpDownloadEngine::download(
+                                                                  std::vector<File> files)
+{
+    auto batch = std::make_shared<Batch>();
+    batch->_nRemaining = static_cast<int>(files.size());
+    batch->_nUnknownTotals = static_cast<int>(files.size());
+    if (files.empty()) {
+        return batch;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        for (File& file : files) {
+            auto transfer = std::make_unique<Transfer>();
+            transfer->file = std::move(file);
+            transfer->batch = batch;
+            _queuedTransfers.push_back(std::move(transfer));
+        }
+
+        if (!_thread.joinable()) {
+            _thread = std::thread([this]() { run(); });
+        }
+    }
+
+    _wakeUpCondition.notify_all();
+    return batch;
+}
+
+void HttpDownloadEngine::run() {
+    CURLM* multi = reinterpret_cast<CURLM*>(_multiHandle);
+
+    while (!_shouldStop) {
+        ZoneScopedN("HttpDownloadEngine");
+
+        {
+            std::lock_guard lock(_mutex);
+            startQueuedTransfers();
+        }
+
+        int nRunning = 0;
+        curl_multi_perform(multi, &nRunning);
+
+        int nMessages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &nMessages)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            CURL* handle = msg->easy_handle;
+            const CURLcode result = msg->data.result;
+
+            auto it = std::find_if(
+                _activeTransfers.begin(),
+                _activeTransfers.end(),
+                [handle](const std::unique_ptr<Transfer>& t) {
+                    return t->handle == handle;
+                }
+            );
+            ghoul_assert(it != _activeTransfers.end(), "Unknown transfer finished");
+            std::unique_ptr<Transfer> transfer = std::move(*it);
+            _activeTransfers.erase(it);
+
+            long responseCode = 0;
+            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+            // The easy handle keeps its connection cache, so it is reset and reused
+            curl_multi_remove_handle(multi, handle);
+            curl_easy_reset(handle);
+            curl_slist_free_all(transfer->headers);
+            transfer->headers = nullptr;
+            _idleHandles.push_back(handle);
+            transfer->handle = nullptr;
+            transfer->stream.close();
+
+            // 416 (Range Not Satisfiable) means that the temporary file can not be used
+            // to resume the transfer, so we start over from the beginning once
+            if (result != CURLE_OK && responseCode == 416 &&
+                transfer->resumeOffset > 0 && !transfer->hasRetried)
+            {
+                std::error_code ec;
+                std::filesystem::remove(transfer->temporary, ec);
+                std::filesystem::remove(transfer->validatorFile, ec);
+                resetProgress(*transfer);
+                transfer->resumeOffset = 0;
+                transfer->hasRetried = true;
+
+                std::lock_guard lock(_mutex);
+                _queuedTransfers.push_front(std::move(transfer));
+                continue;
+            }
+
+            bool success = result == CURLE_OK && !transfer->hasFailedWrite;
+            if (!success) {
+                LERROR(fmt::format(
+                    "Failed download {} with error {}",
+                    transfer->file.url,
+                    transfer->hasFailedWrite ?
+                        "writing to file" :
+                        curl_easy_strerror(result)
+                ));
+            }
+            finishTransfer(std::move(transfer), success);
+        }
+
+        if (_activeTransfers.empty()) {
+            // Without any transfers, curl has nothing to wait on, so we sleep until new
+            // files are enqueued or the engine is destroyed
+            std::unique_lock lock(_mutex);
+            _wakeUpCondition.wait(
+                lock,
+                [this]() { return _shouldStop || !_queuedTransfers.empty(); }
+            );
+        }
+        else {
+            // curl_multi_wait can not be interrupted from another thread, so newly
+            // enqueued transfers are started after at most PollTimeout milliseconds
+            curl_multi_wait(multi, nullptr, 0, PollTimeout, nullptr);
+        }
+    }
+
+    // Abort all outstanding transfers. Their temporary files are kept so that a later
+    // download of the same files can be resumed
+    for (std::unique_ptr<Transfer>& transfer : _activeTransfers) {
+        curl_multi_remove_handle(multi, transfer->handle);
+        curl_easy_cleanup(transfer->handle);
+        transfer->handle = nullptr;
+        curl_slist_free_all(transfer->headers);
+        transfer->headers = nullptr;
+        transfer->stream.close();
+        finishTransfer(std::move(transfer), false);
+    }
+    _activeTransfers.clear();
+
+    {
+        std::lock_guard lock(_mutex);
+        for (std::unique_ptr<Transfer>& transfer : _queuedTransfers) {
+            finishTransfer(std::move(transfer), false);
+        }
+        _queuedTransfers.clear();
+    }
+
+    for (void* handle : _idleHandles) {
+        curl_easy_cleanup(reinterpret_cast<CURL*>(handle));
+    }
+    _idleHandles.clear();
+}
+
+void HttpDownloadEngine::startQueuedTransfers() {
+    while (static_cast<int>(_activeTransfers.size()) < _maxConcurrentTransfers &&
+           !_queuedTransfers.empty())
+    {
+        std::unique_ptr<Transfer> transfer = std::move(_queuedTransfers.front());
+        _queuedTransfers.pop_front();
+
+        if (transfer->batch->_shouldCancel || !startTransfer(*transfer)) {
+            finishTransfer(std::move(transfer), false);
+            continue;
+        }
+        _activeTransfers.push_back(std::move(transfer));
+    }
+}
+
+bool HttpDownloadEngine::startTransfer(Transfer& transfer) {
+    std::error_code ec;
+    std::filesystem::path directory = transfer.file.destination.parent_path();
+    if (!directory.empty() && !std::filesystem::is_directory(directory)) {
+        std::filesystem::create_directories(directory, ec);
+    }
+
+    transfer.temporary = transfer.file.destination;
+    transfer.temporary += ".tmp";
+    transfer.validatorFile = transfer.file.destination;
+    transfer.validatorFile += ".tmp.validator";
+
+    // A partial file can only be resumed if we know which version of the file on the
+    // server it belongs to. The validator is sent as If-Range, so the server responds
+    // with the entire file instead of the range if the file has changed in the meantime
+    std::string resumeValidator;
+    if (std::filesystem::is_regular_file(transfer.validatorFile)) {
+        std::ifstream validatorStream(transfer.validatorFile);
+        std::getline(validatorStream, resumeValidator);
+    }
+
+    transfer.resumeOffset = 0;
+    transfer.validator.clear();
+    if (std::filesystem::is_regular_file(transfer.temporary)) {
+        const uintmax_t size = std::filesystem::file_size(transfer.temporary, ec);
+        if (!ec && !resumeValidator.empty()) {
+            transfer.resumeOffset = static_cast<int64_t>(size);
+        }
+        else {
+            // Without a validator the partial file might belong to an older version of
+            // the file, so the download is started from the beginning instead
+            std::filesystem::remove(transfer.temporary, ec);
+            std::filesystem::remove(transfer.validatorFile, ec);
+        }
+    }
+
+    transfer.stream.open(
+        transfer.temporary,
+        std::ofstream::binary |
+            (transfer.resumeOffset > 0 ? std::ofstream::app : std::ofstream::trunc)
+    );
+    if (!transfer.stream.good()) {
+        LERROR(fmt::format("Cannot open file {}", transfer.temporary));
+        return false;
+    }
+
+    CURL* handle = nullptr;
+    if (!_idleHandles.empty()) {
+        handle = reinterpret_cast<CURL*>(_idleHandles.back());
+        _idleHandles.pop_back();
+    }
+    else {
+        handle = curl_easy_init();
+        if (!handle) {
+            return false;
+        }
+    }
+    transfer.handle = handle;
+
+    curl_easy_setopt(handle, CURLOPT_URL, transfer.file.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, "OpenSpace");
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    // Error responses should not end up in the temporary file that might be resumed
+    curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, &transfer);
+
+    if (transfer.resumeOffset > 0) {
+        curl_easy_setopt(
+            handle,
+            CURLOPT_RESUME_FROM_LARGE,
+            static_cast<curl_off_t>(transfer.resumeOffset)
+        );
+        // The list is owned by the transfer as curl only keeps a pointer to it
+        const std::string ifRange = fmt::format("If-Range: {}", resumeValidator);
+        transfer.headers = curl_slist_append(nullptr, ifRange.c_str());
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer.headers);
+        reportProgress(transfer, transfer.resumeOffset, 0);
+    }
+
+    // The leading + in all of the lambda expressions are to cause an implicit conversion
+    // to a standard C function pointer, see HttpRequest::perform
+
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer);
+    curl_easy_setopt(
+        handle,
+        CURLOPT_HEADERFUNCTION,
+        +[](char* ptr, size_t size, size_t nmemb, void* userData) {
+            Transfer* t = reinterpret_cast<Transfer*>(userData);
+            const size_t nBytes = size * nmemb;
+            const std::string_view line = std::string_view(ptr, nBytes);
+
+            // Weak ETags can not be used for range requests, in which case we fall back
+            // to the modification date. Every response after a redirect starts over
+            if (line.starts_with("HTTP/")) {
+                t->validator.clear();
+            }
+            else if (std::optional<std::string> e = headerValue(line, "etag"); e) {
+                if (!e->starts_with("W/")) {
+                    t->validator = *e;
+                }
+            }
+            else if (std::optional<std::string> m = headerValue(line, "last-modified");
+                     m && t->validator.empty())
+            {
+                t->validator = *m;
+            }
+
+            // The header is terminated by an empty line, after which the response code
+            // is known
+            if (nBytes <= 2) {
+                long responseCode = 0;
+                curl_easy_getinfo(t->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+                // A response code of 200 instead of 206 (Partial Content) means that the
+                // server ignored the range request or that the file has changed, so it
+                // sends the entire file instead
+                if (t->resumeOffset > 0 && responseCode == 200) {
+                    t->stream.close();
+                    t->stream.open(
+                        t->temporary,
+                        std::ofstream::binary | std::ofstream::trunc
+                    );
+                    resetProgress(*t);
+                    t->resumeOffset = 0;
+                }
+
+                // Remember which version of the file is stored in the temporary file in
+                // case the transfer is interrupted and resumed later
+                if (responseCode == 200 && !t->validator.empty()) {
+                    std::ofstream validatorStream(t->validatorFile, std::ofstream::trunc);
+                    validatorStream << t->validator;
+                }
+                else if (responseCode == 200) {
+                    std::error_code ec;
+                    std::filesystem::remove(t->validatorFile, ec);
+                }
+            }
+            return nBytes;
+        }
+    );
+
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(
+        handle,
+        CURLOPT_WRITEFUNCTION,
+        +[](char* ptr, size_t size, size_t nmemb, void* userData) {
+            Transfer* t = reinterpret_cast<Transfer*>(userData);
+            const size_t nBytes = size * nmemb;
+            t->stream.write(ptr, nBytes);
+            if (!t->stream.good()) {
+                t->hasFailedWrite = true;
+                return size_t(0);
+            }
+            return nBytes;
+        }
+    );
+
+    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(handle, CURLOPT_XFERINFODATA, &transfer);
+    curl_easy_setopt(
+        handle,
+        CURLOPT_XFERINFOFUNCTION,
+        +[](void* userData, curl_off_t nTotalDownloadBytes, curl_off_t nDownloadedBytes,
+            curl_off_t, curl_off_t)
+        {
+            Transfer* t = reinterpret_cast<Transfer*>(userData);
+            if (t->batch->_shouldCancel) {
+                return 1;
+            }
+
+            // The numbers reported by curl only cover the part that was not resumed
+            reportProgress(
+                *t,
+                t->resumeOffset + nDownloadedBytes,
+                nTotalDownloadBytes > 0 ? t->resumeOffset + nTotalDownloadBytes : 0
+            );
+            return 0;
+        }
+    );
+
+    curl_multi_add_handle(reinterpret_cast<CURLM*>(_multiHandle), handle);
+    return true;
+}
+
+void HttpDownloadEngine::finishTransfer(std::unique_ptr<Transfer> transfer,
+                                        bool success)
+{
+    if (success) {
+        // A transfer without a known size contributes the bytes that it downloaded
+        if (!transfer->isTotalKnown) {
+            transfer->isTotalKnown = true;
+            transfer->reportedTotal = transfer->reportedBytes;
+            transfer->batch->_nTotalBytes += transfer->reportedTotal;
+            transfer->batch->_nUnknownTotals--;
+        }
+
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(transfer->file.destination)) {
+            std::filesystem::remove(transfer->file.destination, ec);
+        }
+        std::filesystem::rename(transfer->temporary, transfer->file.destination, ec);
+        std::error_code validatorEc;
+        std::filesystem::remove(transfer->validatorFile, validatorEc);
+        if (ec) {
+            LERROR(fmt::format(
+                "Error renaming {} to {}", transfer->temporary, transfer->file.destination
+            ));
+            success = false;
+        }
+    }
+
+    Batch& batch = *transfer->batch;
+    std::lock_guard lock(batch._mutex);
+    if (!success) {
+        batch._failedUrls.push_back(transfer->file.url);
+    }
+    batch._nRemaining--;
+    if (batch._nRemaining == 0) {
+        batch._finishedCondition.notify_all();
+    }
+}
+
+void HttpDownloadEngine::reportProgress(Transfer& transfer, int64_t nBytes,
+                                        int64_t nTotalBytes)
+{
+    Batch& batch = *transfer.batch;
+    batch._nDownloadedBytes += nBytes - transfer.reportedBytes;
+    transfer.reportedBytes = nBytes;
+
+    if (!transfer.isTotalKnown && nTotalBytes > 0) {
+        transfer.isTotalKnown = true;
+        transfer.reportedTotal = nTotalBytes;
+        batch._nTotalBytes += nTotalBytes;
+        batch._nUnknownTotals--;
+    }
+}
+
+void HttpDownloadEngine::resetProgress(Transfer& transfer) {
+    Batch& batch = *transfer.batch;
+    batch._nDownloadedBytes -= transfer.reportedBytes;
+    transfer.reportedBytes = 0;
+
+    if (transfer.isTotalKnown) {
+        batch._nTotalBytes -= transfer.reportedTotal;
+        batch._nUnknownTotals++;
+        transfer.isTotalKnown = false;
+        transfer.reportedTotal = 0;
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,137 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^ WIN32 / !WIN32 vvv
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFile(std::filesystem::path path)
+    : _path(std::move(path))
+{
+    if (!std::filesystem::is_regular_file(_path)) {
+        throw ghoul::RuntimeError(fmt::format("Could not find file '{}'", _path));
+    }
+
+    _size = static_cast<size_t>(std::filesystem::file_size(_path));
+    if (_size == 0) {
+        // Empty files cannot be mapped, but there is nothing to access anyway
+        return;
+    }
+
+#ifdef WIN32
+    _fileHandle = CreateFileW(
+        _path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        _fileHandle = nullptr;
+        throw ghoul::RuntimeError(fmt::format("Could not open file '{}'", _path));
+    }
+
+    _mappingHandle = CreateFileMappingW(
+        _fileHandle,
+        nullptr,
+        PAGE_READONLY,
+        0,
+        0,
+        nullptr
+    );
+    if (!_mappingHandle) {
+        CloseHandle(_fileHandle);
+        _fileHandle = nullptr;
+        throw ghoul::RuntimeError(fmt::format("Could not map file '{}'", _path));
+    }
+
+    void* view = MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(_mappingHandle);
+        CloseHandle(_fileHandle);
+        _mappingHandle = nullptr;
+        _fileHandle = nullptr;
+        throw ghoul::RuntimeError(fmt::format("Could not map file '{}'", _path));
+    }
+    _data = reinterpret_cast<const std::byte*>(view);
+#else // ^^^ WIN32 / !WIN32 vvv
+    const int fd = open(_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw ghoul::RuntimeError(fmt::format("Could not open file '{}'", _path));
+    }
+
+    void* view = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+    if (view == MAP_FAILED) {
+        throw ghoul::RuntimeError(fmt::format("Could not map file '{}'", _path));
+    }
+    _data = reinterpret_cast<const std::byte*>(view);
+#endif // WIN32
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+    }
+#else // ^^^ WIN32 / !WIN32 vvv
+    if (_data) {
+        munmap(const_cast<std::byte*>(_data), _size);
+    }
+#endif // WIN32
+}
+
+const std::byte* MemoryMappedFile::data() const {
+    return _data;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+const std::filesystem::path& MemoryMappedFile::path() const {
+    return _path;
+}
+
+} // namespace openspace
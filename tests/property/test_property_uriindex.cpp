@@ -0,0 +1,256 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/propertyurimatcher.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace openspace::properties;
+
+namespace {
+    constexpr int NNodes = 500;
+    constexpr int NComponents = 10;
+    constexpr int NPropertiesPerComponent = 10;
+
+    // A synthetic property tree of NNodes * NComponents * NPropertiesPerComponent
+    // properties that mirrors the structure of a scene graph
+    struct SyntheticTree {
+        explicit SyntheticTree(bool useIndex = true) {
+            if (useIndex) {
+                root.enableUriIndex();
+            }
+            root.addPropertySubOwner(scene);
+
+            for (int i = 0; i < NNodes; i++) {
+                auto node = std::make_unique<PropertyOwner>(
+                    PropertyOwner::PropertyOwnerInfo{ "Node" + std::to_string(i) }
+                );
+                if (i % 10 == 0) {
+                    node->addTag("tagged");
+                }
+
+                for (int j = 0; j < NComponents; j++) {
+                    auto comp = std::make_unique<PropertyOwner>(
+                        PropertyOwner::PropertyOwnerInfo{ "Comp" + std::to_string(j) }
+                    );
+                    for (int k = 0; k < NPropertiesPerComponent; k++) {
+                        const std::string id = "Prop" + std::to_string(k);
+                        auto p = std::make_unique<FloatProperty>(
+                            Property::PropertyInfo(id.c_str(), id.c_str(), "")
+                        );
+                        comp->addProperty(p.get());
+                        properties.push_back(std::move(p));
+                    }
+                    node->addPropertySubOwner(comp.get());
+                    owners.push_back(std::move(comp));
+                }
+                scene.addPropertySubOwner(node.get());
+                owners.push_back(std::move(node));
+            }
+        }
+
+        PropertyOwner root = PropertyOwner({ "" });
+        PropertyOwner scene = PropertyOwner({ "Scene" });
+        std::vector<std::unique_ptr<PropertyOwner>> owners;
+        std::vector<std::unique_ptr<Property>> properties;
+    };
+
+    // Reference implementation that resolves the URIs without the index
+    std::vector<Property*> linearMatches(const PropertyOwner& root,
+                                         const PropertyUriMatcher& matcher)
+    {
+        std::vector<Property*> res;
+        for (Property* p : root.propertiesRecursive()) {
+            if (matcher.matches(p->fullyQualifiedIdentifier(), *p)) {
+                res.push_back(p);
+            }
+        }
+        return res;
+    }
+
+    std::vector<Property*> toProperties(
+                            const std::vector<std::pair<std::string, Property*>>& matches)
+    {
+        std::vector<Property*> res;
+        for (const std::pair<std::string, Property*>& m : matches) {
+            res.push_back(m.second);
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("PropertyUriIndex: Lookup", "[propertyuriindex]") {
+    SyntheticTree tree;
+    REQUIRE(tree.properties.size() == NNodes * NComponents * NPropertiesPerComponent);
+
+    for (const std::unique_ptr<Property>& p : tree.properties) {
+        CHECK(tree.root.property(p->fullyQualifiedIdentifier()) == p.get());
+    }
+
+    CHECK(tree.root.property("Scene.Node1.Comp1.NotAProperty") == nullptr);
+    CHECK(tree.root.property("Scene.Node1.Comp1") == nullptr);
+    CHECK(tree.root.property("") == nullptr);
+}
+
+TEST_CASE("PropertyUriIndex: Structural Changes", "[propertyuriindex]") {
+    SyntheticTree tree;
+    PropertyOwner* node = tree.scene.propertySubOwner("Node2");
+    REQUIRE(node);
+    PropertyOwner* comp = node->propertySubOwner("Comp3");
+    REQUIRE(comp);
+
+    // Adding a property to an attached owner
+    BoolProperty added(Property::PropertyInfo("Added", "Added", ""));
+    comp->addProperty(added);
+    CHECK(tree.root.property("Scene.Node2.Comp3.Added") == &added);
+
+    // Removing a property
+    comp->removeProperty(added);
+    CHECK(tree.root.property("Scene.Node2.Comp3.Added") == nullptr);
+
+    // Renaming an owner in the middle of the tree
+    Property* p = tree.root.property("Scene.Node2.Comp3.Prop4");
+    REQUIRE(p);
+    node->setIdentifier("Renamed");
+    CHECK(tree.root.property("Scene.Node2.Comp3.Prop4") == nullptr);
+    CHECK(tree.root.property("Scene.Renamed.Comp3.Prop4") == p);
+    CHECK(p->fullyQualifiedIdentifier() == "Scene.Renamed.Comp3.Prop4");
+
+    // Detaching and reattaching a subtree
+    tree.scene.removePropertySubOwner(node);
+    CHECK(tree.root.property("Scene.Renamed.Comp3.Prop4") == nullptr);
+    comp->addProperty(added);
+    CHECK(tree.root.property("Scene.Renamed.Comp3.Added") == nullptr);
+    tree.scene.addPropertySubOwner(node);
+    CHECK(tree.root.property("Scene.Renamed.Comp3.Prop4") == p);
+    CHECK(tree.root.property("Scene.Renamed.Comp3.Added") == &added);
+    comp->removeProperty(added);
+
+    // Owners without an identifier do not contribute to the URIs
+    PropertyOwner anonymous = PropertyOwner({ "" });
+    BoolProperty hidden(Property::PropertyInfo("Hidden", "Hidden", ""));
+    anonymous.addProperty(hidden);
+    tree.scene.addPropertySubOwner(anonymous);
+    CHECK(tree.root.property("Scene.Hidden") == &hidden);
+    CHECK(hidden.fullyQualifiedIdentifier() == "Scene.Hidden");
+    anonymous.setIdentifier("Named");
+    CHECK(tree.root.property("Scene.Hidden") == nullptr);
+    CHECK(tree.root.property("Scene.Named.Hidden") == &hidden);
+    anonymous.setIdentifier("");
+    CHECK(tree.root.property("Scene.Named.Hidden") == nullptr);
+    CHECK(tree.root.property("Scene.Hidden") == &hidden);
+    tree.scene.removePropertySubOwner(anonymous);
+    CHECK(tree.root.property("Scene.Hidden") == nullptr);
+    anonymous.removeProperty(hidden);
+}
+
+TEST_CASE("PropertyUriIndex: Matcher", "[propertyuriindex]") {
+    SyntheticTree tree;
+
+    const std::vector<PropertyUriMatcher> matchers = {
+        PropertyUriMatcher("Scene.Node12.Comp3.Prop7"),
+        PropertyUriMatcher("*Prop7"),
+        PropertyUriMatcher("Scene.Node12*"),
+        PropertyUriMatcher("Scene.Node1*Prop3"),
+        PropertyUriMatcher("*Comp4.Prop3"),
+        PropertyUriMatcher(".Comp4.Prop3", "tagged"),
+        PropertyUriMatcher("*Prop1", "tagged")
+    };
+    for (const PropertyUriMatcher& matcher : matchers) {
+        INFO(matcher.expression());
+        REQUIRE(matcher.isValid());
+
+        const std::vector<Property*> reference = linearMatches(tree.root, matcher);
+        CHECK(!reference.empty());
+        CHECK(toProperties(matcher.findMatches(tree.root)) == reference);
+        CHECK(toProperties(matchingProperties(tree.root, matcher)) == reference);
+        // Second call is served from the cache
+        CHECK(toProperties(matchingProperties(tree.root, matcher)) == reference);
+    }
+
+    // The cache has to be invalidated by structural changes
+    PropertyUriMatcher matcher("*Added");
+    CHECK(matchingProperties(tree.root, matcher).empty());
+    BoolProperty added(Property::PropertyInfo("Added", "Added", ""));
+    tree.scene.propertySubOwner("Node3")->addProperty(added);
+    std::vector<std::pair<std::string, Property*>> m =
+        matchingProperties(tree.root, matcher);
+    REQUIRE(m.size() == 1);
+    CHECK(m[0].first == "Scene.Node3.Added");
+    CHECK(m[0].second == &added);
+    tree.scene.propertySubOwner("Node3")->removeProperty(added);
+    CHECK(matchingProperties(tree.root, matcher).empty());
+
+    CHECK_FALSE(PropertyUriMatcher("*").isValid());
+    CHECK_FALSE(PropertyUriMatcher("Scene*Comp*Prop").isValid());
+}
+
+TEST_CASE("PropertyUriIndex: Benchmark", "[propertyuriindex][.benchmark]") {
+    using namespace std::chrono;
+
+    SyntheticTree tree;
+    SyntheticTree unindexedTree(false);
+    const PropertyOwner& unindexed = unindexedTree.root;
+
+    std::vector<std::string> uris;
+    for (size_t i = 0; i < tree.properties.size(); i += 97) {
+        uris.push_back(tree.properties[i]->fullyQualifiedIdentifier());
+    }
+
+    auto t0 = high_resolution_clock::now();
+    for (const std::string& uri : uris) {
+        CHECK(unindexed.property(uri));
+    }
+    auto t1 = high_resolution_clock::now();
+    for (const std::string& uri : uris) {
+        CHECK(tree.root.property(uri));
+    }
+    auto t2 = high_resolution_clock::now();
+
+    const PropertyUriMatcher matcher("*Prop7");
+    const std::vector<Property*> reference = linearMatches(tree.root, matcher);
+    auto t3 = high_resolution_clock::now();
+    const std::vector<std::pair<std::string, Property*>> first =
+        matchingProperties(tree.root, matcher);
+    auto t4 = high_resolution_clock::now();
+    const std::vector<std::pair<std::string, Property*>> cached =
+        matchingProperties(tree.root, matcher);
+    auto t5 = high_resolution_clock::now();
+    CHECK(toProperties(cached) == reference);
+
+    const auto us = [](auto d) { return duration_cast<microseconds>(d).count(); };
+    WARN(
+        "Lookup of " << uris.size() << " URIs in " << tree.properties.size() <<
+        " properties: linear " << us(t1 - t0) << "us, indexed " << us(t2 - t1) <<
+        "us; wildcard: fullyQualifiedIdentifier scan " << us(t3 - t2) <<
+        "us, single traversal " << us(t4 - t3) << "us, cached " << us(t5 - t4) << "us"
+    );
+}
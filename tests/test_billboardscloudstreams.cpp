@@ -0,0 +1,253 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#if defined(OPENSPACE_MODULE_DIGITALUNIVERSE_ENABLED) && \
+    defined(OPENSPACE_MODULE_SPACE_ENABLED)
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/digitaluniverse/rendering/billboardscloudstreams.h>
+#include <modules/space/speckloader.h>
+#include <glm/gtx/component_wise.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    speck::Dataset createDataset(size_t nEntries) {
+        std::mt19937 rd(1337);
+        std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+        std::uniform_real_distribution<float> value(-5.f, 25.f);
+
+        speck::Dataset dataset;
+        dataset.variables = { { 0, "color" }, { 1, "size" } };
+        for (size_t i = 0; i < nEntries; i++) {
+            speck::Dataset::Entry e;
+            e.position = glm::vec3(position(rd), position(rd), position(rd));
+            e.data = { value(rd), value(rd) };
+            dataset.entries.push_back(std::move(e));
+        }
+        return dataset;
+    }
+
+    speck::ColorMap createColorMap() {
+        speck::ColorMap colorMap;
+        for (int i = 0; i < 32; i++) {
+            const float t = static_cast<float>(i) / 31.f;
+            colorMap.entries.emplace_back(t, 1.f - t, t * t, 1.f);
+        }
+        return colorMap;
+    }
+
+    // The interleaved data slice as it was created before the attributes were split into
+    // separate streams, for a dataset with a color map and a size column
+    std::vector<float> interleavedSlice(const speck::Dataset& dataset,
+                                        const speck::ColorMap& colorMap,
+                                        const glm::dmat4& transformationMatrix,
+                                        const billboardscloud::ColorMapping& mapping)
+    {
+        std::vector<float> result;
+        const int colorMapInUse = mapping.dataIndex;
+        const int sizeScalingInUse = 1;
+
+        float minColorIdx = std::numeric_limits<float>::max();
+        float maxColorIdx = -std::numeric_limits<float>::max();
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            float color = e.data[colorMapInUse];
+            minColorIdx = std::min(color, minColorIdx);
+            maxColorIdx = std::max(color, maxColorIdx);
+        }
+
+        for (const speck::Dataset::Entry& e : dataset.entries) {
+            glm::vec3 transformedPos = glm::vec3(transformationMatrix * glm::vec4(
+                e.position, 1.0
+            ));
+            // Parsec
+            glm::vec4 position(transformedPos, 2.f);
+            for (int j = 0; j < 4; ++j) {
+                result.push_back(position[j]);
+            }
+
+            float variableColor = e.data[colorMapInUse];
+            float cmax = mapping.range.has_value() ? mapping.range->y : maxColorIdx;
+            float cmin = mapping.range.has_value() ? mapping.range->x : minColorIdx;
+
+            if (mapping.isExact) {
+                int colorIndex = static_cast<int>(variableColor + cmin);
+                for (int j = 0; j < 4; ++j) {
+                    result.push_back(colorMap.entries[colorIndex][j]);
+                }
+            }
+            else if (mapping.useLinearFiltering) {
+                float valueT = (variableColor - cmin) / (cmax - cmin);
+                valueT = std::clamp(valueT, 0.f, 1.f);
+
+                const float idx = valueT * (colorMap.entries.size() - 1);
+                const int floorIdx = static_cast<int>(std::floor(idx));
+                const int ceilIdx = static_cast<int>(std::ceil(idx));
+
+                const glm::vec4 floorColor = colorMap.entries[floorIdx];
+                const glm::vec4 ceilColor = colorMap.entries[ceilIdx];
+
+                const glm::vec4 c = floorColor != ceilColor ?
+                    floorColor + idx * (ceilColor - floorColor) :
+                    floorColor;
+                for (int j = 0; j < 4; ++j) {
+                    result.push_back(c[j]);
+                }
+            }
+            else {
+                float ncmap = static_cast<float>(colorMap.entries.size());
+                float normalization = ((cmax != cmin) && (ncmap > 2.f)) ?
+                    (ncmap - 2.f) / (cmax - cmin) : 0;
+                int colorIndex = static_cast<int>(
+                    (variableColor - cmin) * normalization + 1.f
+                );
+                colorIndex = colorIndex < 0 ? 0 : colorIndex;
+                colorIndex = colorIndex >= ncmap ?
+                    static_cast<int>(ncmap - 1.f) : colorIndex;
+
+                for (int j = 0; j < 4; ++j) {
+                    result.push_back(colorMap.entries[colorIndex][j]);
+                }
+            }
+
+            result.push_back(e.data[sizeScalingInUse]);
+        }
+        return result;
+    }
+
+    void checkStreams(const speck::Dataset& dataset, const speck::ColorMap& colorMap,
+                      const billboardscloud::ColorMapping& mapping, unsigned int nThreads)
+    {
+        const glm::dmat4 transform = glm::dmat4(
+            0.0, 1.0, 0.0, 0.0,
+            -1.0, 0.0, 0.0, 0.0,
+            0.0, 0.0, 2.0, 0.0,
+            10.0, 20.0, 30.0, 1.0
+        );
+        const std::vector<float> slice =
+            interleavedSlice(dataset, colorMap, transform, mapping);
+
+        billboardscloud::PositionStream positions = billboardscloud::createPositionStream(
+            dataset,
+            transform,
+            DistanceUnit::Parsec,
+            nThreads
+        );
+        std::vector<glm::vec4> colors =
+            billboardscloud::createColorStream(dataset, colorMap, mapping, nThreads);
+        std::vector<float> sizes =
+            billboardscloud::createSizeStream(dataset, 1, nThreads);
+
+        REQUIRE(positions.positions.size() == dataset.entries.size());
+        REQUIRE(colors.size() == dataset.entries.size());
+        REQUIRE(sizes.size() == dataset.entries.size());
+        REQUIRE(slice.size() == 9 * dataset.entries.size());
+
+        bool isEqual = true;
+        float biggestCoordinate = -1.f;
+        for (size_t i = 0; i < dataset.entries.size(); i++) {
+            const float* vertex = &slice[9 * i];
+            for (int j = 0; j < 4; j++) {
+                isEqual &= positions.positions[i][j] == vertex[j];
+                isEqual &= colors[i][j] == vertex[4 + j];
+            }
+            isEqual &= sizes[i] == vertex[8];
+            biggestCoordinate = std::max(
+                biggestCoordinate,
+                glm::compMax(positions.positions[i])
+            );
+        }
+        CHECK(isEqual);
+        CHECK(positions.biggestCoordinate == biggestCoordinate);
+    }
+} // namespace
+
+TEST_CASE("BillboardsCloudStreams: Nearest Color", "[billboardscloudstreams]") {
+    const speck::Dataset dataset = createDataset(100000);
+    const speck::ColorMap colorMap = createColorMap();
+
+    billboardscloud::ColorMapping mapping;
+    for (unsigned int nThreads : { 1u, 3u, 0u }) {
+        checkStreams(dataset, colorMap, mapping, nThreads);
+
+        mapping.range = glm::vec2(0.f, 20.f);
+        checkStreams(dataset, colorMap, mapping, nThreads);
+        mapping.range = std::nullopt;
+    }
+}
+
+TEST_CASE("BillboardsCloudStreams: Linear Color", "[billboardscloudstreams]") {
+    const speck::Dataset dataset = createDataset(100000);
+    const speck::ColorMap colorMap = createColorMap();
+
+    billboardscloud::ColorMapping mapping;
+    mapping.useLinearFiltering = true;
+    for (unsigned int nThreads : { 1u, 3u, 0u }) {
+        checkStreams(dataset, colorMap, mapping, nThreads);
+
+        mapping.range = glm::vec2(2.f, 10.f);
+        checkStreams(dataset, colorMap, mapping, nThreads);
+        mapping.range = std::nullopt;
+    }
+}
+
+TEST_CASE("BillboardsCloudStreams: Exact Color", "[billboardscloudstreams]") {
+    speck::Dataset dataset = createDataset(50000);
+    // For an exact color map, the values are indices into the color map
+    for (speck::Dataset::Entry& e : dataset.entries) {
+        e.data[0] = std::floor(std::abs(e.data[0]));
+    }
+    const speck::ColorMap colorMap = createColorMap();
+
+    billboardscloud::ColorMapping mapping;
+    mapping.isExact = true;
+    mapping.range = glm::vec2(0.f, 31.f);
+    for (unsigned int nThreads : { 1u, 3u, 0u }) {
+        checkStreams(dataset, colorMap, mapping, nThreads);
+    }
+}
+
+TEST_CASE("BillboardsCloudStreams: Empty Dataset", "[billboardscloudstreams]") {
+    const speck::Dataset dataset;
+    billboardscloud::PositionStream positions = billboardscloud::createPositionStream(
+        dataset,
+        glm::dmat4(1.0),
+        DistanceUnit::Meter
+    );
+    CHECK(positions.positions.empty());
+    CHECK(positions.maxRadius == 0.0);
+    CHECK(billboardscloud::createColorStream(
+        dataset,
+        createColorMap(),
+        billboardscloud::ColorMapping()
+    ).empty());
+    CHECK(billboardscloud::createSizeStream(dataset, 0).empty());
+}
+
+#endif // OPENSPACE_MODULE_DIGITALUNIVERSE_ENABLED && OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,311 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_EXOPLANETS_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/exoplanets/exoplanetsindex.h>
+#include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
+#include <ghoul/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace openspace::exoplanets;
+
+namespace {
+    std::filesystem::path tempFile(std::string_view name) {
+        return std::filesystem::temp_directory_path() /
+            fmt::format("test_exoplanetsindex_{}", name);
+    }
+
+    // Creates `nSystems` systems with one to four planets each, in random order
+    std::vector<ExoplanetsIndex::Entry> createEntries(int nSystems) {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> nPlanets(1, 4);
+
+        std::vector<ExoplanetsIndex::Entry> entries;
+        for (int i = 0; i < nSystems; i++) {
+            const std::string host = fmt::format("Star-{}", i);
+            const int n = nPlanets(rng);
+            for (int j = 0; j < n; j++) {
+                const char component = static_cast<char>('b' + j);
+                entries.push_back({
+                    .host = host,
+                    .name = fmt::format("{} {}", host, component),
+                    .offset = static_cast<uint64_t>(entries.size() * 100 + 4)
+                });
+            }
+        }
+        std::shuffle(entries.begin(), entries.end(), rng);
+        return entries;
+    }
+
+    void writeLookUpTable(const std::vector<ExoplanetsIndex::Entry>& entries,
+                          const std::filesystem::path& path)
+    {
+        std::ofstream file(path);
+        for (const ExoplanetsIndex::Entry& e : entries) {
+            file << e.name << ',' << e.offset << '\n';
+        }
+    }
+
+    // The previous way of finding the planets of a system by scanning the text table
+    std::vector<uint64_t> scanLookUpTable(const std::filesystem::path& path,
+                                          std::string_view host)
+    {
+        std::ifstream file(path);
+        std::vector<uint64_t> result;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream ss(line);
+            std::string name;
+            std::getline(ss, name, ',');
+            if (name.substr(0, name.length() - 2) != host) {
+                continue;
+            }
+            std::string location;
+            std::getline(ss, location);
+            result.push_back(std::stoull(location));
+        }
+        return result;
+    }
+
+    // The columns of the rows that are created by createDataRows
+    const std::vector<std::string> DataColumns = {
+        "pl_name", "hostname", "pl_letter", "pl_orbsmax", "pl_orbper", "st_teff",
+        "ra", "dec", "sy_dist"
+    };
+
+    // Creates `nRows` rows of the exoplanet archive with random values, one planet per
+    // system, where the host star of row `i` is called `Star-i`
+    std::vector<std::string> createDataRows(int nRows) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        std::vector<std::string> rows;
+        for (int i = 0; i < nRows; i++) {
+            rows.push_back(fmt::format(
+                "Star-{0} b,Star-{0},b,{1},{2},{3},{4},{5},{6}",
+                i, unit(rng) * 5.f, unit(rng) * 1000.f, 3500.f + unit(rng) * 5000.f,
+                unit(rng) * 360.f, unit(rng) * 180.f - 90.f, 10.f + unit(rng) * 500.f
+            ));
+        }
+        return rows;
+    }
+
+    void writeTeffToBv(const std::filesystem::path& path) {
+        std::ofstream file(path);
+        file << "3000,1.5\n5000,0.8\n7000,0.3\n9000,0.0\n";
+    }
+} // namespace
+
+TEST_CASE("ExoplanetsIndex: Empty", "[exoplanetsindex]") {
+    const std::filesystem::path file = tempFile("empty.idx");
+    ExoplanetsIndex::write({}, file);
+
+    {
+        ExoplanetsIndex index(file);
+        CHECK(index.size() == 0);
+        CHECK(index.planets("Star").empty());
+        CHECK(index.hosts().empty());
+    }
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ExoplanetsIndex: Lookup", "[exoplanetsindex]") {
+    const std::filesystem::path file = tempFile("lookup.idx");
+    std::vector<ExoplanetsIndex::Entry> entries = {
+        { .host = "HD 1", .name = "HD 1 c", .offset = 4 },
+        { .host = "Alpha", .name = "Alpha b", .offset = 100 },
+        { .host = "HD 1", .name = "HD 1 b", .offset = 196 },
+        { .host = "HD 1 A", .name = "HD 1 A b", .offset = 292 }
+    };
+    ExoplanetsIndex::write(entries, file);
+
+    {
+        ExoplanetsIndex index(file);
+        REQUIRE(index.size() == 4);
+
+        // Planets of the same system keep their order
+        std::vector<ExoplanetsIndex::Planet> planets = index.planets("HD 1");
+        REQUIRE(planets.size() == 2);
+        CHECK(planets[0].name == "HD 1 c");
+        CHECK(planets[0].offset == 4);
+        CHECK(planets[1].name == "HD 1 b");
+        CHECK(planets[1].offset == 196);
+
+        // A host whose name starts with the name of another host is kept separate
+        planets = index.planets("HD 1 A");
+        REQUIRE(planets.size() == 1);
+        CHECK(planets[0].offset == 292);
+
+        CHECK(index.planets("HD").empty());
+        CHECK(index.planets("Zeta").empty());
+
+        const std::vector<std::string_view> hosts = index.hosts();
+        REQUIRE(hosts.size() == 3);
+        CHECK(hosts[0] == "Alpha");
+        CHECK(hosts[1] == "HD 1");
+        CHECK(hosts[2] == "HD 1 A");
+    }
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ExoplanetsIndex: Invalid File", "[exoplanetsindex]") {
+    const std::filesystem::path file = tempFile("invalid.idx");
+    {
+        std::ofstream f(file, std::ios::binary);
+        f << "not an index";
+    }
+    CHECK_THROWS(ExoplanetsIndex(file));
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ExoplanetsIndex: Read Look-up Table", "[exoplanetsindex]") {
+    const std::filesystem::path lut = tempFile("read.txt");
+    const std::vector<ExoplanetsIndex::Entry> entries = createEntries(100);
+    writeLookUpTable(entries, lut);
+
+    const std::vector<ExoplanetsIndex::Entry> read =
+        ExoplanetsIndex::readLookUpTable(lut);
+    REQUIRE(read.size() == entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        CHECK(read[i].host == entries[i].host);
+        CHECK(read[i].name == entries[i].name);
+        CHECK(read[i].offset == entries[i].offset);
+    }
+    std::filesystem::remove(lut);
+}
+
+TEST_CASE("ExoplanetsIndex: Parse Data Rows", "[exoplanetsindex]") {
+    const std::filesystem::path teffToBv = tempFile("teff_bv.txt");
+    writeTeffToBv(teffToBv);
+    const std::vector<std::string> rows = createDataRows(2000);
+
+    using Task = ExoplanetsDataPreparationTask;
+    std::vector<Task::PlanetData> single = Task::parseDataRows(
+        rows, DataColumns, "", teffToBv, 1
+    );
+    std::vector<Task::PlanetData> multi = Task::parseDataRows(
+        rows, DataColumns, "", teffToBv
+    );
+    std::filesystem::remove(teffToBv);
+
+    REQUIRE(single.size() == rows.size());
+    REQUIRE(multi.size() == rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        CHECK(single[i].host == fmt::format("Star-{}", i));
+        CHECK(multi[i].host == single[i].host);
+        CHECK(multi[i].name == single[i].name);
+        CHECK(multi[i].dataEntry.a == single[i].dataEntry.a);
+        CHECK(multi[i].dataEntry.bmv == single[i].dataEntry.bmv);
+        CHECK(multi[i].dataEntry.positionX == single[i].dataEntry.positionX);
+    }
+}
+
+TEST_CASE("ExoplanetsIndex: Benchmark", "[exoplanetsindex][.benchmark]") {
+    using namespace std::chrono;
+
+    constexpr int NSystems = 5000;
+    constexpr int NQueries = 100;
+
+    const std::filesystem::path lut = tempFile("benchmark.txt");
+    const std::filesystem::path file = tempFile("benchmark.idx");
+    const std::vector<ExoplanetsIndex::Entry> entries = createEntries(NSystems);
+    writeLookUpTable(entries, lut);
+
+    auto t0 = high_resolution_clock::now();
+    ExoplanetsIndex::write(ExoplanetsIndex::readLookUpTable(lut), file);
+    auto t1 = high_resolution_clock::now();
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> system(0, NSystems - 1);
+    std::vector<std::string> queries;
+    for (int i = 0; i < NQueries; i++) {
+        queries.push_back(fmt::format("Star-{}", system(rng)));
+    }
+
+    std::vector<std::vector<uint64_t>> scanned;
+    auto t2 = high_resolution_clock::now();
+    for (const std::string& query : queries) {
+        scanned.push_back(scanLookUpTable(lut, query));
+    }
+    auto t3 = high_resolution_clock::now();
+
+    std::vector<std::vector<uint64_t>> indexed;
+    auto t4 = high_resolution_clock::now();
+    {
+        ExoplanetsIndex index(file);
+        for (const std::string& query : queries) {
+            std::vector<uint64_t> offsets;
+            for (const ExoplanetsIndex::Planet& p : index.planets(query)) {
+                offsets.push_back(p.offset);
+            }
+            indexed.push_back(std::move(offsets));
+        }
+    }
+    auto t5 = high_resolution_clock::now();
+    std::filesystem::remove(lut);
+    std::filesystem::remove(file);
+
+    const double scanUs = duration<double, std::micro>(t3 - t2).count() / NQueries;
+    const double indexUs = duration<double, std::micro>(t5 - t4).count() / NQueries;
+    WARN(
+        entries.size() << " exoplanets: creating the index " <<
+        duration<double, std::milli>(t1 - t0).count() << "ms, lookup per system " <<
+        scanUs << "us scanning the text table, " << indexUs << "us with the index"
+    );
+
+    CHECK(scanned == indexed);
+
+    const std::filesystem::path teffToBv = tempFile("benchmark_teff_bv.txt");
+    writeTeffToBv(teffToBv);
+    const std::vector<std::string> rows = createDataRows(NSystems);
+
+    using Task = ExoplanetsDataPreparationTask;
+    auto t6 = high_resolution_clock::now();
+    std::vector<Task::PlanetData> single = Task::parseDataRows(
+        rows, DataColumns, "", teffToBv, 1
+    );
+    auto t7 = high_resolution_clock::now();
+    std::vector<Task::PlanetData> multi = Task::parseDataRows(
+        rows, DataColumns, "", teffToBv
+    );
+    auto t8 = high_resolution_clock::now();
+    std::filesystem::remove(teffToBv);
+
+    WARN(
+        rows.size() << " exoplanet rows: parsing single-threaded " <<
+        duration<double, std::milli>(t7 - t6).count() << "ms, multi-threaded " <<
+        duration<double, std::milli>(t8 - t7).count() << "ms"
+    );
+
+    CHECK(single.size() == multi.size());
+}
+
+#endif // OPENSPACE_MODULE_EXOPLANETS_ENABLED
@@ -0,0 +1,246 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/space/fluxnodesstates.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    struct SourceFiles {
+        std::filesystem::path positions;
+        std::filesystem::path fluxes;
+        std::filesystem::path radii;
+    };
+
+    std::filesystem::path tempFile(std::string_view name) {
+        return std::filesystem::temp_directory_path() /
+            fmt::format("test_fluxnodesstates_{}", name);
+    }
+
+    // The value of the flux of `node` in `state`, the radius is the negated flux and the
+    // position contains the flux in all components
+    float valueAt(uint32_t state, uint32_t node) {
+        return static_cast<float>(state) * 1000.f + static_cast<float>(node);
+    }
+
+    // Writes the source files in the format of the FluxNodes sync folder
+    SourceFiles writeSourceFiles(std::string_view name, uint32_t nNodes,
+                                 uint32_t nStates)
+    {
+        SourceFiles files = {
+            .positions = tempFile(fmt::format("{}_positions", name)),
+            .fluxes = tempFile(fmt::format("{}_fluxes", name)),
+            .radii = tempFile(fmt::format("{}_radiuses", name))
+        };
+
+        std::ofstream positions(files.positions, std::ofstream::binary);
+        std::ofstream fluxes(files.fluxes, std::ofstream::binary);
+        std::ofstream radii(files.radii, std::ofstream::binary);
+        positions.write(reinterpret_cast<const char*>(&nNodes), sizeof(uint32_t));
+        positions.write(reinterpret_cast<const char*>(&nStates), sizeof(uint32_t));
+        for (uint32_t s = 0; s < nStates; s++) {
+            for (uint32_t n = 0; n < nNodes; n++) {
+                const float v = valueAt(s, n);
+                const glm::vec3 p = glm::vec3(v);
+                const float r = -v;
+                positions.write(reinterpret_cast<const char*>(&p), sizeof(glm::vec3));
+                fluxes.write(reinterpret_cast<const char*>(&v), sizeof(float));
+                radii.write(reinterpret_cast<const char*>(&r), sizeof(float));
+            }
+        }
+        return files;
+    }
+
+    void removeSourceFiles(const SourceFiles& files) {
+        std::filesystem::remove(files.positions);
+        std::filesystem::remove(files.fluxes);
+        std::filesystem::remove(files.radii);
+    }
+} // namespace
+
+TEST_CASE("FluxNodesStates: Convert", "[fluxnodesstates]") {
+    constexpr uint32_t NNodes = 37;
+    constexpr uint32_t NStates = 11;
+
+    const SourceFiles source = writeSourceFiles("convert", NNodes, NStates);
+    const std::filesystem::path file = tempFile("convert.states");
+    FluxNodesStates::convert(source.positions, source.fluxes, source.radii, file);
+
+    {
+        FluxNodesStates states(file);
+        REQUIRE(states.nStates() == NStates);
+        REQUIRE(states.nNodesPerState() == NNodes);
+
+        // The states are accessed out of order as only the offset table is used
+        for (uint32_t s = NStates; s > 0; s--) {
+            const FluxNodesStates::State state = states.state(s - 1);
+            REQUIRE(state.nNodes == NNodes);
+            for (uint32_t n = 0; n < NNodes; n++) {
+                const float v = valueAt(s - 1, n);
+                CHECK(state.positions[n] == glm::vec3(v));
+                CHECK(state.fluxes[n] == v);
+                CHECK(state.radii[n] == -v);
+            }
+        }
+    }
+
+    removeSourceFiles(source);
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("FluxNodesStates: Empty", "[fluxnodesstates]") {
+    const SourceFiles source = writeSourceFiles("empty", 0, 0);
+    const std::filesystem::path file = tempFile("empty.states");
+    FluxNodesStates::convert(source.positions, source.fluxes, source.radii, file);
+
+    {
+        FluxNodesStates states(file);
+        CHECK(states.nStates() == 0);
+        CHECK(states.nNodesPerState() == 0);
+    }
+
+    removeSourceFiles(source);
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("FluxNodesStates: Truncated Source", "[fluxnodesstates]") {
+    const SourceFiles source = writeSourceFiles("truncated", 10, 4);
+    // Remove the last state from the radii
+    std::filesystem::resize_file(source.radii, 3 * 10 * sizeof(float));
+
+    const std::filesystem::path file = tempFile("truncated.states");
+    CHECK_THROWS_AS(
+        FluxNodesStates::convert(source.positions, source.fluxes, source.radii, file),
+        ghoul::RuntimeError
+    );
+    // No partial file must be left behind
+    CHECK(!std::filesystem::exists(file));
+
+    removeSourceFiles(source);
+}
+
+TEST_CASE("FluxNodesStates: Invalid File", "[fluxnodesstates]") {
+    const SourceFiles source = writeSourceFiles("invalid", 10, 4);
+    const std::filesystem::path file = tempFile("invalid.states");
+    FluxNodesStates::convert(source.positions, source.fluxes, source.radii, file);
+
+    // A file without the data of the last state
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 1);
+    CHECK_THROWS_AS(FluxNodesStates(file), ghoul::RuntimeError);
+
+    // A file from a different version
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        const uint32_t version = 1234;
+        f.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    }
+    CHECK_THROWS_AS(FluxNodesStates(file), ghoul::RuntimeError);
+
+    removeSourceFiles(source);
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("FluxNodesStates: Benchmark", "[fluxnodesstates][.benchmark]") {
+    using namespace std::chrono;
+
+    constexpr uint32_t NNodes = 20000;
+    constexpr uint32_t NStates = 100;
+
+    const SourceFiles source = writeSourceFiles("benchmark", NNodes, NStates);
+    const std::filesystem::path file = tempFile("benchmark.states");
+
+    // The previous way of reading all states of all three files into memory at startup
+    auto t0 = high_resolution_clock::now();
+    std::vector<std::vector<glm::vec3>> statesPos;
+    std::vector<std::vector<float>> statesColor;
+    std::vector<std::vector<float>> statesRadius;
+    {
+        std::ifstream positions(source.positions, std::ifstream::binary);
+        std::ifstream fluxes(source.fluxes, std::ifstream::binary);
+        std::ifstream radii(source.radii, std::ifstream::binary);
+        positions.seekg(2 * sizeof(uint32_t));
+        for (uint32_t i = 0; i < NStates; i++) {
+            std::vector<glm::vec3> p(NNodes);
+            positions.read(reinterpret_cast<char*>(p.data()), NNodes * sizeof(glm::vec3));
+            statesPos.push_back(std::move(p));
+        }
+        for (uint32_t i = 0; i < NStates; i++) {
+            std::vector<float> c(NNodes);
+            fluxes.read(reinterpret_cast<char*>(c.data()), NNodes * sizeof(float));
+            statesColor.push_back(std::move(c));
+        }
+        for (uint32_t i = 0; i < NStates; i++) {
+            std::vector<float> r(NNodes);
+            radii.read(reinterpret_cast<char*>(r.data()), NNodes * sizeof(float));
+            statesRadius.push_back(std::move(r));
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+
+    FluxNodesStates::convert(source.positions, source.fluxes, source.radii, file);
+    auto t2 = high_resolution_clock::now();
+
+    // Mapping the converted file and accessing a single state, as it happens when the
+    // renderable starts or the energy bin changes
+    constexpr uint32_t Active = NStates / 2;
+    float sum = 0.f;
+    {
+        FluxNodesStates states(file);
+        const FluxNodesStates::State state = states.state(Active);
+        for (uint32_t n = 0; n < state.nNodes; n++) {
+            sum += state.fluxes[n];
+        }
+    }
+    auto t3 = high_resolution_clock::now();
+
+    float expected = 0.f;
+    for (float v : statesColor[Active]) {
+        expected += v;
+    }
+
+    removeSourceFiles(source);
+    std::filesystem::remove(file);
+
+    const double loadMs = duration<double, std::milli>(t1 - t0).count();
+    const double mapMs = duration<double, std::milli>(t3 - t2).count();
+    WARN(
+        NStates << " states with " << NNodes << " nodes: loading all states " <<
+        loadMs << "ms, converting once " <<
+        duration<double, std::milli>(t2 - t1).count() << "ms, mapping " << mapMs << "ms"
+    );
+
+    CHECK(sum == expected);
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
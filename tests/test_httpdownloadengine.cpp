@@ -0,0 +1,178 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/httpdownloadengine.h>
+#include <ghoul/fmt.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    std::filesystem::path tempDirectory(std::string_view name) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() /
+            fmt::format("test_httpdownloadengine_{}", name);
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+        return path;
+    }
+
+    std::string fileUrl(const std::filesystem::path& path) {
+        std::string p = path.generic_string();
+        return p.starts_with('/') ? "file://" + p : "file:///" + p;
+    }
+
+    std::vector<char> writeFile(const std::filesystem::path& path, size_t size) {
+        std::mt19937 rng(static_cast<unsigned int>(size));
+        std::uniform_int_distribution<int> dist(0, 255);
+
+        std::vector<char> content(size);
+        for (char& c : content) {
+            c = static_cast<char>(dist(rng));
+        }
+        std::ofstream f(path, std::ofstream::binary);
+        f.write(content.data(), content.size());
+        return content;
+    }
+
+    std::vector<char> readFile(const std::filesystem::path& path) {
+        std::ifstream f(path, std::ifstream::binary);
+        return std::vector<char>(
+            std::istreambuf_iterator<char>(f),
+            std::istreambuf_iterator<char>()
+        );
+    }
+} // namespace
+
+TEST_CASE("HttpDownloadEngine: Local Files", "[httpdownloadengine]") {
+    const std::filesystem::path source = tempDirectory("source");
+    const std::filesystem::path destination = tempDirectory("destination");
+
+    // More files than concurrent transfers to exercise the queue
+    std::vector<std::vector<char>> contents;
+    std::vector<HttpDownloadEngine::File> files;
+    int64_t totalSize = 0;
+    for (int i = 0; i < 25; i++) {
+        const std::string name = fmt::format("file{}.bin", i);
+        const size_t size = 1000 * i + 17;
+        contents.push_back(writeFile(source / name, size));
+        files.push_back({ fileUrl(source / name), destination / "sub" / name });
+        totalSize += size;
+    }
+
+    HttpDownloadEngine engine(4);
+    std::shared_ptr<HttpDownloadEngine::Batch> batch = engine.download(files);
+    CHECK(batch->wait());
+    CHECK(batch->isFinished());
+    CHECK(batch->failedUrls().empty());
+    CHECK(batch->isTotalBytesKnown());
+    CHECK(batch->nTotalBytes() == totalSize);
+    CHECK(batch->nDownloadedBytes() == totalSize);
+
+    for (size_t i = 0; i < files.size(); i++) {
+        CHECK(readFile(files[i].destination) == contents[i]);
+        CHECK_FALSE(std::filesystem::exists(destination / "sub" / (
+            files[i].destination.filename().string() + ".tmp"
+        )));
+    }
+}
+
+TEST_CASE("HttpDownloadEngine: Resume", "[httpdownloadengine]") {
+    const std::filesystem::path source = tempDirectory("resume_source");
+    const std::filesystem::path destination = tempDirectory("resume_destination");
+
+    const std::vector<char> content = writeFile(source / "file.bin", 100000);
+
+    // Simulate an interrupted download that has received the first part of the file
+    // together with the validator of the server's version of that file
+    {
+        std::ofstream f(destination / "file.bin.tmp", std::ofstream::binary);
+        f.write(content.data(), 40000);
+        std::ofstream validator(destination / "file.bin.tmp.validator");
+        validator << "\"etag\"";
+    }
+
+    HttpDownloadEngine engine;
+    std::shared_ptr<HttpDownloadEngine::Batch> batch = engine.download({
+        { fileUrl(source / "file.bin"), destination / "file.bin" }
+    });
+    CHECK(batch->wait());
+    CHECK(batch->nDownloadedBytes() == 100000);
+    CHECK(readFile(destination / "file.bin") == content);
+    CHECK_FALSE(std::filesystem::exists(destination / "file.bin.tmp.validator"));
+}
+
+TEST_CASE("HttpDownloadEngine: Unvalidated Partial File", "[httpdownloadengine]") {
+    const std::filesystem::path source = tempDirectory("unvalidated_source");
+    const std::filesystem::path destination = tempDirectory("unvalidated_destination");
+
+    const std::vector<char> content = writeFile(source / "file.bin", 100000);
+
+    // A partial file of an unknown version must not be resumed, as the new part of the
+    // file would be appended to an outdated beginning
+    {
+        std::ofstream f(destination / "file.bin.tmp", std::ofstream::binary);
+        const std::vector<char> stale(40000, 'x');
+        f.write(stale.data(), stale.size());
+    }
+
+    HttpDownloadEngine engine;
+    std::shared_ptr<HttpDownloadEngine::Batch> batch = engine.download({
+        { fileUrl(source / "file.bin"), destination / "file.bin" }
+    });
+    CHECK(batch->wait());
+    CHECK(batch->nDownloadedBytes() == 100000);
+    CHECK(readFile(destination / "file.bin") == content);
+}
+
+TEST_CASE("HttpDownloadEngine: Missing File", "[httpdownloadengine]") {
+    const std::filesystem::path source = tempDirectory("missing_source");
+    const std::filesystem::path destination = tempDirectory("missing_destination");
+
+    writeFile(source / "exists.bin", 1234);
+
+    const std::string missingUrl = fileUrl(source / "missing.bin");
+    HttpDownloadEngine engine;
+    std::shared_ptr<HttpDownloadEngine::Batch> batch = engine.download({
+        { fileUrl(source / "exists.bin"), destination / "exists.bin" },
+        { missingUrl, destination / "missing.bin" }
+    });
+    CHECK_FALSE(batch->wait());
+    REQUIRE(batch->failedUrls().size() == 1);
+    CHECK(batch->failedUrls()[0] == missingUrl);
+    CHECK(std::filesystem::is_regular_file(destination / "exists.bin"));
+    CHECK_FALSE(std::filesystem::exists(destination / "missing.bin"));
+}
+
+TEST_CASE("HttpDownloadEngine: Empty Batch", "[httpdownloadengine]") {
+    HttpDownloadEngine engine;
+    std::shared_ptr<HttpDownloadEngine::Batch> batch = engine.download({});
+    CHECK(batch->isFinished());
+    CHECK(batch->wait());
+    CHECK(batch->isTotalBytesKnown());
+}
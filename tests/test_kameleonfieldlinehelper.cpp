@@ -0,0 +1,301 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+
+#include <modules/kameleon/include/kameleonhelper.h>
+
+#ifdef _MSC_VER
+#pragma warning (push)
+#pragma warning (disable : 4619)
+#endif // _MSC_VER
+
+#include <ccmc/Kameleon.h>
+
+#ifdef _MSC_VER
+#pragma warning (pop)
+#endif // _MSC_VER
+
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+
+namespace {
+    // An analytic field that stands in for the interpolated model variables
+    float field(const std::string& variable, const glm::vec3& p) {
+        const float v = static_cast<float>(variable.front()) + variable.size() * 0.25f;
+        return std::sin(p.x * v) + std::cos(p.y + v) * p.z + v;
+    }
+
+    // A tracer that follows the analytic field and, like a ccmc::Tracer, has state that
+    // must not be shared between threads. The lengths of the lines differ between seeds
+    openspace::fls::LineTracer createTracer() {
+        auto position = std::make_shared<glm::vec3>(0.f);
+        return [position](const glm::vec3& seed) {
+            std::vector<glm::vec3> vertices;
+            *position = seed;
+            const int nSteps = 5 + static_cast<int>(std::abs(seed.x * 7.f + seed.y)) % 40;
+            for (int i = 0; i < nSteps; i++) {
+                vertices.push_back(*position);
+                *position += 0.1f * glm::vec3(
+                    field("bx", *position),
+                    field("by", *position),
+                    field("bz", *position)
+                );
+            }
+            return vertices;
+        };
+    }
+
+    std::vector<glm::vec3> createPositions() {
+        std::vector<glm::vec3> positions;
+        for (int i = 0; i < 10000; i++) {
+            const float f = static_cast<float>(i);
+            positions.emplace_back(
+                std::sin(f) * 10.f,
+                std::cos(f * 0.3f) * 10.f,
+                f * 1e-3f
+            );
+        }
+        return positions;
+    }
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+    // The CDF files are too large to be part of the repository, so the test that reads
+    // one only runs if a BATSRUS file has been placed at this location
+    constexpr std::string_view TestFile = "${TESTDIR}/fieldlinessequence/test.cdf";
+
+    struct Conversion {
+        std::unordered_map<std::string, std::vector<glm::vec3>> seeds;
+        std::vector<std::string> extraVars = { "T", "rho", "p" };
+        std::vector<std::string> extraMagVars = { "ux", "uy", "uz", "jx", "jy", "jz" };
+    };
+
+    // Creates a grid of seed points in the equatorial plane for the time of the file
+    Conversion createConversion(const std::filesystem::path& path) {
+        std::unique_ptr<ccmc::Kameleon> kameleon =
+            openspace::kameleonHelper::createKameleonObject(path.string());
+        const double time = openspace::kameleonHelper::getTime(kameleon.get(), 0.0);
+        const std::string key = openspace::SpiceManager::ref().dateFromEphemerisTime(
+            time,
+            "YYYYMMDDHRMNSC::RND"
+        );
+
+        Conversion conversion;
+        std::vector<glm::vec3>& seeds = conversion.seeds[key];
+        for (int x = -10; x <= 10; x++) {
+            for (int y = -10; y <= 10; y++) {
+                seeds.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.f);
+            }
+        }
+        return conversion;
+    }
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+
+    template <typename T>
+    bool isSame(const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() == b.size() &&
+            (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+    }
+} // namespace
+
+TEST_CASE("KameleonFieldlineHelper: Trace Lines", "[kameleonfieldlinehelper]") {
+    using namespace openspace;
+
+    std::vector<glm::vec3> seeds;
+    for (int x = -10; x <= 10; x++) {
+        for (int y = -10; y <= 10; y++) {
+            seeds.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.f);
+        }
+    }
+
+    std::vector<std::vector<glm::vec3>> serial = fls::traceLines(
+        seeds,
+        [](unsigned int) { return createTracer(); },
+        1
+    );
+    REQUIRE(serial.size() == seeds.size());
+    for (size_t i = 0; i < seeds.size(); i++) {
+        REQUIRE(!serial[i].empty());
+        CHECK(serial[i].front() == seeds[i]);
+    }
+
+    for (unsigned int nThreads : { 2u, 3u, 8u }) {
+        std::mutex mutex;
+        std::vector<unsigned int> threads;
+        std::vector<std::vector<glm::vec3>> parallel = fls::traceLines(
+            seeds,
+            [&mutex, &threads](unsigned int thread) {
+                std::lock_guard lock(mutex);
+                threads.push_back(thread);
+                return createTracer();
+            },
+            nThreads
+        );
+
+        // Every thread creates exactly one tracer
+        std::sort(threads.begin(), threads.end());
+        CHECK(threads.size() == nThreads);
+        for (size_t i = 0; i < threads.size(); i++) {
+            CHECK(threads[i] == i);
+        }
+
+        REQUIRE(parallel.size() == serial.size());
+        for (size_t i = 0; i < serial.size(); i++) {
+            CHECK(isSame(serial[i], parallel[i]));
+        }
+    }
+}
+
+TEST_CASE("KameleonFieldlineHelper: Extra Quantities", "[kameleonfieldlinehelper]") {
+    using namespace openspace;
+
+    const std::vector<glm::vec3> positions = createPositions();
+    const std::vector<std::string> scalars = { "T = p/rho", "rho", "p" };
+    const std::vector<std::string> magnitudes = {
+        "ux", "uy", "uz", "jx", "jy", "jz", "bx", "by", "bz"
+    };
+
+    auto createSampler = [](unsigned int, const std::vector<std::string>& variables) {
+        return fls::VariableSampler(
+            [variables](size_t variable, const glm::vec3& p) {
+                return field(variables[variable], p);
+            }
+        );
+    };
+
+    // Every variable is requested once, even if several quantities use it
+    std::map<std::string, int> nRequests;
+    std::vector<std::vector<float>> serial = fls::computeExtraQuantities(
+        positions,
+        fls::Model::Batsrus,
+        scalars,
+        magnitudes,
+        [&](unsigned int thread, const std::vector<std::string>& variables) {
+            for (const std::string& variable : variables) {
+                nRequests[variable]++;
+            }
+            return createSampler(thread, variables);
+        },
+        1
+    );
+    CHECK(nRequests.size() == 11);
+    for (const std::pair<const std::string, int>& request : nRequests) {
+        CHECK(request.second == 1);
+    }
+
+    REQUIRE(serial.size() == scalars.size() + magnitudes.size() / 3);
+    for (const std::vector<float>& quantity : serial) {
+        REQUIRE(quantity.size() == positions.size());
+    }
+    for (size_t i = 0; i < positions.size(); i++) {
+        const glm::vec3& p = positions[i];
+        CHECK(serial[1][i] == field("rho", p));
+        CHECK(serial[2][i] == field("p", p));
+        const float ux = field("ux", p);
+        const float uy = field("uy", p);
+        const float uz = field("uz", p);
+        CHECK(serial[3][i] == std::sqrt(ux*ux + uy*uy + uz*uz));
+    }
+
+    std::vector<std::vector<float>> parallel = fls::computeExtraQuantities(
+        positions,
+        fls::Model::Batsrus,
+        scalars,
+        magnitudes,
+        createSampler,
+        4
+    );
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); i++) {
+        CHECK(isSame(serial[i], parallel[i]));
+    }
+}
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+TEST_CASE("KameleonFieldlineHelper: Parallel Tracing", "[kameleonfieldlinehelper]") {
+    using namespace openspace;
+
+    const std::filesystem::path path = absPath(TestFile);
+    if (!std::filesystem::is_regular_file(path)) {
+        WARN(fmt::format("Skipping test, no CDF file found at '{}'", path));
+        return;
+    }
+    SpiceManager::ref().loadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls").string()
+    );
+
+    Conversion serialConversion = createConversion(path);
+    FieldlinesState serial;
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+    REQUIRE(fls::convertCdfToFieldlinesState(
+        serial, path.string(), serialConversion.seeds, 0.0, "b",
+        serialConversion.extraVars, serialConversion.extraMagVars, 1
+    ));
+    auto t1 = Clock::now();
+
+    Conversion parallelConversion = createConversion(path);
+    FieldlinesState parallel;
+    REQUIRE(fls::convertCdfToFieldlinesState(
+        parallel, path.string(), parallelConversion.seeds, 0.0, "b",
+        parallelConversion.extraVars, parallelConversion.extraMagVars, 0
+    ));
+    auto t2 = Clock::now();
+
+    CHECK(isSame(serial.vertexPositions(), parallel.vertexPositions()));
+    CHECK(isSame(serial.lineStart(), parallel.lineStart()));
+    CHECK(isSame(serial.lineCount(), parallel.lineCount()));
+    CHECK(serial.extraQuantityNames() == parallel.extraQuantityNames());
+    REQUIRE(serial.extraQuantities().size() == parallel.extraQuantities().size());
+    for (size_t i = 0; i < serial.extraQuantities().size(); i++) {
+        CHECK(isSame(serial.extraQuantities()[i], parallel.extraQuantities()[i]));
+    }
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    WARN(fmt::format(
+        "Tracing {} lines: serial {:.1f} ms, parallel {:.1f} ms",
+        serial.lineCount().size(), Ms(t1 - t0).count(), Ms(t2 - t1).count()
+    ));
+}
+
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
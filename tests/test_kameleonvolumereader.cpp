@@ -0,0 +1,205 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_KAMELEONVOLUME_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/kameleonvolume/kameleonvolumereader.h>
+#include <modules/volume/rawvolume.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+namespace {
+    // The CDF files are too large to be part of the repository, so the tests that read
+    // one only run if a file has been placed at this location
+    constexpr std::string_view TestFile = "${TESTDIR}/kameleonvolume/test.cdf";
+
+    // A sampler with state that is not safe to share between threads, like the cell
+    // cache of a ccmc::Interpolator, whose value only depends on the position
+    openspace::kameleonvolume::KameleonVolumeReader::Sampler createSampler() {
+        auto previous = std::make_shared<glm::vec3>(0.f);
+        return [previous](const glm::vec3& p) {
+            *previous = p;
+            return std::sin(p.x) * std::cos(p.y * 0.5f) + p.z * p.z;
+        };
+    }
+
+    bool isSameVolume(const openspace::volume::RawVolume<float>& a,
+                      const openspace::volume::RawVolume<float>& b)
+    {
+        return a.dimensions() == b.dimensions() &&
+            std::memcmp(a.data(), b.data(), a.nCells() * sizeof(float)) == 0;
+    }
+} // namespace
+
+TEST_CASE("KameleonVolumeReader: Parallel Brick Resampling", "[kameleonvolumereader]") {
+    using namespace openspace;
+    using Reader = kameleonvolume::KameleonVolumeReader;
+
+    // Dimensions that are not a multiple of the brick size exercise the partial bricks
+    const glm::uvec3 dims = glm::uvec3(37, 21, 18);
+    const glm::vec3 lower = glm::vec3(-3.f, -2.f, -1.f);
+    const glm::vec3 upper = glm::vec3(4.f, 2.5f, 1.5f);
+
+    float serialMin = 0.f;
+    float serialMax = 0.f;
+    std::unique_ptr<volume::RawVolume<float>> serial = Reader::resampleVolume(
+        dims, lower, upper, { createSampler() }, serialMin, serialMax
+    );
+
+    // The voxels are sampled at the same positions as before the resampling was split
+    // into bricks
+    const glm::vec3 diff = upper - lower;
+    serial->forEachVoxel([&](const glm::uvec3& voxel, float value) {
+        const glm::vec3 p = lower + diff * (glm::vec3(voxel) / glm::vec3(dims));
+        CHECK(value == createSampler()(p));
+    });
+
+    for (unsigned int nThreads : { 2u, 3u, 8u }) {
+        std::vector<Reader::Sampler> samplers;
+        for (unsigned int i = 0; i < nThreads; i++) {
+            samplers.push_back(createSampler());
+        }
+
+        float min = 0.f;
+        float max = 0.f;
+        float lastProgress = 0.f;
+        bool isMonotonic = true;
+        std::unique_ptr<volume::RawVolume<float>> parallel = Reader::resampleVolume(
+            dims, lower, upper, samplers, min, max,
+            [&lastProgress, &isMonotonic](float progress) {
+                isMonotonic &= progress >= lastProgress;
+                lastProgress = progress;
+            }
+        );
+        CHECK(isSameVolume(*serial, *parallel));
+        CHECK(min == serialMin);
+        CHECK(max == serialMax);
+        CHECK(isMonotonic);
+        CHECK(lastProgress == 1.f);
+    }
+}
+
+TEST_CASE("KameleonVolumeReader: Parallel Resampling", "[kameleonvolumereader]") {
+    using namespace openspace;
+
+    const std::filesystem::path path = absPath(TestFile);
+    if (!std::filesystem::is_regular_file(path)) {
+        WARN(fmt::format("Skipping test, no CDF file found at '{}'", path));
+        return;
+    }
+
+    kameleonvolume::KameleonVolumeReader reader(path.string());
+    const std::array<std::string, 3> grid = reader.gridVariableNames();
+    const glm::vec3 lower = glm::vec3(
+        reader.minValue(grid[0]),
+        reader.minValue(grid[1]),
+        reader.minValue(grid[2])
+    );
+    const glm::vec3 upper = glm::vec3(
+        reader.maxValue(grid[0]),
+        reader.maxValue(grid[1]),
+        reader.maxValue(grid[2])
+    );
+    const std::string variable = reader.variableNames().front();
+
+    // Dimensions that are not a multiple of the brick size exercise the partial bricks
+    const glm::uvec3 dims = glm::uvec3(37, 21, 18);
+
+    float serialMin = 0.f;
+    float serialMax = 0.f;
+    std::unique_ptr<volume::RawVolume<float>> serial = reader.readFloatVolume(
+        dims, variable, lower, upper, serialMin, serialMax, 1
+    );
+
+    for (unsigned int nThreads : { 2u, 3u, 8u }) {
+        float min = 0.f;
+        float max = 0.f;
+        float lastProgress = 0.f;
+        bool isMonotonic = true;
+        std::unique_ptr<volume::RawVolume<float>> parallel = reader.readFloatVolume(
+            dims, variable, lower, upper, min, max, nThreads,
+            [&lastProgress, &isMonotonic](float progress) {
+                isMonotonic &= progress >= lastProgress;
+                lastProgress = progress;
+            }
+        );
+        CHECK(isSameVolume(*serial, *parallel));
+        CHECK(min == serialMin);
+        CHECK(max == serialMax);
+        CHECK(isMonotonic);
+        CHECK(lastProgress == 1.f);
+    }
+}
+
+TEST_CASE("KameleonVolumeReader: Benchmark", "[kameleonvolumereader][.benchmark]") {
+    using namespace openspace;
+
+    const std::filesystem::path path = absPath(TestFile);
+    if (!std::filesystem::is_regular_file(path)) {
+        WARN(fmt::format("Skipping benchmark, no CDF file found at '{}'", path));
+        return;
+    }
+
+    kameleonvolume::KameleonVolumeReader reader(path.string());
+    const std::array<std::string, 3> grid = reader.gridVariableNames();
+    const glm::vec3 lower = glm::vec3(
+        reader.minValue(grid[0]),
+        reader.minValue(grid[1]),
+        reader.minValue(grid[2])
+    );
+    const glm::vec3 upper = glm::vec3(
+        reader.maxValue(grid[0]),
+        reader.maxValue(grid[1]),
+        reader.maxValue(grid[2])
+    );
+    const std::string variable = reader.variableNames().front();
+    const glm::uvec3 dims = glm::uvec3(128);
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+    std::unique_ptr<volume::RawVolume<float>> serial =
+        reader.readFloatVolume(dims, variable, lower, upper, 1);
+    auto t1 = Clock::now();
+    std::unique_ptr<volume::RawVolume<float>> parallel =
+        reader.readFloatVolume(dims, variable, lower, upper, 0);
+    auto t2 = Clock::now();
+
+    CHECK(isSameVolume(*serial, *parallel));
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    WARN(fmt::format(
+        "Resampling {}^3 voxels: serial {:.1f} ms, parallel {:.1f} ms",
+        dims.x, Ms(t1 - t0).count(), Ms(t2 - t1).count()
+    ));
+}
+
+#endif // OPENSPACE_MODULE_KAMELEONVOLUME_ENABLED
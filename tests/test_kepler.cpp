@@ -0,0 +1,216 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/space/kepler.h>
+#include <ghoul/fmt.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    std::filesystem::path tempFile(std::string_view name) {
+        return std::filesystem::temp_directory_path() /
+            fmt::format("test_kepler_{}", name);
+    }
+
+    void writeTle(const std::filesystem::path& file, int n) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::ofstream f(file);
+        for (int i = 0; i < n; i++) {
+            f << fmt::format("OBJECT {}\n", i);
+            f << fmt::format(
+                "1 {:05}U {:02}{:03}A   {:02}{:012.8f} -.00002182  00000-0 -11606-4 0  "
+                "2927\n",
+                i % 100000, i % 100, i % 1000, (i + 57) % 100, 1.0 + unit(rng) * 364.0
+            );
+            f << fmt::format(
+                "2 {:05} {:8.4f} {:8.4f} {:07} {:8.4f} {:8.4f} {:11.8f}563537\n",
+                i % 100000, unit(rng) * 180.0, unit(rng) * 360.0,
+                static_cast<int>(unit(rng) * 9999999.0), unit(rng) * 360.0,
+                unit(rng) * 360.0, 1.0 + unit(rng) * 15.0
+            );
+        }
+    }
+
+    void writeOmm(const std::filesystem::path& file, int n) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::ofstream f(file);
+        for (int i = 0; i < n; i++) {
+            f << "CCSDS_OMM_VERS = 2.0\n";
+            f << fmt::format("OBJECT_NAME = OBJECT {}\n", i);
+            f << fmt::format("OBJECT_ID = 2000-{:03}A\n", i % 1000);
+            f << fmt::format(
+                "EPOCH = 2020-{:02}-{:02}T12:34:56.789\n", 1 + i % 12, 1 + i % 28
+            );
+            f << fmt::format("MEAN_MOTION = {}\n", 1.0 + unit(rng) * 15.0);
+            f << fmt::format("ECCENTRICITY = {}\n", unit(rng) * 0.9);
+            f << fmt::format("INCLINATION = {}\n", unit(rng) * 180.0);
+            f << fmt::format("RA_OF_ASC_NODE = {}\n", unit(rng) * 360.0);
+            f << fmt::format("ARG_OF_PERICENTER = {}\n", unit(rng) * 360.0);
+            f << fmt::format("MEAN_ANOMALY = {}\n", unit(rng) * 360.0);
+            f << "\n";
+        }
+    }
+
+    void writeSbdb(const std::filesystem::path& file, int n) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::ofstream f(file);
+        f << "full_name,epoch_cal,e,a,i,om,w,ma,per\n";
+        for (int i = 0; i < n; i++) {
+            f << fmt::format(
+                "  {} Asteroid ({}),{:04}{:02}{:02}.{},{},{},{},{},{},{},{}\n",
+                i, i, 1990 + i % 40, 1 + i % 12, 1 + i % 28, i % 10, unit(rng) * 0.9,
+                0.5 + unit(rng) * 50.0, unit(rng) * 180.0, unit(rng) * 360.0,
+                unit(rng) * 360.0, -10.0 + unit(rng) * 370.0, 100.0 + unit(rng) * 1e5
+            );
+        }
+    }
+
+    void compare(const std::vector<kepler::Parameters>& lhs,
+                 const std::vector<kepler::Parameters>& rhs)
+    {
+        REQUIRE(lhs.size() == rhs.size());
+        for (size_t i = 0; i < lhs.size(); i++) {
+            const kepler::Parameters& a = lhs[i];
+            const kepler::Parameters& b = rhs[i];
+            REQUIRE(a.name == b.name);
+            REQUIRE(a.id == b.id);
+            REQUIRE(a.inclination == b.inclination);
+            REQUIRE(a.semiMajorAxis == b.semiMajorAxis);
+            REQUIRE(a.ascendingNode == b.ascendingNode);
+            REQUIRE(a.eccentricity == b.eccentricity);
+            REQUIRE(a.argumentOfPeriapsis == b.argumentOfPeriapsis);
+            REQUIRE(a.meanAnomaly == b.meanAnomaly);
+            REQUIRE(a.epoch == b.epoch);
+            REQUIRE(a.period == b.period);
+        }
+    }
+} // namespace
+
+TEST_CASE("Kepler: Parallel TLE", "[kepler]") {
+    const std::filesystem::path file = tempFile("parallel.tle");
+    writeTle(file, 20000);
+
+    const std::vector<kepler::Parameters> single = kepler::readTleFile(file, 1);
+    const std::vector<kepler::Parameters> multi = kepler::readTleFile(file, 8);
+    std::filesystem::remove(file);
+
+    REQUIRE(single.size() == 20000);
+    CHECK(single[1].name == "OBJECT 1");
+    compare(single, multi);
+}
+
+TEST_CASE("Kepler: Parallel OMM", "[kepler]") {
+    const std::filesystem::path file = tempFile("parallel.omm");
+    writeOmm(file, 10000);
+
+    const std::vector<kepler::Parameters> single = kepler::readOmmFile(file, 1);
+    const std::vector<kepler::Parameters> multi = kepler::readOmmFile(file, 8);
+    std::filesystem::remove(file);
+
+    REQUIRE(single.size() == 10000);
+    CHECK(single[2].name == "OBJECT 2");
+    CHECK(single[2].id == "2000-002A");
+    compare(single, multi);
+}
+
+TEST_CASE("Kepler: Parallel SBDB", "[kepler]") {
+    const std::filesystem::path file = tempFile("parallel.csv");
+    writeSbdb(file, 50000);
+
+    const std::vector<kepler::Parameters> single = kepler::readSbdbFile(file, 1);
+    const std::vector<kepler::Parameters> multi = kepler::readSbdbFile(file, 8);
+    std::filesystem::remove(file);
+
+    REQUIRE(single.size() == 50000);
+    CHECK(single[3].name == "3 Asteroid (3)");
+    compare(single, multi);
+}
+
+TEST_CASE("Kepler: Cache", "[kepler]") {
+    const std::filesystem::path file = tempFile("cache.csv");
+    writeSbdb(file, 1000);
+
+    const std::vector<kepler::Parameters> parsed = kepler::readSbdbFile(file);
+    // The first call creates the cache, the second one reads it
+    compare(kepler::readFile(file, kepler::Format::SBDB), parsed);
+    compare(kepler::readFile(file, kepler::Format::SBDB), parsed);
+
+    // Changing the source file has to invalidate the cache
+    writeSbdb(file, 1500);
+    const std::vector<kepler::Parameters> changed = kepler::readFile(
+        file,
+        kepler::Format::SBDB
+    );
+    std::filesystem::remove(file);
+
+    REQUIRE(changed.size() == 1500);
+    compare(
+        std::vector<kepler::Parameters>(changed.begin(), changed.begin() + 1000),
+        parsed
+    );
+}
+
+TEST_CASE("Kepler: Benchmark", "[kepler][.benchmark]") {
+    using namespace std::chrono;
+
+    const std::filesystem::path file = tempFile("benchmark.csv");
+    writeSbdb(file, 200000);
+
+    auto t0 = high_resolution_clock::now();
+    const std::vector<kepler::Parameters> single = kepler::readSbdbFile(file, 1);
+    auto t1 = high_resolution_clock::now();
+    const std::vector<kepler::Parameters> multi = kepler::readSbdbFile(file);
+    auto t2 = high_resolution_clock::now();
+
+    // Create the cache and then measure loading from it
+    kepler::readFile(file, kepler::Format::SBDB);
+    auto t3 = high_resolution_clock::now();
+    const std::vector<kepler::Parameters> cached =
+        kepler::readFile(file, kepler::Format::SBDB);
+    auto t4 = high_resolution_clock::now();
+    std::filesystem::remove(file);
+
+    const double singleMs = duration<double, std::milli>(t1 - t0).count();
+    const double multiMs = duration<double, std::milli>(t2 - t1).count();
+    const double cachedMs = duration<double, std::milli>(t4 - t3).count();
+    WARN(
+        "200k SBDB objects: single-threaded " << singleMs << "ms, multi-threaded " <<
+        multiMs << "ms, cached " << cachedMs << "ms"
+    );
+
+    compare(single, multi);
+    compare(single, cached);
+}
@@ -0,0 +1,351 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/space/keplerpropagator.h>
+#include <modules/space/translation/keplertranslation.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    std::vector<kepler::Parameters> randomOrbits(size_t n) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> angle(0.0, 360.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        // Cover all regimes of the eccentric anomaly solver
+        constexpr std::array<double, 6> Eccentricities = {
+            0.0, 0.1, 0.5, 0.85, 0.95, 0.99
+        };
+
+        std::vector<kepler::Parameters> res(n);
+        for (size_t i = 0; i < n; i++) {
+            kepler::Parameters& p = res[i];
+            p.name = std::to_string(i);
+            p.eccentricity = i < Eccentricities.size() ?
+                Eccentricities[i] :
+                std::min(unit(rng) * unit(rng), 0.99);
+            p.semiMajorAxis = 7000.0 + unit(rng) * 1e6;
+            p.inclination = angle(rng) / 2.0;
+            p.ascendingNode = angle(rng);
+            p.argumentOfPeriapsis = angle(rng);
+            p.meanAnomaly = angle(rng);
+            p.epoch = unit(rng) * 1e9;
+            p.period = 5400.0 + unit(rng) * 1e8;
+        }
+        return res;
+    }
+
+    // Computes the same segment sizes and start indices as the RenderableOrbitalKepler
+    void segments(const std::vector<kepler::Parameters>& orbits, int quality,
+                  std::vector<int>& nSegments, std::vector<int>& firstVertex)
+    {
+        nSegments.clear();
+        firstVertex.clear();
+        int vertex = 0;
+        for (const kepler::Parameters& p : orbits) {
+            const int n = kepler::numberOfSegments(p.eccentricity, quality);
+            nSegments.push_back(n);
+            firstVertex.push_back(vertex);
+            vertex += n + 1;
+        }
+    }
+
+    // The path that the RenderableOrbitalKepler used before the batched propagator
+    std::vector<kepler::OrbitVertex> referenceVertices(
+                                            const std::vector<kepler::Parameters>& orbits,
+                                                     const std::vector<int>& nSegments,
+                                                               size_t nVertices)
+    {
+        std::vector<kepler::OrbitVertex> res(nVertices);
+        size_t idx = 0;
+        KeplerTranslation translation;
+        for (size_t i = 0; i < orbits.size(); i++) {
+            const kepler::Parameters& orbit = orbits[i];
+            translation.setKeplerElements(
+                orbit.eccentricity,
+                orbit.semiMajorAxis,
+                orbit.inclination,
+                orbit.ascendingNode,
+                orbit.argumentOfPeriapsis,
+                orbit.meanAnomaly,
+                orbit.period,
+                orbit.epoch
+            );
+
+            for (int j = 0; j < nSegments[i] + 1; j++) {
+                const double timeOffset = orbit.period *
+                    static_cast<double>(j) / static_cast<double>(nSegments[i]);
+                const glm::dvec3 position = translation.position({
+                    {},
+                    Time(timeOffset + orbit.epoch),
+                    Time(0.0)
+                });
+                res[idx].x = static_cast<float>(position.x);
+                res[idx].y = static_cast<float>(position.y);
+                res[idx].z = static_cast<float>(position.z);
+                res[idx].time = static_cast<float>(timeOffset);
+                res[idx].epoch = orbit.epoch;
+                res[idx].period = orbit.period;
+                idx++;
+            }
+        }
+        return res;
+    }
+
+    void compare(const std::vector<kepler::Parameters>& orbits,
+                 const std::vector<int>& nSegments, const std::vector<int>& firstVertex,
+                 const std::vector<kepler::OrbitVertex>& lhs,
+                 const std::vector<kepler::OrbitVertex>& rhs)
+    {
+        REQUIRE(lhs.size() == rhs.size());
+        for (size_t i = 0; i < orbits.size(); i++) {
+            // Allow for rounding differences relative to the size of the orbit
+            const double eps = orbits[i].semiMajorAxis * 1000.0 * 1e-6;
+            for (int j = 0; j < nSegments[i] + 1; j++) {
+                const kepler::OrbitVertex& a = lhs[firstVertex[i] + j];
+                const kepler::OrbitVertex& b = rhs[firstVertex[i] + j];
+                const double d = glm::distance(
+                    glm::dvec3(a.x, a.y, a.z),
+                    glm::dvec3(b.x, b.y, b.z)
+                );
+                if (d > eps) {
+                    FAIL(
+                        "Orbit " << i << " vertex " << j << " differs by " << d << "m"
+                    );
+                }
+                CHECK(a.time == b.time);
+                CHECK(a.epoch == b.epoch);
+                CHECK(a.period == b.period);
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("KeplerPropagator: Eccentric Anomaly", "[keplerpropagator]") {
+    // The eccentric anomaly has to fulfill Kepler's equation M = E - e * sin(E)
+    for (double e : { 0.0, 0.1, 0.5 }) {
+        std::vector<double> m;
+        for (int i = 0; i < 100; i++) {
+            m.push_back(i * glm::two_pi<double>() / 100.0);
+        }
+        std::vector<double> ea(m.size());
+        kepler::eccentricAnomalies(e, m.data(), ea.data(), m.size());
+        for (size_t i = 0; i < m.size(); i++) {
+            CHECK(std::abs(ea[i] - e * std::sin(ea[i]) - m[i]) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("KeplerPropagator: Matches KeplerTranslation", "[keplerpropagator]") {
+    const std::vector<kepler::Parameters> orbits = randomOrbits(500);
+    std::vector<int> nSegments;
+    std::vector<int> firstVertex;
+    segments(orbits, 3, nSegments, firstVertex);
+    const size_t nVertices = firstVertex.back() + nSegments.back() + 1;
+
+    const std::vector<kepler::OrbitVertex> reference =
+        referenceVertices(orbits, nSegments, nVertices);
+
+    const kepler::OrbitElements elements = kepler::orbitElements(orbits);
+    REQUIRE(elements.size() == orbits.size());
+
+    // Single- and multi-threaded results have to be identical
+    std::vector<kepler::OrbitVertex> single(nVertices);
+    kepler::generateOrbitVertices(elements, nSegments, firstVertex, single.data(), 1);
+    std::vector<kepler::OrbitVertex> multi(nVertices);
+    kepler::generateOrbitVertices(elements, nSegments, firstVertex, multi.data(), 4);
+    REQUIRE(
+        std::memcmp(single.data(), multi.data(), nVertices * sizeof(kepler::OrbitVertex))
+        == 0
+    );
+
+    compare(orbits, nSegments, firstVertex, single, reference);
+}
+
+TEST_CASE("KeplerPropagator: Invalid Elements", "[keplerpropagator]") {
+    std::vector<kepler::Parameters> orbits = randomOrbits(1);
+    orbits[0].eccentricity = 1.5;
+    CHECK_THROWS(kepler::orbitElements(orbits));
+}
+
+TEST_CASE("KeplerPropagator: Number of Segments", "[keplerpropagator]") {
+    // The formula that was used by the RenderableOrbitalKepler before
+    for (unsigned int quality = 1; quality <= 10; quality++) {
+        for (double e : { 0.0, 0.1, 0.5, 0.85, 0.95, 0.99 }) {
+            const double scale = static_cast<double>(quality) * 10.0;
+            const int n = static_cast<int>(scale + (scale / std::pow(1 - e, 1.2)));
+            CHECK(kepler::numberOfSegments(e, quality) == n);
+        }
+    }
+}
+
+TEST_CASE("KeplerPropagator: Orbit Buckets", "[keplerpropagator]") {
+    constexpr unsigned int Quality = 2;
+    constexpr double MaxOverdraw = 1.25;
+
+    // Includes near-parabolic orbits that need many more segments than the others
+    std::vector<float> eccentricities;
+    for (int i = 0; i < 1000; i++) {
+        eccentricities.push_back(static_cast<float>(i) / 1000.f);
+    }
+    eccentricities.push_back(0.9999f);
+
+    const std::vector<kepler::OrbitBucket> buckets =
+        kepler::orbitBuckets(eccentricities, Quality, MaxOverdraw);
+    REQUIRE(!buckets.empty());
+
+    size_t next = 0;
+    size_t nVertices = 0;
+    size_t nSegments = 0;
+    for (const kepler::OrbitBucket& bucket : buckets) {
+        // The buckets cover all orbits in order without gaps
+        CHECK(bucket.first == next);
+        CHECK(bucket.count > 0);
+        next = bucket.first + bucket.count;
+
+        for (size_t i = bucket.first; i < bucket.first + bucket.count; i++) {
+            const int n = kepler::numberOfSegments(eccentricities[i], Quality);
+            CHECK(bucket.nVertices >= n + 1);
+            CHECK(bucket.nVertices <= n * MaxOverdraw + 2);
+            nVertices += bucket.nVertices;
+            nSegments += n;
+        }
+    }
+    CHECK(next == eccentricities.size());
+
+    // Drawing every orbit with the vertex count of the most eccentric one would be
+    // several times as expensive
+    const int maxSegments = kepler::numberOfSegments(eccentricities.back(), Quality);
+    CHECK(nVertices <= nSegments * MaxOverdraw + 2 * eccentricities.size());
+    CHECK(nVertices < eccentricities.size() * static_cast<size_t>(maxSegments) / 10);
+}
+
+TEST_CASE("KeplerPropagator: GPU Reference Matches Baked Orbits", "[keplerpropagator]") {
+    const std::vector<kepler::Parameters> orbits = randomOrbits(500);
+    std::vector<int> nSegments;
+    std::vector<int> firstVertex;
+    segments(orbits, 3, nSegments, firstVertex);
+    const size_t nVertices = firstVertex.back() + nSegments.back() + 1;
+
+    const kepler::OrbitElements elements = kepler::orbitElements(orbits);
+    std::vector<kepler::OrbitVertex> baked(nVertices);
+    kepler::generateOrbitVertices(elements, nSegments, firstVertex, baked.data());
+
+    const std::vector<kepler::OrbitRecord> records = kepler::orbitRecords(elements);
+    REQUIRE(records.size() == orbits.size());
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const kepler::OrbitRecord& r = records[i];
+        CHECK(r.epoch == orbits[i].epoch);
+        CHECK(r.period == orbits[i].period);
+
+        // The shader works in single precision, so the tolerance is relative to the size
+        // of the orbit
+        const double eps = orbits[i].semiMajorAxis * 1000.0 * 1e-3;
+        const float n = static_cast<float>(nSegments[i]);
+        for (int j = 0; j < nSegments[i] + 1; j++) {
+            const float m =
+                r.meanAnomaly + glm::two_pi<float>() * static_cast<float>(j) / n;
+            const glm::vec3 gpu = kepler::orbitRecordPosition(r, m);
+            const kepler::OrbitVertex& v = baked[firstVertex[i] + j];
+            const double d = glm::distance(glm::dvec3(gpu), glm::dvec3(v.x, v.y, v.z));
+            if (d > eps) {
+                FAIL("Orbit " << i << " vertex " << j << " differs by " << d << "m");
+            }
+        }
+    }
+}
+
+TEST_CASE("KeplerPropagator: GPU Reference Current Position", "[keplerpropagator]") {
+    const std::vector<kepler::Parameters> orbits = randomOrbits(100);
+    const kepler::OrbitElements elements = kepler::orbitElements(orbits);
+    const std::vector<kepler::OrbitRecord> records = kepler::orbitRecords(elements);
+
+    KeplerTranslation translation;
+    for (size_t i = 0; i < orbits.size(); i++) {
+        const kepler::Parameters& orbit = orbits[i];
+        translation.setKeplerElements(
+            orbit.eccentricity,
+            orbit.semiMajorAxis,
+            orbit.inclination,
+            orbit.ascendingNode,
+            orbit.argumentOfPeriapsis,
+            orbit.meanAnomaly,
+            orbit.period,
+            orbit.epoch
+        );
+
+        // Many revolutions away from the epoch, where a time in single precision would
+        // no longer be able to resolve the position within the orbit
+        const double time = orbit.epoch + 1234.25 * orbit.period;
+        const glm::dvec3 reference = translation.position({ {}, Time(time), Time(0.0) });
+
+        const float m = kepler::orbitRecordMeanAnomaly(records[i], time);
+        const glm::vec3 gpu = kepler::orbitRecordPosition(records[i], m);
+
+        const double eps = orbit.semiMajorAxis * 1000.0 * 1e-3;
+        const double d = glm::distance(glm::dvec3(gpu), reference);
+        if (d > eps) {
+            FAIL("Orbit " << i << " differs by " << d << "m");
+        }
+    }
+}
+
+TEST_CASE("KeplerPropagator: Benchmark", "[keplerpropagator][.benchmark]") {
+    using namespace std::chrono;
+
+    const std::vector<kepler::Parameters> orbits = randomOrbits(20000);
+    std::vector<int> nSegments;
+    std::vector<int> firstVertex;
+    segments(orbits, 2, nSegments, firstVertex);
+    const size_t nVertices = firstVertex.back() + nSegments.back() + 1;
+
+    auto t0 = high_resolution_clock::now();
+    const std::vector<kepler::OrbitVertex> reference =
+        referenceVertices(orbits, nSegments, nVertices);
+    auto t1 = high_resolution_clock::now();
+    const kepler::OrbitElements elements = kepler::orbitElements(orbits);
+    std::vector<kepler::OrbitVertex> single(nVertices);
+    kepler::generateOrbitVertices(elements, nSegments, firstVertex, single.data(), 1);
+    auto t2 = high_resolution_clock::now();
+    std::vector<kepler::OrbitVertex> multi(nVertices);
+    kepler::generateOrbitVertices(elements, nSegments, firstVertex, multi.data());
+    auto t3 = high_resolution_clock::now();
+
+    const auto ms = [](auto d) { return duration_cast<milliseconds>(d).count(); };
+    WARN(
+        orbits.size() << " orbits with " << nVertices << " vertices: " <<
+        "KeplerTranslation " << ms(t1 - t0) << "ms, batched " << ms(t2 - t1) <<
+        "ms, batched parallel " << ms(t3 - t2) << "ms"
+    );
+}
@@ -0,0 +1,225 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/network/keyframecompression.h>
+#include <openspace/network/messagestructures.h>
+#include <glm/gtc/quaternion.hpp>
+#include <cmath>
+
+using namespace openspace::datamessagestructures;
+
+namespace {
+    constexpr double Tolerance = 5e-4;
+    // Additional error introduced by the quantization of the final keyframe of a segment
+    constexpr double QuantizationError = 1e-4;
+
+    // A camera that orbits the anchor for 30 s, hovers for 20 s, and then switches to a
+    // second anchor and approaches it for 10 s, sampled at 60 Hz
+    CameraKeyframe cameraPath(double t) {
+        CameraKeyframe kf;
+        kf._timestamp = t;
+        kf._scale = 1.f;
+        if (t < 30.0) {
+            const double angle = 0.2 * t;
+            kf._position = glm::dvec3(std::cos(angle), std::sin(angle), 0.1) * 1.5e7;
+            kf._rotation = glm::angleAxis(angle, glm::dvec3(0.0, 0.0, 1.0));
+            kf._focusNode = "Earth";
+        }
+        else if (t < 50.0) {
+            kf._position = glm::dvec3(std::cos(6.0), std::sin(6.0), 0.1) * 1.5e7;
+            kf._rotation = glm::angleAxis(6.0, glm::dvec3(0.0, 0.0, 1.0));
+            kf._focusNode = "Earth";
+        }
+        else {
+            kf._position = glm::dvec3(0.0, 1.0, 0.0) * (4e6 - 2e5 * (t - 50.0));
+            kf._rotation = glm::angleAxis(0.3, glm::dvec3(1.0, 0.0, 0.0));
+            kf._focusNode = "Moon";
+            kf._followNodeRotation = true;
+        }
+        return kf;
+    }
+} // namespace
+
+TEST_CASE("KeyframeCompression: Rotation Quantization", "[keyframecompression]") {
+    const glm::dquat rotations[] = {
+        glm::dquat(1.0, 0.0, 0.0, 0.0),
+        glm::dquat(0.0, 0.0, 0.0, 1.0),
+        glm::normalize(glm::dquat(-0.3, 0.5, -0.7, 0.2)),
+        glm::angleAxis(2.5, glm::normalize(glm::dvec3(1.0, -2.0, 3.0)))
+    };
+
+    for (const glm::dquat& q : rotations) {
+        uint8_t index = 0;
+        std::array<int16_t, 3> components;
+        quantizeRotation(q, index, components);
+        const glm::dquat r = dequantizeRotation(index, components);
+
+        // q and -q are the same rotation
+        const double angle = 2.0 * std::acos(std::min(std::abs(glm::dot(q, r)), 1.0));
+        CHECK(angle < QuantizationError);
+    }
+}
+
+TEST_CASE("KeyframeCompression: Serialization", "[keyframecompression]") {
+    CompactCameraKeyframe kf;
+    kf._flags = CompactCameraKeyframe::HasFocusNodeName |
+        CompactCameraKeyframe::AbsolutePosition;
+    kf._focusNodeIndex = 3;
+    kf._focusNodeName = "Earth";
+    kf._position = glm::dvec3(1.0, 2.0, 3.0);
+    kf._rotationIndex = 2;
+    kf._rotation = { 1, -2, 3 };
+    kf._scale = 0.5f;
+    kf._timestamp = 12.0;
+
+    std::vector<char> buffer;
+    kf.serialize(buffer);
+    CompactCameraKeyframe res(buffer);
+
+    CHECK(res._flags == kf._flags);
+    CHECK(res._focusNodeIndex == kf._focusNodeIndex);
+    CHECK(res._focusNodeName == kf._focusNodeName);
+    CHECK(res._position == kf._position);
+    CHECK(res._rotationIndex == kf._rotationIndex);
+    CHECK(res._rotation == kf._rotation);
+    CHECK(res._scale == kf._scale);
+    CHECK(res._timestamp == kf._timestamp);
+
+    CompactTimeTimeline timeline;
+    TimeKeyframe tkf;
+    tkf._time = 1.0;
+    tkf._dt = 2.0;
+    tkf._paused = true;
+    tkf._timestamp = 3.0;
+    timeline._keyframes.push_back(tkf);
+
+    buffer.clear();
+    timeline.serialize(buffer);
+    CompactTimeTimeline timelineRes(buffer);
+    REQUIRE(timelineRes._keyframes.size() == 1);
+    CHECK(timelineRes._keyframes[0]._time == tkf._time);
+    CHECK(timelineRes._keyframes[0]._dt == tkf._dt);
+    CHECK(timelineRes._keyframes[0]._paused == tkf._paused);
+    CHECK(timelineRes._keyframes[0]._requiresTimeJump == tkf._requiresTimeJump);
+    CHECK(timelineRes._keyframes[0]._timestamp == tkf._timestamp);
+}
+
+TEST_CASE("KeyframeCompression: Bandwidth and Error", "[keyframecompression]") {
+    constexpr double FrameTime = 1.0 / 60.0;
+    constexpr double Duration = 60.0;
+    // Send interval of the uncompressed camera keyframes
+    constexpr double LegacyInterval = 0.1;
+
+    CameraKeyframeEncoder encoder;
+    encoder.setTolerance(Tolerance);
+    encoder.setMaximumInterval(LegacyInterval);
+    CameraKeyframeDecoder decoder;
+
+    size_t legacyBytes = 0;
+    double lastLegacyTimestamp = -LegacyInterval;
+    size_t compactBytes = 0;
+    std::vector<CameraKeyframe> received;
+
+    for (double t = 0.0; t < Duration; t += FrameTime) {
+        const CameraKeyframe kf = cameraPath(t);
+
+        if (t - lastLegacyTimestamp >= LegacyInterval) {
+            std::vector<char> buffer;
+            kf.serialize(buffer);
+            legacyBytes += buffer.size();
+            lastLegacyTimestamp = t;
+        }
+
+        for (const CompactCameraKeyframe& compact : encoder.encode(kf)) {
+            std::vector<char> buffer;
+            compact.serialize(buffer);
+            compactBytes += buffer.size();
+
+            std::optional<CameraKeyframe> decoded = decoder.decode(
+                CompactCameraKeyframe(buffer)
+            );
+            REQUIRE(decoded.has_value());
+            received.push_back(*decoded);
+        }
+    }
+
+    INFO("Uncompressed: " << legacyBytes << " bytes, compressed: " << compactBytes);
+    CHECK(compactBytes * 2 < legacyBytes);
+
+    // Interpolate between the received keyframes the same way the KeyframeNavigator
+    // does and compare against the original camera path
+    REQUIRE(received.size() >= 2);
+    size_t k = 0;
+    for (double t = 0.0; t < received.back()._timestamp; t += FrameTime) {
+        while (received[k + 1]._timestamp < t) {
+            k++;
+        }
+        const CameraKeyframe& prev = received[k];
+        const CameraKeyframe& next = received[k + 1];
+        if (prev._focusNode != next._focusNode) {
+            continue;
+        }
+
+        const CameraKeyframe expected = cameraPath(t);
+        const double s = (t - prev._timestamp) / (next._timestamp - prev._timestamp);
+        const glm::dvec3 position = prev._position * (1.0 - s) + next._position * s;
+        const glm::dquat rotation = glm::slerp(prev._rotation, next._rotation, s);
+
+        const double positionError =
+            glm::length(position - expected._position) / glm::length(expected._position);
+        const double d = std::min(std::abs(glm::dot(rotation, expected._rotation)), 1.0);
+        const double rotationError = 2.0 * std::acos(d);
+
+        INFO("Time: " << t);
+        CHECK(positionError < Tolerance + QuantizationError);
+        CHECK(rotationError < Tolerance + QuantizationError);
+    }
+}
+
+TEST_CASE("KeyframeCompression: Late Joining Peer", "[keyframecompression]") {
+    CameraKeyframeEncoder encoder;
+    CameraKeyframeDecoder decoder;
+
+    bool hasDecoded = false;
+    bool hasSkipped = false;
+    for (double t = 1.0; t < 10.0; t += 1.0 / 60.0) {
+        for (const CompactCameraKeyframe& kf : encoder.encode(cameraPath(t))) {
+            // Simulate a peer that missed the first sync point
+            if (!(kf._flags & CompactCameraKeyframe::AbsolutePosition) && !hasDecoded) {
+                CHECK_FALSE(decoder.decode(kf).has_value());
+                hasSkipped = true;
+                continue;
+            }
+            if (!hasSkipped) {
+                continue;
+            }
+            CHECK(decoder.decode(kf).has_value());
+            hasDecoded = true;
+        }
+    }
+    CHECK(hasSkipped);
+    CHECK(hasDecoded);
+}
@@ -0,0 +1,248 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/space/labelbatch.h>
+#include <modules/space/labelsindex.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace openspace::labelbatch;
+
+namespace {
+    // A font in which all letters and digits have the same size and spaces have no area
+    std::optional<GlyphMetrics> fakeGlyph(wchar_t c) {
+        if (c == L' ') {
+            return GlyphMetrics { .advance = 5.f };
+        }
+
+        const bool isLetter = (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z');
+        const bool isDigit = c >= L'0' && c <= L'9';
+        if (!isLetter && !isDigit) {
+            return std::nullopt;
+        }
+
+        const float u = static_cast<float>(c) / 128.f;
+        return GlyphMetrics {
+            .leftBearing = 1.f,
+            .topBearing = 9.f,
+            .width = 8.f,
+            .height = 10.f,
+            .advance = 10.f,
+            .texCoordTopLeft = glm::vec2(u, 0.f),
+            .texCoordBottomRight = glm::vec2(u + 0.005f, 0.5f),
+            .outlineTexCoordTopLeft = glm::vec2(u, 0.5f),
+            .outlineTexCoordBottomRight = glm::vec2(u + 0.005f, 1.f)
+        };
+    }
+
+    constexpr float LineHeight = 12.f;
+} // namespace
+
+TEST_CASE("LabelBatch: Decode UTF-8", "[labelbatch]") {
+    CHECK(decodeUtf8("") == L"");
+    CHECK(decodeUtf8("abc") == L"abc");
+    CHECK(decodeUtf8("\xC3\xA9t\xC3\xA9") == L"\u00E9t\u00E9");
+    CHECK(decodeUtf8("\xE2\x82\xAC") == L"\u20AC");
+
+    // Truncated and invalid sequences are replaced
+    CHECK(decodeUtf8("a\xC3") == L"a?");
+    CHECK(decodeUtf8("\xFF" "b") == L"?b");
+}
+
+TEST_CASE("LabelBatch: Empty Label", "[labelbatch]") {
+    Layout layout;
+    appendLabel(layout, glm::vec3(1.f, 2.f, 3.f), "", LineHeight, fakeGlyph);
+    CHECK(layout.glyphs.empty());
+    CHECK(layout.nLabels == 1);
+}
+
+TEST_CASE("LabelBatch: Single Line", "[labelbatch]") {
+    const glm::vec3 position = glm::vec3(1.f, 2.f, 3.f);
+
+    Layout layout;
+    appendLabel(layout, position, "ab", LineHeight, fakeGlyph);
+    REQUIRE(layout.glyphs.size() == 2);
+    CHECK(layout.nLabels == 1);
+
+    CHECK(layout.glyphs[0].labelPosition == position);
+    CHECK(layout.glyphs[0].rect == glm::vec4(1.f, 9.f, 9.f, -1.f));
+    CHECK(layout.glyphs[1].labelPosition == position);
+    CHECK(layout.glyphs[1].rect == glm::vec4(11.f, 9.f, 19.f, -1.f));
+
+    const GlyphMetrics b = *fakeGlyph(L'b');
+    CHECK(
+        layout.glyphs[1].texCoords ==
+        glm::vec4(b.texCoordTopLeft, b.texCoordBottomRight)
+    );
+    CHECK(
+        layout.glyphs[1].outlineTexCoords ==
+        glm::vec4(b.outlineTexCoordTopLeft, b.outlineTexCoordBottomRight)
+    );
+}
+
+TEST_CASE("LabelBatch: Spaces And Missing Glyphs", "[labelbatch]") {
+    Layout layout;
+    appendLabel(layout, glm::vec3(0.f), "a b", LineHeight, fakeGlyph);
+    REQUIRE(layout.glyphs.size() == 2);
+    CHECK(layout.glyphs[1].rect.x == 16.f);
+
+    // Characters that are not part of the font do not advance the pen
+    layout = Layout();
+    appendLabel(layout, glm::vec3(0.f), "a%b", LineHeight, fakeGlyph);
+    REQUIRE(layout.glyphs.size() == 2);
+    CHECK(layout.glyphs[1].rect.x == 11.f);
+}
+
+TEST_CASE("LabelBatch: Multiple Lines", "[labelbatch]") {
+    Layout layout;
+    appendLabel(layout, glm::vec3(0.f), "ab\nc", LineHeight, fakeGlyph);
+    REQUIRE(layout.glyphs.size() == 3);
+    CHECK(layout.nLabels == 1);
+    CHECK(layout.glyphs[2].rect == glm::vec4(1.f, 9.f - LineHeight, 9.f, -13.f));
+}
+
+TEST_CASE("LabelBatch: Multiple Labels", "[labelbatch]") {
+    Layout layout;
+    appendLabel(layout, glm::vec3(0.f), "ab", LineHeight, fakeGlyph);
+    appendLabel(layout, glm::vec3(5.f), "cde", LineHeight, fakeGlyph);
+    REQUIRE(layout.glyphs.size() == 5);
+    CHECK(layout.nLabels == 2);
+
+    // Each label starts with its own pen position
+    CHECK(layout.glyphs[2].labelPosition == glm::vec3(5.f));
+    CHECK(layout.glyphs[2].rect.x == 1.f);
+}
+
+TEST_CASE("LabelBatch: Benchmark", "[labelbatch][.benchmark]") {
+    using namespace std::chrono;
+
+    constexpr int NLabels = 100000;
+
+    std::mt19937 rd(1337);
+    std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+    std::uniform_int_distribution<int> length(4, 20);
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<std::pair<glm::vec3, std::string>> labels;
+    labels.reserve(NLabels);
+    size_t nCharacters = 0;
+    for (int i = 0; i < NLabels; i++) {
+        std::string text(length(rd), ' ');
+        for (char& c : text) {
+            c = static_cast<char>(letter(rd));
+        }
+        nCharacters += text.size();
+        labels.emplace_back(
+            glm::vec3(position(rd), position(rd), position(rd)),
+            std::move(text)
+        );
+    }
+
+    const GlyphLookup lookup = fakeGlyph;
+    auto t0 = high_resolution_clock::now();
+    Layout layout;
+    for (const std::pair<glm::vec3, std::string>& label : labels) {
+        appendLabel(layout, label.first, label.second, LineHeight, lookup);
+    }
+    auto t1 = high_resolution_clock::now();
+
+    const double layoutMs = duration<double, std::milli>(t1 - t0).count();
+    WARN(
+        "100k labels: glyph layout " << layoutMs << "ms for " << layout.glyphs.size() <<
+        " glyphs, which is only done once when the labels change"
+    );
+
+    CHECK(layout.nLabels == NLabels);
+    CHECK(layout.glyphs.size() == nCharacters);
+}
+
+TEST_CASE("LabelBatch: Per-Frame Benchmark", "[labelbatch][.benchmark]") {
+    using namespace std::chrono;
+
+    constexpr int NLabels = 100000;
+    constexpr int NFrames = 100;
+
+    std::mt19937 rd(1337);
+    std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+    std::uniform_int_distribution<uint32_t> length(4, 20);
+
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> textLengths;
+    for (int i = 0; i < NLabels; i++) {
+        positions.emplace_back(position(rd), position(rd), position(rd));
+        textLengths.push_back(length(rd));
+    }
+
+    openspace::LabelsIndex index;
+    index.build(positions, textLengths);
+
+    const glm::dmat4 projection = glm::perspective(
+        glm::radians(60.0),
+        16.0 / 9.0,
+        0.1,
+        5000.0
+    );
+
+    // The camera circles around the labels, so the visible set changes every frame
+    openspace::LabelsIndex::CullingResult result;
+    size_t nVisible = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int frame = 0; frame < NFrames; frame++) {
+        const double angle = glm::two_pi<double>() * frame / NFrames;
+        const glm::dmat4 view = glm::lookAt(
+            glm::dvec3(std::cos(angle), 0.2, std::sin(angle)) * 1500.0,
+            glm::dvec3(0.0),
+            glm::dvec3(0.0, 1.0, 0.0)
+        );
+
+        openspace::LabelsIndex::CullingParameters parameters;
+        parameters.modelViewProjection = projection * view;
+        parameters.glyphSize = 1.0;
+        parameters.viewportHeight = 1080.0;
+        parameters.minSize = 4.0;
+        index.cull(parameters, result);
+        nVisible += result.visible.size();
+    }
+    auto t1 = high_resolution_clock::now();
+
+    // The instanced path has no per-label work on the CPU, so only the default path,
+    // which culls the labels before submitting the visible ones to the font renderer,
+    // depends on the number of labels
+    const double frameMs = duration<double, std::milli>(t1 - t0).count() / NFrames;
+    WARN(
+        "100k labels: culling " << frameMs << "ms per frame, " <<
+        nVisible / NFrames << " labels submitted to the font renderer per frame"
+    );
+
+    CHECK(index.nLabels() == NLabels);
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/space/labelsindex.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    struct Labels {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> textLengths;
+    };
+
+    Labels createLabels(size_t nLabels) {
+        std::mt19937 rd(1337);
+        std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+        std::uniform_int_distribution<uint32_t> length(1, 24);
+
+        Labels labels;
+        for (size_t i = 0; i < nLabels; i++) {
+            labels.positions.emplace_back(position(rd), position(rd), position(rd));
+            labels.textLengths.push_back(length(rd));
+        }
+        return labels;
+    }
+
+    LabelsIndex::CullingParameters createParameters(double glyphSize, double minSize) {
+        const glm::dmat4 projection = glm::perspective(
+            glm::radians(60.0),
+            16.0 / 9.0,
+            0.1,
+            5000.0
+        );
+        const glm::dmat4 view = glm::lookAt(
+            glm::dvec3(0.0, 0.0, 1500.0),
+            glm::dvec3(250.0, 0.0, 0.0),
+            glm::dvec3(0.0, 1.0, 0.0)
+        );
+
+        LabelsIndex::CullingParameters parameters;
+        parameters.modelViewProjection = projection * view;
+        parameters.glyphSize = glyphSize;
+        parameters.viewportHeight = 1080.0;
+        parameters.minSize = minSize;
+        return parameters;
+    }
+
+    // Tests every label individually with the same criteria that the index uses
+    std::vector<uint32_t> bruteForce(const Labels& labels,
+                                     const LabelsIndex::CullingParameters& parameters)
+    {
+        const glm::dmat4& mvp = parameters.modelViewProjection;
+        double norm = 0.0;
+        for (int c = 0; c < 3; c++) {
+            for (int r = 0; r < 4; r++) {
+                norm += mvp[c][r] * mvp[c][r];
+            }
+        }
+        const double clipGlyphSize = parameters.glyphSize * std::sqrt(norm);
+
+        std::vector<uint32_t> result;
+        for (uint32_t i = 0; i < labels.positions.size(); i++) {
+            const glm::dvec4 c = mvp * glm::dvec4(glm::dvec3(labels.positions[i]), 1.0);
+            const double m = clipGlyphSize * (labels.textLengths[i] + 1);
+            const bool isOutside =
+                c.w + c.x < -m || c.w - c.x < -m || c.w + c.y < -m ||
+                c.w - c.y < -m || c.w + c.z < -m || c.w - c.z < -m;
+            if (isOutside) {
+                continue;
+            }
+
+            if (parameters.minSize > 0.0 && c.w > 0.0) {
+                const double size = clipGlyphSize / c.w * parameters.viewportHeight * 0.5;
+                if (size < parameters.minSize) {
+                    continue;
+                }
+            }
+            result.push_back(i);
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("LabelsIndex: Empty", "[labelsindex]") {
+    LabelsIndex index;
+    index.build({}, {});
+    CHECK(index.nLabels() == 0);
+
+    LabelsIndex::CullingResult result;
+    index.cull(createParameters(1.0, 8.0), result);
+    CHECK(result.visible.empty());
+    CHECK(result.nFrustumCulled == 0);
+    CHECK(result.nSizeCulled == 0);
+}
+
+TEST_CASE("LabelsIndex: Identity Keeps Everything", "[labelsindex]") {
+    Labels labels;
+    for (int i = 0; i < 100; i++) {
+        const float v = static_cast<float>(i) / 100.f - 0.5f;
+        labels.positions.emplace_back(v, -v, 0.f);
+        labels.textLengths.push_back(4);
+    }
+
+    LabelsIndex index;
+    index.build(labels.positions, labels.textLengths);
+    REQUIRE(index.nLabels() == 100);
+
+    LabelsIndex::CullingParameters parameters;
+    LabelsIndex::CullingResult result;
+    index.cull(parameters, result);
+    REQUIRE(result.visible.size() == 100);
+    for (uint32_t i = 0; i < 100; i++) {
+        CHECK(result.visible[i] == i);
+        CHECK(index.position(i) == labels.positions[i]);
+    }
+    CHECK(result.nFrustumCulled == 0);
+    CHECK(result.nSizeCulled == 0);
+}
+
+TEST_CASE("LabelsIndex: Frustum Culling", "[labelsindex]") {
+    const Labels labels = createLabels(20000);
+    LabelsIndex index;
+    index.build(labels.positions, labels.textLengths);
+
+    const LabelsIndex::CullingParameters parameters = createParameters(0.5, 0.0);
+    LabelsIndex::CullingResult result;
+    index.cull(parameters, result);
+
+    const std::vector<uint32_t> expected = bruteForce(labels, parameters);
+    CHECK(result.visible == expected);
+    CHECK(result.nFrustumCulled > 0);
+    CHECK(result.nSizeCulled == 0);
+    CHECK(
+        result.visible.size() + result.nFrustumCulled == labels.positions.size()
+    );
+}
+
+TEST_CASE("LabelsIndex: Size Culling", "[labelsindex]") {
+    const Labels labels = createLabels(20000);
+    LabelsIndex index;
+    index.build(labels.positions, labels.textLengths);
+
+    const LabelsIndex::CullingParameters parameters = createParameters(0.5, 4.0);
+    LabelsIndex::CullingResult result;
+    index.cull(parameters, result);
+
+    const std::vector<uint32_t> expected = bruteForce(labels, parameters);
+    CHECK(result.visible == expected);
+    CHECK(result.nSizeCulled > 0);
+    CHECK(
+        result.visible.size() + result.nFrustumCulled + result.nSizeCulled ==
+        labels.positions.size()
+    );
+}
+
+TEST_CASE("LabelsIndex: Coincident Labels", "[labelsindex]") {
+    // Many labels at the same position must not lead to an unbounded subdivision
+    Labels labels;
+    for (int i = 0; i < 1000; i++) {
+        labels.positions.emplace_back(1.f, 2.f, 3.f);
+        labels.textLengths.push_back(8);
+    }
+
+    LabelsIndex index;
+    index.build(labels.positions, labels.textLengths);
+
+    LabelsIndex::CullingResult result;
+    index.cull(createParameters(0.5, 0.0), result);
+    CHECK(result.visible.size() + result.nFrustumCulled == 1000);
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -24,6 +24,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
@@ -31,6 +32,13 @@
 #include <openspace/util/timeline.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
 TEST_CASE("RawVolumeIO: TinyInputOutput", "[rawvolumeio]") {
     using namespace openspace::volume;
@@ -81,3 +89,187 @@ TEST_CASE("RawVolumeIO: BasicInputOutput", "[rawvolumeio]") {
         CHECK(v == value(x));
     });
 }
+
+TEST_CASE("RawVolumeIO: MappedVolume", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    glm::uvec3 dims(3, 4, 5);
+    auto value = [dims](glm::uvec3 v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    RawVolume<float> vol(dims);
+    vol.forEachVoxel([&vol, &value](glm::uvec3 x, float) { vol.set(x, value(x)); });
+
+    std::filesystem::path volumePath = absPath("${TESTDIR}/mappedvolume.rawvolume");
+    RawVolumeWriter<float> writer(volumePath.string());
+    writer.write(vol);
+
+    RawVolumeReader<float> reader(volumePath.string(), dims);
+    std::unique_ptr<MappedRawVolume<float>> mapped = reader.map();
+    REQUIRE(mapped->dimensions() == dims);
+    vol.forEachVoxel([&mapped](glm::uvec3 x, float v) { CHECK(mapped->get(x) == v); });
+
+    // A brick refers to the mapped voxels without copying them
+    const glm::uvec3 offset = glm::uvec3(1, 1, 2);
+    MappedRawVolume<float>::Brick brick = mapped->brick(offset, glm::uvec3(2, 3, 2));
+    CHECK(brick.data == mapped->data() + mapped->coordsToIndex(offset));
+    std::vector<float> copied(brick.nCells());
+    brick.copyTo(copied.data());
+    size_t i = 0;
+    for (unsigned int z = 0; z < brick.dimensions.z; z++) {
+        for (unsigned int y = 0; y < brick.dimensions.y; y++) {
+            for (unsigned int x = 0; x < brick.dimensions.x; x++) {
+                const glm::uvec3 p = glm::uvec3(x, y, z);
+                CHECK(brick.get(p) == value(offset + p));
+                CHECK(copied[i] == value(offset + p));
+                i++;
+            }
+        }
+    }
+
+    // Reading with an inverted z axis must give the same result as the voxel-wise flip
+    std::unique_ptr<RawVolume<float>> inverted = reader.read(true);
+    vol.forEachVoxel([&inverted, dims](glm::uvec3 x, float v) {
+        CHECK(inverted->get(glm::uvec3(x.x, x.y, dims.z - x.z - 1)) == v);
+    });
+
+    // A file that is too small for the dimensions cannot be mapped
+    RawVolumeReader<float> tooLarge(volumePath.string(), dims + glm::uvec3(1));
+    CHECK_THROWS(tooLarge.map());
+}
+
+TEST_CASE("RawVolumeIO: WriteSlabs", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(7, 5, 9);
+    auto value = [dims](const glm::uvec3& v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    std::filesystem::path serialPath = absPath("${TESTDIR}/serialvolume.rawvolume");
+    RawVolumeWriter<float> serialWriter(serialPath.string());
+    serialWriter.setDimensions(dims);
+    serialWriter.write(value);
+
+    // A buffer that is larger than one slice results in slabs with multiple slices
+    for (size_t bufferSize : { size_t(1), size_t(50), size_t(1024) }) {
+        std::filesystem::path slabPath = absPath("${TESTDIR}/slabvolume.rawvolume");
+        RawVolumeWriter<float> slabWriter(slabPath.string(), bufferSize);
+        slabWriter.setDimensions(dims);
+
+        std::vector<std::pair<unsigned int, unsigned int>> slabs;
+        float lastProgress = 0.f;
+        slabWriter.writeSlabs(
+            value,
+            [&slabs](unsigned int begin, unsigned int end) {
+                slabs.emplace_back(begin, end);
+            },
+            4,
+            [&lastProgress](float progress) { lastProgress = progress; }
+        );
+        CHECK(lastProgress == 1.f);
+
+        // The slabs cover all slices in order
+        REQUIRE(!slabs.empty());
+        CHECK(slabs.front().first == 0);
+        CHECK(slabs.back().second == dims.z);
+        for (size_t i = 1; i < slabs.size(); i++) {
+            CHECK(slabs[i].first == slabs[i - 1].second);
+        }
+
+        RawVolumeReader<float> serialReader(serialPath.string(), dims);
+        RawVolumeReader<float> slabReader(slabPath.string(), dims);
+        std::unique_ptr<RawVolume<float>> serial = serialReader.read();
+        std::unique_ptr<RawVolume<float>> slab = slabReader.read();
+        serial->forEachVoxel([&slab](glm::uvec3 x, float v) {
+            CHECK(slab->get(x) == v);
+        });
+    }
+}
+
+TEST_CASE("RawVolumeIO: WriteSlabs Worker Index", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(16, 16, 16);
+    constexpr unsigned int NThreads = 4;
+
+    // Each worker only touches its own counter, so no synchronization is needed
+    std::vector<size_t> nVoxels(NThreads, 0);
+    std::atomic<bool> indexInRange = true;
+    std::filesystem::path path = absPath("${TESTDIR}/workervolume.rawvolume");
+    RawVolumeWriter<float> writer(path.string(), 64);
+    writer.setDimensions(dims);
+    writer.writeSlabs(
+        [&](const glm::uvec3& v, unsigned int worker) {
+            if (worker >= NThreads) {
+                indexInRange = false;
+                return 0.f;
+            }
+            nVoxels[worker]++;
+            return static_cast<float>(v.x + v.y + v.z);
+        },
+        nullptr,
+        NThreads
+    );
+    REQUIRE(indexInRange);
+
+    size_t total = 0;
+    for (size_t n : nVoxels) {
+        total += n;
+    }
+    CHECK(total == static_cast<size_t>(dims.x) * dims.y * dims.z);
+
+    RawVolumeReader<float> reader(path.string(), dims);
+    std::unique_ptr<RawVolume<float>> volume = reader.read();
+    volume->forEachVoxel([](glm::uvec3 v, float value) {
+        CHECK(value == static_cast<float>(v.x + v.y + v.z));
+    });
+}
+
+TEST_CASE("RawVolumeIO: WriteSlabs Benchmark", "[rawvolumeio][.benchmark]") {
+    using namespace openspace::volume;
+    using namespace std::chrono;
+
+    // A function that is about as expensive as a trilinearly filtered sample
+    const glm::uvec3 dims(256);
+    auto value = [](const glm::uvec3& v) {
+        const glm::vec3 p = glm::vec3(v) * 0.05f;
+        float sum = 0.f;
+        for (int i = 0; i < 8; i++) {
+            sum += std::sin(p.x + i) * std::cos(p.y - i) * std::sin(p.z * i);
+        }
+        return sum;
+    };
+
+    std::filesystem::path serialPath = absPath("${TESTDIR}/benchmarkserial.rawvolume");
+    std::filesystem::path slabPath = absPath("${TESTDIR}/benchmarkslabs.rawvolume");
+
+    auto t0 = high_resolution_clock::now();
+    RawVolumeWriter<float> serialWriter(serialPath.string());
+    serialWriter.setDimensions(dims);
+    serialWriter.write(value);
+    auto t1 = high_resolution_clock::now();
+    RawVolumeWriter<float> slabWriter(slabPath.string());
+    slabWriter.setDimensions(dims);
+    slabWriter.writeSlabs(value, nullptr);
+    auto t2 = high_resolution_clock::now();
+
+    WARN(
+        "256^3 volume: serial " << duration<double, std::milli>(t1 - t0).count() <<
+        "ms, parallel slabs " << duration<double, std::milli>(t2 - t1).count() << "ms"
+    );
+
+    CHECK(std::filesystem::file_size(slabPath) == std::filesystem::file_size(serialPath));
+    std::ifstream serialFile(serialPath, std::ios::binary);
+    std::ifstream slabFile(slabPath, std::ios::binary);
+    CHECK(std::equal(
+        std::istreambuf_iterator<char>(serialFile),
+        std::istreambuf_iterator<char>(),
+        std::istreambuf_iterator<char>(slabFile)
+    ));
+    serialFile.close();
+    slabFile.close();
+    std::filesystem::remove(serialPath);
+    std::filesystem::remove(slabPath);
+}
@@ -28,7 +28,9 @@
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
 #include <ghoul/misc/dictionary.h>
+#include <chrono>
 #include <limits>
 
 TEST_CASE("ScriptScheduler: Simple Forward", "[scriptscheduler]") {
@@ -55,7 +57,8 @@ TEST_CASE("ScriptScheduler: Simple Forward", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 03"));
@@ -93,7 +96,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Single Jump", "[scriptscheduler]")
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -137,7 +141,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Ordering", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
@@ -171,7 +176,8 @@ TEST_CASE("ScriptScheduler: Simple Backward", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 05"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
@@ -211,7 +217,8 @@ TEST_CASE("ScriptScheduler: Multiple Backward Single Jump", "[scriptscheduler]")
     scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -254,7 +261,8 @@ TEST_CASE("ScriptScheduler: Multiple Backward Ordering", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 01"));
@@ -282,14 +290,14 @@ TEST_CASE("ScriptScheduler: Empty", "[scriptscheduler]") {
     // First test if a new ScriptScheduler will return an empty list
     for (double t : TestTimes) {
         ScriptScheduler scheduler;
-        std::vector<std::string> res = scheduler.progressTo(t);
+        std::vector<std::string_view> res = scheduler.progressTo(t);
         CHECK(res.empty());
     }
 
     // Then test the same thing but keeping the same ScriptScheduler
     ScriptScheduler scheduler;
     for (double t : TestTimes) {
-        std::vector<std::string> res = scheduler.progressTo(t);
+        std::vector<std::string_view> res = scheduler.progressTo(t);
         CHECK(res.empty());
     }
 
@@ -325,7 +333,8 @@ TEST_CASE("ScriptScheduler: Forward Backwards", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
 
@@ -372,7 +381,8 @@ TEST_CASE("ScriptScheduler: Rewind", "[scriptscheduler]") {
     scheduler.progressTo(Time::convertTime("2000 JAN 01"));
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 07"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     REQUIRE(res.size() == 2);
 
     scheduler.rewind();
@@ -472,7 +482,7 @@ TEST_CASE("ScriptScheduler: Jump Equal", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::vector<std::string_view> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 11:00:00"));
     CHECK(res.empty());
 
@@ -512,7 +522,7 @@ TEST_CASE("ScriptScheduler: Same Time", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::vector<std::string_view> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 12:00:00"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
@@ -545,7 +555,7 @@ TEST_CASE("ScriptScheduler: Multi Inner Jump", "[scriptscheduler]") {
     ScriptScheduler scheduler;
     scheduler.loadScripts(scripts);
 
-    std::vector<std::string> res =
+    std::vector<std::string_view> res =
         scheduler.progressTo(Time::convertTime("2000 JAN 03 10:00:00"));
     CHECK(res.empty());
 
@@ -591,7 +601,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -631,7 +642,8 @@ TEST_CASE("ScriptScheduler: Multiple Forward Ordering Multiple Load" "[scriptsch
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 02"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 02"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
@@ -670,7 +682,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
@@ -713,7 +726,8 @@ TEST_CASE(
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 06"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 06"));
     CHECK(res.empty());
 
     res = scheduler.progressTo(Time::convertTime("2000 JAN 01"));
@@ -749,7 +763,8 @@ TEST_CASE("ScriptScheduler: Forward Backwards Multiple Load", "[scriptscheduler]
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 04"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 04"));
     REQUIRE(res.size() == 1);
     CHECK(res[0] == "ForwardScript1");
 
@@ -792,7 +807,8 @@ TEST_CASE("ScriptScheduler: Rewind Multiple Load", "[scriptscheduler]") {
     scheduler.loadScripts({ script1 });
     scheduler.loadScripts({ script2 });
 
-    std::vector<std::string> res = scheduler.progressTo(Time::convertTime("2000 JAN 07"));
+    std::vector<std::string_view> res =
+        scheduler.progressTo(Time::convertTime("2000 JAN 07"));
     REQUIRE(res.size() == 2);
 
     scheduler.rewind();
@@ -880,3 +896,139 @@ TEST_CASE("ScriptScheduler: All Scripts Mixed Load", "[scriptscheduler]") {
 
     SpiceManager::deinitialize();
 }
+
+TEST_CASE("ScriptScheduler: Clear Group", "[scriptscheduler]") {
+    using namespace openspace::scripting;
+
+    std::vector<ScriptScheduler::ScheduledScript> scripts;
+    for (int i = 0; i < 6; i++) {
+        ScriptScheduler::ScheduledScript script;
+        script.time = static_cast<double>(i);
+        script.forwardScript = "Forward" + std::to_string(i);
+        script.backwardScript = "Backward" + std::to_string(i);
+        script.group = i % 2;
+        scripts.push_back(script);
+    }
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(-1.0);
+    scheduler.loadScripts(scripts);
+
+    std::vector<std::string_view> res = scheduler.progressTo(2.5);
+    REQUIRE(res.size() == 3);
+    CHECK(res[0] == "Forward0");
+    CHECK(res[1] == "Forward1");
+    CHECK(res[2] == "Forward2");
+
+    scheduler.clearSchedule(0);
+    CHECK(scheduler.allScripts().size() == 3);
+    CHECK(scheduler.allScripts(0).empty());
+    REQUIRE(scheduler.allScripts(1).size() == 3);
+    CHECK(scheduler.allScripts(1)[0].forwardScript == "Forward1");
+
+    res = scheduler.progressTo(10.0);
+    REQUIRE(res.size() == 2);
+    CHECK(res[0] == "Forward3");
+    CHECK(res[1] == "Forward5");
+
+    res = scheduler.progressTo(0.0);
+    REQUIRE(res.size() == 3);
+    CHECK(res[0] == "Backward5");
+    CHECK(res[1] == "Backward3");
+    CHECK(res[2] == "Backward1");
+
+    // Moving backward when no script has been passed does not return anything
+    res = scheduler.progressTo(-1.0);
+    CHECK(res.empty());
+}
+
+TEST_CASE("ScriptScheduler: Same Time Load Order", "[scriptscheduler]") {
+    using namespace openspace::scripting;
+
+    ScriptScheduler::ScheduledScript script1;
+    script1.time = 1.0;
+    script1.forwardScript = "Forward1";
+    script1.universalScript = "Universal";
+
+    ScriptScheduler::ScheduledScript script2;
+    script2.time = 1.0;
+    script2.forwardScript = "Forward2";
+    script2.group = 1;
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(0.0);
+    scheduler.loadScripts({ script1 });
+    scheduler.loadScripts({ script2 });
+
+    std::vector<std::string_view> res = scheduler.progressTo(2.0);
+    REQUIRE(res.size() == 2);
+    CHECK(res[0] == "Universal; Forward1");
+    CHECK(res[1] == "Forward2");
+}
+
+TEST_CASE("ScriptScheduler: Benchmark", "[scriptscheduler][.benchmark]") {
+    using namespace openspace::scripting;
+    using namespace std::chrono;
+
+    constexpr int NGroups = 200;
+    constexpr int NScriptsPerGroup = 500;
+
+    // Interleave the scripts of all groups on the timeline, with many scripts sharing
+    // the same body, as is common for mission profiles
+    std::vector<std::vector<ScriptScheduler::ScheduledScript>> groups(NGroups);
+    for (int g = 0; g < NGroups; g++) {
+        for (int i = 0; i < NScriptsPerGroup; i++) {
+            ScriptScheduler::ScheduledScript script;
+            script.time = static_cast<double>(i * NGroups + g);
+            script.forwardScript = fmt::format(
+                "openspace.setPropertyValueSingle('Scene.Node{}.Enabled', true)",
+                i % 50
+            );
+            script.backwardScript = fmt::format(
+                "openspace.setPropertyValueSingle('Scene.Node{}.Enabled', false)",
+                i % 50
+            );
+            script.group = g;
+            groups[g].push_back(std::move(script));
+        }
+    }
+    const double end = static_cast<double>(NGroups * NScriptsPerGroup);
+
+    ScriptScheduler scheduler;
+    scheduler.progressTo(end / 2.0 - 0.5);
+
+    auto t0 = high_resolution_clock::now();
+    for (std::vector<ScriptScheduler::ScheduledScript>& group : groups) {
+        scheduler.loadScripts(group);
+    }
+    auto t1 = high_resolution_clock::now();
+    REQUIRE(scheduler.allScripts().size() == NGroups * NScriptsPerGroup);
+
+    // Scrub through the entire timeline in small steps, forward and backward
+    size_t nForward = 0;
+    for (double t = end / 2.0; t <= end; t += 10.0) {
+        nForward += scheduler.progressTo(t).size();
+    }
+    size_t nBackward = 0;
+    for (double t = end; t >= -1.0; t -= 10.0) {
+        nBackward += scheduler.progressTo(t).size();
+    }
+    auto t2 = high_resolution_clock::now();
+    CHECK(nForward == NGroups * NScriptsPerGroup / 2);
+    CHECK(nBackward == NGroups * NScriptsPerGroup);
+
+    // Unloading every other group
+    for (int g = 0; g < NGroups; g += 2) {
+        scheduler.clearSchedule(g);
+    }
+    auto t3 = high_resolution_clock::now();
+    CHECK(scheduler.allScripts().size() == NGroups * NScriptsPerGroup / 2);
+    CHECK(scheduler.progressTo(end + 1.0).size() == NGroups * NScriptsPerGroup / 2);
+
+    const auto ms = [](auto d) { return duration_cast<milliseconds>(d).count(); };
+    WARN(
+        NGroups * NScriptsPerGroup << " scheduled scripts in " << NGroups <<
+        " groups: load " << ms(t1 - t0) << "ms, scrubbing " << ms(t2 - t1) <<
+        "ms, clearing half the groups " << ms(t3 - t2) << "ms"
+    );
+}
@@ -0,0 +1,134 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/base/rendering/trailsamplecache.h>
+#include <openspace/scene/translation.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <atomic>
+#include <cmath>
+
+using namespace openspace;
+
+namespace {
+    // A translation on a circle with a period of 100 seconds that counts how often it
+    // was evaluated
+    class CountingTranslation : public Translation {
+    public:
+        explicit CountingTranslation(bool concurrent) : _concurrent(concurrent) {}
+
+        glm::dvec3 position(const UpdateData& data) const override {
+            nEvaluations++;
+            const double t = data.time.j2000Seconds();
+            return glm::dvec3(std::cos(t / 100.0), std::sin(t / 100.0), t);
+        }
+
+        bool supportsConcurrentEvaluation() const override {
+            return _concurrent;
+        }
+
+        mutable std::atomic_int nEvaluations = 0;
+
+    private:
+        bool _concurrent;
+    };
+} // namespace
+
+TEST_CASE("TrailSampleCache: Grid", "[trailsamplecache]") {
+    TrailSampleCache cache;
+    cache.setSampleInterval(10.0);
+    CHECK(cache.sampleIndex(0.0) == 0);
+    CHECK(cache.sampleIndex(9.9) == 0);
+    CHECK(cache.sampleIndex(10.0) == 1);
+    CHECK(cache.sampleIndex(-0.1) == -1);
+    CHECK(cache.sampleTime(3) == 30.0);
+    CHECK(cache.sampleTime(-2) == -20.0);
+}
+
+TEST_CASE("TrailSampleCache: Fill and Reuse", "[trailsamplecache]") {
+    CountingTranslation translation(false);
+    TrailSampleCache cache;
+    cache.setSampleInterval(10.0);
+
+    // The budget limits the number of evaluations, newest samples first
+    CHECK_FALSE(cache.fill(translation, 0, 99, 40));
+    CHECK(translation.nEvaluations == 40);
+    CHECK(cache.find(99) != nullptr);
+    CHECK(cache.find(60) != nullptr);
+    CHECK(cache.find(59) == nullptr);
+
+    CHECK(cache.fill(translation, 0, 99, 100));
+    CHECK(translation.nEvaluations == 100);
+    REQUIRE(cache.find(42) != nullptr);
+    CHECK(cache.find(42)->z == 420.f);
+
+    // An overlapping range only evaluates the new samples
+    CHECK(cache.fill(translation, 50, 149, 100));
+    CHECK(translation.nEvaluations == 150);
+
+    // Changing the interval invalidates all samples
+    cache.setSampleInterval(5.0);
+    CHECK(cache.size() == 0);
+    CHECK(cache.find(42) == nullptr);
+}
+
+TEST_CASE("TrailSampleCache: Concurrent", "[trailsamplecache]") {
+    CountingTranslation serial(false);
+    TrailSampleCache serialCache;
+    serialCache.setSampleInterval(3.5);
+    REQUIRE(serialCache.fill(serial, -5000, 5000, 20000));
+
+    CountingTranslation concurrent(true);
+    TrailSampleCache concurrentCache;
+    concurrentCache.setSampleInterval(3.5);
+    REQUIRE(concurrentCache.fill(concurrent, -5000, 5000, 20000));
+    CHECK(concurrent.nEvaluations == 10001);
+
+    for (int64_t i = -5000; i <= 5000; i++) {
+        const glm::vec3* a = serialCache.find(i);
+        const glm::vec3* b = concurrentCache.find(i);
+        REQUIRE(a);
+        REQUIRE(b);
+        REQUIRE(*a == *b);
+    }
+}
+
+TEST_CASE("TrailSampleCache: Capacity", "[trailsamplecache]") {
+    CountingTranslation translation(false);
+    TrailSampleCache cache(300);
+    cache.setSampleInterval(1.0);
+
+    REQUIRE(cache.fill(translation, 0, 99, 100));
+    REQUIRE(cache.fill(translation, 1000, 1099, 100));
+    REQUIRE(cache.fill(translation, 2000, 2099, 100));
+    CHECK(cache.size() == 300);
+
+    // Going beyond the capacity drops the samples that are farthest away
+    REQUIRE(cache.fill(translation, 3000, 3099, 100));
+    CHECK(cache.size() <= 300);
+    CHECK(cache.find(3050) != nullptr);
+    CHECK(cache.find(50) == nullptr);
+}